@@ -0,0 +1,66 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+
+#include "common/LibCommon.hpp"
+#include "common/CSRTable.hpp"
+
+namespace cf3 {
+namespace common {
+
+common::ComponentBuilder < CSRTable<Uint>, Component, LibCommon > CSRTable_Uint_Builder;
+
+common::ComponentBuilder < CSRTable<int>, Component, LibCommon >  CSRTable_int_Builder;
+
+common::ComponentBuilder < CSRTable<Real>, Component, LibCommon > CSRTable_Real_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void print_csr_table(std::ostream& os, const CSRTable<T>& table)
+{
+  if (table.size())
+    os << "\n";
+  for (Uint i=0; i<table.size(); ++i)
+  {
+    os << "  " << i << ":  ";
+    if (table.row_size(i) == 0)
+      os << "~";
+    else
+    {
+      boost_foreach(const T& entry, table[i])
+        os << entry << " ";
+    }
+    os << "\n";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::ostream& operator<<(std::ostream& os, const CSRTable<Uint>& table)
+{
+  print_csr_table(os, table);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const CSRTable<int>& table)
+{
+  print_csr_table(os, table);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const CSRTable<Real>& table)
+{
+  print_csr_table(os, table);
+  return os;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
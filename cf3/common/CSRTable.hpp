@@ -0,0 +1,221 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_CSRTable_hpp
+#define cf3_common_CSRTable_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <numeric>
+
+#include <boost/range/iterator_range.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+#include "common/StringConversion.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class CSRTableBuilder;
+
+/// Component holding a table with variable row-size per row, in compressed
+/// sparse row storage: one contiguous array with all values, and an array
+/// of offsets where each row starts.
+/// Rows are read exactly like DynTable rows (size(), operator[], begin(), end(), boost_foreach),
+/// but the row sizes are fixed once the table is built. Use a CSRTableBuilder to fill it.
+/// @note T = bool is not supported, as std::vector<bool> does not store its values contiguously
+template<typename T>
+class CSRTable : public common::Component {
+
+public:
+
+  typedef boost::iterator_range<T*> Row;
+  typedef boost::iterator_range<const T*> ConstRow;
+
+  /// Contructor
+  /// @param name of the component
+  CSRTable ( const std::string& name ) : Component(name), m_offsets(1,0u) { }
+
+  ~CSRTable () {}
+
+  /// Get the class name
+  static std::string type_name () { return "CSRTable<"+common::class_name<T>()+">"; }
+
+  /// @return the number of rows
+  Uint size() const { return m_offsets.size()-1; }
+
+  /// Resize the table to new_size rows. Added rows are empty.
+  void resize(const Uint new_size)
+  {
+    if (new_size < size())
+    {
+      m_offsets.resize(new_size+1);
+      m_values.resize(m_offsets.back());
+    }
+    else
+    {
+      m_offsets.resize(new_size+1, m_offsets.back());
+    }
+  }
+
+  Uint row_size(const Uint i) const { return m_offsets[i+1]-m_offsets[i]; }
+
+  /// @return the total number of values stored in all rows
+  Uint nb_values() const { return m_values.size(); }
+
+  /// Copy the values of a row
+  /// @throws BadValue if the size of the row differs from the size of the given vector
+  template<typename VectorT>
+  void set_row(const Uint array_idx, const VectorT& row)
+  {
+    if (row.size() != row_size(array_idx))
+      throw BadValue(FromHere(), "Row "+to_str(array_idx)+" of "+uri().string()+" has size "+to_str(row_size(array_idx))
+                     +", cannot be set with a vector of size "+to_str(static_cast<Uint>(row.size())));
+    std::copy(row.begin(), row.end(), m_values.begin()+m_offsets[array_idx]);
+  }
+
+  /// Fill the table with a copy of a vector of vectors, such as DynTable::ArrayT
+  template<typename ArrayT>
+  void assign(const ArrayT& array)
+  {
+    m_offsets.resize(array.size()+1);
+    m_offsets[0] = 0;
+    for (Uint i=0; i<array.size(); ++i)
+      m_offsets[i+1] = m_offsets[i] + array[i].size();
+    m_values.resize(m_offsets.back());
+    for (Uint i=0; i<array.size(); ++i)
+      std::copy(array[i].begin(), array[i].end(), m_values.begin()+m_offsets[i]);
+  }
+
+  Row operator[] (const Uint idx)
+  {
+    cf3_assert(idx < size());
+    T* values = data();
+    return Row(values+m_offsets[idx], values+m_offsets[idx+1]);
+  }
+
+  ConstRow operator[] (const Uint idx) const
+  {
+    cf3_assert(idx < size());
+    const T* values = data();
+    return ConstRow(values+m_offsets[idx], values+m_offsets[idx+1]);
+  }
+
+  /// @return the offsets of the rows in values(). Row i spans [ offsets()[i] , offsets()[i+1] [
+  const std::vector<Uint>& offsets() const { return m_offsets; }
+
+  /// @return A reference to the contiguous values of all rows
+  std::vector<T>& values() { return m_values; }
+
+  /// @return A const reference to the contiguous values of all rows
+  const std::vector<T>& values() const { return m_values; }
+
+private: // functions
+
+  T* data() { return m_values.empty() ? 0 : &m_values[0]; }
+  const T* data() const { return m_values.empty() ? 0 : &m_values[0]; }
+
+private: // data
+
+  friend class CSRTableBuilder<T>;
+
+  /// Start of each row in m_values, with one extra entry holding the total size
+  std::vector<Uint> m_offsets;
+
+  /// Values of all rows, stored contiguously
+  std::vector<T> m_values;
+
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::ostream& operator<<(std::ostream& os, const CSRTable<Uint>& table);
+std::ostream& operator<<(std::ostream& os, const CSRTable<int>& table);
+std::ostream& operator<<(std::ostream& os, const CSRTable<Real>& table);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Two-pass builder for a CSRTable, replacing the row-by-row growth of a DynTable.
+/// In the first pass the number of values of each row is counted, after which
+/// all memory is allocated at once. In the second pass the values are added.
+/// @code
+/// CSRTableBuilder<Uint> builder(table, nb_rows);
+/// for (...) builder.count(row);
+/// builder.allocate();
+/// for (...) builder.add(row, value);
+/// @endcode
+template <typename T>
+class CSRTableBuilder
+{
+public:
+
+  /// Start building the table with nb_rows empty rows. Previous contents of the table are discarded.
+  CSRTableBuilder(CSRTable<T>& table, const Uint nb_rows) :
+    m_table(table),
+    m_allocated(false)
+  {
+    m_table.m_values.clear();
+    m_table.m_offsets.assign(nb_rows+1, 0u);
+  }
+
+  /// First pass: reserve room for nb_entries more values in a row
+  void count(const Uint row, const Uint nb_entries=1)
+  {
+    cf3_assert(!m_allocated);
+    cf3_assert(row < m_table.size());
+    m_table.m_offsets[row+1] += nb_entries;
+  }
+
+  /// Allocate the values, after all rows are counted
+  void allocate()
+  {
+    cf3_assert(!m_allocated);
+    std::partial_sum(m_table.m_offsets.begin(), m_table.m_offsets.end(), m_table.m_offsets.begin());
+    m_table.m_values.resize(m_table.m_offsets.back());
+    m_position.assign(m_table.m_offsets.begin(), m_table.m_offsets.end()-1);
+    m_allocated = true;
+  }
+
+  /// Second pass: append a value to a row
+  void add(const Uint row, const T& value)
+  {
+    cf3_assert(m_allocated);
+    cf3_assert(m_position[row] < m_table.m_offsets[row+1]);
+    m_table.m_values[m_position[row]++] = value;
+  }
+
+  /// @return the number of values that was added to a row so far in the second pass
+  Uint nb_added(const Uint row) const
+  {
+    return m_position[row] - m_table.m_offsets[row];
+  }
+
+private:
+
+  /// The table that is built
+  CSRTable<T>& m_table;
+
+  /// Insert position for the next value of every row
+  std::vector<Uint> m_position;
+
+  /// True after the first pass is finished
+  bool m_allocated;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_CSRTable_hpp
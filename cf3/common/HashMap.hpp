@@ -0,0 +1,354 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_HashMap_hpp
+#define cf3_common_HashMap_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "common/Component.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// This component class represents a map with SINGLE key, implemented as an
+/// open-addressing hash table with linear probing. It has the same interface
+/// as common::Map, so it can be used as a drop-in replacement, but lookups
+/// take constant time instead of a binary search.
+///
+/// The pairs are stored contiguously in the order they were inserted, and
+/// can be iterated over like in common::Map (but they are not sorted by key).
+/// The hash table itself stores the keys next to the index of their pair, so that
+/// probing only touches one contiguous array. It is kept at most half full.
+///
+/// Contrary to common::Map, no sort_keys() is needed before find() can be used,
+/// and find() is also allowed in the const version after push_back().
+/// @pre KEY must be hashable with boost::hash and comparable with "=="
+template <typename KEY, typename DATA>
+class HashMap : public Component {
+
+public: // typedefs
+
+  /// @brief Associative Container -- The map's key type, Key.
+  typedef KEY key_type;
+  /// @brief Pair Associative Container -- The type of object associated with the keys.
+  typedef DATA data_type;
+  /// @brief The type of object, pair<const key_type, data_type>, stored in the map.
+  typedef std::pair<key_type, data_type> value_type;
+
+  /// @brief iterator definition for use in stl algorithms
+  typedef typename std::vector<value_type>::iterator         iterator;
+  /// @brief const_iterator definition for use in stl algorithms
+  typedef typename std::vector<value_type>::const_iterator   const_iterator;
+
+public: // functions
+
+  /// Contructor
+  /// @param[in] name of the component
+  HashMap ( const std::string& name ) : Component(name)
+  {
+    regist_typeinfo(this);
+    rehash(min_nb_slots());
+  }
+
+  /// Virtual destructor
+  virtual ~HashMap() {}
+
+  /// Get the class name
+  static std::string type_name () { return "HashMap<"+common::class_name<KEY>()+","+common::class_name<DATA>()+">"; }
+
+  /// @brief Reserve memory
+  /// @param[in] max_size of the map to be set before starting inserting pairs in the map
+  /// @post the memory for the pairs and the hash table will be allocated, so that
+  ///       no rehashing happens until max_size pairs are inserted
+  void reserve (size_t max_size)
+  {
+    m_entries.reserve(max_size);
+    if (2*max_size > m_slots.size())
+      rehash(2*max_size);
+  }
+
+  /// @brief Copy a std::map into the HashMap
+  /// @param[in] map The map to copy
+  void copy_std_map (std::map<key_type,data_type>& map)
+  {
+    clear();
+    reserve(map.size());
+    typename std::map<key_type,data_type>::iterator itr = map.begin();
+    typename std::map<key_type,data_type>::iterator map_end = map.end();
+    for(; itr != map_end; ++itr)
+      push_back(itr->first,itr->second);
+  }
+
+  /// @brief Insert pair without any checks if it is already present
+  ///
+  /// This is the recommended way to add entries to the map, if you are
+  /// sure that no entries will be duplicated. If a key is duplicated anyway,
+  /// find() returns the first inserted pair.
+  /// @param[in] key   new key to be inserted
+  /// @param[in] data  new data to be inserted, corresponding to the given key
+  /// @return the index of the new pair in the iteration order
+  Uint push_back(const key_type& key, const data_type& data)
+  {
+    if (2*(m_entries.size()+1) > m_slots.size())
+      rehash(2*m_slots.size());
+    m_entries.push_back(std::make_pair(key,data));
+    const Uint entry = m_entries.size()-1;
+    Uint slot = home_slot(key);
+    while (m_slots[slot].entry != invalid())
+      slot = next_slot(slot);
+    m_slots[slot].key = key;
+    m_slots[slot].entry = entry;
+    return entry;
+  }
+
+  /// @brief Insert pair the same way a std::map would.
+  /// @param[in] v   std::pair<KEY,DATA> type to insert
+  /// @returns a pair, with its member pair::first set to an
+  ///          iterator pointing to either the newly inserted element or to the element
+  ///          that already had its same value in the map. The pair::second element in
+  ///          the pair is set to true if a new element was inserted or false if an element
+  ///          with the same value existed.
+  std::pair<iterator,bool> insert(const value_type& v)
+  {
+    iterator itr = find(v.first);
+    if (itr != end())
+      return std::make_pair(itr,false);
+    return std::make_pair(begin()+push_back(v.first,v.second),true);
+  }
+
+  /// @brief Find the iterator matching with the given KEY
+  /// @param[in] key  key to be looked-up
+  /// @return the iterator with key and value, the end() iterator is returned
+  ///         if no match is found
+  iterator find(const key_type& key)
+  {
+    const Uint slot = find_slot(key);
+    return slot == invalid() ? end() : begin()+m_slots[slot].entry;
+  }
+
+  /// @brief Find the iterator matching with the given KEY
+  /// @param[in] key  key to be looked-up
+  /// @return the iterator with key and value, the end() iterator is returned
+  ///         if no match is found
+  const_iterator find(const key_type& key) const
+  {
+    const Uint slot = find_slot(key);
+    return slot == invalid() ? end() : begin()+m_slots[slot].entry;
+  }
+
+  /// @brief Erase the given iterator from the map
+  /// @param[in] itr The iterator to delete
+  /// @note The last pair takes the place of the erased pair in the iteration order
+  void erase (iterator itr)
+  {
+    cf3_assert(itr != end());
+    const Uint entry = itr-begin();
+    Uint slot = home_slot(itr->first);
+    while (m_slots[slot].entry != entry)
+      slot = next_slot(slot);
+    erase_slot(slot);
+  }
+
+  /// @brief Erase the entry with given key from the map
+  /// @param[in] key The key to delete
+  /// @returns true if element is erased, false if no element was erased
+  bool erase (const key_type& key)
+  {
+    const Uint slot = find_slot(key);
+    if (slot == invalid())
+      return false;
+    erase_slot(slot);
+    return true;
+  }
+
+  /// @brief Check if the given KEY is existing in the HashMap
+  /// @param[in] key  key to be looked-up
+  /// @return flag to know if key exists
+  bool exists(const key_type& key) const
+  {
+    return find_slot(key) != invalid();
+  }
+
+  /// @brief Clear the content of the map, and release its memory
+  void clear()
+  {
+    std::vector<value_type>().swap(m_entries);
+    std::vector<Slot>().swap(m_slots);
+    rehash(min_nb_slots());
+  }
+
+  /// @brief Get the number of pairs already inserted
+  size_t size() const { return m_entries.size(); }
+
+  /// @brief Get the capacity of the map (memory allocated for the pairs)
+  size_t capacity() const { return m_entries.capacity(); }
+
+  /// @brief Overloading of the operator"[]" for assignment AND insertion
+  /// @param[in] key The key to look for. If the key is not found,
+  ///               it is inserted using push_back().
+  /// @return modifiable data. In case the key did not exist, this will assign the newly created data.
+  data_type& operator[] (const key_type& key)
+  {
+    const Uint slot = find_slot(key);
+    if (slot != invalid())
+      return m_entries[m_slots[slot].entry].second;
+    return m_entries[push_back(key,data_type())].second;
+  }
+
+  /// @brief Overloading of the operator"[]" for lookup only
+  /// @param[in] key The key to look for, which must exist
+  /// @return non-modifiable data for the given key
+  const data_type& operator[] (const key_type& key) const
+  {
+    const Uint slot = find_slot(key);
+    cf3_assert_desc( "The key is not found in the HashMap, and can not be inserted in const version." , slot != invalid() );
+    return m_entries[m_slots[slot].entry].second;
+  }
+
+  /// @brief Does nothing, as the hash table is always ready for lookups.
+  /// Provided so code written for common::Map works unchanged.
+  void sort_keys() {}
+
+  /// @return the iterator pointing at the first element
+  iterator begin() { return m_entries.begin(); }
+
+  /// @return the const_iterator pointing at the first element
+  const_iterator begin() const { return m_entries.begin(); }
+
+  /// @return the end iterator
+  iterator end() { return m_entries.end(); }
+
+  /// @return the end const_iterator
+  const_iterator end() const { return m_entries.end(); }
+
+private: // nested classes
+
+  /// Slot of the hash table, with the key stored next to the index of its pair
+  struct Slot
+  {
+    Slot() : entry(invalid()) {}
+    key_type key;
+    Uint entry;
+  };
+
+private: // helper functions
+
+  static Uint invalid() { return static_cast<Uint>(-1); }
+
+  static Uint min_nb_slots() { return 16u; }
+
+  /// Hash of a key, with a final mixing step so that consecutive
+  /// integer keys (such as global indices) are spread over the table
+  static boost::uint64_t hash(const key_type& key)
+  {
+    boost::uint64_t h = static_cast<boost::uint64_t>(boost::hash<key_type>()(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  Uint home_slot(const key_type& key) const { return static_cast<Uint>(hash(key) & m_mask); }
+
+  Uint next_slot(const Uint slot) const { return (slot+1) & m_mask; }
+
+  /// @return the slot holding the key, or invalid() if the key is not present
+  Uint find_slot(const key_type& key) const
+  {
+    Uint slot = home_slot(key);
+    while (m_slots[slot].entry != invalid())
+    {
+      if (m_slots[slot].key == key)
+        return slot;
+      slot = next_slot(slot);
+    }
+    return invalid();
+  }
+
+  /// Rebuild the hash table with at least nb_slots slots, rounded up to a power of two
+  void rehash(const size_t nb_slots)
+  {
+    size_t size = min_nb_slots();
+    while (size < nb_slots)
+      size *= 2;
+    std::vector<Slot>(size).swap(m_slots);
+    m_mask = size-1;
+    for (Uint entry=0; entry<m_entries.size(); ++entry)
+    {
+      Uint slot = home_slot(m_entries[entry].first);
+      while (m_slots[slot].entry != invalid())
+        slot = next_slot(slot);
+      m_slots[slot].key = m_entries[entry].first;
+      m_slots[slot].entry = entry;
+    }
+  }
+
+  /// Remove a slot and its pair. The following slots of the probe sequence are shifted back
+  /// so that no tombstones are needed, and the last pair is moved into the freed place.
+  void erase_slot(const Uint slot)
+  {
+    const Uint entry = m_slots[slot].entry;
+    Uint hole = slot;
+    Uint next = next_slot(slot);
+    while (m_slots[next].entry != invalid())
+    {
+      const Uint home = home_slot(m_slots[next].key);
+      // The slot can move back to the hole unless its home lies cyclically in ]hole,next]
+      const bool stays = (hole < next) ? (home > hole && home <= next) : (home > hole || home <= next);
+      if (!stays)
+      {
+        m_slots[hole] = m_slots[next];
+        hole = next;
+      }
+      next = next_slot(next);
+    }
+    m_slots[hole] = Slot();
+
+    const Uint last = m_entries.size()-1;
+    if (entry != last)
+    {
+      Uint last_slot = home_slot(m_entries[last].first);
+      while (m_slots[last_slot].entry != last)
+        last_slot = next_slot(last_slot);
+      m_slots[last_slot].entry = entry;
+      m_entries[entry] = m_entries[last];
+    }
+    m_entries.pop_back();
+  }
+
+private: // data
+
+  /// storage of the inserted pairs, in insertion order
+  std::vector<value_type> m_entries;
+
+  /// hash table, with a power of two number of slots
+  std::vector<Slot> m_slots;
+
+  /// number of slots minus one, to wrap slot indices
+  Uint m_mask;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_HashMap_hpp
@@ -0,0 +1,88 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/CF.hpp"
+
+#if defined CF3_OS_LINUX || defined CF3_OS_MACOSX // if we are on a POSIX system...
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <fstream>
+
+#include "common/BasicExceptions.hpp"
+#include "common/MappedFile.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(const std::string& path) :
+  m_path(path),
+  m_begin(0),
+  m_end(0),
+  m_mapping(0),
+  m_mapping_size(0)
+{
+#if defined CF3_OS_LINUX || defined CF3_OS_MACOSX
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw FileSystemError(FromHere(), "Could not open file "+path);
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0)
+  {
+    ::close(fd);
+    throw FileSystemError(FromHere(), "Could not determine the size of file "+path);
+  }
+  if (file_stat.st_size > 0)
+  {
+    m_mapping_size = file_stat.st_size;
+    m_mapping = ::mmap(0, m_mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (m_mapping == MAP_FAILED)
+    {
+      ::close(fd);
+      throw FileSystemError(FromHere(), "Could not map file "+path+" into memory");
+    }
+    ::madvise(m_mapping, m_mapping_size, MADV_SEQUENTIAL);
+    m_begin = static_cast<const char*>(m_mapping);
+    m_end = m_begin + m_mapping_size;
+  }
+  ::close(fd);
+#else
+  std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!file)
+    throw FileSystemError(FromHere(), "Could not open file "+path);
+  file.seekg(0, std::ios_base::end);
+  m_buffer.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0, std::ios_base::beg);
+  if (!m_buffer.empty())
+  {
+    file.read(&m_buffer[0], m_buffer.size());
+    m_begin = &m_buffer[0];
+    m_end = m_begin + m_buffer.size();
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::~MappedFile()
+{
+#if defined CF3_OS_LINUX || defined CF3_OS_MACOSX
+  if (m_mapping)
+    ::munmap(m_mapping, m_mapping_size);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
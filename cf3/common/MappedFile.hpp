@@ -0,0 +1,78 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_MappedFile_hpp
+#define cf3_common_MappedFile_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Read-only view of the contents of a file
+///
+/// On POSIX systems the file is mapped into memory, so that pages are only read
+/// from disk when they are accessed, and never copied into a user buffer.
+/// Elsewhere, the file is read into memory at once.
+class Common_API MappedFile : public boost::noncopyable
+{
+public: // functions
+
+  /// Constructor
+  /// @param [in] path  file to map
+  /// @throw FileSystemError if the file can not be opened or mapped
+  MappedFile(const std::string& path);
+
+  /// Destructor, unmaps the file
+  ~MappedFile();
+
+  /// @return the first character of the file
+  const char* begin() const { return m_begin; }
+
+  /// @return one past the last character of the file
+  const char* end() const { return m_end; }
+
+  /// @return the size of the file in bytes
+  std::size_t size() const { return m_end - m_begin; }
+
+  /// @return the path of the file
+  const std::string& path() const { return m_path; }
+
+private: // data
+
+  std::string m_path;
+
+  const char* m_begin;
+  const char* m_end;
+
+  void* m_mapping;
+  std::size_t m_mapping_size;
+
+  /// Contents of the file, if it is not mapped
+  std::vector<char> m_buffer;
+
+}; // MappedFile
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_MappedFile_hpp
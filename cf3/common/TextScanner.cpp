@@ -0,0 +1,216 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstdlib>
+
+#include <boost/cstdint.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/TextScanner.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Powers of ten that are exactly representable as a double
+const double exact_powers_of_ten[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// Largest exponent in exact_powers_of_ten
+const int max_exact_exponent = 22;
+
+/// Largest number of significant digits that is exactly representable as a double
+const int max_exact_digits = 15;
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string TextScanner::next_token()
+{
+  skip_whitespace();
+  const char* begin = m_pos;
+  while (m_pos != m_end && !is_whitespace(*m_pos))
+    ++m_pos;
+  return std::string(begin, m_pos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint TextScanner::next_uint()
+{
+  skip_whitespace();
+  if (m_pos == m_end || !is_digit(*m_pos))
+    throw_parsing_failed("an unsigned integer");
+
+  Uint value = 0;
+  while (m_pos != m_end && is_digit(*m_pos))
+  {
+    value = 10*value + static_cast<Uint>(*m_pos - '0');
+    ++m_pos;
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int TextScanner::next_int()
+{
+  skip_whitespace();
+  bool negative = false;
+  if (m_pos != m_end && (*m_pos == '-' || *m_pos == '+'))
+  {
+    negative = (*m_pos == '-');
+    ++m_pos;
+  }
+  if (m_pos == m_end || !is_digit(*m_pos))
+    throw_parsing_failed("an integer");
+
+  int value = 0;
+  while (m_pos != m_end && is_digit(*m_pos))
+  {
+    value = 10*value + (*m_pos - '0');
+    ++m_pos;
+  }
+  return negative ? -value : value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real TextScanner::next_real()
+{
+  skip_whitespace();
+
+  // Fast path: collect the significant digits as an integer and a power of ten.
+  // If both are exactly representable, one multiplication or division gives
+  // the correctly rounded result, as strtod would.
+  const char* p = m_pos;
+  bool negative = false;
+  if (p != m_end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  boost::uint64_t mantissa = 0;
+  int nb_significant_digits = 0;
+  int exponent = 0;
+  bool has_digits = false;
+  while (p != m_end && is_digit(*p))
+  {
+    mantissa = 10*mantissa + static_cast<boost::uint64_t>(*p - '0');
+    if (mantissa)
+      ++nb_significant_digits;
+    has_digits = true;
+    ++p;
+  }
+  if (p != m_end && *p == '.')
+  {
+    ++p;
+    while (p != m_end && is_digit(*p))
+    {
+      mantissa = 10*mantissa + static_cast<boost::uint64_t>(*p - '0');
+      if (mantissa)
+        ++nb_significant_digits;
+      --exponent;
+      has_digits = true;
+      ++p;
+    }
+  }
+  if (has_digits && p != m_end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negative_exponent = false;
+    if (p != m_end && (*p == '-' || *p == '+'))
+    {
+      negative_exponent = (*p == '-');
+      ++p;
+    }
+    if (p == m_end || !is_digit(*p))
+      return next_real_strtod();
+    int exponent_value = 0;
+    while (p != m_end && is_digit(*p))
+    {
+      if (exponent_value < 10000)
+        exponent_value = 10*exponent_value + (*p - '0');
+      ++p;
+    }
+    exponent += negative_exponent ? -exponent_value : exponent_value;
+  }
+
+  // Anything unusual (nan, inf, hexadecimal, too many digits) is left to strtod
+  if ( !has_digits
+    || (p != m_end && !is_whitespace(*p))
+    || nb_significant_digits > max_exact_digits
+    || exponent < -max_exact_exponent || exponent > max_exact_exponent )
+    return next_real_strtod();
+
+  double value = static_cast<double>(mantissa);
+  if (exponent < 0)
+    value /= exact_powers_of_ten[-exponent];
+  else
+    value *= exact_powers_of_ten[exponent];
+
+  m_pos = p;
+  return static_cast<Real>(negative ? -value : value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real TextScanner::next_real_strtod()
+{
+  skip_whitespace();
+  const char* begin = m_pos;
+  const char* token_end = m_pos;
+  while (token_end != m_end && !is_whitespace(*token_end))
+    ++token_end;
+
+  // strtod needs a null-terminated string
+  const std::string token(begin, token_end);
+  char* parsed_end;
+  const double value = std::strtod(token.c_str(), &parsed_end);
+  if (token.empty() || parsed_end != token.c_str()+token.size())
+    throw_parsing_failed("a real number");
+
+  m_pos = token_end;
+  return static_cast<Real>(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint TextScanner::count_lines(const char* begin, const char* end)
+{
+  Uint nb_lines = 0;
+  const char* newline;
+  while ( (newline = static_cast<const char*>(std::memchr(begin, '\n', end-begin))) )
+  {
+    ++nb_lines;
+    begin = newline+1;
+  }
+  return nb_lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TextScanner::throw_parsing_failed(const std::string& expected) const
+{
+  const char* token_end = m_pos;
+  while (token_end != m_end && token_end-m_pos < 32 && *token_end != '\n')
+    ++token_end;
+  throw ParsingFailed(FromHere(), "Expected "+expected+" but found \""+std::string(m_pos,token_end)+"\"");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
@@ -0,0 +1,133 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_TextScanner_hpp
+#define cf3_common_TextScanner_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <string>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Scanner of whitespace separated numbers in a character buffer
+///
+/// Numbers are parsed directly from memory, without the locale and stream state
+/// handling of std::istream::operator>>. This makes reading the large numeric
+/// sections of mesh files an order of magnitude faster.
+/// The buffer does not need to be null-terminated, and is not copied.
+class Common_API TextScanner
+{
+public: // functions
+
+  /// Constructor
+  /// @param [in] begin  first character to scan
+  /// @param [in] end    one past the last character to scan
+  TextScanner(const char* begin, const char* end) : m_pos(begin), m_end(end) {}
+
+  /// @return the current position in the buffer
+  const char* position() const { return m_pos; }
+
+  /// @return the end of the buffer
+  const char* end() const { return m_end; }
+
+  /// Skip spaces, tabs and line endings
+  void skip_whitespace()
+  {
+    while (m_pos != m_end && is_whitespace(*m_pos))
+      ++m_pos;
+  }
+
+  /// @return true if nothing but whitespace remains
+  bool at_end()
+  {
+    skip_whitespace();
+    return m_pos == m_end;
+  }
+
+  /// Skip the remainder of the current line, including its line ending
+  void skip_line()
+  {
+    const char* newline = static_cast<const char*>(std::memchr(m_pos, '\n', m_end-m_pos));
+    m_pos = newline ? newline+1 : m_end;
+  }
+
+  /// Skip the next nb_lines lines, counting line endings without parsing
+  void skip_lines(const Uint nb_lines)
+  {
+    for (Uint l=0; l<nb_lines && m_pos!=m_end; ++l)
+      skip_line();
+  }
+
+  /// Skip the next whitespace separated token
+  void skip_token()
+  {
+    skip_whitespace();
+    while (m_pos != m_end && !is_whitespace(*m_pos))
+      ++m_pos;
+  }
+
+  /// @return the next whitespace separated token
+  std::string next_token();
+
+  /// @return the next unsigned integer
+  /// @throw ParsingFailed if the next token does not start with a digit
+  Uint next_uint();
+
+  /// @return the next, possibly signed, integer
+  /// @throw ParsingFailed if the next token is not an integer
+  int next_int();
+
+  /// @return the next real number, in fixed or scientific notation
+  /// @throw ParsingFailed if the next token is not a number
+  Real next_real();
+
+  /// @return the number of line endings between begin and end
+  static Uint count_lines(const char* begin, const char* end);
+
+private: // functions
+
+  static bool is_whitespace(const char c)
+  {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  static bool is_digit(const char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  /// Parse the token starting at the current position with strtod,
+  /// for the numbers the fast path cannot convert exactly
+  Real next_real_strtod();
+
+  /// @throw ParsingFailed mentioning the expected value and the current token
+  void throw_parsing_failed(const std::string& expected) const;
+
+private: // data
+
+  const char* m_pos;
+  const char* m_end;
+
+}; // TextScanner
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_TextScanner_hpp
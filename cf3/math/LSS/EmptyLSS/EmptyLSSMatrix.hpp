@@ -127,6 +127,12 @@ public:
   /// Note that sparsity info is lost, values will contain zeros where no matrix entry is present
   void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values) { cf3_assert(m_is_created); values.resize(m_blockcol_size*m_neq,0.); }
 
+  /// Set a list of rows in one go, diagonal and off-diagonals values separately (dirichlet-type boundaries applied in bulk)
+  void set_rows(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, Real diagval, Real offdiagval) { cf3_assert(m_is_created); cf3_assert(iblockrows.size()==ieqs.size()); }
+
+  /// Replace a list of columns to zero in a single sweep over the matrix (dirichlet-type boundaries applied in bulk, when trying to preserve symmetry)
+  void get_columns_and_replace_to_zero(const std::vector<Uint>& iblockcols, const std::vector<Uint>& ieqs, const std::vector<Real>& colvalues, std::vector<Real>& values) { cf3_assert(m_is_created); values.assign(m_blockcol_size*m_neq,0.); }
+
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from) { cf3_assert(m_is_created); }
 
@@ -111,6 +111,15 @@ public:
   /// @attention by the definitiona of the compresssed sparse row matrices, this operation tends to be very heavy
   virtual void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values) = 0;
 
+  /// Set a list of rows in one go, diagonal and off-diagonals values separately (dirichlet-type boundaries applied in bulk)
+  /// The rows are given by the (iblockrows[i],ieqs[i]) pairs, rows that are not owned are skipped just like in set_row.
+  virtual void set_rows(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, Real diagval, Real offdiagval) = 0;
+
+  /// Replace a list of columns to zero in a single sweep over the matrix (dirichlet-type boundaries applied in bulk, when trying to preserve symmetry)
+  /// The columns are given by the (iblockcols[i],ieqs[i]) pairs, values receives the sum of the removed columns, each scaled by colvalues[i].
+  /// @note values is sized and indexed like in get_column_and_replace_to_zero
+  virtual void get_columns_and_replace_to_zero(const std::vector<Uint>& iblockcols, const std::vector<Uint>& ieqs, const std::vector<Real>& colvalues, std::vector<Real>& values) = 0;
+
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   virtual void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from) = 0;
 
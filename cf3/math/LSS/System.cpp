@@ -126,6 +126,7 @@ void LSS::System::create_blocked(common::PE::CommPattern& cp, const VariablesDes
 
 void LSS::System::swap(const Handle<LSS::Matrix>& matrix, const Handle<LSS::Vector>& solution, const Handle<LSS::Vector>& rhs)
 {
+  apply_dirichlet();
   if (m_mat->is_swappable(*solution,*rhs))
   {
   if ((matrix->is_created()!=solution->is_created())||(matrix->is_created()!=rhs->is_created()))
@@ -149,6 +150,9 @@ void LSS::System::swap(const Handle<LSS::Matrix>& matrix, const Handle<LSS::Vect
 
 void LSS::System::destroy()
 {
+  m_dirichlet_blockrows.clear();
+  m_dirichlet_eqs.clear();
+  m_dirichlet_values.clear();
   m_mat.reset();
   m_sol.reset();
   m_rhs.reset();
@@ -159,6 +163,7 @@ void LSS::System::destroy()
 void LSS::System::solve()
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->solve(*m_sol,*m_rhs);
 }
 
@@ -167,6 +172,7 @@ void LSS::System::solve()
 void LSS::System::set_values(const LSS::BlockAccumulator& values)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->set_values(values);
   m_sol->set_sol_values(values);
   m_rhs->set_rhs_values(values);
@@ -177,6 +183,7 @@ void LSS::System::set_values(const LSS::BlockAccumulator& values)
 void LSS::System::add_values(const LSS::BlockAccumulator& values)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->add_values(values);
   m_sol->add_sol_values(values);
   m_rhs->add_rhs_values(values);
@@ -187,6 +194,7 @@ void LSS::System::add_values(const LSS::BlockAccumulator& values)
 void LSS::System::get_values(LSS::BlockAccumulator& values)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->get_values(values);
   m_sol->get_sol_values(values);
   m_rhs->get_rhs_values(values);
@@ -197,6 +205,7 @@ void LSS::System::get_values(LSS::BlockAccumulator& values)
 void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real value, const bool preserve_symmetry)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   if (preserve_symmetry)
   {
     std::vector<Real> v;
@@ -211,9 +220,60 @@ void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real val
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void LSS::System::dirichlet(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, const std::vector<Real>& values, const bool preserve_symmetry)
+{
+  cf3_assert(is_created());
+  cf3_assert(iblockrows.size()==ieqs.size());
+  cf3_assert(iblockrows.size()==values.size());
+  apply_dirichlet();
+  if (preserve_symmetry)
+  {
+    std::vector<Real> v;
+    m_mat->get_columns_and_replace_to_zero(iblockrows,ieqs,values,v);
+    for (int i=0; i<(const int)v.size(); i++)
+      if (v[i]!=0.)
+        m_rhs->add_value(i,-v[i]);
+  }
+  m_mat->set_rows(iblockrows,ieqs,1.,0.);
+  for (int i=0; i<(const int)iblockrows.size(); i++)
+  {
+    m_sol->set_value(iblockrows[i],ieqs[i],values[i]);
+    m_rhs->set_value(iblockrows[i],ieqs[i],values[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::queue_dirichlet(const Uint iblockrow, const Uint ieq, const Real value)
+{
+  cf3_assert(is_created());
+  m_dirichlet_blockrows.push_back(iblockrow);
+  m_dirichlet_eqs.push_back(ieq);
+  m_dirichlet_values.push_back(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::apply_dirichlet()
+{
+  if (m_dirichlet_blockrows.empty())
+    return;
+
+  // move the queue out first, dirichlet itself flushes the queue
+  std::vector<Uint> blockrows, eqs;
+  std::vector<Real> values;
+  blockrows.swap(m_dirichlet_blockrows);
+  eqs.swap(m_dirichlet_eqs);
+  values.swap(m_dirichlet_values);
+  dirichlet(blockrows,eqs,values,false);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void LSS::System::periodicity (const Uint iblockrow_to, const Uint iblockrow_from)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   LSS::BlockAccumulator ba;
   const int neq=m_mat->neq();
   ba.resize(2,neq);
@@ -241,6 +301,7 @@ void LSS::System::periodicity (const Uint iblockrow_to, const Uint iblockrow_fro
 void LSS::System::set_diagonal(const std::vector<Real>& diag)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->set_diagonal(diag);
 }
 
@@ -249,6 +310,7 @@ void LSS::System::set_diagonal(const std::vector<Real>& diag)
 void LSS::System::add_diagonal(const std::vector<Real>& diag)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->add_diagonal(diag);
 }
 
@@ -257,6 +319,7 @@ void LSS::System::add_diagonal(const std::vector<Real>& diag)
 void LSS::System::get_diagonal(std::vector<Real>& diag)
 {
   cf3_assert(is_created());
+  apply_dirichlet();
   m_mat->get_diagonal(diag);
 }
 
@@ -265,6 +328,9 @@ void LSS::System::get_diagonal(std::vector<Real>& diag)
 void LSS::System::reset(Real reset_to)
 {
   cf3_assert(is_created());
+  m_dirichlet_blockrows.clear();
+  m_dirichlet_eqs.clear();
+  m_dirichlet_values.clear();
   m_mat->reset(reset_to);
   m_sol->reset(reset_to);
   m_rhs->reset(reset_to);
@@ -276,6 +342,7 @@ void LSS::System::print(common::LogStream& stream)
 {
   if (is_created())
   {
+    apply_dirichlet();
     m_mat->print(stream);
     m_sol->print(stream);
     m_rhs->print(stream);
@@ -288,6 +355,7 @@ void LSS::System::print(std::ostream& stream)
 {
   if (is_created())
   {
+    apply_dirichlet();
     m_mat->print(stream);
     m_sol->print(stream);
     m_rhs->print(stream);
@@ -300,6 +368,7 @@ void LSS::System::print(const std::string& filename)
 {
   if (is_created())
   {
+    apply_dirichlet();
     m_mat->print(filename,std::ios_base::out);
     m_sol->print(filename,std::ios_base::app);
     m_rhs->print(filename,std::ios_base::app);
@@ -109,6 +109,17 @@ public:
   /// When preserve_symmetry is true than blockrow*numequations+eq column is is zeroed by moving it to the right hand side (however this usually results in performance penalties).
   void dirichlet(const Uint iblockrow, const Uint ieq, const Real value, const bool preserve_symmetry=false);
 
+  /// Apply a list of dirichlet-type boundary conditions at once, given as (iblockrows[i],ieqs[i],values[i]) triples.
+  /// The matrix is processed in a single sweep instead of one sweep per condition, which is much cheaper when preserve_symmetry is true.
+  void dirichlet(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, const std::vector<Real>& values, const bool preserve_symmetry=false);
+
+  /// Store a dirichlet-type boundary condition, to be applied later in bulk by apply_dirichlet.
+  /// Pending conditions are also applied before the matrix, solution or rhs is accessed or the system is solved.
+  void queue_dirichlet(const Uint iblockrow, const Uint ieq, const Real value);
+
+  /// Apply all dirichlet conditions stored with queue_dirichlet, without preserving symmetry
+  void apply_dirichlet();
+
   /// Applying periodicity by adding one line to another and dirichlet-style fixing it to
   /// Note that prerequisite for this is to work that the matrix sparsity should be compatible (same nonzero pattern for the two block rows).
   /// Note that only structural symmetry can be preserved (again, if sparsity input was symmetric).
@@ -141,13 +152,13 @@ public:
   void print(const std::string& filename);
 
   /// Accessor to matrix
-  Handle<LSS::Matrix> matrix() { return m_mat; };
+  Handle<LSS::Matrix> matrix() { apply_dirichlet(); return m_mat; };
 
   /// Accessor to right hand side
-  Handle<LSS::Vector> rhs() { return m_rhs; };
+  Handle<LSS::Vector> rhs() { apply_dirichlet(); return m_rhs; };
 
   /// Accessor to solution
-  Handle<LSS::Vector> solution() { return m_sol; };
+  Handle<LSS::Vector> solution() { apply_dirichlet(); return m_sol; };
 
   /// Accessor to the state of create
   const bool is_created();
@@ -178,6 +189,11 @@ private:
   /// shared_ptr to right hand side vector
   Handle<LSS::Vector> m_rhs;
 
+  /// dirichlet conditions waiting to be applied in bulk, as block rows, equations and values
+  std::vector<Uint> m_dirichlet_blockrows;
+  std::vector<Uint> m_dirichlet_eqs;
+  std::vector<Real> m_dirichlet_values;
+
 }; // end of class System
 
 ////////////////////////////////////////////////////////////////////////////////////////////
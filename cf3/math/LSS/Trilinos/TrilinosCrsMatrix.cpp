@@ -394,7 +394,99 @@ void TrilinosCrsMatrix::set_row(const Uint iblockrow, const Uint ieq, Real diagv
 
 void TrilinosCrsMatrix::get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values)
 {
-  throw common::NotImplemented(FromHere(), "get_column_and_replace_to_zero is not implemented for TrilinosCrsMatrix");
+  get_columns_and_replace_to_zero(std::vector<Uint>(1,iblockcol), std::vector<Uint>(1,ieq), std::vector<Real>(1,1.), values);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::set_rows(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, Real diagval, Real offdiagval)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(iblockrows.size()==ieqs.size());
+  const int nb_rows = iblockrows.size();
+  int nb_errors = 0;
+
+  // rows are independent, and exceptions may not leave the parallel region, so errors are only counted
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for reduction(+:nb_errors)
+#endif
+  for(int r = 0; r < nb_rows; ++r)
+  {
+    const int row = m_p2m[iblockrows[r]*m_neq+ieqs[r]];
+    if(row >= m_num_my_elements)
+      continue;
+
+    int num_entries;
+    Real* extracted_values;
+    int* extracted_indices;
+    if(m_mat->ExtractMyRowView(row, num_entries, extracted_values, extracted_indices) != 0)
+    {
+      ++nb_errors;
+      continue;
+    }
+    for(int i = 0; i != num_entries; ++i)
+      extracted_values[i] = extracted_indices[i] == row ? diagval : offdiagval;
+  }
+
+  if(nb_errors != 0)
+    throw common::FailedAssertion(FromHere(),"Call to 'ExtractMyRowView' in Trilinos dependency returned a non-zero error code for " + boost::lexical_cast<std::string>(nb_errors) + " rows.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::get_columns_and_replace_to_zero(const std::vector<Uint>& iblockcols, const std::vector<Uint>& ieqs, const std::vector<Real>& colvalues, std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(iblockcols.size()==ieqs.size());
+  cf3_assert(iblockcols.size()==colvalues.size());
+  const int nb_cols = m_p2m.size();
+
+  // flag the removed columns in matrix numbering, together with their scaling
+  std::vector<char> col_mask(nb_cols,0);
+  std::vector<Real> col_scale(nb_cols,0.);
+  for(Uint c = 0; c != iblockcols.size(); ++c)
+  {
+    const int col = m_p2m[iblockcols[c]*m_neq+ieqs[c]];
+    col_mask[col] = 1;
+    col_scale[col] = colvalues[c];
+  }
+
+  // inverse of m_p2m, so the result can be written in process local numbering
+  std::vector<int> m2p(nb_cols);
+  for(int i = 0; i != nb_cols; ++i)
+    m2p[m_p2m[i]] = i;
+
+  values.assign(nb_cols,0.);
+  int nb_errors = 0;
+
+  // single sweep over the owned rows, each row writes to its own entry of values
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for reduction(+:nb_errors)
+#endif
+  for(int row = 0; row < m_num_my_elements; ++row)
+  {
+    int num_entries;
+    Real* extracted_values;
+    int* extracted_indices;
+    if(m_mat->ExtractMyRowView(row, num_entries, extracted_values, extracted_indices) != 0)
+    {
+      ++nb_errors;
+      continue;
+    }
+    Real removed = 0.;
+    for(int i = 0; i != num_entries; ++i)
+    {
+      if(col_mask[extracted_indices[i]])
+      {
+        removed += extracted_values[i]*col_scale[extracted_indices[i]];
+        extracted_values[i] = 0.;
+      }
+    }
+    values[m2p[row]] = removed;
+  }
+
+  if(nb_errors != 0)
+    throw common::FailedAssertion(FromHere(),"Call to 'ExtractMyRowView' in Trilinos dependency returned a non-zero error code for " + boost::lexical_cast<std::string>(nb_errors) + " rows.");
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
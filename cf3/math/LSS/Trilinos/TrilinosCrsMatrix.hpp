@@ -106,6 +106,14 @@ public:
   /// Note that sparsity info is lost, values will contain zeros where no matrix entry is present
   void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values);
 
+  /// Set a list of rows in one go, diagonal and off-diagonals values separately (dirichlet-type boundaries applied in bulk)
+  /// The rows are processed in parallel when OpenMP is available
+  void set_rows(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, Real diagval, Real offdiagval);
+
+  /// Replace a list of columns to zero in a single sweep over the matrix (dirichlet-type boundaries applied in bulk, when trying to preserve symmetry)
+  /// The sweep over the rows is done in parallel when OpenMP is available
+  void get_columns_and_replace_to_zero(const std::vector<Uint>& iblockcols, const std::vector<Uint>& ieqs, const std::vector<Real>& colvalues, std::vector<Real>& values);
+
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from);
 
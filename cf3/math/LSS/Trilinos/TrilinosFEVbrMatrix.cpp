@@ -567,6 +567,118 @@ void TrilinosFEVbrMatrix::get_column_and_replace_to_zero(const Uint iblockcol, U
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void TrilinosFEVbrMatrix::set_rows(const std::vector<Uint>& iblockrows, const std::vector<Uint>& ieqs, Real diagval, Real offdiagval)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(iblockrows.size()==ieqs.size());
+  const int nb_rows = iblockrows.size();
+  const int blockrow_size = m_blockrow_size;
+  const int neq = m_neq;
+  int nb_errors = 0;
+
+  // rows are independent (two equations of the same blockrow touch different rows of the blocks),
+  // and exceptions may not leave the parallel region, so errors are only counted
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for reduction(+:nb_errors)
+#endif
+  for(int r = 0; r < nb_rows; ++r)
+  {
+    const int br=m_p2m[iblockrows[r]];
+    if (br>=blockrow_size)
+      continue;
+
+    Epetra_SerialDenseMatrix **val;
+    int* colindices;
+    int blockrowsize;
+    int dummy_neq;
+    if (m_mat->ExtractMyBlockRowView(br,dummy_neq,blockrowsize,colindices,val)!=0)
+    {
+      ++nb_errors;
+      continue;
+    }
+    const int ieq=ieqs[r];
+    for (int i=0; i<blockrowsize; i++)
+    {
+      Epetra_SerialDenseMatrix& block=val[i][0];
+      for (int j=0; j<neq; j++)
+        block(ieq,j)=offdiagval;
+      if (colindices[i]==br)
+        block(ieq,ieq)=diagval;
+    }
+  }
+
+  if (nb_errors!=0)
+    throw common::FailedAssertion(FromHere(),"Call to 'ExtractMyBlockRowView' in Trilinos dependency returned a non-zero error code for " + boost::lexical_cast<std::string>(nb_errors) + " block rows.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosFEVbrMatrix::get_columns_and_replace_to_zero(const std::vector<Uint>& iblockcols, const std::vector<Uint>& ieqs, const std::vector<Real>& colvalues, std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(iblockcols.size()==ieqs.size());
+  cf3_assert(iblockcols.size()==colvalues.size());
+  const int blockcol_size = m_blockcol_size;
+  const int blockrow_size = m_blockrow_size;
+  const int neq = m_neq;
+
+  // flag the removed columns in matrix numbering, together with their scaling
+  std::vector<char> col_mask(blockcol_size*neq,0);
+  std::vector<Real> col_scale(blockcol_size*neq,0.);
+  for (Uint c=0; c<iblockcols.size(); c++)
+  {
+    const int col=m_p2m[iblockcols[c]]*neq+ieqs[c];
+    col_mask[col]=1;
+    col_scale[col]=colvalues[c];
+  }
+
+  // inverse of m_p2m, so the result can be written in process local numbering
+  std::vector<int> m2p(blockcol_size);
+  for (int k=0; k<blockcol_size; k++)
+    m2p[m_p2m[k]]=k;
+
+  values.assign(blockcol_size*neq,0.);
+  int nb_errors = 0;
+
+  // single sweep over the owned block rows, each block row writes to its own chunk of values
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for reduction(+:nb_errors)
+#endif
+  for (int br=0; br<blockrow_size; br++)
+  {
+    Epetra_SerialDenseMatrix **val;
+    int* colindices;
+    int blockrowsize;
+    int dummy_neq;
+    if (m_mat->ExtractMyBlockRowView(br,dummy_neq,blockrowsize,colindices,val)!=0)
+    {
+      ++nb_errors;
+      continue;
+    }
+    Real* removed=&values[m2p[br]*neq];
+    for (int i=0; i<blockrowsize; i++)
+    {
+      const int col_begin=colindices[i]*neq;
+      Epetra_SerialDenseMatrix& block=val[i][0];
+      for (int e=0; e<neq; e++)
+        if (col_mask[col_begin+e])
+        {
+          const Real scale=col_scale[col_begin+e];
+          for (int j=0; j<neq; j++)
+          {
+            removed[j]+=block(j,e)*scale;
+            block(j,e)=0.;
+          }
+        }
+    }
+  }
+
+  if (nb_errors!=0)
+    throw common::FailedAssertion(FromHere(),"Call to 'ExtractMyBlockRowView' in Trilinos dependency returned a non-zero error code for " + boost::lexical_cast<std::string>(nb_errors) + " block rows.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void TrilinosFEVbrMatrix::tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from)
 {
   cf3_assert(m_is_created);
@@ -7,12 +7,16 @@
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include "common/Signal.hpp"
+#include "common/EventHandler.hpp"
 #include "common/XML/SignalOptions.hpp"
 
 #include "mesh/AInterpolator.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/Tags.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -29,6 +33,26 @@ AInterpolator::AInterpolator(const std::string &name) : Component(name)
       .pretty_name( "Interpolate" )
       .connect   ( boost::bind ( &AInterpolator::signal_interpolate,    this, _1 ) )
       .signature ( boost::bind ( &AInterpolator::signature_interpolate, this, _1 ) );
+
+  Core::instance().event_handler().connect_to_event(Tags::event_mesh_loaded(), this, &AInterpolator::on_mesh_modified_event);
+  Core::instance().event_handler().connect_to_event(Tags::event_mesh_changed(), this, &AInterpolator::on_mesh_modified_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void AInterpolator::on_mesh_modified_event(SignalArgs& args)
+{
+  SignalOptions options(args);
+  mesh_modified(options.value<URI>("mesh_uri"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool AInterpolator::is_part_of_mesh(const URI& component_uri, const URI& mesh_uri)
+{
+  const std::string component_path = component_uri.path();
+  const std::string mesh_path = mesh_uri.path();
+  return component_path == mesh_path || boost::algorithm::starts_with(component_path, mesh_path+"/");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
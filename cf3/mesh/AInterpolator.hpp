@@ -89,6 +89,21 @@ public: // functions
   void signature_interpolate ( common::SignalArgs& node);
   //@}
 
+protected: // functions
+
+  /// @brief Called when a mesh was loaded or changed
+  ///
+  /// Implementations that store interpolation data must discard it here if it depends on the mesh.
+  /// @param [in]  mesh_uri  URI of the mesh that was modified
+  virtual void mesh_modified(const common::URI& mesh_uri) {}
+
+  /// @return if the component at component_uri is the mesh at mesh_uri, or one of its children
+  static bool is_part_of_mesh(const common::URI& component_uri, const common::URI& mesh_uri);
+
+private: // functions
+
+  void on_mesh_modified_event( common::SignalArgs& args );
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -287,6 +287,27 @@ struct BlockArrays::Implementation
     }
   }
 
+  /// Direction in which a single block has the most subdivisions
+  Uint most_refined_direction() const
+  {
+    const Uint dimensions = points->row_size();
+    const Table<Uint>& block_subdivs = *block_subdivisions;
+    Uint direction = XX;
+    Uint max_segments = 0;
+    for(Uint block_idx = 0; block_idx != block_subdivs.size(); ++block_idx)
+    {
+      for(Uint i = 0; i != dimensions; ++i)
+      {
+        if(block_subdivs[block_idx][i] > max_segments)
+        {
+          max_segments = block_subdivs[block_idx][i];
+          direction = i;
+        }
+      }
+    }
+    return direction;
+  }
+
   void trigger_block_regions()
   {
     const Uint nb_blocks = blocks->size();
@@ -1589,10 +1610,16 @@ void BlockArrays::create_mesh(Mesh& mesh)
 
   common::Timer timer;
 
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  // Blocks that were not partitioned explicitly are split among the processes along their most refined direction,
+  // so each rank only creates its own part of the mesh
+  if(nb_procs > 1 && m_implementation->block_distribution.size() <= 2)
+    partition_blocks(nb_procs, m_implementation->most_refined_direction());
+
   // Make sure the block connectivity mesh is up-to-date
   create_block_mesh();
 
-  const Uint nb_procs = PE::Comm::instance().size();
   const Uint rank = PE::Comm::instance().rank();
   const Uint dimensions = points.row_size();
 
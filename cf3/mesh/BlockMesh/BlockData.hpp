@@ -78,7 +78,8 @@ public:
   /// @param gradings Uniform grading definition in the spanwise direction for each block
   void extrude_blocks(const std::vector<Real>& positions, const std::vector<Uint>& nb_segments, const std::vector<Real>& gradings);
 
-  /// Create the refined mesh
+  /// Create the refined mesh. Each rank only generates the blocks of its own partition.
+  /// If the blocks were not partitioned in a parallel run, they are partitioned along the direction with the most subdivisions.
   /// @param mesh The mesh in which the output will be stored
   void create_mesh(Mesh& mesh);
 
@@ -17,6 +17,8 @@
 #include "common/FindComponents.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
 
 #include "math/VariablesDescriptor.hpp"
 
@@ -28,6 +30,8 @@
 #include "mesh/MeshElements.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/MeshTransformer.hpp"
+#include "mesh/MergedParallelDistribution.hpp"
+#include "mesh/ParallelDistribution.hpp"
 
 #include "mesh/CGNS/Reader.hpp"
 
@@ -45,12 +49,32 @@ common::ComponentBuilder< Reader, MeshReader, LibCGNS > aCGNSReader_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/// Range [begin,end) of the objects of a distribution that are owned by this rank
+void owned_range(const ParallelDistribution& hash, const Uint nb_obj, Uint& begin, Uint& end)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  begin = hash.start_idx_in_proc(rank);
+  end = (rank == PE::Comm::instance().size()-1) ? nb_obj : hash.start_idx_in_proc(rank+1);
+}
+
+} // anonymous namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
 Reader::Reader(const std::string& name)
-: MeshReader(name), Shared()
+: MeshReader(name), Shared(),
+  m_nodes_begin(0),
+  m_nodes_end(0),
+  m_elems_begin(0),
+  m_elems_end(0)
 {
   options().add( "SectionsAreBCs", false )
       .description("Treat Sections of lower dimensionality as BC. "
                         "This means no BCs from cgns will be read");
+
+  m_hash = create_static_component<MergedParallelDistribution>("hash");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -85,6 +109,15 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // close the CGNS file
   CALL_CGNS(cg_close(m_file.idx));
 
+  // Elements read on this rank are owned by this rank
+  const Uint my_rank = PE::Comm::instance().rank();
+  boost_foreach(Elements& elements, find_components_recursively<Elements>(m_mesh->topology()))
+  {
+    elements.rank().resize(elements.size());
+    for (Uint e=0; e<elements.size(); ++e)
+      elements.rank()[e] = my_rank;
+  }
+
   // Fix global numbering
   /// @todo remove this and read glb_index ourself
   build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalNumbering","glb_numbering")->transform(m_mesh);
@@ -123,6 +156,9 @@ void Reader::read_base(Mesh& parent_region)
 
 void Reader::read_zone(Mesh& mesh)
 {
+  m_ghost_nodes.clear();
+  m_ghost_node_idx.clear();
+
   // get zone type (Structured or Unstructured)
   CALL_CGNS(cg_zone_type(m_file.idx,m_base.idx,m_zone.idx,&m_zone.type));
 
@@ -130,6 +166,10 @@ void Reader::read_zone(Mesh& mesh)
   if (m_zone.type != Structured && m_zone.type != Unstructured)
     throw NotImplemented (FromHere(),"Only Unstructured and Structured zone types are supported");
 
+  // Structured zones are read entirely on every rank, so their elements can't be owned by the reading rank
+  if (m_zone.type == Structured && PE::Comm::instance().size() > 1)
+    throw NotSupported (FromHere(),"CGNS: Structured zones can only be read in serial");
+
   // Read zone size and name
   if (m_zone.type == Unstructured)
   {
@@ -162,7 +202,14 @@ void Reader::read_zone(Mesh& mesh)
     // Add up all the nb elements from all sections
     m_zone.total_nbElements = get_total_nbElements();
 
-
+    // Distribute the nodes and elements of this zone over the ranks
+    std::vector<Uint> nb_obj(2);
+    nb_obj[NODES] = m_zone.total_nbVertices;
+    nb_obj[ELEMS] = m_zone.total_nbElements;
+    m_hash->options().set("nb_parts",PE::Comm::instance().size());
+    m_hash->options().set("nb_obj",nb_obj);
+    owned_range(m_hash->subhash(NODES), m_zone.total_nbVertices, m_nodes_begin, m_nodes_end);
+    owned_range(m_hash->subhash(ELEMS), m_zone.total_nbElements, m_elems_begin, m_elems_end);
     // Create a region for this zone if there is more than one
     //Region& this_region = m_zone.unique? parent_region : parent_region.create_region(m_zone.name);
     //this_region.add_tag("grid_zone");
@@ -177,10 +224,14 @@ void Reader::read_zone(Mesh& mesh)
       read_coordinates_unstructured(this_region);
 
     // read sections (or subregions) in this zone
-    m_global_to_region.reserve(m_zone.total_nbElements);
+    m_global_to_region.clear();
+    m_section_ranges.clear();
     for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
       read_section(this_region);
 
+    // create the owned and ghost nodes used by the sections
+    create_nodes_unstructured();
+
 //    // Only read boco's if sections are not defined as BC's
 //    if (!option("SectionsAreBCs")->value<bool>())
 //    {
@@ -197,9 +248,8 @@ void Reader::read_zone(Mesh& mesh)
 
     // Cleanup:
 
-    // truely deallocate the global_to_region vector
-    m_global_to_region.resize(0);
-    std::vector<Region_TableIndex_pair>().swap (m_global_to_region);
+    m_global_to_region.clear();
+    m_section_ranges.clear();
 
 
 
@@ -274,55 +324,123 @@ void Reader::read_coordinates_unstructured(Region& parent_region)
   m_zone.nodes = &nodes;
   m_zone.nodes_start_idx = nodes.size();
 
-  // read coordinates
-  int one = 1;
-  Real *xCoord;
-  Real *yCoord;
-  Real *zCoord;
-  switch (m_zone.coord_dim)
+  // read the coordinates of the owned range of nodes only
+  const Uint nb_owned = m_nodes_end - m_nodes_begin;
+  int range_min = m_nodes_begin+1; // +1 because cgns has index-base 1 instead of 0
+  int range_max = m_nodes_end;
+  const char* coord_names[3] = { "CoordinateX", "CoordinateY", "CoordinateZ" };
+
+  std::vector<Real> coord(nb_owned);
+  m_owned_coordinates.resize(nb_owned*m_zone.coord_dim);
+  for (int d=0; d<m_zone.coord_dim; ++d)
   {
-    case 3:
-      zCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateZ", RealDouble, &one, &m_zone.total_nbVertices, zCoord));
-    case 2:
-      yCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateY", RealDouble, &one, &m_zone.total_nbVertices, yCoord));
-    case 1:
-      xCoord = new Real[m_zone.total_nbVertices];
-      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, "CoordinateX", RealDouble, &one, &m_zone.total_nbVertices, xCoord));
+    if (nb_owned)
+      CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, coord_names[d], RealDouble, &range_min, &range_max, &coord[0]));
+    for (Uint i=0; i<nb_owned; ++i)
+      m_owned_coordinates[i*m_zone.coord_dim+d] = coord[i];
   }
+}
 
-  m_mesh->initialize_nodes(m_zone.total_nbVertices, (Uint)m_zone.coord_dim);
+//////////////////////////////////////////////////////////////////////////////
 
+void Reader::create_nodes_unstructured()
+{
+  const Uint dim = m_zone.coord_dim;
+  const Uint nb_owned = m_nodes_end - m_nodes_begin;
+
+  std::vector<Real> ghost_coordinates;
+  fetch_ghost_values(m_owned_coordinates, dim, ghost_coordinates);
+
+  m_mesh->initialize_nodes(m_zone.nodes_start_idx + nb_owned + m_ghost_nodes.size(), dim);
+
+  Dictionary& nodes = *m_zone.nodes;
   common::Table<Real>& coords = nodes.coordinates();
   common::List<Uint>& rank = nodes.rank();
-  //  common::Table<Real>::Buffer buffer = nodes.coordinates().create_buffer();
-  //buffer.increase_array_size(m_zone.total_nbVertices);
-  //std::vector<Real> row(m_zone.coord_dim);
-  for (int i=0; i<m_zone.total_nbVertices; ++i)
+  common::List<Uint>& glb_idx = nodes.glb_idx();
+
+  // Owned nodes first, then the ghost nodes, as numbered by local_node_idx()
+  const Uint my_rank = PE::Comm::instance().rank();
+  Uint n = m_zone.nodes_start_idx;
+  for (Uint i=0; i<nb_owned; ++i, ++n)
   {
-    switch (m_zone.coord_dim)
-    {
-      case 3:
-        coords[i][2] = zCoord[i];
-       case 2:
-        coords[i][1] = yCoord[i];
-       case 1:
-        coords[i][0] = xCoord[i];
-     }
-    rank[i] = 0;
+    for (Uint d=0; d<dim; ++d)
+      coords[n][d] = m_owned_coordinates[i*dim+d];
+    rank[n] = my_rank;
+    glb_idx[n] = m_nodes_begin+i;
+  }
+  for (Uint g=0; g<m_ghost_nodes.size(); ++g, ++n)
+  {
+    for (Uint d=0; d<dim; ++d)
+      coords[n][d] = ghost_coordinates[g*dim+d];
+    rank[n] = m_hash->subhash(NODES).proc_of_obj(m_ghost_nodes[g]);
+    glb_idx[n] = m_ghost_nodes[g];
   }
 
-  switch (m_zone.coord_dim)
+  std::vector<Real>().swap(m_owned_coordinates);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint Reader::local_node_idx(const Uint zone_node)
+{
+  if (zone_node >= m_nodes_begin && zone_node < m_nodes_end)
+    return m_zone.nodes_start_idx + zone_node - m_nodes_begin;
+
+  std::map<Uint,Uint>::iterator ghost = m_ghost_node_idx.find(zone_node);
+  if (ghost == m_ghost_node_idx.end())
   {
-    case 3:
-      delete_ptr_array(zCoord);
-    case 2:
-      delete_ptr_array(yCoord);
-    case 1:
-      delete_ptr_array(xCoord);
+    ghost = m_ghost_node_idx.insert(std::make_pair(zone_node, static_cast<Uint>(m_ghost_nodes.size()))).first;
+    m_ghost_nodes.push_back(zone_node);
+  }
+  return m_zone.nodes_start_idx + (m_nodes_end - m_nodes_begin) + ghost->second;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::fetch_ghost_values(const std::vector<Real>& owned_values, const Uint stride, std::vector<Real>& ghost_values)
+{
+  ghost_values.resize(m_ghost_nodes.size()*stride);
+
+  PE::Comm& comm = PE::Comm::instance();
+  if ( !comm.is_active() )
+    return;
+
+  const Uint nb_procs = comm.size();
+  const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+
+  // Ask the owner of every ghost node for its values
+  std::vector< std::vector<Uint> > requested(nb_procs);
+  std::vector< std::vector<Uint> > ghost_positions(nb_procs);
+  for (Uint g=0; g<m_ghost_nodes.size(); ++g)
+  {
+    const Uint proc = node_hash.proc_of_obj(m_ghost_nodes[g]);
+    requested[proc].push_back(m_ghost_nodes[g]);
+    ghost_positions[proc].push_back(g);
+  }
+  std::vector< std::vector<Uint> > received(nb_procs);
+  comm.all_to_all(requested, received);
+
+  // Answer the requests of the other ranks
+  std::vector< std::vector<Real> > send_values(nb_procs);
+  std::vector< std::vector<Real> > recv_values(nb_procs);
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    send_values[proc].reserve(received[proc].size()*stride);
+    boost_foreach(const Uint zone_node, received[proc])
+    {
+      cf3_assert(zone_node >= m_nodes_begin && zone_node < m_nodes_end);
+      const Uint i = zone_node - m_nodes_begin;
+      send_values[proc].insert(send_values[proc].end(), owned_values.begin()+i*stride, owned_values.begin()+(i+1)*stride);
+    }
   }
+  comm.all_to_all(send_values, recv_values);
 
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    cf3_assert(recv_values[proc].size() == ghost_positions[proc].size()*stride);
+    for (Uint i=0; i<ghost_positions[proc].size(); ++i)
+      std::copy(recv_values[proc].begin()+i*stride, recv_values[proc].begin()+(i+1)*stride, ghost_values.begin()+ghost_positions[proc][i]*stride);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -417,7 +535,18 @@ void Reader::read_section(Region& parent_region)
   Region& this_region = parent_region.create_region(m_section.name);
 
   Dictionary& all_nodes = *m_zone.nodes;
-  Uint start_idx = m_zone.nodes_start_idx;
+
+  // Remember which elements this section spans, to recognize boundaries that span the entire section
+  SectionRange section_range;
+  section_range.region = this_region.handle<Region>();
+  section_range.eBegin = m_section.eBegin;
+  section_range.eEnd = m_section.eEnd;
+  m_section_ranges.push_back(section_range);
+
+  // Range of the elements of this section that are owned by this rank (index-base 1, as in cgns)
+  const int owned_begin = std::max(m_section.eBegin, static_cast<int>(m_elems_begin)+1);
+  const int owned_end = std::min(m_section.eEnd, static_cast<int>(m_elems_end));
+  const int nb_owned = std::max(0, owned_end-owned_begin+1);
 
   if (m_section.type == MIXED) // Different element types, Can also be faces
   {
@@ -429,49 +558,45 @@ void Reader::read_section(Region& parent_region)
     elements.insert(faces.begin(),faces.end());
     std::map<std::string, boost::shared_ptr< ArrayBufferT<Uint> > > buffer = create_connectivity_buffermap(elements);
 
-    // Handle each element of this section separately to see in which Elements component it will be written
-    for (int elem=m_section.eBegin;elem<=m_section.eEnd;++elem)
+    if (nb_owned)
     {
-      // Read the amount of nodes this 1 element contains
-      CALL_CGNS(cg_ElementPartialSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,elem,elem,&m_section.elemNodeCount));
-      m_section.elemNodeCount--; // subtract 1 as there is one index too many storing the element type
-
-      // Storage for element type (index 0) and element nodes (index 1->elemNodeCount)
-      int elemNodes[1][1+m_section.elemNodeCount];
-
-      // Read nodes of 1 element
-      CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,elem,elem,*elemNodes,&m_section.parentData));
-
-      // Store the cgns element type
-      ElementType_t etype_cgns = static_cast<ElementType_t>(elemNodes[0][0]);
-
-      // Put the element nodes in a vector
-      std::vector<Uint> row(m_section.elemNodeCount);
-      for (int n=1;n<=m_section.elemNodeCount;++n)  // n=0 is the cell type
-        row[n-1]=start_idx+(elemNodes[0][n]-1); // -1 because cgns has index-base 1 instead of 0
-
-      // Convert the cgns element type to the CF element type
-      const std::string& etype_CF = m_elemtype_CGNS_to_CF[etype_cgns]+to_str(m_zone.coord_dim)+"D";
-      // Add the nodes to the correct Elements component using its buffer
-      cf3_assert(buffer[etype_CF]);
-      Uint table_idx = buffer[etype_CF]->add_row(row);
-
-      // Store the global element number to a pair of (region , local element number)
-      m_global_to_region.push_back(Region_TableIndex_pair(find_component_ptr_with_name<Elements>(this_region, etype_CF),table_idx));
-      cf3_assert( m_global_to_region.back().first );
-    } // for elem
+      // Read all owned elements at once. Every element is stored as its type followed by its nodes
+      int elemDataSize;
+      CALL_CGNS(cg_ElementPartialSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,owned_begin,owned_end,&elemDataSize));
+      std::vector<int> elemData(elemDataSize);
+      std::vector<int> parentData(m_section.parentFlag ? 4*nb_owned : 1);
+      CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,owned_begin,owned_end,&elemData[0],&parentData[0]));
+
+      std::vector<Uint> row;
+      Uint pos = 0;
+      for (int elem=owned_begin; elem<=owned_end; ++elem)
+      {
+        // Store the cgns element type
+        ElementType_t etype_cgns = static_cast<ElementType_t>(elemData[pos++]);
+        CALL_CGNS(cg_npe(etype_cgns,&m_section.elemNodeCount));
+
+        // Put the element nodes in a vector
+        row.resize(m_section.elemNodeCount);
+        for (int n=0; n<m_section.elemNodeCount; ++n)
+          row[n]=local_node_idx(elemData[pos++]-1); // -1 because cgns has index-base 1 instead of 0
+
+        // Convert the cgns element type to the CF element type
+        const std::string& etype_CF = m_elemtype_CGNS_to_CF[etype_cgns]+to_str(m_zone.coord_dim)+"D";
+        // Add the nodes to the correct Elements component using its buffer
+        cf3_assert(buffer[etype_CF]);
+        Uint table_idx = buffer[etype_CF]->add_row(row);
+
+        // Store the global element number to a pair of (region , local element number)
+        m_global_to_region[elem-1] = Region_TableIndex_pair(elements[etype_CF],table_idx);
+        cf3_assert( m_global_to_region[elem-1].first );
+      } // for elem
+    }
   } // if mixed
   else // Single element type in this section
   {
     // Read the number of nodes in this section
     CALL_CGNS(cg_npe(m_section.type,&m_section.elemNodeCount));
 
-    // Read the size of all elements
-    CALL_CGNS(cg_ElementDataSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,&m_section.elemDataSize	));
-
-    // Calculate the number of elements
-    int nbElems = m_section.elemDataSize/m_section.elemNodeCount;
-
     // Convert the CGNS element type to the CF element type
     const std::string& etype_CF = m_elemtype_CGNS_to_CF[m_section.type]+to_str<int>(m_base.phys_dim)+"D";
 
@@ -483,30 +608,23 @@ void Reader::read_section(Region& parent_region)
     // Create a buffer for this element component, to start filling in the elements we will read.
     Connectivity& node_connectivity = element_region.geometry_space().connectivity();
 
-    // Create storage for element nodes
-    int* elemNodes = new int [m_section.elemDataSize];
-
-    // Read in the element nodes
-    cg_elements_read	(m_file.idx,m_base.idx,m_zone.idx,m_section.idx, elemNodes,&m_section.parentData);
+    // Read in the nodes of the owned elements only
+    std::vector<int> elemNodes(nb_owned*m_section.elemNodeCount);
+    std::vector<int> parentData(m_section.parentFlag ? 4*nb_owned : 1);
+    if (nb_owned)
+      CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,owned_begin,owned_end,&elemNodes[0],&parentData[0]));
 
     // --------------------------------------------- Fill connectivity table
-    std::vector<Uint> coords_added;
-    std::vector<Uint> row(m_section.elemNodeCount);
-    node_connectivity.resize(nbElems);
+    node_connectivity.resize(nb_owned);
 
-    for (int elem=0; elem<nbElems; ++elem) //, ++progress)
+    for (int elem=0; elem<nb_owned; ++elem)
     {
       for (int node=0;node<m_section.elemNodeCount;++node)
-        node_connectivity[elem][node] = start_idx + elemNodes[node+elem*m_section.elemNodeCount]-1;  // -1 because cgns has index-base 1 instead of 0;
+        node_connectivity[elem][node] = local_node_idx(elemNodes[node+elem*m_section.elemNodeCount]-1);  // -1 because cgns has index-base 1 instead of 0;
 
       // Store the global element number to a pair of (region , local element number)
-      m_global_to_region.push_back(Region_TableIndex_pair(element_region.handle<Elements>(),elem));
+      m_global_to_region[owned_begin-1+elem] = Region_TableIndex_pair(element_region.handle<Elements>(),elem);
     } // for elem
-
-
-
-    // Delete storage for element nodes
-    delete_ptr(elemNodes);
   } // else not mixed
 
   remove_empty_element_regions(this_region);
@@ -648,19 +766,13 @@ void Reader::read_boco_unstructured(Region& parent_region)
       if (m_zone.type != Unstructured)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"ElementRange\" is only supported for Unstructured grids");
 
-      // First do some simple checks to see if an entire region can be taken as a BC.
-      Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
-      Handle< Elements > last_elements = m_global_to_region[boco_elems[1]-1].first;
-      if (first_elements->parent() == last_elements->parent())
+      // First check if an entire section region can be taken as a BC.
+      // This is decided on the global element range, as ranks only know their own elements.
+      if (Handle< Region > group_region = section_with_range(boco_elems[0],boco_elems[1]))
       {
-        Handle< Region > group_region = Handle<Region>(first_elements->parent());
-        Uint prev_elm_count = group_region->properties().check("previous_elem_count") ? group_region->properties().value<Uint>("previous_elem_count") : 0;
-        if (group_region->recursive_elements_count(true) == prev_elm_count + Uint(boco_elems[1]-boco_elems[0]+1))
-        {
-          group_region->properties()["cgns_section_name"] = group_region->name();
-          group_region->rename(m_boco.name);
-          break;
-        }
+        group_region->properties()["cgns_section_name"] = group_region->name();
+        group_region->rename(m_boco.name);
+        break;
       }
 
 
@@ -680,14 +792,18 @@ void Reader::read_boco_unstructured(Region& parent_region)
 
       for (int global_element=boco_elems[0]-1;global_element<boco_elems[1];++global_element)
       {
+        // Only the elements owned by this rank are known
+        std::map<Uint,Region_TableIndex_pair>::const_iterator found = m_global_to_region.find(global_element);
+        if (found == m_global_to_region.end())
+          continue;
+
         // Check which region this global_element belongs to
-        Handle< Elements > element_region = m_global_to_region[global_element].first;
+        Handle< Elements > element_region = found->second.first;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = found->second.second;
 
         // Add the local element to the correct Elements component through its buffer
-        std::cout << "element_region->element_type().derived_type_name() = " << element_region->element_type().derived_type_name() << std::endl;
         cf3_assert(buffer[element_region->element_type().derived_type_name()]);
         buffer[element_region->element_type().derived_type_name()]->add_row(element_region->geometry_space().connectivity()[local_element]);
       }
@@ -706,23 +822,17 @@ void Reader::read_boco_unstructured(Region& parent_region)
       if (m_zone.type != Unstructured)
         throw NotSupported(FromHere(),"CGNS: Boundary with pointset_type \"ElementList\" is only supported for Unstructured grids");
 
-      // First do some simple checks to see if an entire region can be taken as a BC.
-      std::cout << "boco_elems[0]-1 = " << boco_elems[0]-1 << std::endl;
-      std::cout << m_global_to_region[boco_elems[0]-1].second << std::endl;
-      cf3_assert(m_global_to_region[boco_elems[0]-1].first);
-      Handle< Elements > first_elements = m_global_to_region[boco_elems[0]-1].first;
-      cf3_assert(m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first);
-      Handle< Elements > last_elements = m_global_to_region[boco_elems[m_boco.nBC_elem-1]-1].first;
-      if (first_elements->parent() == last_elements->parent())
+      // First check if an entire section region can be taken as a BC.
+      // This is decided on the global element range, as ranks only know their own elements.
+      const int first_elem = boco_elems[0];
+      const int last_elem = boco_elems[m_boco.nBC_elem-1];
+      if (m_boco.nBC_elem == last_elem-first_elem+1)
       {
-        Handle< Region > group_region = Handle<Region>(first_elements->parent());
-        if (group_region->name() != m_boco.name)
+        Handle< Region > group_region = section_with_range(first_elem,last_elem);
+        if (is_not_null(group_region) && group_region->name() != m_boco.name)
         {
-          if (group_region->recursive_elements_count(true) == Uint(boco_elems[m_boco.nBC_elem-1]-boco_elems[0]+1))
-          {
-            group_region->rename(m_boco.name);
-            break;  // EXIT switch
-          }
+          group_region->rename(m_boco.name);
+          break;  // EXIT switch
         }
       }
 
@@ -745,14 +855,18 @@ void Reader::read_boco_unstructured(Region& parent_region)
       {
         Uint global_element = boco_elems[i]-1;
 
+        // Only the elements owned by this rank are known
+        std::map<Uint,Region_TableIndex_pair>::const_iterator found = m_global_to_region.find(global_element);
+        if (found == m_global_to_region.end())
+          continue;
+
         // Check which region this global_element belongs to
-        Handle< Elements > element_region = m_global_to_region[global_element].first;
+        Handle< Elements > element_region = found->second.first;
 
         // Check the local element number in this region
-        Uint local_element = m_global_to_region[global_element].second;
+        Uint local_element = found->second.second;
 
         // Add the local element to the correct Elements component through its buffer
-        std::cout << "element_region->element_type().derived_type_name() = " << element_region->element_type().derived_type_name() << std::endl;
         cf3_assert(buffer[element_region->element_type().derived_type_name()]);
         buffer[element_region->element_type().derived_type_name()]->add_row(element_region->geometry_space().connectivity()[local_element]);
       }
@@ -937,6 +1051,18 @@ void Reader::read_boco_structured(Region& parent_region)
 
 //////////////////////////////////////////////////////////////////////////////
 
+Handle<Region> Reader::section_with_range(const int eBegin, const int eEnd)
+{
+  boost_foreach(const SectionRange& section, m_section_ranges)
+  {
+    if (section.eBegin == eBegin && section.eEnd == eEnd)
+      return section.region;
+  }
+  return Handle<Region>();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Reader::read_flowsolution()
 {
 //  std::cout << "nbsols = " << m_zone.nbSols << std::endl;
@@ -981,7 +1107,11 @@ void Reader::read_flowsolution()
     }
 
     cf3_assert(datasize == m_zone.total_nbVertices);
-    cf3_assert(datasize == m_mesh->geometry_fields().size());
+
+    // Unstructured zones only read the owned range of nodes, structured zones read all nodes
+    const bool distributed = (m_zone.type == Unstructured);
+    const Uint first_node = distributed ? m_nodes_begin : 0;
+    const Uint nb_read = distributed ? m_nodes_end-m_nodes_begin : datasize;
 
     boost::shared_ptr<math::VariablesDescriptor> variables = allocate_component<math::VariablesDescriptor>("variables");
     variables->options().set("dimension",static_cast<Uint>(m_base.phys_dim));
@@ -1002,25 +1132,43 @@ void Reader::read_flowsolution()
 
     Field& flowsol_field = dict->create_field(m_flowsol.name,variables->description());
     // std::cout << "flowsol_field.size() = " <<  flowsol_field.size() << std::endl;
+    const Uint nb_fields = m_flowsol.nbFields;
+    std::vector<Real> read_values(nb_read*nb_fields);
     for (m_field.idx=1; m_field.idx<=m_flowsol.nbFields; ++m_field.idx)
     {
       char field_name_char[CGNS_CHAR_MAX];
       CALL_CGNS(cg_field_info(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,m_field.idx,&m_field.datatype,field_name_char));
       m_field.name=field_name_char;
 
-      std::vector<double> field_data(datasize);
-      cgsize_t imin = 1;
-      cgsize_t imax = datasize;
-      CALL_CGNS(cg_field_read( m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,
-                               field_name_char,RealDouble,&imin,&imax,(void*)(&field_data[0]) ));
+      std::vector<double> field_data(nb_read);
+      cgsize_t imin = first_node+1;
+      cgsize_t imax = first_node+nb_read;
+      if (nb_read)
+        CALL_CGNS(cg_field_read( m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,
+                                 field_name_char,RealDouble,&imin,&imax,(void*)(&field_data[0]) ));
 
-      cf3_assert(field_data.size() == flowsol_field.size());
-      cf3_assert(flowsol_field.nb_vars() == m_flowsol.nbFields);
-      cf3_assert(flowsol_field.row_size() == m_flowsol.nbFields);
-      for (Uint i=0; i< field_data.size(); ++i)
-      {
-        flowsol_field[i][m_field.idx-1] = field_data[i];
-      }
+      for (Uint i=0; i<nb_read; ++i)
+        read_values[i*nb_fields+m_field.idx-1] = field_data[i];
+    }
+
+    // Values of the ghost nodes come from the ranks that read them
+    std::vector<Real> ghost_values;
+    if (distributed)
+      fetch_ghost_values(read_values, nb_fields, ghost_values);
+
+    cf3_assert(flowsol_field.nb_vars() == nb_fields);
+    cf3_assert(flowsol_field.row_size() == nb_fields);
+    cf3_assert(m_zone.nodes_start_idx + nb_read + m_ghost_nodes.size() <= flowsol_field.size());
+    Uint n = m_zone.nodes_start_idx;
+    for (Uint i=0; i<nb_read; ++i, ++n)
+    {
+      for (Uint var=0; var<nb_fields; ++var)
+        flowsol_field[n][var] = read_values[i*nb_fields+var];
+    }
+    for (Uint g=0; g<m_ghost_nodes.size(); ++g, ++n)
+    {
+      for (Uint var=0; var<nb_fields; ++var)
+        flowsol_field[n][var] = ghost_values[g*nb_fields+var];
     }
   }
 }
@@ -19,11 +19,17 @@
 namespace cf3 {
 namespace mesh {
   class Region;
+  class MergedParallelDistribution;
 namespace CGNS {
 
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines CGNS mesh format reader
+///
+/// Unstructured zones are read in parallel: every rank only reads its own range
+/// of nodes and elements, as given by a MergedParallelDistribution. Nodes of
+/// owned elements that belong to another rank are then fetched from their owner.
+/// Structured zones are read entirely on every rank.
 /// @author Willem Deconinck
   class Mesh_CGNS_API Reader : public MeshReader, public CGNS::Shared
 {
@@ -31,6 +37,8 @@ private: // typedefs
 
   typedef std::pair<Handle<Elements>,Uint> Region_TableIndex_pair;
 
+  enum HashType { NODES=0, ELEMS=1 };
+
 public: // functions
 
   /// Contructor
@@ -51,6 +59,7 @@ private: // functions
   void read_base(Mesh& parent_region);
   void read_zone(Mesh& parent_region);
   void read_coordinates_unstructured(Region& parent_region);
+  void create_nodes_unstructured();
   void read_coordinates_structured(Region& parent_region);
   void read_section(Region& parent_region);
   void create_structured_elements(Region& parent_region);
@@ -59,6 +68,21 @@ private: // functions
   void read_flowsolution();
   Uint get_total_nbElements();
 
+  /// Index in the nodes dictionary of a node of the current unstructured zone.
+  /// Nodes owned by another rank are registered as ghost nodes.
+  /// @param [in] zone_node  0-based node index in the zone
+  Uint local_node_idx(const Uint zone_node);
+
+  /// Get the values of the ghost nodes from the ranks that own them
+  /// @param [in]  owned_values  values of the owned nodes, "stride" values per node
+  /// @param [in]  stride        number of values per node
+  /// @param [out] ghost_values  values of the ghost nodes, in the order of m_ghost_nodes
+  void fetch_ghost_values(const std::vector<Real>& owned_values, const Uint stride, std::vector<Real>& ghost_values);
+
+  /// Region of the section that spans exactly the given 1-based element range
+  /// @return null handle if no section spans this range
+  Handle<Region> section_with_range(const int eBegin, const int eEnd);
+
   Uint structured_node_idx(Uint i, Uint j, Uint k)
   {
     return i + j*m_zone.nbVertices[XX] + k*m_zone.nbVertices[XX]*m_zone.nbVertices[YY];
@@ -70,10 +94,35 @@ private: // functions
 
 private: // data
 
-  std::vector<Region_TableIndex_pair> m_global_to_region;
+  /// Global range of the elements read from a section
+  struct SectionRange
+  {
+    Handle<Region> region;
+    int eBegin;
+    int eEnd;
+  };
+
+  /// Owned elements of the current zone, by 0-based element index in the zone
+  std::map<Uint,Region_TableIndex_pair> m_global_to_region;
+  std::vector<SectionRange> m_section_ranges;
   Handle<Mesh> m_mesh;
   Uint m_coord_start_idx;
 
+  /// Distribution of the nodes and elements of the current zone over the ranks
+  Handle<MergedParallelDistribution> m_hash;
+  /// Range [begin,end) of the zone nodes owned by this rank
+  Uint m_nodes_begin;
+  Uint m_nodes_end;
+  /// Range [begin,end) of the zone elements owned by this rank
+  Uint m_elems_begin;
+  Uint m_elems_end;
+  /// Coordinates of the owned nodes, until the ghost nodes are known
+  std::vector<Real> m_owned_coordinates;
+  /// Zone node index of every ghost node
+  std::vector<Uint> m_ghost_nodes;
+  /// Position in m_ghost_nodes of a zone node index
+  std::map<Uint,Uint> m_ghost_node_idx;
+
 }; // end Reader
 
 
@@ -20,6 +20,7 @@
 #include "common/StringConversion.hpp"
 #include "common/Tags.hpp"
 #include "common/DynTable.hpp"
+#include "common/CSRTable.hpp"
 #include "common/List.hpp"
 
 #include "common/XML/SignalOptions.hpp"
@@ -65,7 +66,7 @@ Dictionary::Dictionary ( const std::string& name  ) :
   m_glb_idx = create_static_component< common::List<Uint> >(mesh::Tags::global_indices());
   m_glb_idx->add_tag(mesh::Tags::global_indices());
 
-  m_glb_to_loc = create_static_component< common::Map<boost::uint64_t,Uint> >(mesh::Tags::map_global_to_local());
+  m_glb_to_loc = create_static_component< GlbToLocMap >(mesh::Tags::map_global_to_local());
   m_glb_to_loc->add_tag(mesh::Tags::map_global_to_local());
 
   m_connectivity = create_static_component< common::DynTable<SpaceElem> >("element_connectivity");
@@ -141,6 +142,28 @@ CommPattern& Dictionary::comm_pattern()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Dictionary::rebuild_comm_pattern()
+{
+  if(is_null(m_comm_pattern))
+    return;
+
+  std::vector< Handle<Field> > parallel_fields;
+  boost_foreach(Field& field, find_components<Field>(*this))
+  {
+    if(is_not_null(m_comm_pattern->get_child(field.name())))
+      parallel_fields.push_back(field.handle<Field>());
+  }
+
+  remove_component(*m_comm_pattern);
+  m_comm_pattern = Handle<common::PE::CommPattern>();
+
+  comm_pattern();
+  boost_foreach(const Handle<Field>& field, parallel_fields)
+    field->parallelize();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 bool Dictionary::is_ghost(const Uint idx) const
 {
   cf3_assert_desc(to_str(idx)+">="+to_str(size()),idx < size());
@@ -456,11 +479,11 @@ Field& Dictionary::create_coordinates()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-DynTable<Uint>& Dictionary::glb_elem_connectivity()
+CSRTable<Uint>& Dictionary::glb_elem_connectivity()
 {
   if (is_null(m_glb_elem_connectivity))
   {
-    m_glb_elem_connectivity = create_static_component< DynTable<Uint> >("glb_elem_connectivity");
+    m_glb_elem_connectivity = create_static_component< CSRTable<Uint> >("glb_elem_connectivity");
     m_glb_elem_connectivity->add_tag("glb_elem_connectivity");
     m_glb_elem_connectivity->resize(size());
   }
@@ -10,6 +10,7 @@
 #include <boost/cstdint.hpp>
 
 #include "common/Map.hpp"
+#include "common/HashMap.hpp"
 
 #include "mesh/LibMesh.hpp"
 
@@ -18,6 +19,7 @@ namespace common {
   class Link;
   template <typename T> class List;
   template <typename T> class DynTable;
+  template <typename T> class CSRTable;
   namespace PE { class CommPattern; }
 }
 namespace math { class VariablesDescriptor; }
@@ -41,6 +43,17 @@ class Mesh_API Dictionary : public common::Component {
 friend class Mesh; // dirty (but harmless) hack, because geometry coordinates field
                    // needs to be initialized differently and added to m_fields
 
+public: // typedefs
+
+  /// Type of the map between global and local indices.
+  /// The hash map gives constant time lookups, the sorted map uses less memory.
+  /// It is selected with the CMake option CF3_ENABLE_HASHED_GLB_TO_LOC.
+#ifdef CF3_ENABLE_HASHED_GLB_TO_LOC
+  typedef common::HashMap<boost::uint64_t,Uint> GlbToLocMap;
+#else
+  typedef common::Map<boost::uint64_t,Uint> GlbToLocMap;
+#endif
+
 public: // functions
 
   /// Contructor
@@ -84,10 +97,10 @@ public: // functions
   const common::List<Uint>& rank() const { return *m_rank; }
 
   /// Return a mapping between global and local indices
-//  common::Map<boost::uint64_t,Uint>& glb_to_loc() { return *m_glb_to_loc; }
+//  GlbToLocMap& glb_to_loc() { return *m_glb_to_loc; }
 
   /// Return a mapping between global and local indices
-  const common::Map<boost::uint64_t,Uint>& glb_to_loc() const { return *m_glb_to_loc; }
+  const GlbToLocMap& glb_to_loc() const { return *m_glb_to_loc; }
 
   /// Node to space-element connectivity
   const common::DynTable<SpaceElem>& connectivity() const { return *m_connectivity; }
@@ -95,6 +108,11 @@ public: // functions
   /// Return the comm pattern valid for this field group. Created based on the glb_idx and rank if it didn't exist already
   common::PE::CommPattern& comm_pattern();
 
+  /// Recreate the comm pattern from the current glb_idx and rank, if it existed,
+  /// and parallelize the fields again that were parallelized with it.
+  /// Needed after rows are moved, as the comm pattern stores local indices.
+  void rebuild_comm_pattern();
+
   /// Check if a field row is owned by this rank
   bool is_ghost(const Uint idx) const;
 
@@ -114,7 +132,7 @@ public: // functions
 
   const std::vector< Handle<Field> >& fields() const { return m_fields; }
 
-  common::DynTable<Uint>& glb_elem_connectivity();
+  common::CSRTable<Uint>& glb_elem_connectivity();
 
   void signal_create_field ( common::SignalArgs& node );
 
@@ -159,9 +177,9 @@ protected:
   Handle<common::List<Uint> > m_glb_idx;
   Handle<common::List<Uint> > m_rank;
   Handle<Field> m_coordinates;
-  Handle<common::DynTable<Uint> > m_glb_elem_connectivity;
+  Handle<common::CSRTable<Uint> > m_glb_elem_connectivity;
   Handle<common::PE::CommPattern> m_comm_pattern;
-  Handle<common::Map<boost::uint64_t,Uint> > m_glb_to_loc;
+  Handle<GlbToLocMap> m_glb_to_loc;
   bool m_is_continuous;
 
   /// Connectivity with the element of the space
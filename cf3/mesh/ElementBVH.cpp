@@ -0,0 +1,411 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/Signal.hpp"
+#include "common/XML/SignalOptions.hpp"
+#include "common/FindComponents.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionComponent.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/ElementBVH.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Tags.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+  using namespace math::Consts;
+
+////////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < ElementBVH, Component, LibMesh > ElementBVH_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Orders elements by the coordinate of their centroid along one axis
+struct CentroidLess
+{
+  CentroidLess(const std::vector<Real>& centroids, const Uint axis) : m_centroids(centroids), m_axis(axis) {}
+
+  bool operator()(const Uint a, const Uint b) const
+  {
+    return m_centroids[3*a+m_axis] < m_centroids[3*b+m_axis];
+  }
+
+  const std::vector<Real>& m_centroids;
+  const Uint m_axis;
+};
+
+/// Subtrees with more elements than this are built as separate tasks
+const Uint task_size = 4096;
+
+/// Elements of a leaf are tested with a bounding box enlarged with this fraction of its size
+const Real box_tolerance = 1e-10;
+
+/// Maximum depth of the tree, which is balanced
+const Uint max_depth = 128;
+
+inline bool is_in_box(const Real* min, const Real* max, const Real* coord)
+{
+  return coord[XX] >= min[XX] && coord[XX] <= max[XX]
+      && coord[YY] >= min[YY] && coord[YY] <= max[YY]
+      && coord[ZZ] >= min[ZZ] && coord[ZZ] <= max[ZZ];
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+ElementBVH::ElementBVH( const std::string& name )
+  : Component(name), m_dim(0), m_max_leaf_size(4u)
+{
+  options().add("mesh", m_mesh)
+      .description("Mesh to create the bounding volume hierarchy from")
+      .pretty_name("Mesh")
+      .mark_basic()
+      .link_to(&m_mesh);
+
+  options().add("max_leaf_size", m_max_leaf_size)
+      .description("Maximum number of elements in a leaf of the tree")
+      .pretty_name("Maximum Leaf Size")
+      .link_to(&m_max_leaf_size);
+
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_loaded(), this, &ElementBVH::on_mesh_changed_event);
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &ElementBVH::on_mesh_changed_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementBVH::on_mesh_changed_event(SignalArgs& args)
+{
+  if (is_null(m_mesh))
+    return;
+
+  SignalOptions options(args);
+  if (options.value<URI>("mesh_uri").path() == m_mesh->uri().path())
+    clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementBVH::clear()
+{
+  m_nodes.clear();
+  m_elements.clear();
+  m_box_min.clear();
+  m_box_max.clear();
+  m_centroids.clear();
+  m_order.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementBVH::create_bvh()
+{
+  if (is_null(m_mesh))
+    throw SetupError(FromHere(), "Option \"mesh\" has not been configured");
+  if (m_max_leaf_size == 0)
+    throw BadValue(FromHere(), "Option \"max_leaf_size\" of "+uri().string()+" must be at least 1");
+
+  m_dim = m_mesh->dimension();
+
+  m_elements.clear();
+  boost_foreach (Elements& elements, find_components_recursively_with_filter<Elements>(*m_mesh,IsElementsVolume()))
+  {
+    for (Uint elem_idx=0; elem_idx<elements.size(); ++elem_idx)
+      m_elements.push_back(Entity(elements,elem_idx));
+  }
+  const Uint nb_elems = m_elements.size();
+
+  // Bounding boxes and centroids of all elements
+  m_box_min.assign(3*nb_elems,0.);
+  m_box_max.assign(3*nb_elems,0.);
+  m_centroids.assign(3*nb_elems,0.);
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    RealVector centroid(m_dim);
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (int e=0; e<static_cast<int>(nb_elems); ++e)
+    {
+      const RealMatrix coordinates = m_elements[e].get_coordinates();
+      m_elements[e].element_type().compute_centroid(coordinates,centroid);
+      Real diagonal = 0.;
+      for (Uint d=0; d<m_dim; ++d)
+      {
+        m_box_min[3*e+d] = coordinates.col(d).minCoeff();
+        m_box_max[3*e+d] = coordinates.col(d).maxCoeff();
+        m_centroids[3*e+d] = centroid[d];
+        diagonal += (m_box_max[3*e+d]-m_box_min[3*e+d])*(m_box_max[3*e+d]-m_box_min[3*e+d]);
+      }
+      const Real tolerance = box_tolerance*std::sqrt(diagonal);
+      for (Uint d=0; d<m_dim; ++d)
+      {
+        m_box_min[3*e+d] -= tolerance;
+        m_box_max[3*e+d] += tolerance;
+      }
+    }
+  }
+
+  // Build the tree, permuting m_order
+  m_order.resize(nb_elems);
+  for (Uint e=0; e<nb_elems; ++e)
+    m_order[e] = e;
+  m_nodes.resize(nb_nodes(nb_elems));
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel
+  #pragma omp single nowait
+#endif
+  build_node(0,0,nb_elems);
+
+  // Store the elements in the order of the leaves, for locality of the searches
+  std::vector<Entity> elements(nb_elems);
+  std::vector<Real> box_min(3*nb_elems), box_max(3*nb_elems), centroids(3*nb_elems);
+  for (Uint e=0; e<nb_elems; ++e)
+  {
+    const Uint original = m_order[e];
+    elements[e] = m_elements[original];
+    std::copy(&m_box_min[3*original],&m_box_min[3*original]+3,&box_min[3*e]);
+    std::copy(&m_box_max[3*original],&m_box_max[3*original]+3,&box_max[3*e]);
+    std::copy(&m_centroids[3*original],&m_centroids[3*original]+3,&centroids[3*e]);
+  }
+  m_elements.swap(elements);
+  m_box_min.swap(box_min);
+  m_box_max.swap(box_max);
+  m_centroids.swap(centroids);
+  std::vector<Uint>().swap(m_order);
+
+  CFdebug << "ElementBVH: " << nb_elems << " elements in " << m_nodes.size() << " nodes" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint ElementBVH::nb_nodes(const Uint nb_elems) const
+{
+  if (nb_elems <= m_max_leaf_size)
+    return 1;
+  return 1 + nb_nodes(nb_elems/2) + nb_nodes(nb_elems-nb_elems/2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementBVH::build_node(const Uint node_idx, const Uint begin, const Uint end)
+{
+  Node& node = m_nodes[node_idx];
+  node.begin = begin;
+  node.end = end;
+
+  if (end-begin <= m_max_leaf_size)
+  {
+    node.right = 0;
+    for (Uint d=0; d<3; ++d)
+    {
+      node.min[d] = real_max();
+      node.max[d] = -real_max();
+      for (Uint e=begin; e<end; ++e)
+      {
+        node.min[d] = std::min(node.min[d],m_box_min[3*m_order[e]+d]);
+        node.max[d] = std::max(node.max[d],m_box_max[3*m_order[e]+d]);
+      }
+    }
+    return;
+  }
+
+  // Split at the median centroid along the direction in which the centroids are spread most
+  Uint axis = XX;
+  Real largest_extent = -1.;
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    Real min = real_max();
+    Real max = -real_max();
+    for (Uint e=begin; e<end; ++e)
+    {
+      min = std::min(min,m_centroids[3*m_order[e]+d]);
+      max = std::max(max,m_centroids[3*m_order[e]+d]);
+    }
+    if (max-min > largest_extent)
+    {
+      largest_extent = max-min;
+      axis = d;
+    }
+  }
+  const Uint mid = begin + (end-begin)/2;
+  std::nth_element(m_order.begin()+begin, m_order.begin()+mid, m_order.begin()+end, CentroidLess(m_centroids,axis));
+
+  const Uint left = node_idx+1;
+  const Uint right = left + nb_nodes(mid-begin);
+  node.right = right;
+
+#ifdef CF3_HAVE_OPENMP
+  if (end-begin > task_size)
+  {
+    #pragma omp task
+    build_node(left,begin,mid);
+    #pragma omp task
+    build_node(right,mid,end);
+    #pragma omp taskwait
+  }
+  else
+#endif
+  {
+    build_node(left,begin,mid);
+    build_node(right,mid,end);
+  }
+
+  for (Uint d=0; d<3; ++d)
+  {
+    node.min[d] = std::min(m_nodes[left].min[d],m_nodes[right].min[d]);
+    node.max[d] = std::max(m_nodes[left].max[d],m_nodes[right].max[d]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementBVH::find_element(const RealVector& target_coord, Entity& element) const
+{
+  if (m_nodes.empty())
+    return false;
+
+  Real coord[3] = {0.,0.,0.};
+  RealVector t_coord(m_dim);
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    coord[d] = target_coord[d];
+    t_coord[d] = target_coord[d];
+  }
+
+  Uint stack[max_depth];
+  Uint stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size)
+  {
+    const Uint node_idx = stack[--stack_size];
+    const Node& node = m_nodes[node_idx];
+    if (!is_in_box(node.min,node.max,coord))
+      continue;
+
+    if (node.right == 0)
+    {
+      for (Uint e=node.begin; e<node.end; ++e)
+      {
+        if (is_in_box(&m_box_min[3*e],&m_box_max[3*e],coord)
+            && m_elements[e].element_type().is_coord_in_element(t_coord,m_elements[e].get_coordinates()))
+        {
+          element = m_elements[e];
+          return true;
+        }
+      }
+    }
+    else
+    {
+      cf3_assert(stack_size+2 <= max_depth);
+      stack[stack_size++] = node.right;
+      stack[stack_size++] = node_idx+1;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementBVH::find_closest_element(const RealVector& target_coord, Entity& element) const
+{
+  if (m_elements.empty())
+    return false;
+
+  RealVector coord(3);
+  coord.setZero();
+  for (Uint d=0; d<m_dim; ++d)
+    coord[d] = target_coord[d];
+
+  Real closest_distance2 = real_max();
+  Uint closest = 0;
+
+  Uint stack[max_depth];
+  Uint stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size)
+  {
+    const Uint node_idx = stack[--stack_size];
+    const Node& node = m_nodes[node_idx];
+    // The centroids of the elements lie in the box, so they are at least this far
+    if (box_distance2(node.min,node.max,coord) >= closest_distance2)
+      continue;
+
+    if (node.right == 0)
+    {
+      for (Uint e=node.begin; e<node.end; ++e)
+      {
+        Real distance2 = 0.;
+        for (Uint d=0; d<m_dim; ++d)
+          distance2 += (m_centroids[3*e+d]-coord[d])*(m_centroids[3*e+d]-coord[d]);
+        if (distance2 < closest_distance2)
+        {
+          closest_distance2 = distance2;
+          closest = e;
+        }
+      }
+    }
+    else
+    {
+      // Visit the nearest child first, to find close candidates early
+      cf3_assert(stack_size+2 <= max_depth);
+      const Uint left = node_idx+1;
+      if (box_distance2(m_nodes[left].min,m_nodes[left].max,coord) < box_distance2(m_nodes[node.right].min,m_nodes[node.right].max,coord))
+      {
+        stack[stack_size++] = node.right;
+        stack[stack_size++] = left;
+      }
+      else
+      {
+        stack[stack_size++] = left;
+        stack[stack_size++] = node.right;
+      }
+    }
+  }
+  element = m_elements[closest];
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real ElementBVH::box_distance2(const Real* min, const Real* max, const RealVector& coord) const
+{
+  Real distance2 = 0.;
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    if (coord[d] < min[d])
+      distance2 += (min[d]-coord[d])*(min[d]-coord[d]);
+    else if (coord[d] > max[d])
+      distance2 += (coord[d]-max[d])*(coord[d]-max[d]);
+  }
+  return distance2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,118 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_ElementBVH_hpp
+#define cf3_mesh_ElementBVH_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Component.hpp"
+
+#include "mesh/Entities.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class Mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Bounding volume hierarchy of the volume elements of a mesh
+///
+/// Every node of the tree holds the bounding box of its elements. The elements are
+/// split at the median of their centroids along the longest direction, so the tree
+/// is balanced whatever the variation in element size is, and a point is located in
+/// O(log n) box tests. The bounding boxes are computed in parallel and the subtrees
+/// are built as parallel tasks, when OpenMP is available.
+class Mesh_API ElementBVH : public common::Component
+{
+public: // functions
+
+  /// constructor
+  ElementBVH( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "ElementBVH"; }
+
+  /// Build the hierarchy for the elements of the configured mesh
+  void create_bvh();
+
+  bool is_created() const { return !m_nodes.empty(); }
+
+  /// Remove the hierarchy, so it is built again from the current elements on next use
+  void clear();
+
+  Uint dimension() const { return m_dim; }
+
+  /// @brief Find which element contains a given coordinate
+  /// @return if element was found
+  bool find_element(const RealVector& target_coord, Entity& element) const;
+
+  /// @brief Find the element with the centroid closest to a given coordinate
+  /// @return if element was found, which is only false for a mesh without elements
+  bool find_closest_element(const RealVector& target_coord, Entity& element) const;
+
+private: // types
+
+  /// Node of the tree, with the range of elements it contains.
+  /// The left child directly follows its parent, a leaf has no right child.
+  struct Node
+  {
+    Real min[3];
+    Real max[3];
+    Uint begin;
+    Uint end;
+    Uint right;
+  };
+
+private: // functions
+
+  /// Clears the hierarchy when its mesh is loaded or changed,
+  /// as it holds the elements and their bounding boxes
+  void on_mesh_changed_event(common::SignalArgs& args);
+
+  /// Build the subtree of elements [begin,end) of m_order, at index node_idx
+  void build_node(const Uint node_idx, const Uint begin, const Uint end);
+
+  /// Number of nodes of a subtree with nb_elems elements
+  Uint nb_nodes(const Uint nb_elems) const;
+
+  /// Squared distance from a coordinate to the box of a node, 0 if inside
+  Real box_distance2(const Real* min, const Real* max, const RealVector& coord) const;
+
+private: // data
+
+  Handle<Mesh> m_mesh;
+
+  Uint m_dim;
+
+  Uint m_max_leaf_size;
+
+  std::vector<Node> m_nodes;
+
+  /// Elements, in the order of the leaves
+  std::vector<Entity> m_elements;
+
+  /// Bounding boxes and centroids of the elements, 3 values each per element
+  std::vector<Real> m_box_min;
+  std::vector<Real> m_box_max;
+  std::vector<Real> m_centroids;
+
+  /// Permutation of the elements during the build
+  std::vector<Uint> m_order;
+
+}; // end ElementBVH
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_ElementBVH_hpp
@@ -0,0 +1,86 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/bind.hpp>
+
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionComponent.hpp"
+
+#include "mesh/ElementBVH.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/ElementFinderBVH.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < ElementFinderBVH, ElementFinder, LibMesh > ElementFinderBVH_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+ElementFinderBVH::ElementFinderBVH(const std::string &name) :
+  ElementFinder(name),
+  m_closest(true)
+{
+  options().option("dict").attach_trigger( boost::bind( &ElementFinderBVH::configure_bvh, this ) );
+
+  options().add("find_closest",m_closest)
+    .description("If true, an inexact match is allowed, finding the element with the closest centroid")
+    .link_to(&m_closest);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementFinderBVH::configure_bvh()
+{
+  Handle<Mesh> mesh = find_parent_component_ptr<Mesh>(*m_dict);
+
+  if (is_null(mesh))
+    throw SetupError(FromHere(),"Mesh was not found as parent of "+m_dict->uri().string());
+
+  if (Handle<Component> found = mesh->get_child("element_bvh"))
+    m_bvh = Handle<ElementBVH>(found);
+  else
+  {
+    m_bvh = mesh->create_component<ElementBVH>("element_bvh");
+    m_bvh->options().set("mesh",mesh);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool ElementFinderBVH::find_element(const RealVector& target_coord, SpaceElem& element)
+{
+  cf3_assert(m_bvh);
+
+  if (m_bvh->is_created() == false)
+    m_bvh->create_bvh();
+
+  if (m_bvh->find_element(target_coord,m_tmp) || (m_closest && m_bvh->find_closest_element(target_coord,m_tmp)))
+  {
+    element = SpaceElem(*const_cast<Space*>(&m_dict->space(*m_tmp.comp)),m_tmp.idx);
+    return true;
+  }
+
+  CFdebug << "coord " << target_coord.transpose() << " has not been found in the bounding volume hierarchy" << CFendl;
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
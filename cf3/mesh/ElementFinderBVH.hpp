@@ -0,0 +1,58 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_ElementFinderBVH_hpp
+#define cf3_mesh_ElementFinderBVH_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/ElementFinder.hpp"
+#include "mesh/Entities.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class ElementBVH;
+
+/// @brief Find elements using a bounding volume hierarchy of the elements
+///
+/// Unlike ElementFinderOcttree, the search cost does not depend on how much the element
+/// sizes vary throughout the mesh, which makes it suited for stretched boundary-layer meshes.
+/// The hierarchy is shared by all finders of a mesh.
+class Mesh_API ElementFinderBVH : public ElementFinder
+{
+public:
+
+  /// @brief type name
+  static std::string type_name() {return "ElementFinderBVH"; }
+
+  /// @brief Constructor
+  ElementFinderBVH(const std::string& name);
+
+  virtual bool find_element(const RealVector& target_coord, SpaceElem& element);
+
+private:
+
+  void configure_bvh();
+
+private:
+
+  Handle<ElementBVH> m_bvh;
+  Entity m_tmp;
+  bool m_closest;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_ElementFinderBVH_hpp
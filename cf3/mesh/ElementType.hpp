@@ -12,6 +12,8 @@
 //#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/range.hpp>
 
+#include "common/Table.hpp"
+
 #include "math/MatrixTypes.hpp"
 
 #include "mesh/Entities.hpp"
@@ -196,6 +198,80 @@ public: // functions
 
   //@}
 
+  /// @name Batched computation functions
+  /// Compute a geometric quantity for all elements of a connectivity table at once.
+  /// The concrete element type gathers the nodes of each element into fixed-size
+  /// matrices, avoiding a virtual call and dynamic allocations per element.
+  //  ---------------------------
+  //@{
+
+  /// Compute the volume of each element
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] volumes       volume of each element, resized to nb_elems
+  virtual void compute_volumes(const common::Table<Uint>& connectivity,
+                               const common::Table<Real>& coordinates,
+                               RealVector& volumes) const = 0;
+
+  /// Compute the area of each element
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] areas         area of each element, resized to nb_elems
+  virtual void compute_areas(const common::Table<Uint>& connectivity,
+                             const common::Table<Real>& coordinates,
+                             RealVector& areas) const = 0;
+
+  /// Compute the unit-normal of each face-element
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] normals       normal of each element, resized to (nb_elems x dimension)
+  virtual void compute_normals(const common::Table<Uint>& connectivity,
+                               const common::Table<Real>& coordinates,
+                               RealMatrix& normals) const = 0;
+
+  /// Compute the centroid of each element
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] centroids     centroid of each element, resized to (nb_elems x dimension)
+  virtual void compute_centroids(const common::Table<Uint>& connectivity,
+                                 const common::Table<Real>& coordinates,
+                                 RealMatrix& centroids) const = 0;
+
+  /// Compute the jacobian dX/dKSI of each element at the same mapped coordinate
+  /// @param [in]  mapped_coord  coordinates in mapped space (dimensionality x 1)
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] jacobians     jacobian of each element, stored row by row in one row per
+  ///                            element, resized to (nb_elems x dimensionality*dimension)
+  virtual void compute_jacobians_at(const RealVector& mapped_coord,
+                                    const common::Table<Uint>& connectivity,
+                                    const common::Table<Real>& coordinates,
+                                    RealMatrix& jacobians) const = 0;
+
+  /// Compute the jacobian determinant of each element at the same mapped coordinate
+  /// @param [in]  mapped_coord  coordinates in mapped space (dimensionality x 1)
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] determinants  jacobian determinant of each element, resized to nb_elems
+  virtual void compute_jacobian_determinants_at(const RealVector& mapped_coord,
+                                                const common::Table<Uint>& connectivity,
+                                                const common::Table<Real>& coordinates,
+                                                RealVector& determinants) const = 0;
+
+  /// Compute the plane jacobian normal of each element at the same mapped coordinate
+  /// @param [in]  mapped_coord  coordinates in mapped space (dimensionality x 1)
+  /// @param [in]  orientation   direction normal to the plane
+  /// @param [in]  connectivity  node indices of each element (nb_elems x nb_nodes)
+  /// @param [in]  coordinates   coordinates of all nodes (nb_all_nodes x dimension)
+  /// @param [out] result        plane jacobian normal of each element, resized to (nb_elems x dimension)
+  virtual void compute_plane_jacobian_normals_at(const RealVector& mapped_coord,
+                                                 const CoordRef orientation,
+                                                 const common::Table<Uint>& connectivity,
+                                                 const common::Table<Real>& coordinates,
+                                                 RealMatrix& result) const = 0;
+
+  //@}
+
 protected: // data
 
   /// the GeoShape::Type corresponding to the shape
@@ -187,7 +187,143 @@ public: // functions
 
   //@}
 
+  /// @name Batched computation functions
+  //  ---------------------------
+  //@{
+  virtual void compute_volumes(const common::Table<Uint>& connectivity,
+                               const common::Table<Real>& coordinates,
+                               RealVector& volumes) const
+  {
+    const Uint nb_elems = connectivity.size();
+    volumes.resize(nb_elems);
+    typename ETYPE::NodesT nodes;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      volumes[elem] = ETYPE::volume(nodes);
+    }
+  }
+
+  virtual void compute_areas(const common::Table<Uint>& connectivity,
+                             const common::Table<Real>& coordinates,
+                             RealVector& areas) const
+  {
+    const Uint nb_elems = connectivity.size();
+    areas.resize(nb_elems);
+    typename ETYPE::NodesT nodes;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      areas[elem] = ETYPE::area(nodes);
+    }
+  }
+
+  virtual void compute_normals(const common::Table<Uint>& connectivity,
+                               const common::Table<Real>& coordinates,
+                               RealMatrix& normals) const
+  {
+    const Uint nb_elems = connectivity.size();
+    normals.resize(nb_elems, ETYPE::dimension);
+    typename ETYPE::NodesT nodes;
+    typename ETYPE::CoordsT normal;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      ETYPE::compute_normal(nodes, normal);
+      normals.row(elem) = normal.transpose();
+    }
+  }
+
+  virtual void compute_centroids(const common::Table<Uint>& connectivity,
+                                 const common::Table<Real>& coordinates,
+                                 RealMatrix& centroids) const
+  {
+    const Uint nb_elems = connectivity.size();
+    centroids.resize(nb_elems, ETYPE::dimension);
+    typename ETYPE::NodesT nodes;
+    typename ETYPE::CoordsT centroid;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      ETYPE::compute_centroid(nodes, centroid);
+      centroids.row(elem) = centroid.transpose();
+    }
+  }
+
+  virtual void compute_jacobians_at(const RealVector& mapped_coord,
+                                    const common::Table<Uint>& connectivity,
+                                    const common::Table<Real>& coordinates,
+                                    RealMatrix& jacobians) const
+  {
+    const Uint nb_elems = connectivity.size();
+    jacobians.resize(nb_elems, ETYPE::dimensionality*ETYPE::dimension);
+    const typename ETYPE::MappedCoordsT mapped_c(mapped_coord);
+    typename ETYPE::NodesT nodes;
+    typename ETYPE::JacobianT jacobian;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      ETYPE::compute_jacobian(mapped_c, nodes, jacobian);
+      for (Uint i=0; i<ETYPE::dimensionality; ++i)
+        for (Uint j=0; j<ETYPE::dimension; ++j)
+          jacobians(elem, i*ETYPE::dimension+j) = jacobian(i,j);
+    }
+  }
+
+  virtual void compute_jacobian_determinants_at(const RealVector& mapped_coord,
+                                                const common::Table<Uint>& connectivity,
+                                                const common::Table<Real>& coordinates,
+                                                RealVector& determinants) const
+  {
+    const Uint nb_elems = connectivity.size();
+    determinants.resize(nb_elems);
+    const typename ETYPE::MappedCoordsT mapped_c(mapped_coord);
+    typename ETYPE::NodesT nodes;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      determinants[elem] = ETYPE::jacobian_determinant(mapped_c, nodes);
+    }
+  }
+
+  virtual void compute_plane_jacobian_normals_at(const RealVector& mapped_coord,
+                                                 const CoordRef orientation,
+                                                 const common::Table<Uint>& connectivity,
+                                                 const common::Table<Real>& coordinates,
+                                                 RealMatrix& result) const
+  {
+    const Uint nb_elems = connectivity.size();
+    result.resize(nb_elems, ETYPE::dimension);
+    const typename ETYPE::MappedCoordsT mapped_c(mapped_coord);
+    typename ETYPE::NodesT nodes;
+    typename ETYPE::CoordsT plane_normal;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      gather_nodes(connectivity[elem], coordinates, nodes);
+      ETYPE::compute_plane_jacobian_normal(mapped_c, nodes, orientation, plane_normal);
+      result.row(elem) = plane_normal.transpose();
+    }
+  }
+
+  //@}
+
 private:
+
+  /// Copy the coordinates of the element nodes into fixed-size storage
+  static void gather_nodes(const common::Table<Uint>::ConstRow& element_nodes,
+                           const common::Table<Real>& coordinates,
+                           typename ETYPE::NodesT& nodes)
+  {
+    cf3_assert(element_nodes.size() == ETYPE::nb_nodes);
+    cf3_assert(coordinates.row_size() == ETYPE::dimension);
+    for (Uint i=0; i<ETYPE::nb_nodes; ++i)
+    {
+      const common::Table<Real>::ConstRow node_coords = coordinates[element_nodes[i]];
+      for (Uint j=0; j<ETYPE::dimension; ++j)
+        nodes(i,j) = node_coords[j];
+    }
+  }
+
   Handle< ShapeFunction > m_sf;
 };
 
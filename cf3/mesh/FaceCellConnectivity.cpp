@@ -17,6 +17,7 @@
 #include "math/Consts.hpp"
 
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Mesh.hpp"
@@ -122,15 +123,8 @@ void FaceCellConnectivity::build_connectivity()
 
   // declartions
   m_connectivity->resize(0);
-  common::Table<Entity>::Buffer f2c = m_connectivity->create_buffer();
-  common::Table<Uint>::Buffer face_number = m_face_nb_in_elem->create_buffer();
-  common::List<bool>::Buffer is_bdry_face = m_is_bdry_face->create_buffer();
-  Dictionary& geometry_fields = find_parent_component<Mesh>(*used()[0]).geometry_fields();
-  Uint tot_nb_nodes = geometry_fields.size();
-  std::vector < std::vector<Uint> > mapNodeFace(tot_nb_nodes);
-  std::vector<Uint> face_nodes;  face_nodes.reserve(100);
-  std::vector<Entity> dummy_element_row(2);
-  std::vector<Uint> dummy_idx_row(2);
+  m_face_nb_in_elem->resize(0);
+  m_is_bdry_face->resize(0);
   Uint max_nb_faces(0);
 
   // calculate max_nb_faces
@@ -165,25 +159,18 @@ void FaceCellConnectivity::build_connectivity()
     }
   }
 
-  // Declarations to save frequent allocations in the loop algorithm
-  Uint nb_inner_faces = 0;
-  Uint nb_matched_nodes = 1;
-  Uint face_node_idx;
-  Uint face_node;
-  Uint face;
-  Uint connected_face;
-  Uint node;
-  Uint nb_nodes;
-  bool found_face = false;
-  Handle< Component > elem_location_comp;
-  Uint elem_location_idx;
-
-  // loop over the element types
-  m_nb_faces=0;
+  // 1) List the faces of all elements, in the order in which new faces are numbered
+  std::vector<Entity> face_element;       face_element.reserve(max_nb_faces);
+  std::vector<Uint>   face_idx_in_elem;   face_idx_in_elem.reserve(max_nb_faces);
+  std::vector<Uint>   face_nb_nodes;      face_nb_nodes.reserve(max_nb_faces);
   boost_foreach (Handle< Component > elements_comp, used() )
   {
     Elements& elements = dynamic_cast<Elements&>(*elements_comp);
-    const Uint nb_faces_in_elem = elements.element_type().nb_faces();
+    const ElementType& etype = elements.element_type();
+    const Uint nb_faces_in_elem = etype.nb_faces();
+    std::vector<Uint> nb_nodes_per_face(nb_faces_in_elem);
+    for (Uint face_idx = 0; face_idx != nb_faces_in_elem; ++face_idx)
+      nb_nodes_per_face[face_idx] = etype.face_type(face_idx).nb_nodes();
 
     Handle< common::List<bool> > is_bdry_elem;
 
@@ -191,115 +178,91 @@ void FaceCellConnectivity::build_connectivity()
       is_bdry_elem = Handle< common::List<bool> >(elements.get_child("is_bdry"));
 
     // loop over the elements of this type
-    Uint loc_elem_idx=0;
-    boost_foreach(Connectivity::ConstRow elem_nodes, elements.geometry_space().connectivity().array() )
+    const Uint nb_elems = elements.geometry_space().connectivity().size();
+    for (Uint loc_elem_idx=0; loc_elem_idx<nb_elems; ++loc_elem_idx)
     {
       if ( is_not_null(is_bdry_elem) )
         if ( (*is_bdry_elem)[loc_elem_idx] == false )
           continue;
 
-      Entity element(elements,loc_elem_idx);
-
-      // loop over the faces in the current element
       for (Uint face_idx = 0; face_idx != nb_faces_in_elem; ++face_idx)
       {
-        // construct sets of nodes that make the corresponding face in this element
-        nb_nodes = elements.element_type().face_type(face_idx).nb_nodes();
-        face_nodes.resize(nb_nodes);
-        Uint i(0);
-        boost_foreach(const Uint face_node_idx, elements.element_type().faces().nodes_range(face_idx))
-            face_nodes[i++] = elem_nodes[face_node_idx];
-
-
-        // consider the first node belonging to the current face
-        // check if you find a face ID shared between all the other
-        // nodes building a face
-        node = face_nodes[0];
-        cf3_assert(node<tot_nb_nodes);
-
-        found_face = false;
-        // search for matching face if they are registered to the node yet
-        boost_foreach( face, mapNodeFace[node] )
-        {
-          nb_matched_nodes = 1;
-          if (nb_nodes > 1)
-          {
-            for (face_node_idx=1; face_node_idx!=nb_nodes; ++face_node_idx)
-            {
-              boost_foreach (connected_face, mapNodeFace[face_nodes[face_node_idx]])
-              {
-                if (connected_face == face)
-                {
-                  ++nb_matched_nodes;
-                  break;
-                }
-              }
-
-
-              if (nb_matched_nodes == nb_nodes) // face matches the nodes
-              {
-                // the corresponding face already exists, meaning
-                // that the face is an internal one, shared by two elements
-                // here you set the second element (==state) neighbor of the face
-                found_face = true;
-                //(*m_connectivity)[elemID][iFace] = currFaceID;
-                f2c.get_row(face)[1]=element;
-                face_number.get_row(face)[1]=face_idx;
-                is_bdry_face.get_row(face)=false;
-                // since it has two neighbor cells,
-                // this face is surely NOT a boundary face
-                // m_isBFace[currFaceID] = false;
-
-                // increment number of inner faces (they always have 2 states)
-                ++nb_inner_faces;
-                break;
-              }
-            }
-          }
-          else // this only applies to the 1D case
-          {
-            // the corresponding faceID already exists, meaning
-            // that the face is an internal one, shared by two elements
-            // here you set the second element (==state) neighbor of the face
-            found_face = true;
-            //(*elem_to_face)[elemID][iFace] = currFaceID;
-            f2c.get_row(face)[1]=element;
-            face_number.get_row(face)[1]=face_idx;
-            is_bdry_face.get_row(face)=false;
-
-            // increment number of inner faces (they always have 2 states)
-            ++nb_inner_faces;
-            break;
-          }
-        }
-        if (found_face == false)
-        {
-          // a new face has been found
-          // add the ID of the new face in the corresponding nodes
-          // referencing it
-          boost_foreach (face_node, face_nodes)
-          {
-            mapNodeFace[face_node].push_back(m_nb_faces);
-          }
-
-          // increment the number of faces
-          dummy_element_row[0]=element;
-          f2c.add_row(dummy_element_row);
-
-          dummy_idx_row[0]=face_idx;
-          face_number.add_row(dummy_idx_row);
-
-          is_bdry_face.add_row(true);
-          ++m_nb_faces;
-        }
+        face_element.push_back(Entity(elements,loc_elem_idx));
+        face_idx_in_elem.push_back(face_idx);
+        face_nb_nodes.push_back(nb_nodes_per_face[face_idx]);
       }
-      ++loc_elem_idx;
-    } // end foreach element
-  } // end foreach elements component
+    }
+  }
+  const Uint nb_element_faces = face_element.size();
+
+  // 2) Store the nodes of every face, and find for every face the first face with the same nodes.
+  //    Both steps are threaded, and give the same result as the serial algorithm.
+  FaceMatcher matcher;
+  matcher.set_face_sizes(face_nb_nodes);
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    std::vector<Uint> face_nodes;
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp for
+#endif
+    for (int f=0; f<static_cast<int>(nb_element_faces); ++f)
+    {
+      const Entity& element = face_element[f];
+      Connectivity::ConstRow elem_nodes = element.comp->geometry_space().connectivity()[element.idx];
+      face_nodes.resize(face_nb_nodes[f]);
+      Uint i(0);
+      boost_foreach(const Uint face_node_idx, element.comp->element_type().faces().nodes_range(face_idx_in_elem[f]))
+        face_nodes[i++] = elem_nodes[face_node_idx];
+      matcher.set_face(f,face_nodes);
+    }
+  }
+  std::vector<Uint> first_match;
+  matcher.match(first_match);
 
-  f2c.flush();
-  face_number.flush();
-  is_bdry_face.flush();
+  // 3) The first face with given nodes becomes a new face, with the element on the left.
+  //    A later face with the same nodes is an internal face, and sets the element on the right.
+  std::vector<Uint> face_number_of(nb_element_faces);
+  m_nb_faces=0;
+  for (Uint f=0; f<nb_element_faces; ++f)
+  {
+    if (first_match[f] == f)
+      face_number_of[f] = m_nb_faces++;
+  }
+
+  ElementConnectivity& f2c = *m_connectivity;
+  common::Table<Uint>& face_number = *m_face_nb_in_elem;
+  common::List<bool>& is_bdry_face = *m_is_bdry_face;
+  f2c.resize(m_nb_faces);
+  face_number.resize(m_nb_faces);
+  is_bdry_face.resize(m_nb_faces);
+
+  Uint nb_inner_faces = 0;
+  for (Uint f=0; f<nb_element_faces; ++f)
+  {
+    if (first_match[f] == f)
+    {
+      const Uint face = face_number_of[f];
+      f2c[face][0] = face_element[f];
+      f2c[face][1] = Entity();
+      face_number[face][0] = face_idx_in_elem[f];
+      face_number[face][1] = 0;
+      is_bdry_face[face] = true;
+    }
+    else
+    {
+      // the corresponding face already exists, meaning
+      // that the face is an internal one, shared by two elements
+      const Uint face = face_number_of[first_match[f]];
+      f2c[face][1] = face_element[f];
+      face_number[face][1] = face_idx_in_elem[f];
+      is_bdry_face[face] = false;
+
+      // increment number of inner faces (they always have 2 states)
+      ++nb_inner_faces;
+    }
+  }
 
   // CFinfo << "Total nb faces [" << m_nb_faces << "]" << CFendl;
   // CFinfo << "Inner nb faces [" << nb_inner_faces << "]" << CFendl;
@@ -324,7 +287,7 @@ void FaceCellConnectivity::build_connectivity()
         if ( is_not_null(elem.comp) )
         {
           common::List<bool>& is_bdry_elem = *Handle< common::List<bool> >(elem.comp->get_child("is_bdry"));
-          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || is_bdry_face.get_row(f) ;
+          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || is_bdry_face[f] ;
         }
       }
     }
@@ -0,0 +1,141 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "mesh/FaceMatcher.hpp"
+
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::set_face_sizes(const std::vector<Uint>& face_sizes)
+{
+  const Uint nb_faces = face_sizes.size();
+  m_offsets.resize(nb_faces+1);
+  m_offsets[0] = 0;
+  for (Uint f=0; f<nb_faces; ++f)
+  {
+    cf3_assert(face_sizes[f] > 0);
+    m_offsets[f+1] = m_offsets[f] + face_sizes[f];
+  }
+  m_nodes.resize(m_offsets.back());
+  m_hashes.resize(nb_faces);
+  m_tables.clear();
+  m_partition_shift = 64u;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::match(std::vector<Uint>& first_match)
+{
+  const Uint nb_faces = size();
+  first_match.resize(nb_faces);
+
+  // One partition of the hash table per thread, rounded up to a power of two
+  Uint nb_partitions = 1;
+  m_partition_shift = 64u;
+#ifdef CF3_HAVE_OPENMP
+  while (nb_partitions < static_cast<Uint>(omp_get_max_threads()))
+  {
+    nb_partitions *= 2;
+    --m_partition_shift;
+  }
+#endif
+  m_tables.assign(nb_partitions, std::vector<Uint>());
+
+  // Every thread scans all faces in order, and inserts those of its own partition.
+  // Faces with the same nodes always end up in the same partition, so the first one of them is kept.
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static,1)
+#endif
+  for (int p=0; p<static_cast<int>(nb_partitions); ++p)
+  {
+    Uint nb_partition_faces = 0;
+    for (Uint f=0; f<nb_faces; ++f)
+      if (partition(m_hashes[f]) == static_cast<Uint>(p))
+        ++nb_partition_faces;
+
+    // keep the load factor below one half
+    Uint capacity = 2;
+    while (capacity < 2*nb_partition_faces)
+      capacity *= 2;
+    m_tables[p].assign(capacity, invalid());
+
+    for (Uint f=0; f<nb_faces; ++f)
+      if (partition(m_hashes[f]) == static_cast<Uint>(p))
+        first_match[f] = insert(f);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::insert(const Uint face)
+{
+  const boost::uint64_t face_hash = m_hashes[face];
+  std::vector<Uint>& table = m_tables[partition(face_hash)];
+  const Uint mask = table.size()-1;
+  const Uint* nodes = &m_nodes[m_offsets[face]];
+  const Uint nb_nodes = m_offsets[face+1]-m_offsets[face];
+  for (Uint slot = static_cast<Uint>(face_hash) & mask; ; slot = (slot+1) & mask)
+  {
+    const Uint stored = table[slot];
+    if (stored == invalid())
+    {
+      table[slot] = face;
+      return face;
+    }
+    if (m_hashes[stored] == face_hash && equal(stored, nodes, nb_nodes))
+      return stored;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find_sorted(const Uint* nodes, const Uint nb_nodes) const
+{
+  if (m_tables.empty())
+    return invalid();
+  const boost::uint64_t face_hash = hash(nodes, nodes+nb_nodes);
+  const std::vector<Uint>& table = m_tables[partition(face_hash)];
+  const Uint mask = table.size()-1;
+  for (Uint slot = static_cast<Uint>(face_hash) & mask; ; slot = (slot+1) & mask)
+  {
+    const Uint stored = table[slot];
+    if (stored == invalid())
+      return invalid();
+    if (m_hashes[stored] == face_hash && equal(stored, nodes, nb_nodes))
+      return stored;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+boost::uint64_t FaceMatcher::hash(const Uint* begin, const Uint* end)
+{
+  // FNV-1a over the nodes
+  boost::uint64_t h = 14695981039346656037ULL;
+  for (const Uint* node = begin; node != end; ++node)
+  {
+    h ^= static_cast<boost::uint64_t>(*node);
+    h *= 1099511628211ULL;
+  }
+  // final mixing, so the high bits used for the partition are as good as the low bits used for the slot
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
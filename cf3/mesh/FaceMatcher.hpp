@@ -0,0 +1,135 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_FaceMatcher_hpp
+#define cf3_mesh_FaceMatcher_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "common/Assertions.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Finds faces that consist of the same nodes.
+/// Every face is stored as its sorted tuple of node indices, which is the key
+/// in an open-addressing hash table. The hash table is split in partitions
+/// on the high bits of the hash, so that the partitions can be filled by
+/// different threads while still seeing the faces of a partition in order.
+///
+/// Usage:
+/// - set_face_sizes() with the number of nodes of every face
+/// - set_face() for every face, which may be called concurrently for different faces
+/// - match(), after which find() can be used to look up faces with given nodes
+class Mesh_API FaceMatcher
+{
+public:
+
+  /// Constructor
+  FaceMatcher() : m_partition_shift(64u) {}
+
+  /// Value returned when no matching face exists
+  static Uint invalid() { return math::Consts::uint_max(); }
+
+  /// Allocate storage for the faces
+  /// @param [in] face_sizes  number of nodes of each face
+  void set_face_sizes(const std::vector<Uint>& face_sizes);
+
+  /// @return number of faces
+  Uint size() const { return m_hashes.size(); }
+
+  /// Store the nodes of a face. The size must match the one given in set_face_sizes()
+  /// @note thread-safe when called for different faces
+  template <typename RowT>
+  void set_face(const Uint face, const RowT& nodes)
+  {
+    cf3_assert(face < size());
+    cf3_assert(static_cast<Uint>(nodes.size()) == m_offsets[face+1]-m_offsets[face]);
+    Uint* face_nodes = &m_nodes[m_offsets[face]];
+    std::copy(nodes.begin(), nodes.end(), face_nodes);
+    std::sort(face_nodes, face_nodes+nodes.size());
+    m_hashes[face] = hash(face_nodes, face_nodes+nodes.size());
+  }
+
+  /// Build the hash index, and find for every face the first face with the same nodes.
+  /// Faces are numbered in the order they were given, so the result does not depend on the number of threads.
+  /// @param [out] first_match  for every face, the index of the first face with the same nodes, or the face itself
+  void match(std::vector<Uint>& first_match);
+
+  /// Find the first face with the given nodes, in any order
+  /// @pre match() was called
+  /// @return the face index, or invalid() if no face has these nodes
+  template <typename RowT>
+  Uint find(const RowT& nodes) const
+  {
+    std::vector<Uint> sorted_nodes(nodes.begin(), nodes.end());
+    std::sort(sorted_nodes.begin(), sorted_nodes.end());
+    if (sorted_nodes.empty())
+      return invalid();
+    return find_sorted(&sorted_nodes[0], sorted_nodes.size());
+  }
+
+private:
+
+  /// Hash of a sorted tuple of nodes
+  static boost::uint64_t hash(const Uint* begin, const Uint* end);
+
+  /// Partition of the hash table a hash belongs to
+  Uint partition(const boost::uint64_t hash) const
+  {
+    return m_partition_shift == 64u ? 0u : static_cast<Uint>(hash >> m_partition_shift);
+  }
+
+  /// Check if a stored face has the given sorted nodes
+  bool equal(const Uint face, const Uint* nodes, const Uint nb_nodes) const
+  {
+    return m_offsets[face+1]-m_offsets[face] == nb_nodes && std::equal(nodes, nodes+nb_nodes, &m_nodes[m_offsets[face]]);
+  }
+
+  /// Insert a face in its partition, or return the face it matches
+  Uint insert(const Uint face);
+
+  Uint find_sorted(const Uint* nodes, const Uint nb_nodes) const;
+
+private:
+
+  /// Start of every face in m_nodes
+  std::vector<Uint> m_offsets;
+
+  /// Sorted nodes of all faces, stored contiguously
+  std::vector<Uint> m_nodes;
+
+  /// Hash of every face
+  std::vector<boost::uint64_t> m_hashes;
+
+  /// Hash table partitions, with the face index in every used slot and invalid() in empty slots
+  std::vector< std::vector<Uint> > m_tables;
+
+  /// Bit shift of a hash to get its partition
+  Uint m_partition_shift;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_FaceMatcher_hpp
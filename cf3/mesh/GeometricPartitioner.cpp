@@ -0,0 +1,482 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/BoundingBox.hpp"
+#include "math/Consts.hpp"
+#include "math/Hilbert.hpp"
+
+#include "mesh/GeometricPartitioner.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Space.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+  using namespace common::PE;
+  using namespace math::Consts;
+
+////////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < GeometricPartitioner, MeshTransformer, LibMesh > GeometricPartitioner_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Position of an element on the Hilbert curve. Elements in the same
+/// cell of the curve are ordered by their global index.
+typedef std::pair<boost::uint64_t,Uint> CurveKey;
+
+struct LessCurveKey
+{
+  LessCurveKey(const std::vector<CurveKey>& keys) : m_keys(keys) {}
+  bool operator()(const Uint a, const Uint b) const { return m_keys[a] < m_keys[b]; }
+  const std::vector<CurveKey>& m_keys;
+};
+
+struct Sample
+{
+  CurveKey key;
+  Real weight;
+  bool operator<(const Sample& other) const { return key < other.key; }
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+GeometricPartitioner::GeometricPartitioner ( const std::string& name ) :
+  MeshPartitioner(name),
+  m_dim(0)
+{
+  properties()["brief"] = std::string("Partition a mesh using only the element coordinates");
+  properties()["description"] = std::string(
+    "  Elements are assigned to parts along a Hilbert space-filling curve (hilbert),\n"
+    "  or by recursive coordinate bisection (rcb), balancing the element weights.\n"
+    "  No external partitioning library is needed.\n");
+
+  std::vector<boost::any> methods;
+  methods.push_back(std::string("hilbert"));
+  methods.push_back(std::string("rcb"));
+  options().add("method", std::string("hilbert"))
+      .description("Partitioning method: Hilbert space-filling curve (hilbert) or recursive coordinate bisection (rcb)")
+      .pretty_name("Method")
+      .mark_basic()
+      .restricted_list() = methods;
+
+  options().add("samples_per_part", 32u)
+      .description("Number of samples of the Hilbert curve taken per part to find the cuts between parts. "
+                   "The imbalance is of the order of 1/samples_per_part.")
+      .pretty_name("Samples Per Part");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GeometricPartitioner::build_graph()
+{
+  const Mesh& mesh = *m_mesh;
+  const Field& coordinates = mesh.geometry_fields().coordinates();
+  m_dim = coordinates.row_size();
+
+  m_centroids.clear();
+  m_weights.clear();
+  m_glb_idx.clear();
+  m_entities_idx.clear();
+  m_elem_idx.clear();
+
+  for (Uint entities_idx=0; entities_idx<mesh.elements().size(); ++entities_idx)
+  {
+    const Entities& entities = *mesh.elements()[entities_idx];
+    const Connectivity& connectivity = entities.geometry_space().connectivity();
+    for (Uint elem=0; elem<entities.size(); ++elem)
+    {
+      if (entities.is_ghost(elem))
+        continue;
+
+      const Uint first = m_centroids.size();
+      m_centroids.resize(first+m_dim, 0.);
+      boost_foreach(const Uint node, connectivity[elem])
+        for (Uint d=0; d<m_dim; ++d)
+          m_centroids[first+d] += coordinates[node][d];
+      for (Uint d=0; d<m_dim; ++d)
+        m_centroids[first+d] /= static_cast<Real>(connectivity.row_size());
+
+      m_weights.push_back(element_weight(entities_idx,elem));
+      m_glb_idx.push_back(entities.glb_idx()[elem]);
+      m_entities_idx.push_back(entities_idx);
+      m_elem_idx.push_back(elem);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GeometricPartitioner::partition_graph()
+{
+  const std::string method = options().value<std::string>("method");
+  std::vector<Uint> part(m_weights.size());
+  if (method == "hilbert")
+    partition_hilbert(part);
+  else if (method == "rcb")
+    partition_rcb(part);
+  else
+    throw BadValue(FromHere(), "Method \""+method+"\" is not supported by "+uri().string()+". Choose hilbert or rcb");
+
+  export_elements(part);
+
+  // Report the balance that was reached
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  std::vector<Real> part_weights(nb_parts, 0.);
+  for (Uint obj=0; obj<part.size(); ++obj)
+    part_weights[part[obj]] += m_weights[obj];
+  Comm::instance().all_reduce(PE::plus(), part_weights, part_weights);
+  Real total_weight = 0.;
+  boost_foreach(const Real part_weight, part_weights)
+    total_weight += part_weight;
+  if (total_weight > 0.)
+  {
+    const Real imbalance = *std::max_element(part_weights.begin(), part_weights.end()) * nb_parts / total_weight;
+    CFinfo << "    " << method << " partitioning in " << nb_parts << " parts, imbalance = " << imbalance << CFendl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GeometricPartitioner::partition_hilbert(std::vector<Uint>& part) const
+{
+  Comm& comm = Comm::instance();
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  const Uint nb_obj = m_weights.size();
+
+  // Hilbert curve through the global bounding box of the centroids
+  std::vector<Real> bbox_min(m_dim, real_max());
+  std::vector<Real> bbox_max(m_dim, -real_max());
+  for (Uint obj=0; obj<nb_obj; ++obj)
+  {
+    for (Uint d=0; d<m_dim; ++d)
+    {
+      bbox_min[d] = std::min(bbox_min[d], m_centroids[obj*m_dim+d]);
+      bbox_max[d] = std::max(bbox_max[d], m_centroids[obj*m_dim+d]);
+    }
+  }
+  comm.all_reduce(PE::min(), bbox_min, bbox_min);
+  comm.all_reduce(PE::max(), bbox_max, bbox_max);
+  if (bbox_min[XX] > bbox_max[XX]) // no elements at all
+    return;
+  math::BoundingBox bounding_box(bbox_min, bbox_max);
+  math::Hilbert compute_hilbert_idx(bounding_box, 20);
+
+  std::vector<CurveKey> keys(nb_obj);
+  std::vector<Uint> order(nb_obj);
+  RealVector centroid(m_dim);
+  for (Uint obj=0; obj<nb_obj; ++obj)
+  {
+    for (Uint d=0; d<m_dim; ++d)
+      centroid[d] = m_centroids[obj*m_dim+d];
+    keys[obj] = CurveKey(compute_hilbert_idx(centroid), m_glb_idx[obj]);
+    order[obj] = obj;
+  }
+  std::sort(order.begin(), order.end(), LessCurveKey(keys));
+
+  // Samples at equal weight intervals of the local curve. Every sample carries
+  // the weight of the elements since the previous sample.
+  Real local_weight = 0.;
+  boost_foreach(const Real weight, m_weights)
+    local_weight += weight;
+  const Uint samples_per_part = std::max(1u, options().value<Uint>("samples_per_part"));
+  const Uint nb_samples = std::min(nb_obj, (samples_per_part*nb_parts + comm.size()-1) / comm.size());
+
+  std::vector<boost::uint64_t> sample_curve_idx;
+  std::vector<Uint> sample_glb_idx;
+  std::vector<Real> sample_weights;
+  sample_curve_idx.reserve(nb_samples);
+  sample_glb_idx.reserve(nb_samples);
+  sample_weights.reserve(nb_samples);
+  Real cumulative_weight = 0.;
+  Real sampled_weight = 0.;
+  for (Uint i=0; i<nb_obj && sample_weights.size()<nb_samples; ++i)
+  {
+    cumulative_weight += m_weights[order[i]];
+    const Real next_sample_weight = (sample_weights.size()+1) * local_weight / nb_samples;
+    if (cumulative_weight >= next_sample_weight || i == nb_obj-1)
+    {
+      sample_curve_idx.push_back(keys[order[i]].first);
+      sample_glb_idx.push_back(keys[order[i]].second);
+      sample_weights.push_back(cumulative_weight - sampled_weight);
+      sampled_weight = cumulative_weight;
+    }
+  }
+
+  // All processors get all samples, and compute the same splitters
+  std::vector< std::vector<boost::uint64_t> > all_sample_curve_idx;
+  std::vector< std::vector<Uint> > all_sample_glb_idx;
+  std::vector< std::vector<Real> > all_sample_weights;
+  comm.all_gather(sample_curve_idx, all_sample_curve_idx);
+  comm.all_gather(sample_glb_idx, all_sample_glb_idx);
+  comm.all_gather(sample_weights, all_sample_weights);
+
+  std::vector<Sample> samples;
+  Real total_weight = 0.;
+  for (Uint pid=0; pid<all_sample_weights.size(); ++pid)
+  {
+    for (Uint s=0; s<all_sample_weights[pid].size(); ++s)
+    {
+      Sample sample;
+      sample.key = CurveKey(all_sample_curve_idx[pid][s], all_sample_glb_idx[pid][s]);
+      sample.weight = all_sample_weights[pid][s];
+      samples.push_back(sample);
+      total_weight += sample.weight;
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+
+  // Elements up to and including splitter p-1 belong to the parts before p
+  std::vector<CurveKey> splitters;
+  splitters.reserve(nb_parts-1);
+  cumulative_weight = 0.;
+  boost_foreach(const Sample& sample, samples)
+  {
+    cumulative_weight += sample.weight;
+    while (splitters.size() < nb_parts-1 && cumulative_weight >= (splitters.size()+1) * total_weight / nb_parts)
+      splitters.push_back(sample.key);
+  }
+  while (splitters.size() < nb_parts-1)
+    splitters.push_back(samples.back().key);
+
+  for (Uint obj=0; obj<nb_obj; ++obj)
+    part[obj] = std::lower_bound(splitters.begin(), splitters.end(), keys[obj]) - splitters.begin();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GeometricPartitioner::partition_rcb(std::vector<Uint>& part) const
+{
+  Comm& comm = Comm::instance();
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  const Uint nb_obj = m_weights.size();
+
+  Uint max_glb_idx = 0;
+  boost_foreach(const Uint glb_idx, m_glb_idx)
+    max_glb_idx = std::max(max_glb_idx, glb_idx);
+  comm.all_reduce(PE::max(), &max_glb_idx, 1, &max_glb_idx);
+
+  // Every group is a range of parts [begin,end[ still to be split
+  std::vector<Uint> group(nb_obj, 0);
+  std::vector<Uint> group_begin(1, 0);
+  std::vector<Uint> group_end(1, nb_parts);
+
+  while (true)
+  {
+    const Uint nb_groups = group_begin.size();
+    bool all_split = true;
+    for (Uint g=0; g<nb_groups; ++g)
+      all_split = all_split && (group_end[g]-group_begin[g] == 1);
+    if (all_split)
+      break;
+
+    // Bounding box and weight of every group
+    std::vector<Real> group_min(nb_groups*m_dim, real_max());
+    std::vector<Real> group_max(nb_groups*m_dim, -real_max());
+    std::vector<Real> group_weight(nb_groups, 0.);
+    for (Uint obj=0; obj<nb_obj; ++obj)
+    {
+      const Uint g = group[obj];
+      for (Uint d=0; d<m_dim; ++d)
+      {
+        group_min[g*m_dim+d] = std::min(group_min[g*m_dim+d], m_centroids[obj*m_dim+d]);
+        group_max[g*m_dim+d] = std::max(group_max[g*m_dim+d], m_centroids[obj*m_dim+d]);
+      }
+      group_weight[g] += m_weights[obj];
+    }
+    comm.all_reduce(PE::min(), group_min, group_min);
+    comm.all_reduce(PE::max(), group_max, group_max);
+    comm.all_reduce(PE::plus(), group_weight, group_weight);
+
+    // Cut every group along its longest side, so that the left part gets a weight
+    // proportional to its number of parts. The cut lies in [lo,hi[, with
+    // W(x<lo) < target <= W(x<hi).
+    std::vector<Uint> direction(nb_groups, 0);
+    std::vector<Real> target(nb_groups, 0.);
+    std::vector<Real> lo(nb_groups, 0.);
+    std::vector<Real> hi(nb_groups, 0.);
+    std::vector<Real> tolerance(nb_groups, 0.);
+    for (Uint g=0; g<nb_groups; ++g)
+    {
+      const Uint nb_group_parts = group_end[g]-group_begin[g];
+      if (nb_group_parts == 1 || group_min[g*m_dim] > group_max[g*m_dim])
+        continue;
+      for (Uint d=1; d<m_dim; ++d)
+      {
+        if (group_max[g*m_dim+d]-group_min[g*m_dim+d] > group_max[g*m_dim+direction[g]]-group_min[g*m_dim+direction[g]])
+          direction[g] = d;
+      }
+      const Real min = group_min[g*m_dim+direction[g]];
+      const Real max = group_max[g*m_dim+direction[g]];
+      target[g] = group_weight[g] * (nb_group_parts/2) / nb_group_parts;
+      lo[g] = min;
+      hi[g] = max + std::max(1., std::abs(max));
+      tolerance[g] = 1e-12 * std::max(max-min, std::abs(max));
+    }
+
+    std::vector<Real> mid(nb_groups);
+    std::vector<Real> weight_below(nb_groups);
+    for (Uint iter=0; iter<64; ++iter)
+    {
+      bool converged = true;
+      for (Uint g=0; g<nb_groups; ++g)
+      {
+        mid[g] = 0.5*(lo[g]+hi[g]);
+        converged = converged && (hi[g]-lo[g] <= tolerance[g]);
+      }
+      if (converged)
+        break;
+
+      weight_below.assign(nb_groups, 0.);
+      for (Uint obj=0; obj<nb_obj; ++obj)
+      {
+        const Uint g = group[obj];
+        if (m_centroids[obj*m_dim+direction[g]] < mid[g])
+          weight_below[g] += m_weights[obj];
+      }
+      comm.all_reduce(PE::plus(), weight_below, weight_below);
+
+      for (Uint g=0; g<nb_groups; ++g)
+      {
+        if (hi[g]-lo[g] <= tolerance[g])
+          continue;
+        if (weight_below[g] >= target[g])
+          hi[g] = mid[g];
+        else
+          lo[g] = mid[g];
+      }
+    }
+
+    // Elements in [lo,hi[ have the same coordinate, and are split by global index
+    std::vector<Real> weight_before_tie(nb_groups, 0.);
+    for (Uint obj=0; obj<nb_obj; ++obj)
+    {
+      const Uint g = group[obj];
+      if (m_centroids[obj*m_dim+direction[g]] < lo[g])
+        weight_before_tie[g] += m_weights[obj];
+    }
+    comm.all_reduce(PE::plus(), weight_before_tie, weight_before_tie);
+
+    std::vector<Uint> glb_lo(nb_groups, 0);
+    std::vector<Uint> glb_hi(nb_groups, max_glb_idx+1);
+    std::vector<Uint> glb_mid(nb_groups);
+    while (true)
+    {
+      bool converged = true;
+      for (Uint g=0; g<nb_groups; ++g)
+      {
+        glb_mid[g] = glb_lo[g] + (glb_hi[g]-glb_lo[g])/2;
+        converged = converged && (glb_hi[g]-glb_lo[g] <= 1);
+      }
+      if (converged)
+        break;
+
+      weight_below.assign(nb_groups, 0.);
+      for (Uint obj=0; obj<nb_obj; ++obj)
+      {
+        const Uint g = group[obj];
+        const Real x = m_centroids[obj*m_dim+direction[g]];
+        if (x >= lo[g] && x < hi[g] && m_glb_idx[obj] < glb_mid[g])
+          weight_below[g] += m_weights[obj];
+      }
+      comm.all_reduce(PE::plus(), weight_below, weight_below);
+      for (Uint g=0; g<nb_groups; ++g)
+        weight_below[g] += weight_before_tie[g];
+
+      for (Uint g=0; g<nb_groups; ++g)
+      {
+        if (glb_hi[g]-glb_lo[g] <= 1)
+          continue;
+        if (weight_below[g] >= target[g])
+          glb_hi[g] = glb_mid[g];
+        else
+          glb_lo[g] = glb_mid[g];
+      }
+    }
+
+    // Split the groups in two, keeping groups of one part as they are
+    std::vector<Uint> left(nb_groups);
+    std::vector<Uint> right(nb_groups);
+    std::vector<Uint> new_group_begin;
+    std::vector<Uint> new_group_end;
+    for (Uint g=0; g<nb_groups; ++g)
+    {
+      const Uint split = group_begin[g] + (group_end[g]-group_begin[g])/2;
+      left[g] = new_group_begin.size();
+      if (group_end[g]-group_begin[g] == 1)
+      {
+        right[g] = left[g];
+        new_group_begin.push_back(group_begin[g]);
+        new_group_end.push_back(group_end[g]);
+        continue;
+      }
+      right[g] = left[g]+1;
+      new_group_begin.push_back(group_begin[g]);  new_group_end.push_back(split);
+      new_group_begin.push_back(split);           new_group_end.push_back(group_end[g]);
+    }
+    for (Uint obj=0; obj<nb_obj; ++obj)
+    {
+      const Uint g = group[obj];
+      const Real x = m_centroids[obj*m_dim+direction[g]];
+      const bool is_left = x < lo[g] || (x < hi[g] && m_glb_idx[obj] < glb_hi[g]);
+      group[obj] = is_left ? left[g] : right[g];
+    }
+    group_begin.swap(new_group_begin);
+    group_end.swap(new_group_end);
+  }
+
+  for (Uint obj=0; obj<nb_obj; ++obj)
+    part[obj] = group_begin[group[obj]];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void GeometricPartitioner::export_elements(const std::vector<Uint>& part)
+{
+  const Mesh& mesh = *m_mesh;
+  const Uint rank = Comm::instance().rank();
+
+  boost_foreach(std::vector< std::vector<Uint> >& export_to_part, m_elements_to_export)
+    boost_foreach(std::vector<Uint>& export_elems, export_to_part)
+      export_elems.clear();
+
+  m_part_of_element.resize(mesh.elements().size());
+  for (Uint entities_idx=0; entities_idx<mesh.elements().size(); ++entities_idx)
+  {
+    const Entities& entities = *mesh.elements()[entities_idx];
+    m_part_of_element[entities_idx].assign(entities.rank().array().begin(), entities.rank().array().end());
+  }
+
+  for (Uint obj=0; obj<part.size(); ++obj)
+  {
+    m_part_of_element[m_entities_idx[obj]][m_elem_idx[obj]] = part[obj];
+    if (part[obj] != rank)
+      m_elements_to_export[part[obj]][m_entities_idx[obj]].push_back(m_elem_idx[obj]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
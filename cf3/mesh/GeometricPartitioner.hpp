@@ -0,0 +1,99 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_GeometricPartitioner_hpp
+#define cf3_mesh_GeometricPartitioner_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshPartitioner.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Mesh partitioner that only uses the coordinates of the element centroids,
+/// and therefore needs no external partitioning library.
+///
+/// The sum of the element weights (see MeshPartitioner::set_element_weights())
+/// is balanced between the parts. Two methods are available:
+/// - "hilbert": the elements are ordered along a Hilbert space-filling curve through
+///   the global bounding box, and the curve is cut in nb_parts pieces of equal weight.
+///   The cuts are found with a parallel sample sort: every processor contributes
+///   weighted samples of its locally sorted elements, and all processors compute the
+///   same splitters from the gathered samples.
+/// - "rcb": recursive coordinate bisection. The parts are recursively split in two
+///   along the longest side of their bounding box, at the weighted median found by
+///   bisection. All groups of one level are split together, so that only a few
+///   small reductions are needed per level.
+///
+/// No graph is built, so partitioning takes a few collective operations even for
+/// many parts. The edge-cut is larger than with a graph partitioner (zoltan or ptscotch).
+/// @pre Part p is migrated to processor p, so nb_parts must equal the number of processors.
+class Mesh_API GeometricPartitioner : public MeshPartitioner {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  GeometricPartitioner ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~GeometricPartitioner() {}
+
+  /// Get the class name
+  static std::string type_name () { return "GeometricPartitioner"; }
+
+  /// Partitioning functions
+
+  /// Compute the centroid and weight of every owned element
+  virtual void build_graph();
+
+  virtual void partition_graph();
+
+  /// @return the part of every element, part_of_element[entities_idx][elem_idx],
+  ///         as computed by the last partition_graph(). Ghost elements keep the rank of their owner.
+  const std::vector< std::vector<Uint> >& part_of_element() const { return m_part_of_element; }
+
+private: // functions
+
+  void partition_hilbert(std::vector<Uint>& part) const;
+
+  void partition_rcb(std::vector<Uint>& part) const;
+
+  /// Fill the exported elements from the part of every owned element
+  void export_elements(const std::vector<Uint>& part);
+
+private: // data
+
+  /// Dimension of the coordinates
+  Uint m_dim;
+
+  /// Centroids of the owned elements, m_dim values per element
+  std::vector<Real> m_centroids;
+
+  /// Weights of the owned elements
+  std::vector<Real> m_weights;
+
+  /// Global indices of the owned elements, to order elements with equal coordinates
+  std::vector<Uint> m_glb_idx;
+
+  /// Location of the owned elements: index in Mesh::elements() and index in the Entities
+  std::vector<Uint> m_entities_idx;
+  std::vector<Uint> m_elem_idx;
+
+  std::vector< std::vector<Uint> > m_part_of_element;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_GeometricPartitioner_hpp
@@ -0,0 +1,79 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Table.hpp"
+
+#include "mesh/InterpolationMatrix.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+InterpolationMatrix::InterpolationMatrix() : m_offsets(1,0u)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationMatrix::clear()
+{
+  m_offsets.assign(1,0u);
+  m_points.clear();
+  m_weights.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationMatrix::reserve(const Uint nb_rows, const Uint nb_entries)
+{
+  m_offsets.reserve(nb_rows+1);
+  m_points.reserve(nb_entries);
+  m_weights.reserve(nb_entries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationMatrix::add_row(const Uint* points, const Real* weights, const Uint nb_entries)
+{
+  m_points.insert(m_points.end(),points,points+nb_entries);
+  m_weights.insert(m_weights.end(),weights,weights+nb_entries);
+  m_offsets.push_back(m_points.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void InterpolationMatrix::multiply(const common::Table<Real>& source, const std::vector<Uint>& source_vars, std::vector<Real>& interpolated) const
+{
+  const Uint nb_vars = source_vars.size();
+  const int nb_rows = static_cast<int>(this->nb_rows());
+  interpolated.resize(nb_rows*nb_vars);
+  if (nb_vars == 0)
+    return;
+
+  // Every row writes its own values, so the rows are independent
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (int r=0; r<nb_rows; ++r)
+  {
+    Real* row_values = &interpolated[r*nb_vars];
+    for (Uint v=0; v<nb_vars; ++v)
+      row_values[v] = 0.;
+    for (Uint s=m_offsets[r]; s<m_offsets[r+1]; ++s)
+    {
+      cf3_assert(m_points[s]<source.size());
+      common::Table<Real>::ConstRow source_row = source[m_points[s]];
+      for (Uint v=0; v<nb_vars; ++v)
+        row_values[v] += source_row[ source_vars[v] ] * m_weights[s];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,72 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_InterpolationMatrix_hpp
+#define cf3_mesh_InterpolationMatrix_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "common/Table_fwd.hpp"
+
+#include "mesh/LibMesh.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Sparse matrix of interpolation weights, in compressed row storage
+///
+/// Row r interpolates from the source rows points()[offsets()[r]] to points()[offsets()[r+1]-1]
+/// with the matching weights(). Once built, the same interpolation is applied
+/// to new source values without locating the points again.
+class Mesh_API InterpolationMatrix
+{
+public: // functions
+
+  /// Constructor, for an empty matrix
+  InterpolationMatrix();
+
+  /// Remove all rows
+  void clear();
+
+  /// Reserve memory for a number of rows and entries
+  void reserve(const Uint nb_rows, const Uint nb_entries);
+
+  /// Append a row with nb_entries source points and weights
+  void add_row(const Uint* points, const Real* weights, const Uint nb_entries);
+
+  Uint nb_rows() const { return m_offsets.size()-1; }
+
+  Uint nb_entries() const { return m_points.size(); }
+
+  const std::vector<Uint>& offsets() const { return m_offsets; }
+  const std::vector<Uint>& points() const { return m_points; }
+  const std::vector<Real>& weights() const { return m_weights; }
+
+  /// @brief Interpolate variables of a source table for all rows, in parallel
+  /// @param [in]  source        Table to interpolate from
+  /// @param [in]  source_vars   Variable indices of source to interpolate
+  /// @param [out] interpolated  Interpolated values, source_vars.size() for each row
+  void multiply(const common::Table<Real>& source, const std::vector<Uint>& source_vars, std::vector<Real>& interpolated) const;
+
+private: // data
+
+  std::vector<Uint> m_offsets;
+  std::vector<Uint> m_points;
+  std::vector<Real> m_weights;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_InterpolationMatrix_hpp
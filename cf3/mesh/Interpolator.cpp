@@ -38,7 +38,8 @@ common::ComponentBuilder<Interpolator,AInterpolator,LibMesh> Interpolator_builde
 Interpolator::Interpolator(const std::string &name) : AInterpolator(name)
 {
   options().add("store", false)
-      .description("Flag to store weights and stencils used for faster interpolation in the future")
+      .description("Flag to store the interpolation weights as a sparse matrix, reused for faster interpolation "
+                   "in the future until the source or target mesh changes")
       .pretty_name("Store");
 
   m_point_interpolator = Handle<APointInterpolator>(create_component<PointInterpolator>("point_interpolator"));
@@ -88,16 +89,10 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
 
   m_proc.clear();
   m_expect_recv.clear();
-  m_stored_element.clear();
-  m_stored_stencil.clear();
-  m_stored_source_field_points.clear();
-  m_stored_source_field_weights.clear();
+  m_stored_matrix.clear();
 
   m_expect_recv.resize(PE::Comm::instance().size());
-  m_stored_element.resize(PE::Comm::instance().size());
-  m_stored_stencil.resize(PE::Comm::instance().size());
-  m_stored_source_field_points.resize(PE::Comm::instance().size());
-  m_stored_source_field_weights.resize(PE::Comm::instance().size());
+  m_stored_matrix.resize(PE::Comm::instance().size());
 
 
   // Now find missing on other procs.
@@ -129,46 +124,24 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
 
     // Find interpolated
 
-    m_stored_element[pid_recv_coords].clear();
-    m_stored_stencil[pid_recv_coords].clear();
-    m_stored_source_field_points[pid_recv_coords].clear();
-    m_stored_source_field_weights[pid_recv_coords].clear();
-
-    m_stored_element[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_stencil[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_source_field_points[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_source_field_weights[pid_recv_coords].reserve(nb_received_coords);
-
-    std::vector<Uint> send_found_coords;  send_found_coords.reserve(nb_received_coords);
-
-    Uint dim = target_coords.row_size();
-    RealVector t_point(dim);
-    SpaceElem element;
-    std::vector<SpaceElem> stencil;
+    std::vector<Uint> offsets;
     std::vector<Uint> points;
     std::vector<Real> weights;
+    m_point_interpolator->compute_storage(received_coords,dim,offsets,points,weights);
 
+    // Keep only the rows of the coordinates found, which are the ones to interpolate
+    std::vector<Uint> send_found_coords;  send_found_coords.reserve(nb_received_coords);
+    InterpolationMatrix& matrix = m_stored_matrix[pid_recv_coords];
+    matrix.clear();
+    matrix.reserve(nb_received_coords,points.size());
     for (Uint t=0; t<nb_received_coords; ++t)
     {
-      t_point = RealVector::MapType(&received_coords[t*dim],dim);
-      bool interpolation_possible_on_this_proc =
-          m_point_interpolator->compute_storage(t_point,
-                                                element,
-                                                stencil,
-                                                points,
-                                                weights);
-
-      if (interpolation_possible_on_this_proc)
+      if (offsets[t+1] > offsets[t])
       {
-        m_stored_element[pid_recv_coords].push_back(element);
-        m_stored_stencil[pid_recv_coords].push_back(stencil);
-        m_stored_source_field_points[pid_recv_coords].push_back(points);
-        m_stored_source_field_weights[pid_recv_coords].push_back(weights);
-
         // mark found
         send_found_coords.push_back(t);
+        matrix.add_row(&points[offsets[t]],&weights[offsets[t]],offsets[t+1]-offsets[t]);
       }
-
     }
 
     std::vector<Uint> recv_found_coords;
@@ -213,32 +186,12 @@ void Interpolator::stored_interpolation(const Field& source_field, Table<Real>&
     const Uint pid_recv_interpolated = (PE::Comm::instance().rank() + pid) %
                                         PE::Comm::instance().size();
 
-    // number of points to be interpolated
-    const Uint nb_points = m_stored_element[pid_send_interpolated].size();
-
     // number of variables for each point to be interpolated
     const Uint nb_vars = m_source_vars.size();
 
-    // storage for interpolated variables, which will be sent to the pid that reqests it (pid_recv_interpolated)
-    std::vector<Real> interpolated; interpolated.reserve(nb_points*nb_vars);
-
-    // Interpolation points and weights
-    const std::vector< std::vector<Uint> >& s_points  = m_stored_source_field_points[pid_send_interpolated];
-    const std::vector< std::vector<Real> >& s_weights = m_stored_source_field_weights[pid_send_interpolated];
-
-    // Do interpolation
-    for (Uint t=0; t<nb_points; ++t)
-    {
-      for (Uint v=0; v<nb_vars; ++v)
-      {
-        interpolated.push_back(0.);
-        for (Uint s=0; s<s_points[t].size(); ++s)
-        {
-          cf3_assert(s_points[t][s]<source_field.size());
-          interpolated.back() += source_field[ s_points[t][s] ][ m_source_vars[v] ] * s_weights[t][s];
-        }
-      }
-    }
+    // Do interpolation, as a sparse matrix-vector product
+    std::vector<Real> interpolated;
+    m_stored_matrix[pid_send_interpolated].multiply(source_field,m_source_vars,interpolated);
 
     // Send/Receive interpolated variables
     std::vector<Real> recv_interpolated;
@@ -318,22 +271,24 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
     // storage for interpolated variables, which will be sent to the pid that reqests it (pid_recv_interpolated)
     std::vector<Real> send_interpolated; send_interpolated.reserve(nb_received_coords*nb_vars);
 
-    Uint dim = target_coords.row_size();
-    RealVector t_point(dim);
-    RealVector t_val(source_field.row_size());
+    std::vector<Uint> offsets;
+    std::vector<Uint> points;
+    std::vector<Real> weights;
+    m_point_interpolator->compute_storage(received_coords,dim,offsets,points,weights);
 
     for (Uint t=0; t<nb_received_coords; ++t)
     {
-      t_point = RealVector::MapType(&received_coords[t*dim],dim);
-      bool interpolation_possible_on_this_proc =
-          m_point_interpolator->interpolate(source_field,t_point,t_val);
-      if (interpolation_possible_on_this_proc)
+      if (offsets[t+1] > offsets[t])
       {
         // mark found
         send_found_coords.push_back(t);
 
         for (Uint v=0; v<nb_vars; ++v)
-          send_interpolated.push_back(t_val[ m_source_vars[v] ] );
+        {
+          send_interpolated.push_back(0.);
+          for (Uint s=offsets[t]; s<offsets[t+1]; ++s)
+            send_interpolated.back() += source_field[ points[s] ][ m_source_vars[v] ] * weights[s];
+        }
       }
     }
 
@@ -365,6 +320,19 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+void Interpolator::mesh_modified(const URI& mesh_uri)
+{
+  if ( is_part_of_mesh(m_source_dict_uri,mesh_uri) || is_part_of_mesh(m_target_uri,mesh_uri) )
+  {
+    // Storage will be recomputed on the next interpolation
+    m_source_dict_uri = URI();
+    m_target_uri = URI();
+    m_stored_matrix.clear();
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void Interpolator::interpolate_vars(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target, const std::vector<Uint>& source_vars, const std::vector<Uint>& target_vars)
@@ -378,11 +346,13 @@ void Interpolator::interpolate_vars(const Field& source_field, const common::Tab
   if (options().value<bool>("store"))
   {
     if (    source_field.dict().uri().string() != m_source_dict_uri.string()
+         || target_coords.uri().string() != m_target_uri.string()
          || m_source_dict_size != source_field.size()
          || m_target_size != target.size() )
     {
       store(source_field.dict(),target_coords);
       m_source_dict_uri = source_field.dict().uri();
+      m_target_uri = target_coords.uri();
       m_source_dict_size = source_field.size();
       m_target_size = target.size();
     }
@@ -11,6 +11,7 @@
 
 #include "mesh/AInterpolator.hpp"
 #include "mesh/Space.hpp"
+#include "mesh/InterpolationMatrix.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -54,6 +55,11 @@ public: // functions
   /// @param [in]  target_vars    Variables in target_field to interpolate to
   virtual void interpolate_vars(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target, const std::vector<Uint>& source_vars, const std::vector<Uint>& target_vars);
 
+protected: // functions
+
+  /// Discard the stored interpolation if the source or target is part of the modified mesh
+  virtual void mesh_modified(const common::URI& mesh_uri);
+
 private: // functions
 
   void store(const Dictionary& dict, const common::Table<Real>& target_coords);
@@ -72,6 +78,7 @@ private: // data
   Handle<Dictionary const> m_dict;
   Uint m_source_dict_size;
   common::URI m_source_dict_uri;
+  common::URI m_target_uri;
   Uint m_target_size;
 
   Handle<common::Table<Real> const> m_table;
@@ -79,10 +86,8 @@ private: // data
   // Values for each processor
   std::vector< int                                   > m_proc;
   std::vector< std::vector< Uint                   > > m_expect_recv;
-  std::vector< std::vector< SpaceElem              > > m_stored_element;
-  std::vector< std::vector< std::vector<SpaceElem> > > m_stored_stencil;
-  std::vector< std::vector< std::vector<Uint>      > > m_stored_source_field_points;
-  std::vector< std::vector< std::vector<Real>      > > m_stored_source_field_weights;
+  // Interpolation of the coordinates that were found, for each processor
+  std::vector< InterpolationMatrix                   > m_stored_matrix;
 
   // store variable indices in table rows
   std::vector<Uint> m_source_vars;
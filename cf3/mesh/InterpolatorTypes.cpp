@@ -9,6 +9,7 @@
 #include "mesh/PointInterpolatorT.hpp"
 #include "mesh/Interpolator.hpp"
 #include "mesh/ElementFinderOcttree.hpp"
+#include "mesh/ElementFinderBVH.hpp"
 #include "mesh/StencilComputerOcttree.hpp"
 #include "mesh/StencilComputerRings.hpp"
 #include "mesh/PseudoLaplacianLinearInterpolation.hpp"
@@ -45,5 +46,25 @@ ComponentBuilder< ShapeFunctionInterpolator , AInterpolator, LibMesh>
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Same interpolators, finding the elements with a bounding volume hierarchy instead of an octtree
+
+typedef PointInterpolatorT<ElementFinderBVH,StencilComputerRings,PseudoLaplacianLinearInterpolation> PseudoLaplacianLinearBVHPointInterpolator;
+ComponentBuilder< PseudoLaplacianLinearBVHPointInterpolator , APointInterpolator, LibMesh>
+  PseudoLaplacianLinearBVHPointInterpolator_builder(LibMesh::library_namespace()+".PseudoLaplacianLinearBVHPointInterpolator");
+
+typedef InterpolatorT<PseudoLaplacianLinearBVHPointInterpolator> PseudoLaplacianLinearBVHInterpolator;
+ComponentBuilder< PseudoLaplacianLinearBVHInterpolator , AInterpolator, LibMesh>
+  PseudoLaplacianLinearBVHInterpolator_builder(LibMesh::library_namespace()+".PseudoLaplacianLinearBVHInterpolator");
+
+typedef PointInterpolatorT<ElementFinderBVH,StencilComputerOneCell,ShapeFunctionInterpolation> ShapeFunctionBVHPointInterpolator;
+ComponentBuilder< ShapeFunctionBVHPointInterpolator , APointInterpolator, LibMesh>
+  ShapeFunctionBVHPointInterpolator_builder(LibMesh::library_namespace()+".ShapeFunctionBVHPointInterpolator");
+
+typedef InterpolatorT<ShapeFunctionBVHPointInterpolator> ShapeFunctionBVHInterpolator;
+ComponentBuilder< ShapeFunctionBVHInterpolator , AInterpolator, LibMesh>
+  ShapeFunctionBVHInterpolator_builder(LibMesh::library_namespace()+".ShapeFunctionBVHInterpolator");
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
@@ -82,6 +82,7 @@ void LoadMesh::update_list_of_available_readers()
     ("cf3.mesh.CGNS.Reader")
   #endif
     ("cf3.mesh.gmsh.Reader")
+    ("cf3.mesh.native.Reader")
     ("cf3.mesh.neu.Reader");
 
   boost_foreach(const std::string& reader_name, known_readers)
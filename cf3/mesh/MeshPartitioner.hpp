@@ -15,6 +15,7 @@
 #include "common/Map.hpp"
 #include "common/Foreach.hpp"
 #include "common/DynTable.hpp"
+#include "common/CSRTable.hpp"
 #include "common/Table.hpp"
 #include "common/List.hpp"
 
@@ -107,6 +108,21 @@ public: // functions
 
   const std::vector<std::vector<std::vector<Uint> > >& exported_elements() { return m_elements_to_export; }
 
+  /// Set the computational weight of every element, which partitioners balance between the parts
+  /// @param [in] weights  weights[entities_idx][elem_idx], with entities_idx the index in Mesh::elements().
+  ///                      An empty vector means all elements have unit weight.
+  void set_element_weights(const std::vector< std::vector<Real> >& weights) { m_element_weights = weights; }
+
+  /// @return the weight of an element, 1 if no weights were set
+  Real element_weight(const Uint entities_idx, const Uint elem_idx) const
+  {
+    if (m_element_weights.empty())
+      return 1.;
+    cf3_assert(entities_idx < m_element_weights.size());
+    cf3_assert(elem_idx < m_element_weights[entities_idx].size());
+    return m_element_weights[entities_idx][elem_idx];
+  }
+
 protected: // functions
 
   bool is_node(const Uint glb_obj) const
@@ -144,6 +160,9 @@ protected: // data
   /// elements_to_export[part][elements_comp_idx][loc_elem_idx]
   std::vector< std::vector< std::vector<Uint> > > m_elements_to_export;
 
+  /// element_weights[elements_comp_idx][loc_elem_idx]
+  std::vector< std::vector<Real> >                m_element_weights;
+
 private: // data
 
   Uint m_base;
@@ -204,7 +223,7 @@ Uint MeshPartitioner::nb_connected_objects_in_part(const Uint part, VectorT& nb_
 
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CSRTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         nb_connections_per_obj[idx] = node_to_glb_elm.row_size(loc_idx);
       }
       else if (Handle< Elements > elements = Handle<Elements>(comp))
@@ -237,7 +256,7 @@ void MeshPartitioner::list_of_connected_objects_in_part(const Uint part, VectorT
       boost::tie(comp,loc_idx) = m_lookup->location(loc_obj);
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CSRTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         boost_foreach (const Uint glb_elm , node_to_glb_elm[loc_idx])
           connected_objects[idx++] = glb_elm;
       }
@@ -273,7 +292,7 @@ void MeshPartitioner::list_of_connected_procs_in_part(const Uint part, VectorT&
       boost::tie(comp,loc_idx) = m_lookup->location(loc_obj);
       if (Handle< Dictionary > nodes = Handle<Dictionary>(comp))
       {
-        const common::DynTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
+        const common::CSRTable<Uint>& node_to_glb_elm = nodes->glb_elem_connectivity();
         boost_foreach (const Uint glb_elm , node_to_glb_elm[loc_idx])
           connected_procs[idx++] = part_of_obj(glb_elm); /// @todo should be proc of obj, not part!!!
       }
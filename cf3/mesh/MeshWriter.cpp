@@ -49,6 +49,12 @@ MeshWriter::MeshWriter ( const std::string& name  ) :
       .link_to(&m_mesh)
       .mark_basic();
 
+  // Metadata to write, to use a copy instead of the metadata of the mesh
+  options().add("metadata", m_metadata)
+      .description("Metadata such as iteration and time to write. Default is the metadata of the mesh")
+      .pretty_name("Metadata")
+      .link_to(&m_metadata);
+
   // Output file path
   m_file_path = URI("mesh", URI::Scheme::FILE);
   options().add("file", m_file_path)
@@ -148,6 +154,13 @@ MeshWriter::~MeshWriter()
 
 //////////////////////////////////////////////////////////////////////////////
 
+const MeshMetadata& MeshWriter::metadata() const
+{
+  return is_not_null(m_metadata) ? *m_metadata : m_mesh->metadata();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void MeshWriter::execute()
 {
   // Check if the mesh was configured
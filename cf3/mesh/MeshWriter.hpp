@@ -17,6 +17,7 @@ namespace common {  class URI;  }
 namespace mesh {
 
   class Mesh;
+  class MeshMetadata;
   class Region;
   class Field;
   class Entities;
@@ -55,6 +56,12 @@ public: // functions
 
   virtual void write_from_to(const Mesh& mesh, const common::URI& file_path);
 
+protected: // functions
+
+  /// Metadata to write, such as the iteration and time: the configured "metadata",
+  /// or else the metadata of the mesh
+  const MeshMetadata& metadata() const;
+
 private: // functions
 
   virtual void write() {};
@@ -87,6 +94,7 @@ protected:
   RegionFilter                         m_region_filter;      ///< Filters regions
   EntitiesFilter                       m_entities_filter;    ///< Filters entities
   Handle<Mesh const>                   m_mesh;               ///< Handle to configured mesh
+  Handle<MeshMetadata const>           m_metadata;           ///< Handle to configured metadata, if not the one of the mesh
   std::vector<Handle<Field const> >    m_fields;             ///< Handle to configured fields
   std::vector<Handle<Region const> >   m_regions;            ///< Handle to configured regions
   std::vector<Handle<Entities const> > m_filtered_entities;  ///< Handle to selected entities
@@ -9,9 +9,13 @@
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
 #include "common/Foreach.hpp"
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
+#include "common/Signal.hpp"
+#include "common/XML/SignalOptions.hpp"
 #include "common/FindComponents.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
@@ -33,6 +37,7 @@
 #include "mesh/Dictionary.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/Tags.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -68,6 +73,29 @@ Octtree::Octtree( const std::string& name )
       .description("The number of cells in each direction of the comb. "
                         "Takes precedence over \"Number of Elements per Octtree Cell\". ")
       .pretty_name("Number of Cells");
+
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_loaded(), this, &Octtree::on_mesh_changed_event);
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &Octtree::on_mesh_changed_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Octtree::on_mesh_changed_event(SignalArgs& args)
+{
+  if (is_null(m_mesh))
+    return;
+
+  SignalOptions options(args);
+  if (options.value<URI>("mesh_uri").path() == m_mesh->uri().path())
+    clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Octtree::clear()
+{
+  m_octtree.resize(boost::extents[0][0][0]);
+  m_elements_pool.clear();
 }
 
 
@@ -119,7 +147,8 @@ void Octtree::create_octtree()
   }
   CFdebug << "V = " << V << CFendl;
 
-  // initialize the octtree
+  // initialize the octtree, without keeping elements of a previous creation
+  clear();
   m_octtree.resize(boost::extents[std::max(Uint(1),m_N[XX])][std::max(Uint(1),m_N[YY])][std::max(Uint(1),m_N[ZZ])]);
 
   RealVector centroid(m_dim);
@@ -73,8 +73,17 @@ public: // functions
 
   bool is_created() const { return m_octtree.num_elements()!=0; }
 
+  /// Remove all elements from the octtree, so it is created again on next use
+  void clear();
+
   const Uint dimension() { return m_dim; }
 
+private: // functions
+
+  /// Clears the octtree when its mesh is loaded or changed,
+  /// as it holds the elements sorted by their location
+  void on_mesh_changed_event(common::SignalArgs& args);
+
 private: // data
 
   ArrayT m_octtree;
@@ -4,10 +4,14 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
 #include "math/MatrixTypesConversion.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/Hilbert.hpp"
 
 #include "common/FindComponents.hpp"
 #include "common/Builder.hpp"
@@ -21,10 +25,7 @@
 #include "mesh/ElementFinder.hpp"
 #include "mesh/StencilComputer.hpp"
 #include "mesh/InterpolationFunction.hpp"
-
-
-
-#include "common/OptionList.hpp"
+#include "mesh/Dictionary.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -58,6 +59,119 @@ void APointInterpolator::configure_dict()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool APointInterpolator::compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights)
+{
+  if (!compute_stencil(coordinate,element,stencil))
+    return false;
+  compute_weights(coordinate,stencil,points,weights);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void APointInterpolator::compute_storage(const std::vector<Real>& coordinates, const Uint dim, std::vector<Uint>& offsets, std::vector<Uint>& points, std::vector<Real>& weights)
+{
+  const Uint nb_coords = dim ? coordinates.size()/dim : 0u;
+
+  // 1) Order the coordinates along a Hilbert space-filling curve, so that
+  //    neighbouring coordinates are located one after the other
+  std::vector< std::pair<boost::uint64_t,Uint> > order(nb_coords);
+  math::BoundingBox bounding_box;
+  RealVector point(dim);
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    for (Uint d=0; d<dim; ++d)
+      point[d] = coordinates[t*dim+d];
+    bounding_box.extend(point);
+  }
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    // Hilbert keeps state during the computation of a key, so each thread needs its own
+    math::Hilbert compute_hilbert_idx(bounding_box, 20);
+    RealVector t_point(dim);
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (int t=0; t<static_cast<int>(nb_coords); ++t)
+    {
+      for (Uint d=0; d<dim; ++d)
+        t_point[d] = coordinates[t*dim+d];
+      order[t] = std::make_pair(nb_coords > 1 ? compute_hilbert_idx(t_point) : 0u, static_cast<Uint>(t));
+    }
+  }
+  std::sort(order.begin(),order.end());
+
+  // 2) Find the elements and stencils. The element finders and stencil computers
+  //    cache their last search, so this is done in order on one thread.
+  std::vector<bool> found(nb_coords,false);
+  std::vector< std::vector<SpaceElem> > stencils(nb_coords);
+  SpaceElem element;
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    const Uint t = order[i].second;
+    for (Uint d=0; d<dim; ++d)
+      point[d] = coordinates[t*dim+d];
+    found[t] = compute_stencil(point,element,stencils[t]);
+  }
+
+  // 3) Compute the weights in parallel. The coordinates field is created on first
+  //    access, which must not happen from within the threads.
+  if (is_not_null(m_dict))
+    m_dict->coordinates();
+  std::vector< std::vector<Uint> > t_points(nb_coords);
+  std::vector< std::vector<Real> > t_weights(nb_coords);
+  std::string error;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel
+#endif
+  {
+    RealVector t_point(dim);
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp for schedule(dynamic,64)
+#endif
+    for (int i=0; i<static_cast<int>(nb_coords); ++i)
+    {
+      const Uint t = order[i].second;
+      if (!found[t])
+        continue;
+      for (Uint d=0; d<dim; ++d)
+        t_point[d] = coordinates[t*dim+d];
+      try
+      {
+        compute_weights(t_point,stencils[t],t_points[t],t_weights[t]);
+      }
+      catch(std::exception& e)
+      {
+#ifdef CF3_HAVE_OPENMP
+        #pragma omp critical
+#endif
+        if (error.empty())
+          error = e.what();
+      }
+    }
+  }
+  if (!error.empty())
+    throw SetupError(FromHere(), "Could not compute interpolation weights in "+uri().string()+": "+error);
+
+  // 4) Gather the points and weights in the original order
+  offsets.resize(nb_coords+1);
+  offsets[0] = 0;
+  for (Uint t=0; t<nb_coords; ++t)
+    offsets[t+1] = offsets[t] + t_points[t].size();
+  points.resize(offsets[nb_coords]);
+  weights.resize(offsets[nb_coords]);
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    cf3_assert(t_points[t].size() == t_weights[t].size());
+    std::copy(t_points[t].begin(),t_points[t].end(),points.begin()+offsets[t]);
+    std::copy(t_weights[t].begin(),t_weights[t].end(),weights.begin()+offsets[t]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 cf3::common::ComponentBuilder<PointInterpolator,APointInterpolator,LibMesh> PointInterpolator_builder;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,7 +241,7 @@ void PointInterpolator::configure_interpolator_function()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool PointInterpolator::compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights)
+bool PointInterpolator::compute_stencil(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil)
 {
   // 1) Find the element this coordinate falls in
   cf3_assert(m_element_finder);
@@ -143,13 +257,18 @@ bool PointInterpolator::compute_storage(const RealVector& coordinate, SpaceElem&
   stencil.clear();
   m_stencil_computer->compute_stencil(element,stencil);
 
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PointInterpolator::compute_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights)
+{
   // 3) Find interpolation
   cf3_assert(m_interpolator_function);
   points.clear();
   weights.clear();
   m_interpolator_function->compute_interpolation_weights(coordinate,stencil,points,weights);
-
-  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
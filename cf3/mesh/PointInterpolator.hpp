@@ -53,7 +53,30 @@ public: // functions
   template<typename VectorT>
   bool interpolate(const Field& field, const RealVector& coordinate, VectorT& interpolated_value);
 
-  virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights) = 0;
+  /// @brief Compute the element, stencil, points and weights to interpolate one coordinate
+  /// @return if the coordinate was found in an element
+  bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
+
+  /// @brief Compute the points and weights to interpolate a batch of coordinates
+  ///
+  /// The coordinates are located in the order of a Hilbert space-filling curve, so that
+  /// consecutive searches reuse the same part of the element finder, after which the
+  /// weights are computed in parallel.
+  /// @param [in]  coordinates  coordinates to interpolate to, dim values for each coordinate
+  /// @param [in]  dim          dimension of the coordinates
+  /// @param [out] offsets      points and weights of coordinate t are in [offsets[t],offsets[t+1]),
+  ///                           an empty range if the coordinate was not found
+  /// @param [out] points       source field points of all coordinates, in the order of the coordinates
+  /// @param [out] weights      weights matching points
+  void compute_storage(const std::vector<Real>& coordinates, const Uint dim, std::vector<Uint>& offsets, std::vector<Uint>& points, std::vector<Real>& weights);
+
+  /// @brief Find the element a coordinate falls in, and the stencil to interpolate from
+  /// @return if the coordinate was found in an element
+  virtual bool compute_stencil(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil) = 0;
+
+  /// @brief Compute the points and weights to interpolate a coordinate from a stencil
+  /// @note This is called concurrently from multiple threads
+  virtual void compute_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights) = 0;
 
 private: // functions
 
@@ -117,7 +140,9 @@ public: // functions
 
   // --------- Direct access ---------
 
-  virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
+  virtual bool compute_stencil(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil);
+
+  virtual void compute_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
 
 private: // functions
 
@@ -38,7 +38,9 @@ public: // functions
 
   // --------- Direct access ---------
 
-  virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
+  virtual bool compute_stencil(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil);
+
+  virtual void compute_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
 
 private: // functions
 
@@ -90,7 +92,7 @@ void PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::co
 ////////////////////////////////////////////////////////////////////////////////
 
 template< typename ELEMENTFINDER, typename STENCILCOMPUTER, typename INTERPOLATIONFUNCTION>
-bool PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights)
+bool PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::compute_stencil(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil)
 {
   // 1) Find the element this coordinate falls in
   const bool element_found = m_element_finder->find_element(coordinate,element);
@@ -104,12 +106,18 @@ bool PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::co
   stencil.clear();
   m_stencil_computer->compute_stencil(element,stencil);
 
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template< typename ELEMENTFINDER, typename STENCILCOMPUTER, typename INTERPOLATIONFUNCTION>
+void PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::compute_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights)
+{
   // 3) Find interpolation
   points.clear();
   weights.clear();
   m_interpolator_function->compute_interpolation_weights(coordinate,stencil,points,weights);
-
-  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +29,7 @@
 #include "mesh/Faces.hpp"
 #include "mesh/Elements.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/MeshTransformer.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -76,6 +77,10 @@ SimpleMeshGenerator::SimpleMeshGenerator ( const std::string& name  ) :
   options().add("bdry", true)
       .description("Generate Boundary")
       .pretty_name("Boundary");
+
+  options().add("overlap", 0u)
+      .description("Number of cell layers to overlap across parallel partitions. Ignored in serial runs")
+      .pretty_name("Overlap");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +116,18 @@ void SimpleMeshGenerator::execute()
   {
     throw SetupError(FromHere(), "Invalid size of the vector number of cells");
   }
+
+  // Every part only generated its own elements, the ghost element layers are added here
+  const Uint overlap = options().value<Uint>("overlap");
+  if(overlap != 0 && PE::Comm::instance().size() > 1)
+  {
+    m_mesh->update_structures();
+    m_mesh->block_mesh_changed(true); // avoid triggering mesh_changed before the load event is raised
+    boost::shared_ptr<MeshTransformer> grow_overlap = build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GrowOverlap","grow_overlap");
+    for(Uint i = 0; i != overlap; ++i)
+      grow_overlap->transform(*m_mesh);
+    m_mesh->block_mesh_changed(false);
+  }
   m_mesh->raise_mesh_loaded();
 }
 
@@ -138,24 +155,27 @@ void SimpleMeshGenerator::create_line()
   hash.options().set("nb_obj",num_obj);
   hash.options().set("nb_parts",nb_parts);
 
+  // Only the elements and nodes of this part are visited
+  const Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
+  const Uint glb_elem_end_idx = hash.subhash(ELEMS).end_idx_in_part(part);
+  const Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
+  const Uint glb_node_end_idx = hash.subhash(NODES).end_idx_in_part(part);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
-  for(Uint i = 0; i < x_segments; ++i)
+  for(Uint i = glb_elem_start_idx; i < glb_elem_end_idx; ++i)
   {
-    if (hash.subhash(ELEMS).part_owns(part,i))
+    glb_node_idx = i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
     {
-      glb_node_idx = i;
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-      {
-        ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-      }
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-      glb_node_idx = (i+1);
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-      {
-        ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-      }
+    glb_node_idx = (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
   }
 
@@ -163,23 +183,18 @@ void SimpleMeshGenerator::create_line()
   Region& region = mesh.topology().create_region("interior");
   Dictionary& nodes = mesh.geometry_fields();
 
-  Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
-
   const Real x_step = x_len / static_cast<Real>(x_segments);
-  for(Uint i = 0; i <= x_segments; ++i)
+  for(Uint i = glb_node_start_idx; i < glb_node_end_idx; ++i)
   {
     glb_node_idx = i;
 
-    if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-    {
-      cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-      common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-      for (Uint d=0; d<m_coord_dim; ++d)
-        row[d]=0.;
-      row[XX] = static_cast<Real>(i) * x_step + x_offset;
-      nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-      nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-    }
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = static_cast<Real>(i) * x_step + x_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
 
   // add ghost nodes
@@ -205,30 +220,26 @@ void SimpleMeshGenerator::create_line()
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
   Uint glb_elem_idx;
-  for(Uint i = 0; i < x_segments; ++i)
+  for(Uint i = glb_elem_start_idx; i < glb_elem_end_idx; ++i)
   {
     glb_elem_idx = i;
 
-    if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-    {
-      Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-      elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-      elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-      glb_node_idx = i;
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        nodes[0] = ghost_nodes_loc[glb_node_idx];
-      else
-        nodes[0] = glb_node_idx-glb_node_start_idx;
-
-      glb_node_idx = (i+1);
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        nodes[1] = ghost_nodes_loc[glb_node_idx];
-      else
-        nodes[1] = glb_node_idx-glb_node_start_idx;
-    }
+    Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
+    elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
+    elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
+
+    glb_node_idx = i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
   }
 
   if (bdry)
@@ -309,67 +320,62 @@ void SimpleMeshGenerator::create_rectangle()
   Dictionary& nodes = mesh.geometry_fields();
 
 
+  // Only the elements and nodes of this part are visited
+  const Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
+  const Uint glb_elem_end_idx = hash.subhash(ELEMS).end_idx_in_part(part);
+  const Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
+  const Uint glb_node_end_idx = hash.subhash(NODES).end_idx_in_part(part);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
-  for(Uint j = 0; j < y_segments; ++j)
+  for(Uint glb_elem_idx = glb_elem_start_idx; glb_elem_idx < glb_elem_end_idx; ++glb_elem_idx)
   {
-    for(Uint i = 0; i < x_segments; ++i)
+    const Uint j = glb_elem_idx / x_segments;
+    const Uint i = glb_elem_idx - j*x_segments;
+
+    glb_node_idx = j * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
     {
-      if (hash.subhash(ELEMS).part_owns(part,i+j*x_segments))
-      {
-        glb_node_idx = j * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = j * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+    glb_node_idx = j * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = (j+1) * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
+    glb_node_idx = (j+1) * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        glb_node_idx = (j+1) * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-        {
-          ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-        }
-      }
+    glb_node_idx = (j+1) * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
   }
 
   mesh.initialize_nodes(hash.subhash(NODES).nb_objects_in_part(part)+ghost_nodes_loc.size(), DIM_2D);
-  Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
 
   const Real x_step = x_len / static_cast<Real>(x_segments);
   const Real y_step = y_len / static_cast<Real>(y_segments);
-  Real y;
-  for(Uint j = 0; j <= y_segments; ++j)
+  for(glb_node_idx = glb_node_start_idx; glb_node_idx < glb_node_end_idx; ++glb_node_idx)
   {
-    y = static_cast<Real>(j) * y_step;
-    for(Uint i = 0; i <= x_segments; ++i)
-    {
-      glb_node_idx = j * (x_segments+1) + i;
+    const Uint j = glb_node_idx / (x_segments+1);
+    const Uint i = glb_node_idx - j*(x_segments+1);
 
-      if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-      {
-        cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-        common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-        for (Uint d=0; d<m_coord_dim; ++d)
-          row[d]=0.;
-        row[XX] = static_cast<Real>(i) * x_step + x_offset;
-        row[YY] = y + y_offset;
-        nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-        nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-      }
-    }
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = static_cast<Real>(i) * x_step + x_offset;
+    row[YY] = static_cast<Real>(j) * y_step + y_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
 
   // add ghost nodes
@@ -398,46 +404,39 @@ void SimpleMeshGenerator::create_rectangle()
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
   Uint glb_elem_idx;
-  for(Uint j = 0; j < y_segments; ++j)
+  for(glb_elem_idx = glb_elem_start_idx; glb_elem_idx < glb_elem_end_idx; ++glb_elem_idx)
   {
-    for(Uint i = 0; i < x_segments; ++i)
-    {
-      glb_elem_idx = j * x_segments + i;
-
-      if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-      {
-        Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-        elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-        elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-        glb_node_idx = j * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[0] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[0] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = j * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[1] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[1] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = (j+1) * (x_segments+1) + i;
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[3] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[3] = glb_node_idx-glb_node_start_idx;
-
-        glb_node_idx = (j+1) * (x_segments+1) + (i+1);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          nodes[2] = ghost_nodes_loc[glb_node_idx];
-        else
-          nodes[2] = glb_node_idx-glb_node_start_idx;
-      }
-
-    }
+    const Uint j = glb_elem_idx / x_segments;
+    const Uint i = glb_elem_idx - j*x_segments;
+
+    Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
+    elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
+    elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
+
+    glb_node_idx = j * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = j * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (j+1) * (x_segments+1) + i;
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[3] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[3] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = (j+1) * (x_segments+1) + (i+1);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[2] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[2] = glb_node_idx-glb_node_start_idx;
   }
 
 
@@ -609,104 +608,92 @@ void SimpleMeshGenerator::create_box()
   Dictionary& nodes = mesh.geometry_fields();
 
 
+  // Only the elements and nodes of this part are visited
+  const Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
+  const Uint glb_elem_end_idx = hash.subhash(ELEMS).end_idx_in_part(part);
+  const Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
+  const Uint glb_node_end_idx = hash.subhash(NODES).end_idx_in_part(part);
+
   // find ghost nodes
   std::map<Uint,Uint> ghost_nodes_loc;
   Uint glb_node_idx;
   Uint glb_elem_idx;
-  for(Uint k = 0; k < z_segments; ++k)
+  for(glb_elem_idx = glb_elem_start_idx; glb_elem_idx < glb_elem_end_idx; ++glb_elem_idx)
   {
-    for(Uint j = 0; j < y_segments; ++j)
-    {
-      for(Uint i = 0; i < x_segments; ++i)
-      {
-        glb_elem_idx = elem_idx(i,j,k, x_segments,y_segments,z_segments);
-        if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-        {
-          glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    const Uint k = glb_elem_idx / (x_segments*y_segments);
+    const Uint j = (glb_elem_idx - k*(x_segments*y_segments)) / x_segments;
+    const Uint i = glb_elem_idx - (k*y_segments + j)*x_segments;
 
-          glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-          glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-          {
-            ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
-          }
+    glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
+    }
 
-        }
-      }
+    glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+    {
+      ghost_nodes_loc[glb_node_idx]=0; // this value will be set further
     }
   }
 
   mesh.initialize_nodes(hash.subhash(NODES).nb_objects_in_part(part)+ghost_nodes_loc.size(), DIM_3D);
-  Uint glb_node_start_idx = hash.subhash(NODES).start_idx_in_part(part);
 
   const Real x_step = x_len / static_cast<Real>(x_segments);
   const Real y_step = y_len / static_cast<Real>(y_segments);
   const Real z_step = z_len / static_cast<Real>(z_segments);
 
-  Real x,y,z;
-  for(Uint k = 0; k <= z_segments; ++k)
+  for(glb_node_idx = glb_node_start_idx; glb_node_idx < glb_node_end_idx; ++glb_node_idx)
   {
-    z = static_cast<Real>(k) * z_step;
-    for(Uint j = 0; j <= y_segments; ++j)
-    {
-      y = static_cast<Real>(j) * y_step;
-      for(Uint i = 0; i <= x_segments; ++i)
-      {
-        x = static_cast<Real>(i) * x_step;
-        glb_node_idx = node_idx(i,j,k, x_segments,y_segments,z_segments);
-        if (hash.subhash(NODES).part_owns(part,glb_node_idx))
-        {
-          cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
-          common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
-          for (Uint d=0; d<m_coord_dim; ++d)
-            row[d]=0.;
-          row[XX] = x + x_offset;
-          row[YY] = y + y_offset;
-          row[ZZ] = z + z_offset;
-          nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
-          nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
-        }
-      }
-    }
+    const Uint k = glb_node_idx / ( (x_segments+1)*(y_segments+1) );
+    const Uint j = (glb_node_idx - k*( (x_segments+1)*(y_segments+1) ))/(x_segments+1);
+    const Uint i = glb_node_idx - (k * (y_segments+1) + j) * (x_segments+1);
+
+    cf3_assert(glb_node_idx-glb_node_start_idx < nodes.size());
+    common::Table<Real>::Row row = nodes.coordinates()[glb_node_idx-glb_node_start_idx];
+    for (Uint d=0; d<m_coord_dim; ++d)
+      row[d]=0.;
+    row[XX] = static_cast<Real>(i) * x_step + x_offset;
+    row[YY] = static_cast<Real>(j) * y_step + y_offset;
+    row[ZZ] = static_cast<Real>(k) * z_step + z_offset;
+    nodes.rank()[glb_node_idx-glb_node_start_idx]=part;
+    nodes.glb_idx()[glb_node_idx-glb_node_start_idx]=glb_node_idx;
   }
   // add ghost nodes
   Uint glb_ghost_node_start_idx = hash.subhash(NODES).nb_objects_in_part(part);
@@ -740,73 +727,63 @@ void SimpleMeshGenerator::create_box()
   common::List<Uint>& elem_rank = cells->rank();
   common::List<Uint>& elem_glb_idx = cells->glb_idx();
 
-  Uint glb_elem_start_idx = hash.subhash(ELEMS).start_idx_in_part(part);
-  for(Uint k = 0; k < z_segments; ++k)
+  for(glb_elem_idx = glb_elem_start_idx; glb_elem_idx < glb_elem_end_idx; ++glb_elem_idx)
   {
-    for(Uint j = 0; j < y_segments; ++j)
-    {
-      for(Uint i = 0; i < x_segments; ++i)
-      {
-        glb_elem_idx = (k * y_segments + j) * x_segments + i;
-
-        if (hash.subhash(ELEMS).part_owns(part,glb_elem_idx))
-        {
-          Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
-          elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
-          elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
-
-          glb_node_idx = node_idx(i,j,k , x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[0] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[0] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[1] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[1] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[2] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[2] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[3] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[3] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j,k+1 , x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[4] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[4] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[5] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[5] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[6] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[6] = glb_node_idx-glb_node_start_idx;
-
-          glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
-          if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
-            nodes[7] = ghost_nodes_loc[glb_node_idx];
-          else
-            nodes[7] = glb_node_idx-glb_node_start_idx;
-
-        }
-
-      }
-    }
+    const Uint k = glb_elem_idx / (x_segments*y_segments);
+    const Uint j = (glb_elem_idx - k*(x_segments*y_segments)) / x_segments;
+    const Uint i = glb_elem_idx - (k*y_segments + j)*x_segments;
+
+    Connectivity::Row nodes = connectivity[glb_elem_idx-glb_elem_start_idx];
+    elem_rank[glb_elem_idx-glb_elem_start_idx] = part;
+    elem_glb_idx[glb_elem_idx-glb_elem_start_idx] = glb_elem_idx;
+
+    glb_node_idx = node_idx(i,j,k , x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[0] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[0] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[1] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[1] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[2] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[2] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j+1,k, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[3] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[3] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j,k+1 , x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[4] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[4] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[5] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[5] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i+1,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[6] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[6] = glb_node_idx-glb_node_start_idx;
+
+    glb_node_idx = node_idx(i,j+1,k+1, x_segments,y_segments,z_segments);
+    if (hash.subhash(NODES).part_owns(part,glb_node_idx) == false)
+      nodes[7] = ghost_nodes_loc[glb_node_idx];
+    else
+      nodes[7] = glb_node_idx-glb_node_start_idx;
   }
   if (bdry)
   {
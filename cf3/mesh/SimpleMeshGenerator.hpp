@@ -38,6 +38,10 @@ namespace mesh {
 ///    topology/top     (bdry)
 ///    topology/back     (bdry)
 ///    topology/front     (bdry)
+///
+/// In parallel, every part only visits its own range of the global element and node
+/// numbering, so generating the mesh scales with the size of the part rather than the
+/// size of the whole mesh. No partitioning or migration step is needed afterwards.
 /// @author Willem Deconinck
 class Mesh_API SimpleMeshGenerator : public MeshGenerator {
 
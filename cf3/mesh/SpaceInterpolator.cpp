@@ -8,6 +8,8 @@
 
 #include "common/FindComponents.hpp"
 #include "common/Builder.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
 
 #include "mesh/SpaceInterpolator.hpp"
 #include "mesh/Mesh.hpp"
@@ -27,8 +29,15 @@ common::ComponentBuilder<SpaceInterpolator,AInterpolator,LibMesh> SpaceInterpola
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SpaceInterpolator::SpaceInterpolator(const std::string &name) : AInterpolator(name)
+SpaceInterpolator::SpaceInterpolator(const std::string &name) :
+  AInterpolator(name),
+  m_source_dict_size(0),
+  m_target_dict_size(0)
 {
+  options().add("store", false)
+      .description("Flag to store the interpolation as a sparse matrix, reused for faster interpolation "
+                   "in the future until the mesh changes")
+      .pretty_name("Store");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +63,44 @@ void SpaceInterpolator::interpolate_vars(const Field& source_field, const common
     throw common::SetupError(FromHere(),"Sizes of source_vars and target_vars don't match");
   }
 
+  if (options().value<bool>("store"))
+  {
+    if (    source_field.dict().uri().string() != m_source_dict_uri.string()
+         || target_field.dict().uri().string() != m_target_dict_uri.string()
+         || m_source_dict_size != source_field.size()
+         || m_target_dict_size != target_field.size() )
+    {
+      store(source_field.dict(),target_field.dict());
+      m_source_dict_uri = source_field.dict().uri();
+      m_target_dict_uri = target_field.dict().uri();
+      m_source_dict_size = source_field.size();
+      m_target_dict_size = target_field.size();
+    }
+
+    std::vector<Real> interpolated;
+    m_stored_matrix.multiply(source_field,source_vars,interpolated);
+
+    const Uint nb_vars=source_vars.size();
+    const int nb_rows = static_cast<int>(m_stored_rows.size());
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (int r=0; r<nb_rows; ++r)
+    {
+      for (Uint var=0; var<nb_vars; ++var)
+        target_field[m_stored_rows[r]][target_vars[var]] = interpolated[r*nb_vars+var];
+    }
+  }
+  else
+  {
+    unstored_interpolation(source_field,target_field,source_vars,target_vars);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpaceInterpolator::unstored_interpolation(const Field& source_field, Field& target_field, const std::vector<Uint>& source_vars, const std::vector<Uint>& target_vars)
+{
   const Uint nb_vars=source_vars.size();
 
   /// Loop over Regions
@@ -99,5 +146,76 @@ void SpaceInterpolator::interpolate_vars(const Field& source_field, const common
 
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+
+void SpaceInterpolator::store(const Dictionary& source_dict, const Dictionary& target_dict)
+{
+  // Source points and weights of every target row. A row shared by several
+  // elements is interpolated from the last one, as in unstored_interpolation()
+  std::vector< std::vector<Uint> > row_points(target_dict.size());
+  std::vector< std::vector<Real> > row_weights(target_dict.size());
+
+  boost_foreach(const Handle<Entities>& elements_handle, target_dict.entities_range())
+  {
+    Entities& elements = *elements_handle;
+    if (source_dict.defined_for_entities(elements_handle) == false)
+      continue;
+
+    const Space& s_space = source_dict.space(elements);
+    const Space& t_space = target_dict.space(elements);
+    const ShapeFunction& s_sf = s_space.shape_function();
+    const ShapeFunction& t_sf = t_space.shape_function();
+
+    /// Compute Interpolation matrix, equal for every element
+    RealMatrix interpolate(t_sf.nb_nodes(),s_sf.nb_nodes());
+    for (Uint t_pt = 0; t_pt<t_sf.nb_nodes(); ++t_pt)
+      interpolate.row(t_pt) = s_sf.value(t_sf.local_coordinates().row(t_pt));
+
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      Connectivity::ConstRow s_field_indexes = s_space.connectivity()[e];
+      Connectivity::ConstRow t_field_indexes = t_space.connectivity()[e];
+      for (Uint t_pt=0; t_pt<t_sf.nb_nodes(); ++t_pt)
+      {
+        std::vector<Uint>& points = row_points[t_field_indexes[t_pt]];
+        std::vector<Real>& weights = row_weights[t_field_indexes[t_pt]];
+        points.resize(s_sf.nb_nodes());
+        weights.resize(s_sf.nb_nodes());
+        for (Uint s_pt=0; s_pt<s_sf.nb_nodes(); ++s_pt)
+        {
+          points[s_pt] = s_field_indexes[s_pt];
+          weights[s_pt] = interpolate(t_pt,s_pt);
+        }
+      }
+    }
+  }
+
+  m_stored_matrix.clear();
+  m_stored_rows.clear();
+  for (Uint row=0; row<row_points.size(); ++row)
+  {
+    if (row_points[row].empty())
+      continue;
+    m_stored_rows.push_back(row);
+    m_stored_matrix.add_row(&row_points[row][0],&row_weights[row][0],row_points[row].size());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SpaceInterpolator::mesh_modified(const URI& mesh_uri)
+{
+  if ( is_part_of_mesh(m_source_dict_uri,mesh_uri) || is_part_of_mesh(m_target_dict_uri,mesh_uri) )
+  {
+    // Storage will be recomputed on the next interpolation
+    m_source_dict_uri = URI();
+    m_target_dict_uri = URI();
+    m_stored_matrix.clear();
+    m_stored_rows.clear();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
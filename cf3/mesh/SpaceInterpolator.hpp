@@ -10,16 +10,20 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "mesh/AInterpolator.hpp"
+#include "mesh/InterpolationMatrix.hpp"
 
 namespace cf3 {
 namespace mesh {
 
 class APointInterpolator;
+class Dictionary;
 
 ////////////////////////////////////////////////////////////////////////////////
 
 /// @brief Interpolator component that interpolates fields between spaces in the same mesh
 ///
+/// With the option "store", the interpolation is built once as a sparse matrix
+/// and reused until the mesh changes.
 /// @author Willem Deconinck
 class Mesh_API SpaceInterpolator : public AInterpolator {
 
@@ -46,6 +50,30 @@ public: // functions
   /// @param [in]  source_vars    Variable indices from source_field to interpolate from
   /// @param [in]  target_vars    Variables in target_field to interpolate to
   virtual void interpolate_vars(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target, const std::vector<Uint>& source_vars, const std::vector<Uint>& target_vars);
+
+protected: // functions
+
+  /// Discard the stored interpolation if it was built for the modified mesh
+  virtual void mesh_modified(const common::URI& mesh_uri);
+
+private: // functions
+
+  /// Build the interpolation matrix from the source dictionary to the target dictionary
+  void store(const Dictionary& source_dict, const Dictionary& target_dict);
+
+  /// Interpolate element by element, without storage
+  void unstored_interpolation(const Field& source_field, Field& target_field, const std::vector<Uint>& source_vars, const std::vector<Uint>& target_vars);
+
+private: // data
+
+  /// Interpolation of the rows m_stored_rows of the target dictionary
+  InterpolationMatrix m_stored_matrix;
+  std::vector<Uint> m_stored_rows;
+
+  common::URI m_source_dict_uri;
+  common::URI m_target_dict_uri;
+  Uint m_source_dict_size;
+  Uint m_target_dict_size;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
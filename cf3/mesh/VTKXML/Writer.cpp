@@ -4,17 +4,30 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <iomanip>
 #include <iostream>
 #include <set>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 
 #include "rapidxml/rapidxml.hpp"
 
+#include "coolfluid-packages.hpp"
+
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef CF3_HAVE_LZ4
+  #include <lz4.h>
+#endif
+
+#include "common/BasicExceptions.hpp"
 #include "common/BoostFilesystem.hpp"
 #include "common/Foreach.hpp"
 #include "common/Log.hpp"
@@ -49,130 +62,229 @@ namespace VTKXML {
 
 namespace detail
 {
-  struct CompressedStreamHeader
+  /// Compression of the appended data arrays
+  enum Compressor { NO_COMPRESSION, ZLIB_COMPRESSION, LZ4_COMPRESSION };
+
+  /// Compress one block of data, replacing the contents of compressed
+  void compress_block(const Compressor compressor, const char* data, const Uint nb_bytes, std::string& compressed)
   {
-    CompressedStreamHeader() :
-      nb_blocks(1),
-      blocksize(32768), // Same as in ParaView
-      last_blocksize(0)
+    compressed.clear();
+    if(compressor == ZLIB_COMPRESSION)
+    {
+      boost::iostreams::filtering_ostream compressed_stream;
+      compressed_stream.push(boost::iostreams::zlib_compressor());
+      compressed_stream.push(boost::iostreams::back_inserter(compressed));
+      compressed_stream.write(data, nb_bytes);
+      compressed_stream.reset(); // flushes the compressor
+    }
+#ifdef CF3_HAVE_LZ4
+    else if(compressor == LZ4_COMPRESSION)
     {
+      compressed.resize(LZ4_compressBound(nb_bytes));
+      const int compressed_size = LZ4_compress_default(data, &compressed[0], nb_bytes, compressed.size());
+      if(compressed_size <= 0)
+        throw FileSystemError(FromHere(), "LZ4 compression failed");
+      compressed.resize(compressed_size);
     }
+#endif
+    else
+    {
+      compressed.assign(data, nb_bytes);
+    }
+  }
 
-    boost::uint32_t nb_blocks;
-    const boost::uint32_t blocksize;
-    boost::uint32_t last_blocksize;
-    std::vector<boost::uint32_t> compressed_blocksizes;
-  };
-
-  struct CompressedStream
+  /// Appended data section of a VTK XML file, written straight to the file.
+  /// Compressed arrays are split in blocks, which are compressed in parallel, a batch of blocks at a time.
+  /// Only the block sizes in the header of an array are patched once the array is finished.
+  struct AppendedDataStream
   {
-    CompressedStream() :
-      data_stream(std::ios_base::in | std::ios_base::out | std::ios_base::binary),
-      m_current_block(std::ios_base::in | std::ios_base::out | std::ios_base::binary)
+    AppendedDataStream(std::ostream& file, const Compressor compressor) :
+      m_file(file),
+      m_compressor(compressor),
+      blocksize(32768) // Same as in ParaView
     {
       // VTK data starts with a _
-      data_stream.write("_", 1);
+      m_file.write("_", 1);
+      m_data_start = m_file.tellp();
+
+      Uint nb_threads = 1;
+#ifdef CF3_HAVE_OPENMP
+      nb_threads = omp_get_max_threads();
+#endif
+      m_batch_nb_blocks = 8*nb_threads;
+      m_batch.reserve(m_batch_nb_blocks*blocksize);
+    }
+
+    /// Offset of the next array in the appended data (= offset after the _)
+    boost::uint64_t offset()
+    {
+      return static_cast<boost::uint64_t>(m_file.tellp() - m_data_start);
     }
 
     /// Start writing a new array
     void start_array(const Uint nb_elems, const Uint wordsize)
     {
       m_wordsize = wordsize;
-
       const Uint nb_bytes = nb_elems * wordsize;
-      m_header.last_blocksize = nb_bytes % m_header.blocksize;
-      if(m_header.last_blocksize)
-      {
-        m_header.nb_blocks = nb_bytes / m_header.blocksize + 1;
-      }
-      else
+      m_batch.clear();
+
+      if(m_compressor == NO_COMPRESSION)
       {
-        m_header.last_blocksize = m_header.blocksize;
-        m_header.nb_blocks = nb_bytes / m_header.blocksize;
+        const boost::uint32_t header = nb_bytes;
+        m_file.write(reinterpret_cast<const char*>(&header), 4);
+        return;
       }
 
-      m_header.compressed_blocksizes.clear();
-      m_header.compressed_blocksizes.reserve(m_header.nb_blocks);
-
-      // Write known header info
-      data_stream.write(reinterpret_cast<const char*>(&m_header.nb_blocks), 4);
-      data_stream.write(reinterpret_cast<const char*>(&m_header.blocksize), 4);
-      data_stream.write(reinterpret_cast<const char*>(&m_header.last_blocksize), 4);
-
-      // save filepointer
-      m_compressed_sizes_start = data_stream.tellp();
-
-      // Reserve space for compressed block sizes
-      for(Uint i = 0; i != m_header.nb_blocks; ++i)
-        data_stream.write(reinterpret_cast<const char*>(&m_header.nb_blocks), 4);
+      boost::uint32_t last_blocksize = nb_bytes % blocksize;
+      boost::uint32_t nb_blocks = nb_bytes / blocksize;
+      if(last_blocksize)
+        ++nb_blocks;
+      else
+        last_blocksize = blocksize;
+
+      // Write known header info, and reserve space for the compressed block sizes
+      m_file.write(reinterpret_cast<const char*>(&nb_blocks), 4);
+      m_file.write(reinterpret_cast<const char*>(&blocksize), 4);
+      m_file.write(reinterpret_cast<const char*>(&last_blocksize), 4);
+      m_compressed_sizes_start = m_file.tellp();
+      m_compressed_blocksizes.assign(nb_blocks, 0);
+      m_nb_written_blocks = 0;
+      if(nb_blocks)
+        m_file.write(reinterpret_cast<const char*>(&m_compressed_blocksizes[0]), 4*nb_blocks);
     }
 
     /// Finish writing the current array
     void finish_array()
     {
-      // Write the last block
-      cf3_assert(static_cast<Uint>(m_current_block.tellp()) == static_cast<Uint>(m_header.last_blocksize));
-      compress_block();
-
-      // go back to the header
-      const Uint stream_end = data_stream.tellp();
-      data_stream.seekp(m_compressed_sizes_start);
-
-      // Write actual compressed block sizes
-      for(Uint i = 0; i != m_header.nb_blocks; ++i)
-        data_stream.write(reinterpret_cast<const char*>(&m_header.compressed_blocksizes[i]), 4);
-
-      // go back to the stream end
-      data_stream.seekp(stream_end);
+      write_batch();
+      if(m_compressor == NO_COMPRESSION)
+        return;
+
+      cf3_assert(m_nb_written_blocks == m_compressed_blocksizes.size());
+      if(m_compressed_blocksizes.empty())
+        return;
+
+      // go back to the header to write the actual compressed block sizes, and return to the end
+      const std::streampos stream_end = m_file.tellp();
+      m_file.seekp(m_compressed_sizes_start);
+      m_file.write(reinterpret_cast<const char*>(&m_compressed_blocksizes[0]), 4*m_compressed_blocksizes.size());
+      m_file.seekp(stream_end);
     }
 
     /// Append a value to the stream
     template<typename ValueT>
     void push_back(const ValueT& value)
     {
-      // Block is full, write it to the compressed stream
-      if(m_current_block.tellp() == static_cast<std::streampos>(m_header.blocksize))
-        compress_block();
-
-      m_current_block.write(reinterpret_cast<const char*>(&value), m_wordsize);
+      cf3_assert(sizeof(ValueT) == m_wordsize);
+      if(m_batch.size() + sizeof(ValueT) > m_batch_nb_blocks*blocksize)
+        write_batch();
+      const char* bytes = reinterpret_cast<const char*>(&value);
+      m_batch.insert(m_batch.end(), bytes, bytes+sizeof(ValueT));
     }
 
-    // Offset to put in the VTK XML (= offset after the _)
-    Uint offset()
+    /// Compress the blocks of the current batch in parallel, and append them to the file
+    void write_batch()
     {
-      return static_cast<Uint>(data_stream.tellp()) - 1u;
-    }
+      if(m_batch.empty())
+        return;
 
-    // Compress the current block and append it to the data stream
-    void compress_block()
-    {
-      // set up zlib compressor
-      boost::iostreams::filtering_stream<boost::iostreams::input> compressed_stream;
-      compressed_stream.push(boost::iostreams::zlib_compressor());
-      compressed_stream.push(m_current_block);
+      if(m_compressor == NO_COMPRESSION)
+      {
+        m_file.write(&m_batch[0], m_batch.size());
+        m_batch.clear();
+        return;
+      }
 
-      // write data and store compressed size
-      const Uint before = data_stream.tellp();
-      data_stream << compressed_stream.rdbuf();
-      m_header.compressed_blocksizes.push_back(static_cast<Uint>(data_stream.tellp()) - before);
+      const Uint batch_size = m_batch.size();
+      const int nb_blocks = (batch_size + blocksize - 1) / blocksize;
+      m_compressed_blocks.resize(nb_blocks);
+      bool failed = false;
+#ifdef CF3_HAVE_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for(int block = 0; block < nb_blocks; ++block)
+      {
+        const Uint begin = block*blocksize;
+        const Uint nb_bytes = std::min(blocksize, batch_size - begin);
+        try
+        {
+          compress_block(m_compressor, &m_batch[begin], nb_bytes, m_compressed_blocks[block]);
+        }
+        catch(...)
+        {
+#ifdef CF3_HAVE_OPENMP
+          #pragma omp critical
+#endif
+          failed = true;
+        }
+      }
+      if(failed)
+        throw FileSystemError(FromHere(), "Compression of VTK XML data failed");
 
-      // clear current block
-      m_current_block.str(std::string());
+      for(int block = 0; block < nb_blocks; ++block)
+      {
+        const std::string& compressed = m_compressed_blocks[block];
+        m_file.write(compressed.data(), compressed.size());
+        m_compressed_blocksizes[m_nb_written_blocks++] = compressed.size();
+      }
+      m_batch.clear();
     }
 
-    CompressedStreamHeader m_header;
+    std::ostream& m_file;
+
+    const Compressor m_compressor;
+
+    const boost::uint32_t blocksize;
+
+    /// File pointer of the start of the appended data, just after the _
+    std::streampos m_data_start;
 
-    /// File pointer where the compressed sizes start
-    Uint m_compressed_sizes_start;
+    /// File pointer where the compressed sizes of the current array start
+    std::streampos m_compressed_sizes_start;
 
     Uint m_wordsize;
 
-    // Uncompressed data for the block that is being appended to
-    std::stringstream m_current_block;
+    /// Uncompressed data of the blocks that are being appended to
+    std::vector<char> m_batch;
+    Uint m_batch_nb_blocks;
+
+    /// Compressed data of the blocks of the current batch, one per block
+    std::vector<std::string> m_compressed_blocks;
 
-    std::stringstream data_stream;
+    /// Compressed sizes of all blocks of the current array
+    std::vector<boost::uint32_t> m_compressed_blocksizes;
+    Uint m_nb_written_blocks;
   };
 
+  /// Append a real value, in single or double precision
+  inline void push_back_real(AppendedDataStream& stream, const Real value, const bool single_precision)
+  {
+    if(single_precision)
+      stream.push_back(static_cast<float>(value));
+    else
+      stream.push_back(value);
+  }
+
+  /// Fixed-width offset attribute, replaced once the offset is known
+  std::string offset_placeholder(const Uint array_idx)
+  {
+    std::string placeholder = "@" + to_str(array_idx);
+    placeholder.resize(20, '@');
+    return placeholder;
+  }
+
+  /// Set the attributes of an appended DataArray, with a placeholder offset
+  void set_data_array(XmlNode& data_array, const std::string& type, const std::string& name, const Uint nb_components, Uint& nb_arrays)
+  {
+    data_array.set_attribute("type", type);
+    if(!name.empty())
+      data_array.set_attribute("Name", name);
+    if(nb_components)
+      data_array.set_attribute("NumberOfComponents", to_str(nb_components));
+    data_array.set_attribute("format", "appended");
+    data_array.set_attribute("offset", offset_placeholder(nb_arrays++));
+  }
+
   // Recursively transform nodes to their parallel counterparts
   void make_pvtu(XmlNode& node)
   {
@@ -206,6 +318,19 @@ Writer::Writer( const std::string& name )
     options().add("distributed_files", false)
     .pretty_name("Distributed Files")
     .description("Indicate if the filesystem is local to each note. When true, the pvtu file is written on each node.");
+
+    std::vector<boost::any> compressors;
+    compressors.push_back(std::string("zlib"));
+    compressors.push_back(std::string("lz4"));
+    compressors.push_back(std::string("none"));
+    options().add("compressor", std::string("zlib"))
+    .pretty_name("Compressor")
+    .description("Compression of the data arrays: zlib, lz4 (faster, if coolfluid was built with LZ4) or none")
+    .restricted_list() = compressors;
+
+    options().add("single_precision", false)
+    .pretty_name("Single Precision")
+    .description("Write coordinates and field values as Float32, halving the file size");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -228,6 +353,25 @@ void Writer::write()
   const std::string basename = my_path.base_name();
   my_path = my_dir / (basename + "_P" + to_str(PE::Comm::instance().rank()) + ".vtu");
 
+  const std::string compressor_name = options().value<std::string>("compressor");
+  detail::Compressor compressor = detail::ZLIB_COMPRESSION;
+  if(compressor_name == "none")
+    compressor = detail::NO_COMPRESSION;
+  else if(compressor_name == "lz4")
+  {
+#ifdef CF3_HAVE_LZ4
+    compressor = detail::LZ4_COMPRESSION;
+#else
+    throw SetupError(FromHere(), "LZ4 compression was requested for " + uri().string() + ", but coolfluid was built without LZ4");
+#endif
+  }
+  else if(compressor_name != "zlib")
+    throw BadValue(FromHere(), "Unknown compressor " + compressor_name + " for " + uri().string() + ", valid values are zlib, lz4 and none");
+
+  const bool single_precision = options().value<bool>("single_precision");
+  const std::string real_type = (single_precision || sizeof(Real) == 4) ? "Float32" : "Float64";
+  const Uint real_size = (single_precision || sizeof(Real) == 4) ? 4 : 8;
+
   XmlDoc doc("1.0", "ISO-8859-1");
 
   // Root node
@@ -235,7 +379,10 @@ void Writer::write()
   vtkfile.set_attribute("type", "UnstructuredGrid");
   vtkfile.set_attribute("version", "0.1");
   vtkfile.set_attribute("byte_order", "LittleEndian");
-  vtkfile.set_attribute("compressor", "vtkZLibDataCompressor");
+  if(compressor == detail::ZLIB_COMPRESSION)
+    vtkfile.set_attribute("compressor", "vtkZLibDataCompressor");
+  else if(compressor == detail::LZ4_COMPRESSION)
+    vtkfile.set_attribute("compressor", "vtkLZ4DataCompressor");
 
   XmlNode unstructured_grid = vtkfile.add_node("UnstructuredGrid");
 
@@ -267,33 +414,93 @@ void Writer::write()
   piece.set_attribute("NumberOfPoints", to_str(npoints));
   piece.set_attribute("NumberOfCells", to_str(nb_elems));
 
-  // Points output
-  detail::CompressedStream appended_data;
+  // The XML meta data is written before the data arrays, so each offset is a placeholder until the array is written
+  Uint nb_arrays = 0;
 
   XmlNode points_data = piece.add_node("Points").add_node("DataArray");
-  points_data.set_attribute("type", sizeof(Real) == 4 ? "Float32" : "Float64");
-  points_data.set_attribute("NumberOfComponents", "3");
-  points_data.set_attribute("format", "appended");
-  points_data.set_attribute("offset", to_str(appended_data.offset()));
+  detail::set_data_array(points_data, real_type, "", 3, nb_arrays);
+
+  XmlNode cells = piece.add_node("Cells");
+  XmlNode connectivity = cells.add_node("DataArray");
+  detail::set_data_array(connectivity, "UInt32", "connectivity", 0, nb_arrays);
+  XmlNode offsets = cells.add_node("DataArray");
+  detail::set_data_array(offsets, "UInt32", "offsets", 0, nb_arrays);
+  XmlNode types = cells.add_node("DataArray");
+  detail::set_data_array(types, "UInt8", "types", 0, nb_arrays);
+
+  XmlNode cell_data = piece.add_node("CellData");
+  XmlNode point_data = piece.add_node("PointData");
 
-  appended_data.start_array(3*npoints, sizeof(Real));
+  // Field variables, in the order they are appended
+  std::vector< std::pair<const Field*, Uint> > field_vars;
+  std::set<std::string> added_fields;
+  boost_foreach(Handle<Field const> field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+
+    if(!added_fields.insert(field.uri().string()).second)
+      continue;
+
+    for(Uint var_idx = 0; var_idx != field.nb_vars(); ++var_idx)
+    {
+      const Uint var_size = field.var_length(var_idx);
+
+      XmlNode data_array = field.continuous()
+        ? point_data.add_node("DataArray")
+        : cell_data.add_node("DataArray");
+
+      detail::set_data_array(data_array, real_type, field.var_name(var_idx), var_size == 2 && dim == 2 ? 3 : var_size, nb_arrays);
+      field_vars.push_back(std::make_pair(&field, var_idx));
+    }
+  }
+
+  // Write to file, inserting the binary data at the end
+  std::cout << "writing file " << my_path.path() << std::endl;
+  boost::filesystem::fstream fout(my_path.path(), std::ios_base::in | std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if(!fout)
+    throw FileSystemError(FromHere(), "Could not open file " + my_path.path() + " for writing");
+
+  // Remove the closing tag
+  std::string xml_string;
+  to_string(doc, xml_string);
+  boost::algorithm::erase_last(xml_string, "</VTKFile>");
+  boost::algorithm::trim_right(xml_string);
+
+  // File positions of the offset placeholders, in array order
+  std::vector<std::streampos> offset_positions(nb_arrays);
+  const std::string offset_attribute = "offset=\"";
+  for(std::size_t pos = xml_string.find(offset_attribute + "@"); pos != std::string::npos; pos = xml_string.find(offset_attribute + "@", pos+1))
+  {
+    const std::size_t placeholder_begin = pos + offset_attribute.size();
+    const std::size_t placeholder_end = xml_string.find_first_of("@\"", placeholder_begin+1);
+    const Uint array_idx = from_str<Uint>(xml_string.substr(placeholder_begin+1, placeholder_end-placeholder_begin-1));
+    offset_positions[array_idx] = placeholder_begin;
+  }
+
+  // Write XML meta data
+  fout << xml_string;
+
+  // Append the data arrays, recording their offsets
+  fout << "\n<AppendedData encoding=\"raw\">\n";
+  std::vector<boost::uint64_t> array_offsets;
+  array_offsets.reserve(nb_arrays);
+
+  detail::AppendedDataStream appended_data(fout, compressor);
+
+  // Points output
+  array_offsets.push_back(appended_data.offset());
+  appended_data.start_array(3*npoints, real_size);
   for(Uint i = 0; i != npoints; ++i)
   {
     const Field::ConstRow row = coords[i];
     for(Uint j = 0; j != dim; ++j)
-      appended_data.push_back(row[j]);
-    if(dim == 2) appended_data.push_back(Real(0.));
+      detail::push_back_real(appended_data, row[j], single_precision);
+    if(dim == 2) detail::push_back_real(appended_data, 0., single_precision);
   }
   appended_data.finish_array();
 
-  XmlNode cells = piece.add_node("Cells");
-
   // Write connectivity
-  XmlNode connectivity = cells.add_node("DataArray");
-  connectivity.set_attribute("type", "UInt32");
-  connectivity.set_attribute("Name", "connectivity");
-  connectivity.set_attribute("format", "appended");
-  connectivity.set_attribute("offset", to_str(appended_data.offset()));
+  array_offsets.push_back(appended_data.offset());
   appended_data.start_array(nb_conn_nodes, 4);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
@@ -313,11 +520,7 @@ void Writer::write()
   appended_data.finish_array();
 
   // Write the offsets
-  XmlNode offsets = cells.add_node("DataArray");
-  offsets.set_attribute("type", "UInt32");
-  offsets.set_attribute("Name", "offsets");
-  offsets.set_attribute("format", "appended");
-  offsets.set_attribute("offset", to_str(appended_data.offset()));
+  array_offsets.push_back(appended_data.offset());
   boost::uint32_t offset = 0;
   appended_data.start_array(nb_elems, 4);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
@@ -335,11 +538,7 @@ void Writer::write()
   }
   appended_data.finish_array();
 
-  XmlNode types = cells.add_node("DataArray");
-  types.set_attribute("type", "UInt8");
-  types.set_attribute("Name", "types");
-  types.set_attribute("format", "appended");
-  types.set_attribute("offset", to_str(appended_data.offset()));
+  array_offsets.push_back(appended_data.offset());
   appended_data.start_array(nb_elems, 1);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
@@ -355,118 +554,92 @@ void Writer::write()
   }
   appended_data.finish_array();
 
-
-  XmlNode cell_data = piece.add_node("CellData");
-  XmlNode point_data = piece.add_node("PointData");
-
-  std::stringstream data_header( std::ios_base::in | std::ios_base::out | std::ios_base::binary );
-
-  std::set<std::string> added_fields;
-  boost_foreach(Handle<Field const> field_ptr, m_fields)
+  for(Uint field_var = 0; field_var != field_vars.size(); ++field_var)
   {
-    const Field& field = *field_ptr;
+    const Field& field = *field_vars[field_var].first;
+    const Uint var_idx = field_vars[field_var].second;
+    const Uint var_begin = field.var_offset(var_idx);
+    const Uint field_size = field.continuous() ? field.size() : nb_elems;
+    const Uint var_size = field.var_length(var_idx);
+    const Uint var_end = var_begin + var_size;
 
-    if(!added_fields.insert(field.uri().string()).second)
-      continue;
+    array_offsets.push_back(appended_data.offset());
+    appended_data.start_array(field_size*(var_size == 2 && dim == 2 ? 3 : var_size), real_size);
 
-    for(Uint var_idx = 0; var_idx != field.nb_vars(); ++var_idx)
+    if(field.continuous())
     {
-      const std::string var_name = field.var_name(var_idx);
-      const Uint var_begin = field.var_offset(var_idx);
-      const Uint field_size = field.continuous() ? field.size() : nb_elems;
-      const Uint var_size = field.var_length(var_idx);
-      const Uint var_end = var_begin + var_size;
-
-      XmlNode data_array = field.continuous()
-        ? point_data.add_node("DataArray")
-        : cell_data.add_node("DataArray");
-
-      data_array.set_attribute("type", sizeof(Real) == 4 ? "Float32" : "Float64");
-      data_array.set_attribute("NumberOfComponents", to_str(var_size == 2 && dim == 2 ? 3 : var_size));
-      data_array.set_attribute("Name", var_name);
-      data_array.set_attribute("format", "appended");
-      data_array.set_attribute("offset", to_str(appended_data.offset()));
-
-      appended_data.start_array(field_size*(var_size == 2 && dim == 2 ? 3 : var_size), sizeof(Real));
-
-      if(field.continuous())
+      if(dim == 2 && var_size == 2)
       {
-        if(dim == 2 && var_size == 2)
+        for(Uint i = 0; i != field_size; ++i)
         {
-          for(Uint i = 0; i != field_size; ++i)
+          for(Uint j = var_begin; j != var_end; ++j)
           {
-            for(Uint j = var_begin; j != var_end; ++j)
-            {
-              appended_data.push_back(field[i][j]);
-            }
-            appended_data.push_back(0.);
+            detail::push_back_real(appended_data, field[i][j], single_precision);
           }
-        }
-        else
-        {
-          for(Uint i = 0; i != field_size; ++i)
-            for(Uint j = var_begin; j != var_end; ++j)
-              appended_data.push_back(field[i][j]);
+          detail::push_back_real(appended_data, 0., single_precision);
         }
       }
       else
       {
-        boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
+        for(Uint i = 0; i != field_size; ++i)
+          for(Uint j = var_begin; j != var_end; ++j)
+            detail::push_back_real(appended_data, field[i][j], single_precision);
+      }
+    }
+    else
+    {
+      boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
+      {
+        const Connectivity& field_connectivity = field.dict().space(elements).connectivity();
+        if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
         {
-          const Connectivity& field_connectivity = field.dict().space(elements).connectivity();
-          if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+          const Uint n_elems = elements.size();
+          if(dim == 2 && var_size == 2)
           {
-            const Uint n_elems = elements.size();
-            if(dim == 2 && var_size == 2)
+            for(Uint i = 0; i != n_elems; ++i)
             {
-              for(Uint i = 0; i != n_elems; ++i)
+              for(Uint j = var_begin; j != var_end; ++j)
               {
-                for(Uint j = var_begin; j != var_end; ++j)
-                {
-                  /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
-                  appended_data.push_back(field[field_connectivity[i][0]][j]);
-                }
-                appended_data.push_back(0.);
+                /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
+                detail::push_back_real(appended_data, field[field_connectivity[i][0]][j], single_precision);
               }
+              detail::push_back_real(appended_data, 0., single_precision);
             }
-            else
+          }
+          else
+          {
+            for(Uint i = 0; i != n_elems; ++i)
             {
-              for(Uint i = 0; i != n_elems; ++i)
+              for(Uint j = var_begin; j != var_end; ++j)
               {
-                for(Uint j = var_begin; j != var_end; ++j)
-                {
-                  /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
-                  appended_data.push_back(field[field_connectivity[i][0]][j]);
-                }
+                /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
+                detail::push_back_real(appended_data, field[field_connectivity[i][0]][j], single_precision);
               }
             }
           }
         }
       }
-
-      appended_data.finish_array();
     }
-  }
-
-  // Write to file, inserting the binary data at the end
-  std::cout << "writing file " << my_path.path() << std::endl;
-  boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
 
-  // Remove the closing tag
-  std::string xml_string;
-  to_string(doc, xml_string);
-  boost::algorithm::erase_last(xml_string, "</VTKFile>");
-  boost::algorithm::trim_right(xml_string);
+    appended_data.finish_array();
+  }
 
-  // Write XML meta data
-  fout << xml_string;
+  cf3_assert(array_offsets.size() == nb_arrays);
 
-  // Append  compressed data
-  fout << "\n<AppendedData encoding=\"raw\">\n";
-  fout << appended_data.data_stream.rdbuf();
   fout << "\n</AppendedData>\n</VTKFile>\n";
 
+  // Replace the placeholders with the actual offsets, which have the same width
+  for(Uint i = 0; i != nb_arrays; ++i)
+  {
+    std::stringstream offset_str;
+    offset_str << std::setw(20) << std::setfill('0') << array_offsets[i];
+    fout.seekp(offset_positions[i]);
+    fout << offset_str.str();
+  }
+
   fout.close();
+  if(fout.fail())
+    throw FileSystemError(FromHere(), "Could not write file " + my_path.path());
 
   // Write the parallel header, if needed
   if(PE::Comm::instance().rank() == 0 || options().value<bool>("distributed_files"))
@@ -24,6 +24,10 @@ namespace VTKXML {
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines VTKXML mesh format writer
+/// The data arrays are appended in raw binary form and streamed to the file as they are
+/// generated. Compressed arrays are split in blocks that are compressed in parallel
+/// (using OpenMP threads when available), and the offsets in the XML header are filled
+/// in once all arrays are written.
 /// @author Bart Janssens
 class VTKXML_API Writer : public MeshWriter
 {
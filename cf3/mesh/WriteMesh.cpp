@@ -109,6 +109,7 @@ void WriteMesh::update_list_of_available_writers()
     ("cf3.mesh.CGNS.Writer")
 #endif
     ("cf3.mesh.gmsh.Writer")
+    ("cf3.mesh.native.Writer")
     ("cf3.mesh.neu.Writer")
     ("cf3.mesh.tecplot.Writer")
     ("cf3.mesh.VTKLegacy.Writer")
@@ -160,19 +161,22 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file )
 
 void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector<URI>& fields)
 {
-  update_list_of_available_writers();
-
-  /// @todo this should be improved to allow http(s) which would then upload the mesh
-  ///       to a remote location after writing to a temporary file
-  ///       uploading can be achieved using the curl library (which we already search for in the build system)
+  Handle< MeshWriter > writer = find_writer(file);
+  writer->options().set("fields",fields);
+  writer->options().set("mesh",mesh.handle<Mesh>());
+  writer->options().set("file", expand_filepath(file,mesh.metadata()));
+  writer->options().set("metadata",Handle<MeshMetadata const>());
 
-  URI filepath = file;
+  writer->execute();
+}
 
-  if( filepath.scheme() != URI::Scheme::FILE )
-    filepath.scheme( URI::Scheme::FILE );
+////////////////////////////////////////////////////////////////////////////////
 
+Handle<MeshWriter> WriteMesh::find_writer( const URI& file )
+{
+  update_list_of_available_writers();
 
-  const std::string extension = filepath.extension();
+  const std::string extension = file.extension();
 
   if ( m_extensions_to_writers.count(extension) == 0 )
     throw FileFormatError (FromHere(), "No meshwriter exists for files with extension " + extension);
@@ -180,16 +184,30 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
   if (m_extensions_to_writers[extension].size()>1)
   {
      std::string msg;
-     msg = filepath.string() + " has ambiguous extension " + extension + "\n"
+     msg = file.string() + " has ambiguous extension " + extension + "\n"
        +  "Possible writers for this extension are: \n";
      boost_foreach(const Handle< MeshWriter > writer , m_extensions_to_writers[extension])
        msg += " - " + writer->name() + "\n";
      throw FileFormatError( FromHere(), msg);
    }
 
-  // substitute the regex wildcards in the file name
+  return m_extensions_to_writers[extension][0];
+}
 
-  const MeshMetadata& metadata = mesh.metadata();
+////////////////////////////////////////////////////////////////////////////////
+
+URI WriteMesh::expand_filepath( const URI& file, const MeshMetadata& metadata ) const
+{
+  /// @todo this should be improved to allow http(s) which would then upload the mesh
+  ///       to a remote location after writing to a temporary file
+  ///       uploading can be achieved using the curl library (which we already search for in the build system)
+
+  URI filepath = file;
+
+  if( filepath.scheme() != URI::Scheme::FILE )
+    filepath.scheme( URI::Scheme::FILE );
+
+  // substitute the regex wildcards in the file name
 
   std::string file_str = filepath.path();
   boost::regex re("\\$\\{(\\w+)\\}");
@@ -230,14 +248,7 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
 
   filepath.path( file_str );
 
-  // get the correct writer based on the extension
-
-  Handle< MeshWriter > writer = m_extensions_to_writers[extension][0];
-  writer->options().set("fields",fields);
-  writer->options().set("mesh",mesh.handle<Mesh>());
-  writer->options().set("file", filepath);
-
-  writer->execute();
+  return filepath;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,6 +18,7 @@
 namespace cf3 {
 namespace mesh {
   class Mesh;
+  class MeshMetadata;
 ////////////////////////////////////////////////////////////////////////////////
 
 /// @author Tiago Quintino
@@ -60,6 +61,13 @@ public: // functions
   /// writes all the fields on the mesh
   void write_mesh( const Mesh&, const common::URI& file);
 
+  /// Find the writer for the extension of a file
+  /// @throws common::FileFormatError if no writer, or more than one writer, handles the extension
+  Handle<MeshWriter> find_writer( const common::URI& file );
+
+  /// File path with the wildcards such as ${iter} and ${time} substituted by the given metadata
+  common::URI expand_filepath( const common::URI& file, const MeshMetadata& metadata ) const;
+
   virtual void execute();
 
 protected: // helper functions
@@ -19,6 +19,7 @@
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -64,15 +65,15 @@ void BuildArea::execute()
   Field& area = faces_P0.create_field(mesh::Tags::area());
   area.add_tag(mesh::Tags::area());
 
+  RealVector areas;
   boost_foreach(const Handle<Space>& space, area.spaces() )
   {
-    RealMatrix coordinates;  space->support().geometry_space().allocate_coordinates(coordinates);
+    const Space& geometry_space = space->support().geometry_space();
+    space->support().element_type().compute_areas( geometry_space.connectivity(), geometry_space.dict().coordinates(), areas );
+
     const Connectivity& field_connectivity = space->connectivity();
     for (Uint face_idx = 0; face_idx<space->size(); ++face_idx)
-    {
-      space->support().geometry_space().put_coordinates( coordinates, face_idx );
-      area[field_connectivity[face_idx][0]][0] = space->support().element_type().area( coordinates );
-    }
+      area[field_connectivity[face_idx][0]][0] = areas[face_idx];
   }
 }
 
@@ -27,6 +27,7 @@
 #include "mesh/Faces.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
 
 #include "math/Functions.hpp"
 
@@ -76,52 +77,55 @@ void BuildFaceNormals::execute()
   Field& face_normals = faces_P0.create_field(mesh::Tags::normal(),std::string(mesh::Tags::normal())+"[vector]");
   face_normals.add_tag(mesh::Tags::normal());
 
-  Handle< Component > component;
-  Uint cell_idx(0);
+  const Field& coordinates = mesh.geometry_fields().coordinates();
+  boost::shared_ptr< common::Table<Uint> > face_nodes = common::allocate_component< common::Table<Uint> >("face_nodes");
+  RealMatrix normals;
   boost_foreach( const Handle<Space>& space, face_normals.spaces() )
   {
     Handle< FaceCellConnectivity > face2cell_ptr = find_component_ptr<FaceCellConnectivity>(space->support());
     if (is_not_null(face2cell_ptr))
     {
       FaceCellConnectivity& face2cell = *face2cell_ptr;
-      common::Table<Uint>& face_nb = face2cell.face_number();
-      RealMatrix face_coordinates(space->support().element_type().nb_nodes(),space->support().element_type().dimension());
-      RealVector normal(space->support().element_type().dimension());
-      for (Face2Cell face(face2cell); face.idx<face2cell.size(); ++face.idx)
-      {
-        // The normal will be outward to the first connected element
-        Entity cell = face.cells()[FIRST];
-        Connectivity::ConstRow cell_nodes = cell.get_nodes();
-        Uint i(0);
-        boost_foreach(Uint node_id, face.nodes() )
-        {
-          Uint j(0);
-          boost_foreach(const Real& coord, mesh.geometry_fields().coordinates()[node_id])
-          {
-            face_coordinates(i,j) = coord;
-            ++j;
-          }
-          ++i;
-        }
+      const ElementType& face_type = space->support().element_type();
+      const Connectivity& field_connectivity = space->connectivity();
 
-        if (face.element_type().dimensionality() == 0) // cannot compute normal from element_type
+      if (face_type.dimensionality() == 0) // cannot compute normal from element_type
+      {
+        for (Face2Cell face(face2cell); face.idx<face2cell.size(); ++face.idx)
         {
+          // The normal will be outward to the first connected element
+          Entity cell = face.cells()[FIRST];
           RealVector cell_centroid(1);
           cell.element_type().compute_centroid(cell.get_coordinates(),cell_centroid);
           RealVector normal(1);
-          normal = face_coordinates.row(0) - cell_centroid;
+          normal[XX] = coordinates[face.nodes()[0]][XX] - cell_centroid[XX];
           normal.normalize();
-          face_normals[space->connectivity()[face.idx][0]][XX]=normal[XX];
+          face_normals[field_connectivity[face.idx][0]][XX]=normal[XX];
         }
-        else
+      }
+      else
+      {
+        // Gather the face nodes as seen from the first connected element,
+        // so the normals point outward to that element
+        face_nodes->set_row_size(face_type.nb_nodes());
+        face_nodes->resize(face2cell.size());
+        for (Face2Cell face(face2cell); face.idx<face2cell.size(); ++face.idx)
         {
-          face.element_type().compute_normal(face_coordinates,normal);
-          Uint field_index = space->connectivity()[face.idx][0];
-          cf3_assert(field_index    < face_normals.size()    );
-          cf3_assert(normal.size() == face_normals.row_size());
-          for (Uint i=0; i<normal.size(); ++i)
-            face_normals[field_index][i]=normal[i];
+          const std::vector<Uint> nodes = face.nodes();
+          cf3_assert(nodes.size() == face_type.nb_nodes());
+          for (Uint i=0; i<nodes.size(); ++i)
+            (*face_nodes)[face.idx][i] = nodes[i];
+        }
+
+        face_type.compute_normals(*face_nodes, coordinates, normals);
 
+        cf3_assert(normals.cols() == face_normals.row_size());
+        for (Uint face_idx=0; face_idx<face2cell.size(); ++face_idx)
+        {
+          Uint field_index = field_connectivity[face_idx][0];
+          cf3_assert(field_index    < face_normals.size()    );
+          for (Uint i=0; i<normals.cols(); ++i)
+            face_normals[field_index][i]=normals(face_idx,i);
         }
       }
     }
@@ -7,7 +7,6 @@
 #include <set>
 
 #include <boost/foreach.hpp>
-#include <boost/functional/hash.hpp>
 
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
@@ -31,8 +30,8 @@
 #include "mesh/Region.hpp"
 #include "mesh/MeshElements.hpp"
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
-#include "mesh/Node2FaceCellConnectivity.hpp"
 #include "mesh/Cells.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Connectivity.hpp"
@@ -50,20 +49,32 @@ namespace actions {
   using namespace common;
   using namespace math::Functions;
 
-struct FaceCompare
+/// Collect the boundary faces of a face to cell connectivity, with their number of nodes
+static void collect_boundary_faces(FaceCellConnectivity& faces, std::vector<Face2Cell>& bdry_faces, std::vector<Uint>& nb_nodes)
 {
-  bool operator()(const Face2Cell& face1, const Face2Cell& face2) const
+  for (Uint idx=0; idx<faces.size(); ++idx)
   {
-    std::size_t seed1=0;
-    std::size_t seed2=0;
-
-    boost::hash_combine(seed1,face1.comp->uri().string());
-    boost::hash_combine(seed2,face2.comp->uri().string());
-    boost::hash_combine(seed1,face1.idx);
-    boost::hash_combine(seed2,face2.idx);
-    return seed1 < seed2;
+    Face2Cell face(faces,idx);
+    if (face.is_bdry())
+    {
+      bdry_faces.push_back(face);
+      nb_nodes.push_back(face.cells()[0].element_type().face_type(face.face_nb_in_cells()[0]).nb_nodes());
+    }
   }
-};
+}
+
+/// Index the collected faces on their nodes
+static void index_faces(std::vector<Face2Cell>& faces, const std::vector<Uint>& nb_nodes, FaceMatcher& matcher)
+{
+  matcher.set_face_sizes(nb_nodes);
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for
+#endif
+  for (int f=0; f<static_cast<int>(faces.size()); ++f)
+    matcher.set_face(f,faces[f].nodes());
+  std::vector<Uint> first_match;
+  matcher.match(first_match);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -443,21 +454,19 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::List<bool>::Buffer> >  buf_bdry;
   std::map<FaceCellConnectivity*,boost::shared_ptr<ElementConnectivity::Buffer> > buf_f2c;
 
-  // Build a node to face connectivity matching faces2
-  boost::shared_ptr<Node2FaceCellConnectivity> node2faces2_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
-  Node2FaceCellConnectivity& node2faces2 = *node2faces2_ptr;
+  // Index the boundary faces of region2 on their nodes
+  std::vector<Face2Cell> bdry_faces2;
+  std::vector<Uint> bdry_faces2_nb_nodes;
   boost_foreach(FaceCellConnectivity& faces2, find_components_recursively_with_tag<FaceCellConnectivity>(region2,mesh::Tags::inner_faces()))
   {
     buf_fnb [&faces2] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(faces2.face_number().create_buffer()));
     buf_bdry[&faces2] = boost::shared_ptr<common::List<bool>::Buffer> ( new common::List<bool>::Buffer(faces2.is_bdry_face().create_buffer()));
     buf_f2c [&faces2] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(faces2.connectivity().create_buffer()));
-    node2faces2.add_used(faces2); // it is assumed this is only face types
+    collect_boundary_faces(faces2,bdry_faces2,bdry_faces2_nb_nodes); // it is assumed this is only face types
   }
-  node2faces2.set_nodes(mesh.geometry_fields());
-  node2faces2.build_connectivity();
+  FaceMatcher faces2_matcher;
+  index_faces(bdry_faces2,bdry_faces2_nb_nodes,faces2_matcher);
 
-  Uint f1(0);
-  Uint faces1_idx(0);
   boost_foreach(FaceCellConnectivity& faces1, find_components_recursively_with_tag<FaceCellConnectivity>(region1,mesh::Tags::inner_faces()))
   {
     buf_fnb [&faces1] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(faces1.face_number().create_buffer()));
@@ -465,7 +474,6 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
     buf_f2c [&faces1] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(faces1.connectivity().create_buffer()));
 
 
-    std::vector<Uint> face_nodes;
     std::vector<Entity> elems(2);
     std::vector<Uint> face_nb(2);
     enum {LEFT=0,RIGHT=1};
@@ -475,59 +483,33 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
     for (Uint idx=0; idx<faces1.size(); ++idx)
     {
       Face2Cell face1(faces1,idx);
-      face_nodes = face1.nodes();
-      const Uint nb_nodes_per_face = face_nodes.size();
 
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
-
-      bool match_found = false;
-      boost_foreach(const Uint face_node, face_nodes)
+      // A match is a boundary face of region2 with exactly the same nodes
+      const Uint match = faces2_matcher.find(face1.nodes());
+      if (match != FaceMatcher::invalid())
       {
-        boost_foreach(const Face2Cell face2, node2faces2.connectivity()[face_node])
-        {
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(face2);
-          if ( it == not_found)
-          {
-            found_faces[face2]=1;
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            if (nb_faces == nb_nodes_per_face)
-            {
-              match_found = true;
-              elems[LEFT]  = face1.cells()[0];
-              elems[RIGHT] = face2.cells()[0];
-              face_nb[LEFT] = face1.face_nb_in_cells()[0];
-              face_nb[RIGHT] = face2.face_nb_in_cells()[0];
-//              CFdebug << PERank << "match found: " << elems[LEFT] << " <--> " << elems[RIGHT] << CFendl;
-
-              // Remove matches from the 2 connectivity tables and add to the interface
-              i2c.add_row(elems);
-              fnb.add_row(face_nb);
-//              fnb.add_row(buf_fnb[face1.comp]->get_row(face1.idx));
-              bdry.add_row(false);
-
-              buf_f2c [face1.comp]->rm_row(face1.idx);
-              buf_f2c [face2.comp]->rm_row(face2.idx);
-              buf_fnb [face1.comp]->rm_row(face1.idx);
-              buf_fnb [face2.comp]->rm_row(face2.idx);
-              buf_bdry[face1.comp]->rm_row(face1.idx);
-              buf_bdry[face2.comp]->rm_row(face2.idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
+        const Face2Cell& face2 = bdry_faces2[match];
+        elems[LEFT]  = face1.cells()[0];
+        elems[RIGHT] = face2.cells()[0];
+        face_nb[LEFT] = face1.face_nb_in_cells()[0];
+        face_nb[RIGHT] = face2.face_nb_in_cells()[0];
+//        CFdebug << PERank << "match found: " << elems[LEFT] << " <--> " << elems[RIGHT] << CFendl;
+
+        // Remove matches from the 2 connectivity tables and add to the interface
+        i2c.add_row(elems);
+        fnb.add_row(face_nb);
+        bdry.add_row(false);
+
+        buf_f2c [face1.comp]->rm_row(face1.idx);
+        buf_f2c [face2.comp]->rm_row(face2.idx);
+        buf_fnb [face1.comp]->rm_row(face1.idx);
+        buf_fnb [face2.comp]->rm_row(face2.idx);
+        buf_bdry[face1.comp]->rm_row(face1.idx);
+        buf_bdry[face2.comp]->rm_row(face2.idx);
+
+        ++nb_matches;
       }
-      ++f1;
     }
-    ++faces1_idx;
   }
 
   return interface;
@@ -545,18 +527,18 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::List<bool>::Buffer> >   buf_inner_face_is_bdry;
   std::map<FaceCellConnectivity*,boost::shared_ptr<ElementConnectivity::Buffer> >  buf_inner_face_connectivity;
 
-  // Build a node to face connectivity matching faces2
-  boost::shared_ptr<Node2FaceCellConnectivity> nodes_to_inner_faces_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
-  Node2FaceCellConnectivity& nodes_to_inner_faces = *nodes_to_inner_faces_ptr;
+  // Index the boundary faces of the inner region on their nodes
+  std::vector<Face2Cell> bdry_inner_faces;
+  std::vector<Uint> bdry_inner_faces_nb_nodes;
   boost_foreach(FaceCellConnectivity& f2c, find_components_recursively_with_tag<FaceCellConnectivity>(inner_region,mesh::Tags::inner_faces()))
   {
     buf_inner_face_nb          [&f2c] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(f2c.face_number().create_buffer()));
     buf_inner_face_is_bdry     [&f2c] = boost::shared_ptr<common::List<bool>::Buffer>  ( new common::List<bool>::Buffer(f2c.is_bdry_face().create_buffer()));
     buf_inner_face_connectivity[&f2c] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(f2c.connectivity().create_buffer()));
-    nodes_to_inner_faces.add_used(f2c);
+    collect_boundary_faces(f2c,bdry_inner_faces,bdry_inner_faces_nb_nodes);
   }
-  nodes_to_inner_faces.set_nodes(mesh.geometry_fields());
-  nodes_to_inner_faces.build_connectivity();
+  FaceMatcher inner_faces_matcher;
+  index_faces(bdry_inner_faces,bdry_inner_faces_nb_nodes,inner_faces_matcher);
 
   boost_foreach(Elements& bdry_faces, find_components<Elements>(bdry_region))
   {
@@ -585,132 +567,29 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
     std::vector<Entity> elems(1);
 
     // initialize a counter for see if matches are found.
-    // A match is found if every node of a boundary face is also found in an inner_face
+    // A match is found if a boundary face has exactly the same nodes as a boundary face of the inner region
     Uint nb_matches(0);
     for (Uint idx=0; idx<bdry_faces.size(); ++idx)
     {
       Entity bdry_entity(bdry_faces,idx);
-      Connectivity::ConstRow bdry_face_nodes = bdry_entity.get_nodes();
-      const Uint nb_nodes_per_face = bdry_face_nodes.size();
-
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
-
-      //      CFdebug << "    searching for match for " << bdry_entity << "  ( ";
-      //      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
-      //          CFdebug << bdry_face_node << " " ;
-      //      CFdebug << ")"<< CFendl;
-      bool match_found = false;
-      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
+      const Uint match = inner_faces_matcher.find(bdry_entity.get_nodes());
+      if (match != FaceMatcher::invalid())
       {
-        //        CFdebug << "         node = " << bdry_face_node << CFendl;
-        boost_foreach( Face2Cell& inner_face, nodes_to_inner_faces.connectivity()[bdry_face_node])
-        {
-          //          CFdebug << "           check inner_face["<<inner_face.idx<<"]  ( ";
-          //          boost_foreach(const Uint face_node, inner_face.nodes())
-          //              CFdebug << face_node << " ";
-          //          CFdebug << " )"<<CFendl;
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(inner_face);
-          if ( it == not_found)
-          {
-            found_faces[inner_face]=1;
-
-            it = found_faces.find(inner_face);
-            //            CFdebug << "               bump " << it->first.comp->uri().path() << "  " << it->first.idx << CFendl;
-
-            if (nb_nodes_per_face == 1)
-            {
-              match_found = true;
-              elems[0] = inner_face.cells()[0];
-
-              //              CFdebug << PERank << "match found: " << inner_face.comp->uri().string()<<"["<<inner_face.idx<<"]" << " <--> " << elems[0] << CFendl;
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            //            CFdebug << "               bump " << it->first.comp->uri().path() << "  " << it->first.idx << CFendl;
-
-            if (nb_faces == nb_nodes_per_face)
-            {
-
-              match_found = true;
-              elems[0] = inner_face.cells()[0];
-
-//              CFdebug << PERank << "match found: " << inner_face.comp->uri().string()<<"["<<inner_face.idx<<"]" << " <--> " << elems[0] << CFendl;
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
-              break;
-
-
-
-
-//              match_found = true;
-//              Handle< FaceCellConnectivity > inner_faces_to_cells;
-//              Uint inner_face_idx;
-//              Uint inner_faces_comp_idx;
-//              boost::tie(inner_faces_comp_idx,inner_face_idx) = nodes_to_inner_faces.face_cell_connectivity().location_idx(unified_inner_face_idx);
-//              inner_faces_to_cells = Handle<FaceCellConnectivity>(unified_inner_faces_to_cells->components()[inner_faces_comp_idx]);
-//              elems[0] = inner_faces_to_cells->connectivity()[inner_face_idx][0];
-
-//              // ----------- debug -----------
-//              //Handle< Component > inner_cell_comp;
-//              //Uint inner_cell_idx;
-//              //boost::tie(inner_cell_comp,inner_cell_idx) = inner_faces_to_cells->lookup().location(inner_faces_to_cells->connectivity()[inner_face_idx][0]);
-//              //CFdebug << PERank << "match found: " << bdry_faces.parent().name() << "/" << bdry_faces.name() << "["<<local_bdry_face_idx<<"] <--> " << inner_cell_comp->parent().name()<<"/"<<inner_cell_comp->name()<<"["<<inner_cell_idx<<"]" << CFendl;
-//              // -----------------------------
-
-//               // RealMatrix cell_coordinates = inner_cell_comp->as_type<Elements>().get_coordinates(inner_cell_idx);
-//               // RealVector face_coordinates = bdry_faces.get_coordinates(local_bdry_face_idx).row(0);
-//               // bool match_found_double_check = false;
-//               // for (Uint i=0; i<cell_coordinates.rows(); ++i)
-//               // {
-//               //   if (cell_coordinates.row(i) == face_coordinates.transpose())
-//               //   {
-//               //     match_found_double_check = true;
-//               //     break;
-//               //   }
-//               // }
-//               // cf3_assert(match_found_double_check);
-
-//              // Remove matches from the 2 connectivity tables and add to the interface
-//              bdry_face_connectivity.set_row(local_bdry_face_idx,elems);
-//              bdry_face_nb[local_bdry_face_idx] = buf_vec_inner_face_nb[inner_faces_comp_idx]->get_row(inner_face_idx);
-//              bdry_face_is_bdry[local_bdry_face_idx] = true;
-
-//              buf_vec_inner_face_connectivity[inner_faces_comp_idx]->rm_row(inner_face_idx);
-//              buf_vec_inner_face_nb[inner_faces_comp_idx]->rm_row(inner_face_idx);
-//              buf_vec_inner_face_is_bdry[inner_faces_comp_idx]->rm_row(inner_face_idx);
-
-//              ++nb_matches;
-//              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
+        Face2Cell& inner_face = bdry_inner_faces[match];
+        elems[0] = inner_face.cells()[0];
+
+//        CFdebug << PERank << "match found: " << inner_face.comp->uri().string()<<"["<<inner_face.idx<<"]" << " <--> " << elems[0] << CFendl;
+
+        // Remove matches from the inner_faces_connectivity tables and add to the boundary
+        bdry_face_connectivity.set_row(bdry_entity.idx,elems);
+        bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
+        bdry_face_is_bdry[bdry_entity.idx] = true;
+
+        buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
+
+        ++nb_matches;
       }
     }
   }
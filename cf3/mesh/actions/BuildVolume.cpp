@@ -19,6 +19,7 @@
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -64,16 +65,15 @@ void BuildVolume::execute()
   Field& volume = cells_P0.create_field("volume");
   volume.add_tag(mesh::Tags::volume());
 
+  RealVector volumes;
   boost_foreach( const Handle<Space>& space, volume.spaces() )
   {
-    RealMatrix coordinates;  space->support().geometry_space().allocate_coordinates(coordinates);
+    const Space& geometry_space = space->support().geometry_space();
+    space->support().element_type().compute_volumes( geometry_space.connectivity(), geometry_space.dict().coordinates(), volumes );
 
     const Connectivity& space_connectivity = space->connectivity();
     for (Uint cell_idx = 0; cell_idx<space->size(); ++cell_idx)
-    {
-      space->support().geometry_space().put_coordinates( coordinates, cell_idx );
-      volume[space_connectivity[cell_idx][0]][0] = space->support().element_type().volume( coordinates );
-    }
+      volume[space_connectivity[cell_idx][0]][0] = volumes[cell_idx];
   }
 
 }
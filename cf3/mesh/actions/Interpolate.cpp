@@ -19,8 +19,9 @@
 #include "mesh/Region.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
 #include "mesh/ShapeFunction.hpp"
-#include "mesh/Octtree.hpp"
+#include "mesh/ElementFinder.hpp"
 #include "mesh/Connectivity.hpp"
 
 #include "mesh/actions/Interpolate.hpp"
@@ -62,6 +63,11 @@ Interpolate::Interpolate( const std::string& name )
       .mark_basic()
       .link_to(&m_target);
 
+  options().add("element_finder", std::string("cf3.mesh.ElementFinderOcttree"))
+      .description("Builder name of the element finder used to locate coordinates in the source mesh")
+      .pretty_name("Element Finder")
+      .attach_trigger( boost::bind( &Interpolate::configure_element_finder, this ) );
+
   regist_signal ( "interpolate" )
       .description( "Interpolate to given coordinates, not mesh-related" )
       .pretty_name("Interpolate" )
@@ -72,6 +78,17 @@ Interpolate::Interpolate( const std::string& name )
 
 /////////////////////////////////////////////////////////////////////////////
 
+void Interpolate::configure_element_finder()
+{
+  if (is_not_null(m_element_finder))
+  {
+    remove_component(m_element_finder->name());
+    m_element_finder = Handle<ElementFinder>();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void Interpolate::execute()
 {
   if (is_null(m_source))
@@ -157,22 +174,20 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
 
   Mesh& source_mesh = find_parent_component<Mesh>(source);
 
-  if ( is_null(m_octtree) )
+  if ( is_null(m_element_finder) )
   {
-    if (Handle<Component> found = source_mesh.get_child("octtree"))
-      m_octtree = Handle<Octtree>(found);
-    else
-    {
-      m_octtree = source_mesh.create_component<Octtree>("octtree");
-      m_octtree->options().set("mesh",source_mesh.handle<Mesh>());
-    }
+    m_element_finder = Handle<ElementFinder>(create_component("element_finder",options().value<std::string>("element_finder")));
+    // Coordinates that are not inside a local element are interpolated by other ranks
+    m_element_finder->options().set("find_closest",false);
   }
+  if ( m_element_finder->options().value< Handle<Dictionary> >("dict") != source_mesh.geometry_fields().handle<Dictionary>() )
+    m_element_finder->options().set("dict",source_mesh.geometry_fields().handle<Dictionary>());
 
   const Uint dimension = source_mesh.dimension();
   const Uint nb_vars = source.row_size();
   m_source = Handle<Field const>(source.handle<Component>());
 
-  Entity element;
+  SpaceElem element;
   std::deque<Uint> missing_cells;
 
   RealVector coord(dimension); coord.setZero();
@@ -182,9 +197,9 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
   {
     for (Uint d=0; d<target_dim; ++d)
       coord[d] = coordinates[i][d];
-    if( m_octtree->find_element(coord,element) )
+    if( m_element_finder->find_element(coord,element) )
     {
-      interpolate_coordinate( coord, *element.comp, element.idx, target[i] );
+      interpolate_coordinate( coord, element.comp->support(), element.idx, target[i] );
 //      std::cout<< PERank << "interpolate for coord (" << coord.transpose() << ") in " << element_component->uri().path() << "["<<element_idx<<"] ... done" << std::endl;
     }
     else
@@ -250,11 +265,11 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
         for (Uint d=0; d<target_dim; ++d)
           coord[d] = recv_coordinates[i][d];
 
-        if( m_octtree->find_element(coord,element) )
+        if( m_element_finder->find_element(coord,element) )
         {
 //          std::cout<< PERank << " send to " << root << ": interpolate for coord (" << coord.transpose() << ") in " << element_component->uri().path() << "["<<element_idx<<"]" << std::endl;
           boost::multi_array<Real,2> target_row(boost::extents[1][nb_vars]);
-          interpolate_coordinate( coord, *element.comp, element.idx, target_row[0] );
+          interpolate_coordinate( coord, element.comp->support(), element.idx, target_row[0] );
           for (Uint v=0; v<nb_vars; ++v)
             send_target_rows[i*nb_vars+v] = target_row[0][v];
         }
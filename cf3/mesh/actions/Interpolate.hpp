@@ -20,7 +20,7 @@
 namespace cf3 {
 namespace mesh {
 
-  class Octtree;
+  class ElementFinder;
   class Field;
   class Elements;
 
@@ -64,8 +64,10 @@ private:
   /// target field
   Handle<Field> m_target;
 
-  /// source octtree
-  Handle<Octtree> m_octtree;
+  /// finds the source element of a coordinate, created from the "element_finder" option
+  Handle<ElementFinder> m_element_finder;
+
+  void configure_element_finder();
 
   void interpolate_coordinate(const RealVector& target_coord, const Entities& element_component, const Uint element_idx, Field::Row target_row);
 
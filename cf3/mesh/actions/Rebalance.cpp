@@ -0,0 +1,299 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <set>
+
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/TimedComponent.hpp"
+#include "common/URI.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/actions/Rebalance.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/MeshAdaptor.hpp"
+#include "mesh/MeshPartitioner.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+using namespace common::PE;
+using namespace math::Consts;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < Rebalance, MeshTransformer, mesh::actions::LibActions> Rebalance_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Rebalance::Rebalance( const std::string& name ) :
+  MeshTransformer(name),
+  m_imbalance(1.)
+{
+  properties()["brief"] = std::string("Repartition the mesh based on measured execution times");
+  std::string desc;
+  desc =
+    "  Usage: Rebalance actions:array[uri]=//solver imbalance_threshold:real=1.1\n\n"
+    "  Execution times of the timed actions are turned into a cost per element of\n"
+    "  the regions they loop over. If the measured imbalance between processors exceeds\n"
+    "  the threshold, the mesh is partitioned again with these costs as element weights.\n";
+  properties()["description"] = desc;
+
+  options().add("actions", std::vector<URI>())
+      .description("Timed actions, or components containing timed actions, whose execution times are used. "
+                   "Actions with a \"regions\" option attribute their time to the elements of these regions.")
+      .pretty_name("Actions")
+      .mark_basic();
+
+  options().add("imbalance_threshold", 1.1)
+      .description("Repartition when the largest load of a processor exceeds the average load by this factor")
+      .pretty_name("Imbalance Threshold")
+      .mark_basic();
+
+  options().add("partitioner", std::string("cf3.mesh.GeometricPartitioner"))
+      .description("Builder name of the MeshPartitioner, which must use the element weights")
+      .pretty_name("Partitioner");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Rebalance::execute()
+{
+  Mesh& mesh = *m_mesh;
+  m_imbalance = 1.;
+
+  if( !Comm::instance().is_active() || Comm::instance().size() == 1 )
+    return;
+
+  const Uint nb_entities = mesh.elements().size();
+
+  std::vector<std::string> actions;
+  std::vector<Real> times;
+  std::vector< std::vector<Uint> > entities_of_action;
+  collect_timings(actions, times, entities_of_action);
+  const Uint nb_actions = actions.size();
+
+  // Measured cost of one element, for every action. Ghost elements are looped over
+  // but not assembled, so the time is attributed to the owned elements only.
+  std::vector<Real> nb_owned(nb_entities, 0.);
+  for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+  {
+    const Entities& entities = *mesh.elements()[entities_idx];
+    for (Uint elem=0; elem<entities.size(); ++elem)
+      if (!entities.is_ghost(elem))
+        nb_owned[entities_idx] += 1.;
+  }
+  std::vector<Real> nb_elements(nb_actions, 0.);
+  for (Uint action=0; action<nb_actions; ++action)
+  {
+    boost_foreach(const Uint entities_idx, entities_of_action[action])
+      nb_elements[action] += nb_owned[entities_idx];
+  }
+  std::vector<Real> total_times(times);
+  std::vector<Real> total_nb_elements(nb_elements);
+  Comm::instance().all_reduce(PE::plus(), total_times, total_times);
+  Comm::instance().all_reduce(PE::plus(), total_nb_elements, total_nb_elements);
+
+  // Cost of an element of every Entities: the sum of the costs of the actions looping over it.
+  // Elements no timed action loops over get the smallest measured cost.
+  std::vector<Real> entities_cost(nb_entities, 0.);
+  std::vector<bool> is_measured(nb_entities, false);
+  Real min_cost = real_max();
+  Real total_time = 0.;
+  for (Uint action=0; action<nb_actions; ++action)
+  {
+    total_time += total_times[action];
+    if (total_times[action] <= 0. || total_nb_elements[action] == 0.)
+      continue;
+    const Real cost = total_times[action] / total_nb_elements[action];
+    min_cost = std::min(min_cost, cost);
+    boost_foreach(const Uint entities_idx, entities_of_action[action])
+    {
+      entities_cost[entities_idx] += cost;
+      is_measured[entities_idx] = true;
+    }
+  }
+  if (min_cost == real_max())
+    min_cost = 1.;
+  for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+  {
+    if (!is_measured[entities_idx])
+      entities_cost[entities_idx] = min_cost;
+  }
+
+  // Load of this processor: the measured time, or without timings the weight of the owned elements
+  Real load = 0.;
+  if (total_time > 0.)
+  {
+    boost_foreach(const Real time, times)
+      load += time;
+  }
+  else
+  {
+    for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+      load += nb_owned[entities_idx] * entities_cost[entities_idx];
+  }
+  std::vector<Real> loads;
+  Comm::instance().all_gather(load, loads);
+  Real max_load = 0.;
+  Real total_load = 0.;
+  boost_foreach(const Real proc_load, loads)
+  {
+    max_load = std::max(max_load, proc_load);
+    total_load += proc_load;
+  }
+  if (total_load > 0.)
+    m_imbalance = max_load * loads.size() / total_load;
+
+  CFinfo << "rebalancing mesh " << mesh.uri() << ": measured imbalance " << m_imbalance << CFendl;
+  if (m_imbalance <= options().value<Real>("imbalance_threshold"))
+  {
+    CFinfo << "  + imbalance below threshold, keeping partitioning" << CFendl;
+    return;
+  }
+
+  CFinfo << "  + removing overlap ..." << CFendl;
+  const bool had_overlap = remove_overlap();
+  CFinfo << "  + removing overlap ... done" << CFendl;
+
+  CFinfo << "  + building joint node & element global numbering and connectivity ..." << CFendl;
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalNumbering","glb_numbering")->transform(mesh);
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalConnectivity","glb_connectivity")->transform(mesh);
+  CFinfo << "  + building joint node & element global numbering and connectivity ... done" << CFendl;
+
+  // Ghost elements do not add to the load of a processor
+  std::vector< std::vector<Real> > element_weights(nb_entities);
+  for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+  {
+    const Entities& entities = *mesh.elements()[entities_idx];
+    element_weights[entities_idx].resize(entities.size());
+    for (Uint elem=0; elem<entities.size(); ++elem)
+      element_weights[entities_idx][elem] = entities.is_ghost(elem) ? 0. : entities_cost[entities_idx];
+  }
+
+  const std::string partitioner_name = options().value<std::string>("partitioner");
+  boost::shared_ptr<MeshPartitioner> partitioner =
+      boost::dynamic_pointer_cast<MeshPartitioner>(build_component_abstract_type<MeshTransformer>(partitioner_name,"partitioner"));
+  if (is_null(partitioner))
+    throw SetupError(FromHere(), "Component "+partitioner_name+" used by "+uri().string()+" is not a MeshPartitioner");
+  partitioner->set_element_weights(element_weights);
+
+  CFinfo << "  + partitioning and migrating ..." << CFendl;
+  partitioner->transform(mesh);
+  CFinfo << "  + partitioning and migrating ... done" << CFendl;
+
+  if (had_overlap)
+  {
+    CFinfo << "  + growing overlap layer ..." << CFendl;
+    build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GrowOverlap","grow_overlap")->transform(mesh);
+    CFinfo << "  + growing overlap layer ... done" << CFendl;
+  }
+
+  // Costs are measured again from here on
+  for (Uint action=0; action<nb_actions; ++action)
+    m_previous_times[actions[action]] += times[action];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Rebalance::collect_timings(std::vector<std::string>& actions,
+                                std::vector<Real>& times,
+                                std::vector< std::vector<Uint> >& entities_of_action) const
+{
+  const Mesh& mesh = *m_mesh;
+  std::map<const Entities*,Uint> entities_idx;
+  for (Uint idx=0; idx<mesh.elements().size(); ++idx)
+    entities_idx[mesh.elements()[idx].get()] = idx;
+
+  // All components with timings, found in the same order on every processor
+  std::vector<Component*> timed;
+  std::set<Component*> found;
+  boost_foreach(const URI& action_uri, options().value< std::vector<URI> >("actions"))
+  {
+    Handle<Component> root = access_component(action_uri);
+    if (is_null(root))
+      throw ValueNotFound(FromHere(), "Could not find timed action "+action_uri.string());
+
+    std::vector<Component*> candidates(1, root.get());
+    boost_foreach(Component& child, find_components_recursively(*root))
+      candidates.push_back(&child);
+
+    boost_foreach(Component* candidate, candidates)
+    {
+      if (TimedComponent* timed_component = dynamic_cast<TimedComponent*>(candidate))
+        timed_component->store_timings();
+      if (candidate->properties().check("timer_count") && candidate->properties().check("timer_mean")
+          && candidate->options().check("regions") && found.insert(candidate).second)
+        timed.push_back(candidate);
+    }
+  }
+
+  boost_foreach(Component* action, timed)
+  {
+    const std::string path = action->uri().path();
+    const Real time = action->properties().value<Uint>("timer_count") * action->properties().value<Real>("timer_mean");
+    std::map<std::string,Real>::const_iterator previous = m_previous_times.find(path);
+    actions.push_back(path);
+    times.push_back(previous == m_previous_times.end() ? time : time - previous->second);
+
+    // Entities of this mesh in the regions of the action
+    std::set<Uint> action_entities;
+    boost_foreach(const URI& region_uri, action->options().value< std::vector<URI> >("regions"))
+    {
+      Handle<Component const> comp = region_uri.is_relative() ? mesh.access_component(region_uri) : access_component(region_uri);
+      if (is_null(comp))
+        continue;
+      boost_foreach(const Entities& entities, find_components_recursively<Entities>(*comp))
+      {
+        std::map<const Entities*,Uint>::const_iterator itr = entities_idx.find(&entities);
+        if (itr != entities_idx.end())
+          action_entities.insert(itr->second);
+      }
+    }
+    entities_of_action.push_back(std::vector<Uint>(action_entities.begin(), action_entities.end()));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool Rebalance::remove_overlap()
+{
+  Uint nb_ghosts = 0;
+  boost_foreach(const Handle<Entities>& entities, m_mesh->elements())
+  {
+    for (Uint elem=0; elem<entities->size(); ++elem)
+      if (entities->is_ghost(elem))
+        ++nb_ghosts;
+  }
+  Comm::instance().all_reduce(PE::plus(), &nb_ghosts, 1, &nb_ghosts);
+  if (nb_ghosts == 0)
+    return false;
+
+  MeshAdaptor mesh_adaptor(*m_mesh);
+  mesh_adaptor.prepare();
+  mesh_adaptor.remove_ghost_elements();
+  mesh_adaptor.finish();
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
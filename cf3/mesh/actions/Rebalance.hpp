@@ -0,0 +1,86 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_Rebalance_hpp
+#define cf3_mesh_actions_Rebalance_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Repartition a distributed mesh based on measured execution times
+///
+/// The execution times of timed actions (see common::TimedActionImpl) are collected.
+/// Actions with a "regions" option, such as solver actions, attribute their time
+/// to the owned elements of these regions, which gives a measured cost per element for
+/// every region. Ghost elements get no weight. The total time of every processor
+/// gives the measured imbalance.
+///
+/// If the imbalance exceeds the threshold, the overlap is removed, the mesh is
+/// partitioned again with the element costs as weights, and elements, nodes and
+/// field values are migrated with MeshAdaptor. The overlap is grown again afterwards.
+///
+/// Only the time spent since the previous rebalancing is used, so that the costs
+/// always reflect the current partitioning.
+/// @note Timings are only available when CF3_ENABLE_COMPONENT_TIMING is on.
+///       Without timings, every element has unit weight.
+class mesh_actions_API Rebalance : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  Rebalance( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Rebalance"; }
+
+  virtual void execute();
+
+  /// @return the imbalance measured by the last execute():
+  ///         the largest load of a processor, relative to the average load
+  Real imbalance() const { return m_imbalance; }
+
+private: // functions
+
+  /// Collect the time every timed action spent since the previous rebalancing,
+  /// and the Entities of the mesh each action loops over
+  void collect_timings(std::vector<std::string>& actions,
+                       std::vector<Real>& times,
+                       std::vector< std::vector<Uint> >& entities_of_action) const;
+
+  /// Remove ghost elements, so that only owned elements are partitioned
+  /// @return true if there was overlap on any processor
+  bool remove_overlap();
+
+private: // data
+
+  /// Time of every action at the previous rebalancing, by action path
+  std::map<std::string,Real> m_previous_times;
+
+  Real m_imbalance;
+
+}; // end Rebalance
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_Rebalance_hpp
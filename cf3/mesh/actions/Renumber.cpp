@@ -0,0 +1,505 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <numeric>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PropertyList.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/List.hpp"
+#include "common/Table.hpp"
+#include "common/CSRTable.hpp"
+
+#include "math/Hilbert.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/NodeElementConnectivity.hpp"
+#include "mesh/BoundingBox.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+  using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < Renumber, MeshTransformer, mesh::actions::LibActions> Renumber_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Move row new_to_old[i] of a table to row i
+template <typename T>
+void reorder_rows(common::Table<T>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  const typename common::Table<T>::ArrayT old_array(table.array());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    table.array()[i] = old_array[new_to_old[i]];
+}
+
+/// Move entry new_to_old[i] of a list to entry i
+template <typename T>
+void reorder_rows(common::List<T>& list, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(list.size() == new_to_old.size());
+  const typename common::List<T>::ListT old_array(list.array());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    list.array()[i] = old_array[new_to_old[i]];
+}
+
+/// Move row new_to_old[i] of a CSRTable to row i
+void reorder_rows(common::CSRTable<Uint>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  const std::vector<Uint> old_offsets(table.offsets());
+  const std::vector<Uint> old_values(table.values());
+  CSRTableBuilder<Uint> builder(table, new_to_old.size());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    builder.count(i, old_offsets[new_to_old[i]+1]-old_offsets[new_to_old[i]]);
+  builder.allocate();
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    for (Uint j=old_offsets[new_to_old[i]]; j<old_offsets[new_to_old[i]+1]; ++j)
+      builder.add(i, old_values[j]);
+}
+
+std::vector<Uint> invert(const std::vector<Uint>& new_to_old)
+{
+  std::vector<Uint> old_to_new(new_to_old.size());
+  for (Uint i=0; i<new_to_old.size(); ++i)
+    old_to_new[new_to_old[i]] = i;
+  return old_to_new;
+}
+
+/// Sort indices by their keys, equal keys keep their original order
+std::vector<Uint> sort_by_keys(const std::vector<boost::uint64_t>& keys)
+{
+  std::vector< std::pair<boost::uint64_t,Uint> > sorted(keys.size());
+  for (Uint i=0; i<keys.size(); ++i)
+    sorted[i] = std::make_pair(keys[i], i);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<Uint> new_to_old(keys.size());
+  for (Uint i=0; i<keys.size(); ++i)
+    new_to_old[i] = sorted[i].second;
+  return new_to_old;
+}
+
+/// Node graph of a dictionary, where nodes are neighbours if they share an element
+class NodeGraph
+{
+public:
+
+  NodeGraph(const Dictionary& dict) : m_nb_nodes(dict.size()), m_stamp(0)
+  {
+    boost_foreach(const Handle<Space>& space, dict.spaces())
+      m_connectivities.push_back(&space->connectivity());
+
+    // Elements of every node, as (connectivity, element) pairs in compressed rows
+    m_node_to_elem_offsets.assign(m_nb_nodes+1, 0u);
+    for (Uint c=0; c<m_connectivities.size(); ++c)
+      boost_foreach(Connectivity::ConstRow nodes, m_connectivities[c]->array())
+        boost_foreach(const Uint node, nodes)
+          ++m_node_to_elem_offsets[node+1];
+    std::partial_sum(m_node_to_elem_offsets.begin(), m_node_to_elem_offsets.end(), m_node_to_elem_offsets.begin());
+    m_node_to_elem.resize(m_node_to_elem_offsets.back());
+    std::vector<Uint> position(m_node_to_elem_offsets.begin(), m_node_to_elem_offsets.end()-1);
+    for (Uint c=0; c<m_connectivities.size(); ++c)
+      for (Uint e=0; e<m_connectivities[c]->size(); ++e)
+        boost_foreach(const Uint node, (*m_connectivities[c])[e])
+          m_node_to_elem[position[node]++] = std::make_pair(c,e);
+
+    m_marker.assign(m_nb_nodes, 0u);
+    m_degree.resize(m_nb_nodes);
+    std::vector<Uint> neighbours;
+    for (Uint node=0; node<m_nb_nodes; ++node)
+    {
+      compute_neighbours(node, neighbours);
+      m_degree[node] = neighbours.size();
+    }
+  }
+
+  Uint size() const { return m_nb_nodes; }
+
+  Uint degree(const Uint node) const { return m_degree[node]; }
+
+  /// Nodes sharing an element with the given node, without duplicates
+  void compute_neighbours(const Uint node, std::vector<Uint>& neighbours)
+  {
+    neighbours.clear();
+    ++m_stamp;
+    m_marker[node] = m_stamp;
+    for (Uint i=m_node_to_elem_offsets[node]; i<m_node_to_elem_offsets[node+1]; ++i)
+    {
+      const std::pair<Uint,Uint>& elem = m_node_to_elem[i];
+      boost_foreach(const Uint neighbour, (*m_connectivities[elem.first])[elem.second])
+      {
+        if (m_marker[neighbour] != m_stamp)
+        {
+          m_marker[neighbour] = m_stamp;
+          neighbours.push_back(neighbour);
+        }
+      }
+    }
+  }
+
+private:
+
+  Uint m_nb_nodes;
+  std::vector<const Connectivity*> m_connectivities;
+  std::vector<Uint> m_node_to_elem_offsets;
+  std::vector< std::pair<Uint,Uint> > m_node_to_elem;
+  /// Nodes already found in a call to compute_neighbours() are marked with the stamp of that call
+  std::vector<Uint> m_marker;
+  Uint m_stamp;
+  std::vector<Uint> m_degree;
+};
+
+/// Compare nodes by their degree in the graph
+struct LessDegree
+{
+  LessDegree(const NodeGraph& graph) : m_graph(graph) {}
+  bool operator()(const Uint a, const Uint b) const
+  {
+    return m_graph.degree(a) < m_graph.degree(b) || (m_graph.degree(a) == m_graph.degree(b) && a < b);
+  }
+  const NodeGraph& m_graph;
+};
+
+/// Breadth first search from a start node, ordering the unvisited neighbours
+/// of every node by increasing degree (Cuthill-McKee)
+/// @return the position in order where the last level starts
+Uint breadth_first_search(NodeGraph& graph, const Uint start, std::vector<bool>& visited, std::vector<Uint>& order)
+{
+  std::vector<Uint> neighbours;
+  const Uint begin = order.size();
+  visited[start] = true;
+  order.push_back(start);
+  Uint level_begin = begin;
+  Uint level_end = order.size();
+  while (level_begin != level_end)
+  {
+    for (Uint i=level_begin; i<level_end; ++i)
+    {
+      graph.compute_neighbours(order[i], neighbours);
+      const Uint first_new = order.size();
+      boost_foreach(const Uint neighbour, neighbours)
+      {
+        if (!visited[neighbour])
+        {
+          visited[neighbour] = true;
+          order.push_back(neighbour);
+        }
+      }
+      std::sort(order.begin()+first_new, order.end(), LessDegree(graph));
+    }
+    if (order.size() == level_end)
+      break;
+    level_begin = level_end;
+    level_end = order.size();
+  }
+  return level_begin;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+Renumber::Renumber( const std::string& name )
+: MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Renumber nodes and elements for cache locality");
+  std::string desc;
+  desc =
+    "  Usage: Renumber ordering:string=rcm \n\n"
+    "  Reorders the nodes of the geometry with reverse Cuthill-McKee (rcm) or along\n"
+    "  a Hilbert space-filling curve (hilbert). Elements are sorted to follow the nodes,\n"
+    "  and the rows of other dictionaries follow the elements.\n";
+  properties()["description"] = desc;
+
+  std::vector<boost::any> orderings;
+  orderings.push_back(std::string("rcm"));
+  orderings.push_back(std::string("hilbert"));
+  options().add("ordering", std::string("rcm"))
+      .description("Ordering of the geometry nodes: reverse Cuthill-McKee (rcm) or Hilbert space-filling curve (hilbert)")
+      .pretty_name("Ordering")
+      .restricted_list() = orderings;
+
+  options().add("elements", true)
+      .description("Also renumber the elements")
+      .pretty_name("Elements");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Renumber::execute()
+{
+  Mesh& mesh = *m_mesh;
+  const std::string ordering = options().value<std::string>("ordering");
+  if (ordering != "rcm" && ordering != "hilbert")
+    throw BadValue(FromHere(), "Ordering \""+ordering+"\" is not supported by "+uri().string()+". Choose rcm or hilbert");
+
+  CFinfo << "Renumbering mesh " << mesh.uri() << " with " << ordering << " ordering" << CFendl;
+
+  mesh.update_structures();
+
+  Dictionary& geometry = mesh.geometry_fields();
+  renumber_dictionary(geometry, order_geometry_nodes(ordering));
+
+  m_elements_old_to_new.clear();
+  if (options().value<bool>("elements"))
+  {
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+      renumber_entities(*entities, order_elements(*entities, ordering));
+    update_element_references();
+  }
+
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+  {
+    if (dict.get() != &geometry)
+      renumber_dictionary(*dict, order_by_first_use(*dict));
+  }
+
+  // Node to element tables are indexed by node and store unified element indices,
+  // which both changed, so they are rebuilt from the renumbered connectivity.
+  // Face to cell tables refer to elements through ElementConnectivity, updated above.
+  boost_foreach(NodeElementConnectivity& node2elem, find_components_recursively<NodeElementConnectivity>(mesh))
+  {
+    if (node2elem.elements().components().size())
+      node2elem.build_connectivity();
+  }
+
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+    dict->rebuild_comm_pattern();
+
+  mesh.raise_mesh_changed();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<Uint> Renumber::order_geometry_nodes(const std::string& ordering)
+{
+  Dictionary& geometry = m_mesh->geometry_fields();
+  const Uint nb_nodes = geometry.size();
+
+  if (ordering == "hilbert")
+  {
+    boost::shared_ptr<BoundingBox> bounding_box = allocate_component<BoundingBox>("bounding_box");
+    bounding_box->build(geometry.coordinates());
+    math::Hilbert compute_hilbert_idx(*bounding_box, 20);
+    const Field& coordinates = geometry.coordinates();
+    RealVector coord(coordinates.row_size());
+    std::vector<boost::uint64_t> keys(nb_nodes);
+    for (Uint node=0; node<nb_nodes; ++node)
+    {
+      for (Uint d=0; d<coordinates.row_size(); ++d)
+        coord[d] = coordinates[node][d];
+      keys[node] = compute_hilbert_idx(coord);
+    }
+    return sort_by_keys(keys);
+  }
+
+  // Reverse Cuthill-McKee, for every connected part of the graph starting
+  // from a pseudo-peripheral node: the node of lowest degree in the last level
+  // of a breadth first search from the unvisited node of lowest degree
+  NodeGraph graph(geometry);
+  std::vector<Uint> by_degree(nb_nodes);
+  for (Uint node=0; node<nb_nodes; ++node)
+    by_degree[node] = node;
+  std::sort(by_degree.begin(), by_degree.end(), LessDegree(graph));
+
+  std::vector<Uint> order;
+  order.reserve(nb_nodes);
+  std::vector<bool> visited(nb_nodes, false);
+  std::vector<bool> trial_visited(nb_nodes, false);
+  std::vector<Uint> trial_order;
+  boost_foreach(const Uint candidate, by_degree)
+  {
+    if (visited[candidate])
+      continue;
+
+    trial_order.clear();
+    const Uint last_level = breadth_first_search(graph, candidate, trial_visited, trial_order);
+    const Uint start = *std::min_element(trial_order.begin()+last_level, trial_order.end(), LessDegree(graph));
+
+    breadth_first_search(graph, start, visited, order);
+  }
+  cf3_assert(order.size() == nb_nodes);
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<Uint> Renumber::order_elements(const Entities& entities, const std::string& ordering)
+{
+  const Connectivity& connectivity = entities.geometry_space().connectivity();
+  const Uint nb_elems = connectivity.size();
+  std::vector<boost::uint64_t> keys(nb_elems);
+
+  if (ordering == "hilbert")
+  {
+    const Field& coordinates = m_mesh->geometry_fields().coordinates();
+    const Uint dim = coordinates.row_size();
+    boost::shared_ptr<BoundingBox> bounding_box = allocate_component<BoundingBox>("bounding_box");
+    bounding_box->build(coordinates);
+    math::Hilbert compute_hilbert_idx(*bounding_box, 20);
+    RealVector centroid(dim);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      centroid.setZero();
+      boost_foreach(const Uint node, connectivity[elem])
+        for (Uint d=0; d<dim; ++d)
+          centroid[d] += coordinates[node][d];
+      centroid /= static_cast<Real>(connectivity.row_size());
+      keys[elem] = compute_hilbert_idx(centroid);
+    }
+  }
+  else
+  {
+    // The nodes are already renumbered, so elements follow their lowest node
+    for (Uint elem=0; elem<nb_elems; ++elem)
+      keys[elem] = *std::min_element(connectivity[elem].begin(), connectivity[elem].end());
+  }
+  return sort_by_keys(keys);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<Uint> Renumber::order_by_first_use(const Dictionary& dict)
+{
+  std::vector<Uint> new_to_old;
+  new_to_old.reserve(dict.size());
+  std::vector<bool> used(dict.size(), false);
+  boost_foreach(const Handle<Entities>& entities, m_mesh->elements())
+  {
+    boost_foreach(const Handle<Space>& space, entities->spaces())
+    {
+      if (&space->dict() != &dict)
+        continue;
+      boost_foreach(Connectivity::ConstRow nodes, space->connectivity().array())
+      {
+        boost_foreach(const Uint node, nodes)
+        {
+          if (!used[node])
+          {
+            used[node] = true;
+            new_to_old.push_back(node);
+          }
+        }
+      }
+    }
+  }
+  // Rows not used by any element keep their relative order at the end
+  for (Uint node=0; node<dict.size(); ++node)
+  {
+    if (!used[node])
+      new_to_old.push_back(node);
+  }
+  return new_to_old;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_dictionary(Dictionary& dict, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(new_to_old.size() == dict.size());
+
+  boost_foreach(Field& field, find_components<Field>(dict))
+    reorder_rows(field, new_to_old);
+  reorder_rows(dict.glb_idx(), new_to_old);
+  reorder_rows(dict.rank(), new_to_old);
+
+  Handle< CSRTable<Uint> > glb_elem_connectivity(dict.get_child("glb_elem_connectivity"));
+  if (is_not_null(glb_elem_connectivity) && glb_elem_connectivity->size() == new_to_old.size())
+    reorder_rows(*glb_elem_connectivity, new_to_old);
+
+  const std::vector<Uint> old_to_new = invert(new_to_old);
+  boost_foreach(const Handle<Entities>& entities, m_mesh->elements())
+  {
+    boost_foreach(const Handle<Space>& space, entities->spaces())
+    {
+      if (&space->dict() != &dict)
+        continue;
+      boost_foreach(Connectivity::Row nodes, space->connectivity().array())
+      {
+        boost_foreach(Uint& node, nodes)
+          node = old_to_new[node];
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_entities(Entities& entities, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(new_to_old.size() == entities.size());
+
+  reorder_rows(entities.glb_idx(), new_to_old);
+  reorder_rows(entities.rank(), new_to_old);
+  boost_foreach(const Handle<Space>& space, entities.spaces())
+    reorder_rows(space->connectivity(), new_to_old);
+
+  if (is_not_null(entities.connectivity_cell2face()))
+    reorder_rows(*entities.connectivity_cell2face(), new_to_old);
+  if (is_not_null(entities.connectivity_cell2cell()))
+    reorder_rows(*entities.connectivity_cell2cell(), new_to_old);
+  if (is_not_null(entities.connectivity_face2cell()))
+  {
+    FaceCellConnectivity& face2cell = *entities.connectivity_face2cell();
+    reorder_rows(face2cell.connectivity(), new_to_old);
+    reorder_rows(face2cell.face_number(), new_to_old);
+    reorder_rows(face2cell.is_bdry_face(), new_to_old);
+  }
+
+  m_elements_old_to_new[&entities] = invert(new_to_old);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Renumber::update_element_references()
+{
+  boost_foreach(ElementConnectivity& table, find_components_recursively<ElementConnectivity>(*m_mesh))
+  {
+    boost_foreach(ElementConnectivity::Row row, table.array())
+    {
+      boost_foreach(Entity& entity, row)
+      {
+        if (is_null(entity.comp))
+          continue;
+        std::map< const Entities*, std::vector<Uint> >::const_iterator old_to_new = m_elements_old_to_new.find(entity.comp);
+        if (old_to_new != m_elements_old_to_new.end())
+          entity.idx = old_to_new->second[entity.idx];
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
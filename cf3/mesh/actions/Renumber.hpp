@@ -0,0 +1,90 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_Renumber_hpp
+#define cf3_mesh_actions_Renumber_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+  class Entities;
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// This class defines a mesh transformer that reorders the local nodes
+/// and elements of a mesh, so that entries that are close in the mesh are also
+/// close in memory.
+///
+/// - The geometry dictionary is ordered with reverse Cuthill-McKee ("rcm") on the
+///   node graph, or along a Hilbert space-filling curve ("hilbert") through the coordinates.
+/// - The elements of every Entities are sorted by their first node for "rcm",
+///   or along the Hilbert curve through their centroids for "hilbert".
+/// - The other dictionaries are ordered in the order their rows are first used
+///   when looping over the reordered elements.
+///
+/// Rows of all fields, global indices and ranks move along, and all connectivity
+/// tables, face-cell connectivities and comm patterns are updated. Only the local order
+/// changes, global indices are kept.
+/// @note Components built from local indices by other actions, such as a
+///       NodeElementConnectivity, must be rebuilt after renumbering.
+class mesh_actions_API Renumber : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  Renumber( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Renumber"; }
+
+  virtual void execute();
+
+private: // functions
+
+  /// @return for every new row, the old row of the geometry dictionary
+  std::vector<Uint> order_geometry_nodes(const std::string& ordering);
+
+  /// @return for every new element, the old element
+  std::vector<Uint> order_elements(const Entities& entities, const std::string& ordering);
+
+  /// @return for every new row, the old row of a dictionary, in order of first use by the elements
+  std::vector<Uint> order_by_first_use(const Dictionary& dict);
+
+  /// Move the rows of a dictionary, and update the connectivity tables of its spaces
+  void renumber_dictionary(Dictionary& dict, const std::vector<Uint>& new_to_old);
+
+  /// Move the elements of an Entities, and all tables with a row per element
+  void renumber_entities(Entities& entities, const std::vector<Uint>& new_to_old);
+
+  /// Update all references to renumbered elements in element connectivity tables
+  void update_element_references();
+
+private: // data
+
+  /// For every renumbered Entities, the new index of each old element
+  std::map< const Entities*, std::vector<Uint> > m_elements_old_to_new;
+
+}; // end Renumber
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_Renumber_hpp
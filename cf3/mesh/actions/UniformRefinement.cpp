@@ -0,0 +1,469 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <set>
+#include <map>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Space.hpp"
+
+#include "mesh/actions/UniformRefinement.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+  using namespace common;
+  using namespace common::PE;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < UniformRefinement, MeshTransformer, mesh::actions::LibActions> UniformRefinement_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Nodes of every child of an element. A child node is given by the bitmask
+/// of the parent nodes it is the average of.
+typedef std::vector< std::vector<Uint> > ChildrenT;
+
+/// Corners of the reference line, quadrilateral and hexahedron, in LagrangeP1 node order
+const Uint line_corners[2][3] = { {0,0,0}, {1,0,0} };
+const Uint quad_corners[4][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} };
+const Uint hexa_corners[8][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+                                  {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+
+/// Children of a tensor product element. With the parent scaled to [0,2]^d,
+/// child c is the parent shrunk to [0,1]^d and shifted by corner c.
+/// A point of the [0,2]^d lattice is the average of the parent corners
+/// that coincide with it in all its even coordinates.
+ChildrenT tensor_children(const Uint corners[][3], const Uint nb_corners, const Uint dim)
+{
+  ChildrenT children(nb_corners, std::vector<Uint>(nb_corners));
+  for (Uint child=0; child<nb_corners; ++child)
+  {
+    for (Uint node=0; node<nb_corners; ++node)
+    {
+      Uint mask = 0;
+      for (Uint corner=0; corner<nb_corners; ++corner)
+      {
+        bool coincides = true;
+        for (Uint d=0; d<dim; ++d)
+        {
+          const Uint lattice = corners[child][d] + corners[node][d];
+          if (lattice != 1 && lattice != 2*corners[corner][d])
+            coincides = false;
+        }
+        if (coincides)
+          mask |= 1u << corner;
+      }
+      children[child][node] = mask;
+    }
+  }
+  return children;
+}
+
+ChildrenT simplex_children(const Uint masks[][4], const Uint nb_children, const Uint nb_nodes)
+{
+  ChildrenT children(nb_children, std::vector<Uint>(nb_nodes));
+  for (Uint child=0; child<nb_children; ++child)
+    std::copy(masks[child], masks[child]+nb_nodes, children[child].begin());
+  return children;
+}
+
+const Uint n0=1u, n1=2u, n2=4u, n3=8u;
+
+/// Triangle split by its edge midpoints
+const Uint triag_masks[4][4] = { { n0,    n0|n1, n2|n0 },
+                                 { n0|n1, n1,    n1|n2 },
+                                 { n2|n0, n1|n2, n2    },
+                                 { n0|n1, n1|n2, n2|n0 } };
+
+/// Tetrahedron split by its edge midpoints as in J. Bey, "Tetrahedral grid refinement",
+/// Computing 55 (1995). The 4 children inside the octahedron are ordered to keep
+/// a positive volume.
+const Uint tetra_masks[8][4] = { { n0,    n0|n1, n0|n2, n0|n3 },
+                                 { n0|n1, n1,    n1|n2, n1|n3 },
+                                 { n0|n2, n1|n2, n2,    n2|n3 },
+                                 { n0|n3, n1|n3, n2|n3, n3    },
+                                 { n0|n1, n0|n2, n0|n3, n1|n3 },
+                                 { n0|n1, n1|n2, n0|n2, n1|n3 },
+                                 { n0|n2, n0|n3, n1|n3, n2|n3 },
+                                 { n0|n2, n1|n3, n1|n2, n2|n3 } };
+
+const ChildrenT& children_of(const ElementType& etype)
+{
+  static const ChildrenT point(1, std::vector<Uint>(1, n0));
+  static const ChildrenT line  = tensor_children(line_corners, 2, 1);
+  static const ChildrenT quad  = tensor_children(quad_corners, 4, 2);
+  static const ChildrenT hexa  = tensor_children(hexa_corners, 8, 3);
+  static const ChildrenT triag = simplex_children(triag_masks, 4, 3);
+  static const ChildrenT tetra = simplex_children(tetra_masks, 8, 4);
+
+  if (etype.order() == 1 || etype.shape() == GeoShape::POINT)
+  {
+    switch (etype.shape())
+    {
+      case GeoShape::POINT: return point;
+      case GeoShape::LINE:  return line;
+      case GeoShape::TRIAG: return triag;
+      case GeoShape::QUAD:  return quad;
+      case GeoShape::TETRA: return tetra;
+      case GeoShape::HEXA:  return hexa;
+      default: break;
+    }
+  }
+  throw NotSupported(FromHere(), "Uniform refinement of element type ["+etype.derived_type_name()+"] is not supported");
+}
+
+/// Flags of a new node, combined over all ranks that create it
+const Uint PROJECTED = 1u;
+const Uint IN_OWNED_ELEMENT = 2u;
+
+} // end anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+UniformRefinement::UniformRefinement( const std::string& name )
+: MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Uniformly refine all elements of the mesh");
+  std::string desc;
+  desc =
+      "  Usage: UniformRefinement \n\n"
+      " Splits every P1 element in 2^d children, keeping the regions, boundaries\n"
+      " and partitioning of the mesh. New nodes on the boundary_regions can be\n"
+      " projected with the projection functions of x,y,z.";
+  properties()["description"] = desc;
+
+  options().add("levels", 1u)
+      .description("Number of times every element is split")
+      .pretty_name("Levels")
+      .mark_basic();
+
+  options().add("boundary_regions", std::vector<URI>())
+      .description("Regions of which the new nodes are moved by the projection functions")
+      .pretty_name("Boundary Regions");
+
+  options().add("projection", std::vector<std::string>())
+      .description("Coordinates of a projected node, as functions of its coordinates (vars x,y,z)")
+      .pretty_name("Projection")
+      .attach_trigger( boost::bind( &UniformRefinement::config_projection, this ) );
+
+  m_projection.variables("x,y,z");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void UniformRefinement::config_projection()
+{
+  m_projection.functions( options()["projection"].value<std::vector<std::string> >() );
+  m_projection.parse();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void UniformRefinement::execute()
+{
+  Mesh& mesh = *m_mesh;
+
+  if (mesh.dictionaries().size() > 1)
+    throw NotSupported(FromHere(), "Mesh ["+mesh.uri().string()+"] can only be refined before other dictionaries than the geometry are created");
+
+  if (!find_components_recursively<FaceCellConnectivity>(mesh.topology()).empty())
+    throw NotSupported(FromHere(), "Mesh ["+mesh.uri().string()+"] can only be refined before its faces are built");
+
+  if (options()["boundary_regions"].value< std::vector<URI> >().size() && !m_projection.is_parsed())
+    throw SetupError(FromHere(), "Option [projection] was not set in ["+uri().path()+"]");
+
+  const Uint levels = options()["levels"].value<Uint>();
+  for (Uint level=0; level<levels; ++level)
+    refine();
+
+  mesh.geometry_fields().rebuild_comm_pattern();
+  mesh.raise_mesh_changed();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void UniformRefinement::refine()
+{
+  Mesh& mesh = *m_mesh;
+  Dictionary& nodes = mesh.geometry_fields();
+  Comm& comm = Comm::instance();
+  const bool parallel = comm.is_active() && comm.size() > 1;
+  const Uint my_rank = comm.rank();
+  const Uint nb_old_nodes = nodes.size();
+
+  std::set<const Entities*> projected_entities;
+  boost_foreach(const URI& region_uri, options()["boundary_regions"].value< std::vector<URI> >())
+  {
+    Handle<Region> region(mesh.access_component_checked(region_uri));
+    if (is_null(region))
+      throw ValueNotFound(FromHere(), "Invalid URI ["+region_uri.string()+"]");
+    boost_foreach(const Entities& entities, find_components_recursively<Entities>(*region))
+      projected_entities.insert(&entities);
+  }
+
+  // Nodes are identified by their parents, in global numbering so every rank finds the same key
+  const List<Uint>& node_glb_idx = nodes.glb_idx();
+  std::map< std::vector<Uint>, Uint > new_node_idx;
+  std::vector< std::vector<Uint> > new_node_parents;
+  std::vector<Uint> new_node_flags;
+
+  // Connectivity of the children of every Entities, numbering the new nodes after the old ones
+  const std::vector< Handle<Entities> >& entities_range = nodes.entities_range();
+  std::vector< std::vector<Uint> > children_connectivity(entities_range.size());
+
+  std::vector<Uint> key;
+  std::vector< std::pair<Uint,Uint> > parents;
+  for (Uint entities_idx=0; entities_idx<entities_range.size(); ++entities_idx)
+  {
+    const Entities& entities = *entities_range[entities_idx];
+    const ChildrenT& children = children_of(entities.element_type());
+    const Connectivity& connectivity = entities.geometry_space().connectivity();
+    const Uint flags = projected_entities.count(&entities) ? PROJECTED : 0u;
+
+    std::vector<Uint>& children_nodes = children_connectivity[entities_idx];
+    children_nodes.reserve(entities.size()*children.size()*connectivity.row_size());
+    for (Uint elem=0; elem<entities.size(); ++elem)
+    {
+      Connectivity::ConstRow elem_nodes = connectivity[elem];
+      const Uint elem_flags = entities.is_ghost(elem) ? flags : (flags | IN_OWNED_ELEMENT);
+      boost_foreach(const std::vector<Uint>& child, children)
+      {
+        boost_foreach(const Uint mask, child)
+        {
+          parents.clear();
+          for (Uint n=0; n<elem_nodes.size(); ++n)
+          {
+            if (mask & (1u << n))
+              parents.push_back(std::make_pair(node_glb_idx[elem_nodes[n]], elem_nodes[n]));
+          }
+          if (parents.size() == 1)
+          {
+            children_nodes.push_back(parents[0].second);
+            continue;
+          }
+
+          std::sort(parents.begin(), parents.end());
+          key.resize(parents.size());
+          for (Uint p=0; p<parents.size(); ++p)
+            key[p] = parents[p].first;
+
+          std::map< std::vector<Uint>, Uint >::iterator it = new_node_idx.find(key);
+          if (it == new_node_idx.end())
+          {
+            it = new_node_idx.insert(std::make_pair(key, (Uint)new_node_parents.size())).first;
+            new_node_parents.push_back(std::vector<Uint>(parents.size()));
+            for (Uint p=0; p<parents.size(); ++p)
+              new_node_parents.back()[p] = parents[p].second;
+            new_node_flags.push_back(0u);
+          }
+          new_node_flags[it->second] |= elem_flags;
+          children_nodes.push_back(nb_old_nodes + it->second);
+        }
+      }
+    }
+  }
+
+  const Uint nb_new_nodes = new_node_parents.size();
+
+  // New global indices are numbered after the largest existing one
+  Uint loc_glb_base = 0;
+  for (Uint n=0; n<nb_old_nodes; ++n)
+    loc_glb_base = std::max(loc_glb_base, node_glb_idx[n]+1);
+  Uint glb_base = loc_glb_base;
+  if (parallel)
+    comm.all_reduce(PE::max(), &loc_glb_base, 1, &glb_base);
+
+  std::vector<Uint> new_node_glb(nb_new_nodes);
+  std::vector<Uint> new_node_rank(nb_new_nodes, my_rank);
+  if (!parallel)
+  {
+    for (Uint n=0; n<nb_new_nodes; ++n)
+      new_node_glb[n] = glb_base + n;
+  }
+  else
+  {
+    // Every key is sent to the rank given by its hash, which owns the numbering of that key.
+    // Send: key size, key, flags
+    const Uint nb_procs = comm.size();
+    std::vector< std::vector<Uint> > send(nb_procs), recv(nb_procs);
+    std::vector< std::vector<Uint> > sent_nodes(nb_procs);
+    for (std::map< std::vector<Uint>, Uint >::const_iterator it=new_node_idx.begin(); it!=new_node_idx.end(); ++it)
+    {
+      const Uint directory = boost::hash_range(it->first.begin(), it->first.end()) % nb_procs;
+      send[directory].push_back(it->first.size());
+      send[directory].insert(send[directory].end(), it->first.begin(), it->first.end());
+      send[directory].push_back(new_node_flags[it->second]);
+      sent_nodes[directory].push_back(it->second);
+    }
+    comm.all_to_all(send, recv);
+
+    // The owner is the lowest rank that creates the node from an owned element,
+    // or else the lowest rank that creates it at all.
+    std::map< std::vector<Uint>, Uint > directory_idx;
+    std::vector<Uint> directory_owner;
+    std::vector<Uint> directory_flags;
+    std::vector< std::vector<Uint> > requests(nb_procs);
+    for (Uint proc=0; proc<nb_procs; ++proc)
+    {
+      std::vector<Uint>::const_iterator buf = recv[proc].begin();
+      while (buf != recv[proc].end())
+      {
+        const Uint key_size = *buf++;
+        key.assign(buf, buf+key_size);
+        buf += key_size;
+        const Uint flags = *buf++;
+
+        std::map< std::vector<Uint>, Uint >::iterator it = directory_idx.find(key);
+        if (it == directory_idx.end())
+        {
+          it = directory_idx.insert(std::make_pair(key, (Uint)directory_owner.size())).first;
+          directory_owner.push_back(proc);
+          directory_flags.push_back(0u);
+        }
+        const Uint idx = it->second;
+        if ( (flags & IN_OWNED_ELEMENT) && !(directory_flags[idx] & IN_OWNED_ELEMENT) )
+          directory_owner[idx] = proc;
+        directory_flags[idx] |= flags;
+        requests[proc].push_back(idx);
+      }
+    }
+
+    std::vector<Uint> directory_sizes;
+    comm.all_gather((Uint)directory_owner.size(), directory_sizes);
+    Uint directory_glb_base = glb_base;
+    for (Uint proc=0; proc<my_rank; ++proc)
+      directory_glb_base += directory_sizes[proc];
+
+    // Reply in the order of the requests: global index, owner, flags
+    for (Uint proc=0; proc<nb_procs; ++proc)
+    {
+      send[proc].clear();
+      send[proc].reserve(3*requests[proc].size());
+      boost_foreach(const Uint idx, requests[proc])
+      {
+        send[proc].push_back(directory_glb_base + idx);
+        send[proc].push_back(directory_owner[idx]);
+        send[proc].push_back(directory_flags[idx]);
+      }
+    }
+    comm.all_to_all(send, recv);
+
+    for (Uint proc=0; proc<nb_procs; ++proc)
+    {
+      for (Uint i=0; i<sent_nodes[proc].size(); ++i)
+      {
+        const Uint n = sent_nodes[proc][i];
+        new_node_glb[n]   = recv[proc][3*i];
+        new_node_rank[n]  = recv[proc][3*i+1];
+        new_node_flags[n] = recv[proc][3*i+2];
+      }
+    }
+  }
+
+  // Add the new nodes, with all geometry fields interpolated from their parents
+  nodes.resize(nb_old_nodes + nb_new_nodes);
+  for (Uint n=0; n<nb_new_nodes; ++n)
+  {
+    nodes.glb_idx()[nb_old_nodes+n] = new_node_glb[n];
+    nodes.rank()[nb_old_nodes+n] = new_node_rank[n];
+  }
+  boost_foreach(Field& field, find_components<Field>(nodes))
+  {
+    for (Uint n=0; n<nb_new_nodes; ++n)
+    {
+      const std::vector<Uint>& node_parents = new_node_parents[n];
+      Field::Row row = field[nb_old_nodes+n];
+      for (Uint var=0; var<row.size(); ++var)
+      {
+        Real value = 0.;
+        boost_foreach(const Uint parent, node_parents)
+          value += field[parent][var];
+        row[var] = value / static_cast<Real>(node_parents.size());
+      }
+    }
+  }
+
+  if (m_projection.is_parsed())
+  {
+    Field& coordinates = nodes.coordinates();
+    std::vector<Real> vars(3,0.);
+    RealVector projected(m_projection.nbfuncs());
+    for (Uint n=0; n<nb_new_nodes; ++n)
+    {
+      if ( !(new_node_flags[n] & PROJECTED) )
+        continue;
+      Field::Row coords = coordinates[nb_old_nodes+n];
+      for (Uint d=0; d<coords.size(); ++d)
+        vars[d] = coords[d];
+      m_projection.evaluate(vars, projected);
+      for (Uint d=0; d<std::min((Uint)coords.size(), m_projection.nbfuncs()); ++d)
+        coords[d] = projected[d];
+    }
+  }
+
+  // Replace every element by its children. Child c of element e becomes element e*nb_children+c.
+  // The children of all element types are numbered in blocks of 2^dim global indices.
+  const Uint glb_stride = 1u << mesh.dimension();
+  for (Uint entities_idx=0; entities_idx<entities_range.size(); ++entities_idx)
+  {
+    Entities& entities = *entities_range[entities_idx];
+    const Uint nb_children = children_of(entities.element_type()).size();
+    const Uint nb_elems = entities.size();
+    const std::vector<Uint> old_rank(entities.rank().array().begin(), entities.rank().array().end());
+    const std::vector<Uint> old_glb_idx(entities.glb_idx().array().begin(), entities.glb_idx().array().end());
+
+    entities.resize(nb_elems*nb_children);
+
+    Connectivity& connectivity = entities.geometry_space().connectivity();
+    const std::vector<Uint>& children_nodes = children_connectivity[entities_idx];
+    const Uint nb_nodes = connectivity.row_size();
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (Uint child=0; child<nb_children; ++child)
+      {
+        const Uint idx = elem*nb_children + child;
+        Connectivity::Row child_nodes = connectivity[idx];
+        for (Uint n=0; n<nb_nodes; ++n)
+          child_nodes[n] = children_nodes[idx*nb_nodes + n];
+        entities.rank()[idx] = old_rank[elem];
+        entities.glb_idx()[idx] = old_glb_idx[elem]*glb_stride + child;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
@@ -0,0 +1,77 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_UniformRefinement_hpp
+#define cf3_mesh_actions_UniformRefinement_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "math/VectorialFunction.hpp"
+
+#include "mesh/MeshTransformer.hpp"
+
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Uniformly refine every element of the mesh
+///
+/// Every P1 line, triangle, quadrilateral, tetrahedron and hexahedron is split
+/// in 2^d children, which stay in the Entities of their parent, so region and
+/// boundary tags are kept. Nodes are added on the edges, faces and cells,
+/// as the average of the nodes they are created from.
+///
+/// The refinement is done in parallel without re-partitioning: each rank refines
+/// its own elements, including the ghost elements. The global index and owner of
+/// the new nodes are agreed on by sending them to a rank that is chosen from
+/// their parent nodes. Children of an element get the rank of their parent.
+///
+/// New nodes on the elements of the configured "boundary_regions" can be moved
+/// to the curved boundary by the "projection" functions of x,y,z.
+///
+/// The mesh must be refined before other dictionaries or its faces are built,
+/// since these are not refined along with the elements.
+class mesh_actions_API UniformRefinement : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  UniformRefinement( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "UniformRefinement"; }
+
+  virtual void execute();
+
+private: // functions
+
+  void config_projection();
+
+  /// Split every element in its children once
+  void refine();
+
+private: // data
+
+  math::VectorialFunction m_projection;
+
+}; // end UniformRefinement
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_UniformRefinement_hpp
@@ -4,6 +4,10 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
 #include <boost/foreach.hpp>
 #include <boost/tokenizer.hpp>
 
@@ -18,7 +22,9 @@
 #include "common/Table.hpp"
 #include "common/List.hpp"
 #include "common/DynTable.hpp"
+#include "common/TextScanner.hpp"
 
+#include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
 
 #include "mesh/Region.hpp"
@@ -27,8 +33,6 @@
 #include "mesh/DiscontinuousDictionary.hpp"
 #include "mesh/MeshElements.hpp"
 #include "mesh/ConnectivityData.hpp"
-#include "mesh/MergedParallelDistribution.hpp"
-#include "mesh/ParallelDistribution.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Cells.hpp"
@@ -46,6 +50,201 @@ namespace gmsh {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail {
+
+/// Reads a byte range of a file in large blocks, and hands it out as lines or as raw bytes
+class ChunkReader
+{
+public:
+
+  ChunkReader(std::istream& file, const std::streamoff begin, const std::streamoff end) :
+    m_file(file),
+    m_next(begin),
+    m_end(end),
+    m_buffer(1u<<22),
+    m_first(0),
+    m_last(0)
+  {}
+
+  /// @return the file position of the first byte that was not handed out yet
+  std::streamoff position() const { return m_next - static_cast<std::streamoff>(m_last-m_first); }
+
+  /// @return true if all bytes of the range were handed out
+  bool at_end() const { return m_first == m_last && m_next == m_end; }
+
+  /// Get the next line, without its line ending
+  /// @return false if all bytes of the range were handed out
+  bool next_line(const char*& line_begin, const char*& line_end)
+  {
+    std::size_t searched = m_first;
+    for (;;)
+    {
+      const char* newline = static_cast<const char*>(std::memchr(data()+searched, '\n', m_last-searched));
+      if (newline)
+      {
+        line_begin = data()+m_first;
+        line_end = newline;
+        m_first = newline-data()+1;
+        return true;
+      }
+      const std::size_t nb_searched = m_last-m_first;
+      if (!refill())
+        break;
+      searched = nb_searched;
+    }
+    if (m_first == m_last)
+      return false;
+    // Last line, without line ending
+    line_begin = data()+m_first;
+    line_end = data()+m_last;
+    m_first = m_last;
+    return true;
+  }
+
+  /// Get all bytes that are read but were not handed out yet, reading a next block if there are none
+  /// @return false if all bytes of the range were handed out
+  bool next_block(const char*& block_begin, const char*& block_end)
+  {
+    if (m_first == m_last && !refill())
+      return false;
+    block_begin = data()+m_first;
+    block_end = data()+m_last;
+    m_first = m_last;
+    return true;
+  }
+
+  /// Get the next bytes of the range
+  /// @throw ParsingFailed if fewer bytes remain in the range
+  const char* next_bytes(const std::size_t nb_bytes)
+  {
+    while (m_last-m_first < nb_bytes)
+    {
+      if (!refill())
+        throw ParsingFailed(FromHere(), "Unexpected end of binary data at position "+to_str(static_cast<Uint>(position())));
+    }
+    const char* bytes = data()+m_first;
+    m_first += nb_bytes;
+    return bytes;
+  }
+
+private:
+
+  const char* data() const { return &m_buffer[0]; }
+
+  /// Move the bytes that were not handed out yet to the front of the buffer,
+  /// and read the next block of the range behind them
+  /// @return false if the whole range was read already
+  bool refill()
+  {
+    if (m_next == m_end)
+      return false;
+    const std::size_t nb_remaining = m_last-m_first;
+    std::memmove(&m_buffer[0], &m_buffer[0]+m_first, nb_remaining);
+    m_first = 0;
+    m_last = nb_remaining;
+    if (m_last == m_buffer.size())
+      m_buffer.resize(2*m_buffer.size());
+
+    const std::streamoff nb_bytes = std::min(static_cast<std::streamoff>(m_buffer.size()-m_last), m_end-m_next);
+    m_file.clear();
+    m_file.seekg(m_next);
+    m_file.read(&m_buffer[0]+m_last, nb_bytes);
+    if (m_file.gcount() != nb_bytes)
+      throw ParsingFailed(FromHere(), "Could not read "+to_str(static_cast<Uint>(nb_bytes))+" bytes from file");
+    m_last += nb_bytes;
+    m_next += nb_bytes;
+    return true;
+  }
+
+  std::istream& m_file;
+  std::streamoff m_next;
+  std::streamoff m_end;
+  std::vector<char> m_buffer;
+  std::size_t m_first;
+  std::size_t m_last;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Reads the records of a section, in ascii or binary format.
+/// Ascii records are lines of whitespace separated numbers. Binary records are
+/// 4-byte integers and 8-byte reals in native byte order, without separators.
+class RecordReader
+{
+public:
+
+  RecordReader(std::istream& file, const std::streamoff begin, const std::streamoff end, const bool binary) :
+    m_chunk(file, begin, end),
+    m_binary(binary),
+    m_line(0, 0)
+  {}
+
+  /// Start reading the next record
+  /// @return false if no records remain
+  bool next_record()
+  {
+    if (m_binary)
+      return !m_chunk.at_end();
+
+    const char* line_begin;
+    const char* line_end;
+    while (m_chunk.next_line(line_begin, line_end))
+    {
+      m_line = TextScanner(line_begin, line_end);
+      if (!m_line.at_end())
+        return true;
+    }
+    return false;
+  }
+
+  Uint next_uint()
+  {
+    if (!m_binary)
+      return m_line.next_uint();
+    const boost::int32_t value = next_binary<boost::int32_t>();
+    if (value < 0)
+      throw ParsingFailed(FromHere(), "Expected an unsigned integer but found "+to_str(static_cast<int>(value)));
+    return static_cast<Uint>(value);
+  }
+
+  int next_int()
+  {
+    return m_binary ? static_cast<int>(next_binary<boost::int32_t>()) : m_line.next_int();
+  }
+
+  Real next_real()
+  {
+    return m_binary ? static_cast<Real>(next_binary<double>()) : m_line.next_real();
+  }
+
+private:
+
+  template <typename T>
+  T next_binary()
+  {
+    T value;
+    std::memcpy(&value, m_chunk.next_bytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  ChunkReader m_chunk;
+  bool m_binary;
+  TextScanner m_line;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Remove trailing whitespace, such as the '\r' of files with windows line endings
+std::string trimmed(const std::string& line)
+{
+  std::string::size_type last = line.find_last_not_of(" \t\r");
+  return last == std::string::npos ? std::string() : line.substr(0, last+1);
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
 cf3::common::ComponentBuilder < gmsh::Reader, MeshReader, LibGmsh> aGmshReader_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -75,14 +274,13 @@ Reader::Reader( const std::string& name )
   properties()["brief"] = std::string("Gmsh file reader component");
 
   std::string desc;
-  desc += "This component can read in parallel.\n";
+  desc += "This component can read in parallel, every processor reading only its own part of the file.\n";
   desc += "It can also read multiple files in serial, combining them in one large mesh.\n";
+  desc += "Files in ascii and binary MSH 2 format are supported.\n";
   desc += "Available coolfluid-element types are:\n";
   boost_foreach(const std::string& supported_type, m_supported_types)
   desc += "  - " + supported_type + "\n";
   properties()["description"] = desc;
-
-  IO_rank = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -104,7 +302,7 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   if( boost::filesystem::exists(fp) )
   {
     CFinfo <<  "Opening file " <<  fp.string() << CFendl;
-    m_file.open(fp,std::ios_base::in); // exists so open it
+    m_file.open(fp,std::ios_base::in | std::ios_base::binary); // exists so open it
   }
   else // doesnt exist so throw exception
   {
@@ -113,6 +311,16 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 
   m_file_basename = boost::filesystem::basename(fp);
 
+  // Ghost nodes can be exchanged if every processor reads the part with its rank
+  const Uint part = options().value<Uint>("part");
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  if (part >= nb_parts)
+    throw SetupError(FromHere(), "Part "+to_str(part)+" does not exist, as there are only "+to_str(nb_parts)+" parts");
+  m_distributed = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1
+               && PE::Comm::instance().size() == nb_parts;
+  if (m_distributed && part != PE::Comm::instance().rank())
+    throw SetupError(FromHere(), "When reading as many parts as there are processors, every processor must read the part with its own rank");
+
   // set the internal mesh pointer
   m_mesh = Handle<Mesh>(mesh.handle<Component>());
 
@@ -120,15 +328,22 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // NOTE: since gmsh contains several 'physical entities' in one mesh, we create one region per physical entity
   m_region = Handle<Region>(m_mesh->topology().handle<Component>());
 
-  // Read file once and store positions
+  // Scan the file once for the positions of its sections
   get_file_positions();
-  cf3_assert(m_hash);
 
   m_mesh->initialize_nodes(0, m_mesh_dimension);
 
-  find_used_nodes();
-  read_coordinates();
-  read_connectivity();
+  {
+    NodeChunk owned_nodes;
+    NodeChunk ghost_nodes;
+    ElementChunk elements;
+    read_nodes(part, owned_nodes);
+    read_elements(part, elements, true);
+    find_element_types(elements);
+    find_ghost_nodes(owned_nodes, elements, ghost_nodes);
+    read_coordinates(owned_nodes, ghost_nodes);
+    read_connectivity(elements);
+  }
 
   fix_negative_volumes(*m_mesh);
 
@@ -138,15 +353,10 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
     read_node_data();
   }
 
-  m_node_idx_gmsh_to_cf.clear();
-  m_elem_idx_gmsh_to_cf.clear();
-
   // clean-up
-  m_ghost_nodes.clear();
-  m_used_nodes.clear();
   m_node_idx_gmsh_to_cf.clear();
-  if (is_not_null(m_hash))
-    remove_component(*m_hash);
+  m_elem_idx_gmsh_to_cf.clear();
+  m_element_blocks.clear();
 
   // close the file
   m_file.close();
@@ -156,109 +366,328 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::get_file_positions()
+std::streamoff Reader::read_mesh_format()
 {
-  std::string region_names("$PhysicalNames");
-  std::string nodes("$Nodes");
-  std::string elements("$Elements");
-  std::string element_data("$ElementData");
-  std::string node_data("$NodeData");
-  std::string element_node_data("$ElementNodeData");
+  //  $MeshFormat
+  //  version-number file-type data-size
+  //  one-binary            // only in binary files: the integer 1, to detect the byte order
+  //  $EndMeshFormat
+
+  std::string line;
+  m_file.clear();
+  m_file.seekg(0,std::ios::beg);
+  getline(m_file,line);
+  if (detail::trimmed(line) != "$MeshFormat")
+    throw ParsingFailed(FromHere(),"File does not start with $MeshFormat. Only the MSH 2 format is supported");
+
+  Real version;
+  Uint file_type;
+  Uint data_size;
+  m_file >> version >> file_type >> data_size;
+  getline(m_file,line); // finish line
+  if (!m_file || version < 2. || version >= 3.)
+    throw ParsingFailed(FromHere(),"Only the MSH 2 format is supported");
+
+  m_binary = (file_type == 1);
+  if (m_binary)
+  {
+    if (data_size != sizeof(double))
+      throw ParsingFailed(FromHere(),"Binary files with reals of "+to_str(data_size)+" bytes are not supported");
+
+    boost::int32_t one;
+    m_file.read(reinterpret_cast<char*>(&one), sizeof(one));
+    if (one != 1)
+      throw ParsingFailed(FromHere(),"Binary file was written on a machine with a different byte order");
+  }
 
+  while (getline(m_file,line))
+  {
+    if (detail::trimmed(line) == "$EndMeshFormat")
+      return m_file.tellg();
+  }
+  throw ParsingFailed(FromHere(),"Section $MeshFormat is not terminated by $EndMeshFormat");
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::get_file_positions()
+{
   m_element_data_positions.clear();
   m_node_data_positions.clear();
   m_element_node_data_positions.clear();
-  m_elements_position=0;
-  int p;
+  m_element_blocks.clear();
+  m_region_names_position=-1;
+  m_nodes_begin=-1;
+  m_nodes_end=-1;
+  m_elements_begin=-1;
+  m_elements_end=-1;
+  m_total_nb_nodes=0;
+  m_total_nb_elements=0;
+
+  const std::streamoff header_end = read_mesh_format();
+
+  m_file.clear();
+  m_file.seekg(0,std::ios::end);
+  m_file_end = m_file.tellg();
+
+  if (m_binary)
+    scan_sections_binary(header_end);
+  else
+    scan_sections_ascii(header_end);
+
+  if (m_region_names_position < 0)
+    throw ParsingFailed(FromHere(),"File does not contain physical names");
+  if (m_nodes_begin < 0 || m_nodes_end < m_nodes_begin || m_total_nb_nodes == 0)
+    throw ParsingFailed(FromHere(),"File contains no nodes");
+  if (m_elements_begin < 0 || m_elements_end < m_elements_begin || m_total_nb_elements == 0)
+    throw ParsingFailed(FromHere(),"File does not contain any elements");
+
+  read_physical_names();
+  m_file.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::scan_sections_ascii(const std::streamoff begin)
+{
+  // Every processor scans a slice of the file for section markers
+  std::vector<std::streamoff> markers;
+  if (m_distributed)
+  {
+    const std::vector<std::streamoff> slice_markers =
+        find_section_markers(begin, m_file_end, PE::Comm::instance().rank(), PE::Comm::instance().size());
+    std::vector<boost::uint64_t> send(slice_markers.begin(), slice_markers.end());
+    std::vector< std::vector<boost::uint64_t> > recv;
+    PE::Comm::instance().all_gather(send, recv);
+    boost_foreach(const std::vector<boost::uint64_t>& recv_markers, recv)
+      markers.insert(markers.end(), recv_markers.begin(), recv_markers.end());
+  }
+  else
+  {
+    markers = find_section_markers(begin, m_file_end, 0, 1);
+  }
+
   std::string line;
-  while (!m_file.eof())
+  boost_foreach(const std::streamoff marker, markers)
   {
-    p = m_file.tellg();
+    m_file.clear();
+    m_file.seekg(marker,std::ios::beg);
     getline(m_file,line);
-    if (line.find(region_names)!=std::string::npos) {
-      m_region_names_position=p;
-      m_file >> m_nb_regions;
-      m_region_list.resize(m_nb_regions);
-
-      m_nb_gmsh_elem_in_region.resize(m_nb_regions);
-      for(Uint ir = 0; ir < m_nb_regions; ++ir)
-      {
-        m_nb_gmsh_elem_in_region[ir].resize(Shared::nb_gmsh_types);
-        for(Uint type = 0; type < Shared::nb_gmsh_types; ++ type)
-           (m_nb_gmsh_elem_in_region[ir])[type] = 0;
-      }
-
-      m_mesh_dimension = options().value<Uint>("dimension");
-      for(Uint ir = 0; ir < m_nb_regions; ++ir)
-      {
-        Uint phys_group_dimensionality;
-        Uint phys_group_index;
-        std::string phys_group_name;
-        m_file >> phys_group_dimensionality >> phys_group_index >> phys_group_name;
-        m_region_list[phys_group_index-1].dim=phys_group_dimensionality;
-        m_region_list[phys_group_index-1].index=phys_group_index;
-        //The original name of the region in the mesh file has quotes, we want to strip them off
-        m_region_list[phys_group_index-1].name=phys_group_name.substr(1,phys_group_name.length()-2);
-        m_region_list[phys_group_index-1].region = create_region(m_region_list[phys_group_index-1].name);
-        m_mesh_dimension = std::max(m_region_list[phys_group_index-1].dim,m_mesh_dimension);
-      }
+    const std::string keyword = detail::trimmed(line);
+    if (keyword == "$PhysicalNames")
+    {
+      m_region_names_position = marker;
     }
-    else if (line.find(nodes)!=std::string::npos) {
-      m_coordinates_position=p;
+    else if (keyword == "$Nodes")
+    {
       m_file >> m_total_nb_nodes;
-//      CFinfo << "The total number of nodes is " << m_total_nb_nodes << CFendl;
-      if (m_total_nb_nodes == 0) throw ParsingFailed(FromHere(),"File contains no nodes");
+      getline(m_file,line); // finish line
+      m_nodes_begin = m_file.tellg();
+    }
+    else if (keyword == "$EndNodes")
+    {
+      m_nodes_end = marker;
     }
-    else if (line.find(elements)!=std::string::npos)
+    else if (keyword == "$Elements")
     {
-      m_elements_position = p;
       m_file >> m_total_nb_elements;
-//      CFinfo << "The total number of elements is " << m_total_nb_elements << CFendl;
-      if (m_total_nb_elements == 0) throw ParsingFailed(FromHere(),"File contains no elements");
-      //Create a hash
-      m_hash = create_component<MergedParallelDistribution>("hash");
-      std::vector<Uint> num_obj(2);
-      num_obj[0] = m_total_nb_nodes;
-      num_obj[1] = m_total_nb_elements;
-      m_hash->options().set("nb_parts",options().value<Uint>("nb_parts"));
-      m_hash->options().set("nb_obj",num_obj);
+      getline(m_file,line); // finish line
+      m_elements_begin = m_file.tellg();
+    }
+    else if (keyword == "$EndElements")
+    {
+      m_elements_end = marker;
+    }
+    else if (keyword == "$ElementData")
+    {
+      m_element_data_positions.push_back(marker);
+    }
+    else if (keyword == "$NodeData")
+    {
+      m_node_data_positions.push_back(marker);
+    }
+    else if (keyword == "$ElementNodeData")
+    {
+      m_element_node_data_positions.push_back(marker);
+    }
+  }
+}
 
+//////////////////////////////////////////////////////////////////////////////
 
-      Uint elem_idx, elem_type, nb_tags, phys_tag;
+std::vector<std::streamoff> Reader::find_section_markers(const std::streamoff begin, const std::streamoff end,
+                                                         const Uint slice, const Uint nb_slices)
+{
+  std::vector<std::streamoff> markers;
+  const std::streamoff slice_begin = begin + (end-begin)*slice/nb_slices;
+  const std::streamoff slice_end = begin + (end-begin)*(slice+1)/nb_slices;
+  if (slice_begin == slice_end)
+    return markers;
+
+  // Start one byte early, to know if the first byte of the slice starts a line.
+  // The section begin itself always starts a line.
+  const std::streamoff scan_begin = (slice_begin == begin) ? begin : slice_begin-1;
+  detail::ChunkReader chunk(m_file, scan_begin, slice_end);
+
+  std::streamoff block_position = scan_begin;
+  char previous = '\n';
+  const char* block_begin;
+  const char* block_end;
+  while (chunk.next_block(block_begin, block_end))
+  {
+    for (const char* c = block_begin; (c = static_cast<const char*>(std::memchr(c, '$', block_end-c))); ++c)
+    {
+      const std::streamoff position = block_position + (c-block_begin);
+      if ( (c == block_begin ? previous : *(c-1)) == '\n' && position >= slice_begin )
+        markers.push_back(position);
+    }
+    previous = *(block_end-1);
+    block_position += block_end-block_begin;
+  }
+  return markers;
+}
 
-      //Let's count how many elements of each type are present
-      for(Uint ie = 0; ie < m_total_nb_elements; ++ie)
-      {
-          m_file >> elem_idx;
-          m_file >> elem_type;
-          m_file >> nb_tags;
-          m_file >> phys_tag;
-          cf3_assert(phys_tag > 0);
-          getline(m_file,line);
-          if (m_hash->subhash(ELEMS).owns(ie))
-            (m_nb_gmsh_elem_in_region[phys_tag-1])[elem_type]++;
-          m_region_list[phys_tag-1].element_types.insert(elem_type);
-      }
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::scan_sections_binary(const std::streamoff begin)
+{
+  // Binary data may contain any byte, so sections are skipped by the size of their data.
+  // Section headers and the number of records are always written in ascii.
+  std::string line;
+  m_file.clear();
+  m_file.seekg(begin,std::ios::beg);
+  std::streamoff position = begin;
+  while (getline(m_file,line))
+  {
+    const std::string keyword = detail::trimmed(line);
+    if (keyword == "$PhysicalNames")
+    {
+      m_region_names_position = position;
     }
-    else if (line.find(element_data)!=std::string::npos)
+    else if (keyword == "$Nodes")
     {
-      m_element_data_positions.push_back(p);
+      //  number-of-nodes
+      //  node-number x y z     // int, 3 doubles
+      //  ...
+      m_file >> m_total_nb_nodes;
+      getline(m_file,line); // finish line
+      m_nodes_begin = m_file.tellg();
+      m_nodes_end = m_nodes_begin + static_cast<std::streamoff>(m_total_nb_nodes)*(sizeof(boost::int32_t)+3*sizeof(double));
+      m_file.seekg(m_nodes_end,std::ios::beg);
+    }
+    else if (keyword == "$Elements")
+    {
+      //  number-of-elements
+      //  element-type number-of-elements-in-block number-of-tags     // element block header
+      //  element-number tags ... nodes ...                          // ints
+      //  ...
+      m_file >> m_total_nb_elements;
+      getline(m_file,line); // finish line
+      m_elements_begin = m_file.tellg();
+      Uint nb_elements = 0;
+      while (nb_elements < m_total_nb_elements)
+      {
+        boost::int32_t header[3];
+        m_file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!m_file)
+          throw ParsingFailed(FromHere(),"Unexpected end of file in binary $Elements section");
+        ElementBlock block;
+        block.gmsh_type = header[0];
+        block.nb_elements = header[1];
+        block.nb_tags = header[2];
+        block.first_element = nb_elements;
+        block.begin = m_file.tellg();
+        if (header[0] <= 0 || block.gmsh_type >= Shared::nb_gmsh_types || Shared::m_nodes_in_gmsh_elem[block.gmsh_type] == 0)
+          throw ParsingFailed(FromHere(),"Unsupported gmsh element type "+to_str(static_cast<int>(header[0])));
+        m_element_blocks.push_back(block);
+        nb_elements += block.nb_elements;
+        const std::streamoff record_size = sizeof(boost::int32_t)*(1+block.nb_tags+Shared::m_nodes_in_gmsh_elem[block.gmsh_type]);
+        m_file.seekg(block.begin + record_size*static_cast<std::streamoff>(block.nb_elements),std::ios::beg);
+      }
+      m_elements_end = m_file.tellg();
     }
-    else if (line.find(node_data)!=std::string::npos)
+    else if (keyword == "$NodeData" || keyword == "$ElementData" || keyword == "$ElementNodeData")
     {
-      m_node_data_positions.push_back(p);
+      if (keyword == "$NodeData")
+        m_node_data_positions.push_back(position);
+      else if (keyword == "$ElementData")
+        m_element_data_positions.push_back(position);
+      else
+        m_element_node_data_positions.push_back(position);
+
+      // The header is ascii, followed by binary records:
+      //  $NodeData, $ElementData : number value ...                         // int, doubles
+      //  $ElementNodeData        : element-number nb-nodes value ...        // 2 ints, doubles
+      std::map<std::string,Field> header;
+      m_file.seekg(position,std::ios::beg);
+      read_variable_header(header);
+      const Field& field = header.begin()->second;
+      const Uint nb_values = field.var_types[0];
+      m_file.seekg(field.file_data_positions[0],std::ios::beg);
+      if (keyword == "$ElementNodeData")
+      {
+        for (Uint e=0; e<field.nb_entries; ++e)
+        {
+          boost::int32_t element[2];
+          m_file.read(reinterpret_cast<char*>(element), sizeof(element));
+          m_file.seekg(static_cast<std::streamoff>(element[1]*nb_values*sizeof(double)),std::ios::cur);
+        }
+      }
+      else
+      {
+        m_file.seekg(static_cast<std::streamoff>(field.nb_entries)*(sizeof(boost::int32_t)+nb_values*sizeof(double)),std::ios::cur);
+      }
+      if (!m_file)
+        throw ParsingFailed(FromHere(),"Unexpected end of file in binary "+keyword+" section");
     }
-    else if (line.find(element_node_data)!=std::string::npos)
+    else if (!keyword.empty() && keyword[0] == '$' && keyword.compare(0,4,"$End") != 0)
     {
-      m_element_node_data_positions.push_back(p);
+      // Unknown sections are skipped, assuming they are ascii
+      const std::string end_keyword = "$End"+keyword.substr(1);
+      while (getline(m_file,line) && detail::trimmed(line) != end_keyword) {}
     }
+    position = m_file.tellg();
+  }
+}
 
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_physical_names()
+{
+  m_file.clear();
+  m_file.seekg(m_region_names_position,std::ios::beg);
+  std::string line;
+  getline(m_file,line);
+
+  m_file >> m_nb_regions;
+  m_region_list.clear();
+  m_region_list.resize(m_nb_regions);
+
+  m_nb_gmsh_elem_in_region.resize(m_nb_regions);
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+  {
+    m_nb_gmsh_elem_in_region[ir].resize(Shared::nb_gmsh_types);
+    for(Uint type = 0; type < Shared::nb_gmsh_types; ++ type)
+       (m_nb_gmsh_elem_in_region[ir])[type] = 0;
   }
-  if (m_elements_position==0)
+
+  m_mesh_dimension = options().value<Uint>("dimension");
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
   {
-    throw ParsingFailed(FromHere(),"File does not contain any elements");
+    Uint phys_group_dimensionality;
+    Uint phys_group_index;
+    std::string phys_group_name;
+    m_file >> phys_group_dimensionality >> phys_group_index >> phys_group_name;
+    if (phys_group_index == 0 || phys_group_index > m_nb_regions)
+      throw ParsingFailed(FromHere(),"Physical groups must be numbered from 1 to the number of physical names");
+    m_region_list[phys_group_index-1].dim=phys_group_dimensionality;
+    m_region_list[phys_group_index-1].index=phys_group_index;
+    //The original name of the region in the mesh file has quotes, we want to strip them off
+    m_region_list[phys_group_index-1].name=phys_group_name.substr(1,phys_group_name.length()-2);
+    m_region_list[phys_group_index-1].region = create_region(m_region_list[phys_group_index-1].name);
+    m_mesh_dimension = std::max(m_region_list[phys_group_index-1].dim,m_mesh_dimension);
   }
-  m_file.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,222 +711,365 @@ Handle< Region > Reader::create_region(std::string const& relative_path)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::find_used_nodes()
+Uint Reader::first_record_of_part(const Uint nb_records, const Uint part) const
 {
-  m_used_nodes.clear();
-  std::string line;
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  if (part == nb_parts)
+    return nb_records;
+  return nb_records/nb_parts*part;
+}
 
-  m_file.seekg(m_elements_position,std::ios::beg);
-  // skip next line
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "header = " << line << std::endl;
-  //Skip the line containing the actual number of elements
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "nb_elems = " << line << std::endl;
+//////////////////////////////////////////////////////////////////////////////
+
+std::streamoff Reader::line_start(const std::streamoff position, const std::streamoff end)
+{
+  m_file.clear();
+  m_file.seekg(position-1,std::ios::beg);
+  std::streamoff next = position-1;
+  char c;
+  while (next < end && m_file.get(c))
+  {
+    ++next;
+    if (c == '\n')
+      return next;
+  }
+  return end;
+}
+
+//////////////////////////////////////////////////////////////////////////////
 
-  // read every line and store the connectivity in the correct region through the buffer
-  Uint elementNumber, elementType, nbElementNodes;
-  Uint gmsh_node_number, nb_tags, phys_tag, other_tag;
+std::streamoff Reader::ascii_chunk_begin(const std::streamoff begin, const std::streamoff end, const Uint part)
+{
+  const Uint nb_parts = options().value<Uint>("nb_parts");
+  if (part == 0)
+    return begin;
+  if (part == nb_parts)
+    return end;
+  return line_start(begin + (end-begin)*part/nb_parts, end);
+}
 
-  std::set<Uint>::iterator it=m_used_nodes.begin();
+//////////////////////////////////////////////////////////////////////////////
 
-//  if (PE::Comm::instance().rank()==IO_rank)
-//  {
-//    std::cout << "nb_obj = "   << m_hash->subhash(ELEMS).options()["nb_obj"].value<Uint>() << std::endl;
-//    std::cout << "nb_parts = " <<m_hash->subhash(ELEMS).options()["nb_parts"].value<Uint>() << std::endl;
-//  }
-  for (Uint i=0; i<m_total_nb_elements; ++i)
+void Reader::read_nodes(const Uint part, NodeChunk& nodes)
+{
+  //  $Nodes
+  //  number-of-nodes
+  //  node-number x-coord y-coord z-coord
+  //  ...
+  //  $EndNodes
+
+  std::streamoff begin, end;
+  if (m_binary)
   {
-//    if (m_total_nb_elements > 100000)
-//    {
-//      if(i%(m_total_nb_elements/20)==0)
-//        CFinfo << 100*i/m_total_nb_elements << "% " << CFflush;
-//    }
-
-    cf3_assert(m_hash);
-    if (m_hash->subhash(ELEMS).owns(i))
-    {
-      // element description
-      m_file >> elementNumber >> elementType;
-      nbElementNodes = Shared::m_nodes_in_gmsh_elem[elementType];
-
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << i << ":  elem["<<m_hash->subhash(ELEMS).part_of_obj(i)<<"] " << elementNumber << " :    ";
-      m_file >> nb_tags;
-      m_file >> phys_tag;
-      for(Uint itag = 0; itag < (nb_tags-1); ++itag)
-          m_file >> other_tag;
-
-      for (Uint j=0; j<nbElementNodes; ++j)
-      {
-        m_file >> gmsh_node_number;
-        it = m_used_nodes.insert(it,gmsh_node_number);
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "  " << gmsh_node_number;
-      }
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << "\n";
-    }
-    getline(m_file,line); // finnish the line
+    const std::streamoff record_size = sizeof(boost::int32_t)+3*sizeof(double);
+    const Uint first = first_record_of_part(m_total_nb_nodes, part);
+    const Uint last  = first_record_of_part(m_total_nb_nodes, part+1);
+    begin = m_nodes_begin + record_size*first;
+    end   = m_nodes_begin + record_size*last;
+    nodes.numbers.reserve(last-first);
+    nodes.coordinates.reserve(3*(last-first));
+    nodes.parts.reserve(last-first);
+  }
+  else
+  {
+    begin = ascii_chunk_begin(m_nodes_begin, m_nodes_end, part);
+    end   = ascii_chunk_begin(m_nodes_begin, m_nodes_end, part+1);
   }
 
-  // Now we have all nodes, used by the elements
+  detail::RecordReader reader(m_file, begin, end, m_binary);
+  while (reader.next_record())
+  {
+    nodes.numbers.push_back(reader.next_uint());
+    //Gmsh always stores 3 coordinates, even for 2D meshes
+    for (Uint d=0; d<3; ++d)
+      nodes.coordinates.push_back(reader.next_real());
+    nodes.parts.push_back(part);
+  }
+}
 
-  // Now add owned nodes
-  m_file.seekg(m_coordinates_position,std::ios::beg);
-  //Skip the line with keyword '$Nodes':
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "header = " << line << std::endl;
-  // skip one line, which says how many (total) nodes are  present in the mesh
-  getline(m_file,line);
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << "nb_nodes = " << line << std::endl;
+//////////////////////////////////////////////////////////////////////////////
 
-  for (Uint node_idx=0; node_idx<m_total_nb_nodes; ++node_idx)
+void Reader::read_elements(const Uint part, ElementChunk& elements, const bool store_nodes)
+{
+  //  $Elements
+  //  number-of-elements
+  //  elm-number elm-type number-of-tags < tag > ... node-number-list
+  //  ...
+  //  $EndElements
+  //
+  // In binary files the elements are stored in blocks of the same type and number of tags,
+  // and the element type and number of tags are only stored in the header of the block.
+
+  if (m_binary)
   {
-//    if (m_total_nb_nodes > 100000)
-//    {
-//      if(node_idx%(m_total_nb_nodes/20)==0)
-//        CFinfo << 100*node_idx/m_total_nb_nodes << "% " << CFflush;
-//      if (node_idx == m_total_nb_nodes-1)
-//        CFinfo << CFendl;
-//    }
-    getline(m_file,line);
-
-    std::stringstream ss(line);
-    ss >> gmsh_node_number;
-    getline(ss,line);
-    if (m_hash->subhash(NODES).owns(node_idx))
+    const Uint first = first_record_of_part(m_total_nb_elements, part);
+    const Uint last  = first_record_of_part(m_total_nb_elements, part+1);
+    boost_foreach(const ElementBlock& block, m_element_blocks)
     {
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << "node " << gmsh_node_number << "\n";
+      const Uint block_first = std::max(first, block.first_element);
+      const Uint block_last  = std::min(last, block.first_element+block.nb_elements);
+      if (block_first >= block_last)
+        continue;
 
-      it = m_used_nodes.insert(it,gmsh_node_number);
-    }
-    else
-    {
-      it = m_used_nodes.find(gmsh_node_number);
-      if (it != m_used_nodes.end())
+      const std::streamoff record_size = sizeof(boost::int32_t)*(1+block.nb_tags+Shared::m_nodes_in_gmsh_elem[block.gmsh_type]);
+      detail::RecordReader reader(m_file,
+                                  block.begin + record_size*(block_first-block.first_element),
+                                  block.begin + record_size*(block_last-block.first_element),
+                                  true);
+      while (reader.next_record())
       {
-        m_ghost_nodes.insert(node_idx);
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "ghostnode " << gmsh_node_number << "\n";
+        const Uint number = reader.next_uint();
+        read_element_record(reader, number, block.gmsh_type, block.nb_tags, elements, store_nodes);
       }
     }
   }
-//  if (PE::Comm::instance().rank()==IO_rank)
-//    std::cout << std::flush;
+  else
+  {
+    detail::RecordReader reader(m_file,
+                                ascii_chunk_begin(m_elements_begin, m_elements_end, part),
+                                ascii_chunk_begin(m_elements_begin, m_elements_end, part+1),
+                                false);
+    while (reader.next_record())
+    {
+      const Uint number = reader.next_uint();
+      const Uint gmsh_type = reader.next_uint();
+      const Uint nb_tags = reader.next_uint();
+      read_element_record(reader, number, gmsh_type, nb_tags, elements, store_nodes);
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::read_coordinates()
+void Reader::read_element_record(detail::RecordReader& reader, const Uint number, const Uint gmsh_type, const Uint nb_tags,
+                                 ElementChunk& elements, const bool store_nodes)
 {
+  if (gmsh_type == 0 || gmsh_type >= Shared::nb_gmsh_types || Shared::m_nodes_in_gmsh_elem[gmsh_type] == 0)
+    throw ParsingFailed(FromHere(),"Element "+to_str(number)+" has unsupported gmsh element type "+to_str(gmsh_type));
+  if (nb_tags == 0)
+    throw ParsingFailed(FromHere(),"Element "+to_str(number)+" has no physical tag");
+
+  // The first tag is the physical group, the others are skipped
+  const int phys_tag = reader.next_int();
+  if (phys_tag <= 0 || static_cast<Uint>(phys_tag) > m_nb_regions)
+    throw ParsingFailed(FromHere(),"Element "+to_str(number)+" has physical tag "+to_str(phys_tag)+" without physical name");
+  for (Uint tag=1; tag<nb_tags; ++tag)
+    reader.next_int();
+
+  elements.numbers.push_back(number);
+  elements.types.push_back(gmsh_type);
+  elements.regions.push_back(phys_tag-1);
+
+  const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[gmsh_type];
+  for (Uint n=0; n<nb_element_nodes; ++n)
+  {
+    const Uint gmsh_node_number = reader.next_uint();
+    if (store_nodes)
+      elements.nodes.push_back(gmsh_node_number);
+  }
+}
 
-  m_file.seekg(m_coordinates_position,std::ios::beg);
+//////////////////////////////////////////////////////////////////////////////
 
-  Dictionary& nodes = m_mesh->geometry_fields();
-  nodes.resize(m_used_nodes.size());
-  m_used_nodes.clear();
+void Reader::find_element_types(const ElementChunk& elements)
+{
+  // Every part creates the same element types in every region, also if it has no elements of that type
+  std::vector<Uint> has_type(m_nb_regions*Shared::nb_gmsh_types, 0u);
+  for (Uint e=0; e<elements.numbers.size(); ++e)
+    has_type[elements.regions[e]*Shared::nb_gmsh_types + elements.types[e]] = 1u;
 
-  Uint part = options().value<Uint>("part");
+  if (m_distributed)
+  {
+    PE::Comm::instance().all_reduce(PE::max(), has_type, has_type);
+  }
+  else
+  {
+    const Uint part = options().value<Uint>("part");
+    const Uint nb_parts = options().value<Uint>("nb_parts");
+    for (Uint other_part=0; other_part<nb_parts; ++other_part)
+    {
+      if (other_part == part)
+        continue;
+      ElementChunk other_elements;
+      read_elements(other_part, other_elements, false);
+      for (Uint e=0; e<other_elements.numbers.size(); ++e)
+        has_type[other_elements.regions[e]*Shared::nb_gmsh_types + other_elements.types[e]] = 1u;
+    }
+  }
 
-  std::string line;
-  //Skip the line with keyword '$Nodes':
-  getline(m_file,line);
-//  CFinfo << line << CFendl;
-  // skip one line, which says how many (total) nodes are  present in the mesh
-  getline(m_file,line);
-//  CFinfo << line << CFendl;
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+  {
+    m_region_list[ir].element_types.clear();
+    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
+    {
+      (m_nb_gmsh_elem_in_region[ir])[etype] = 0;
+      if (has_type[ir*Shared::nb_gmsh_types + etype])
+        m_region_list[ir].element_types.insert(etype);
+    }
+  }
 
+  for (Uint e=0; e<elements.numbers.size(); ++e)
+    (m_nb_gmsh_elem_in_region[elements.regions[e]])[elements.types[e]]++;
+}
 
-  // declare and allocate one coordinate row
-//  std::vector<Real> rowVector(m_mesh_dimension);
+//////////////////////////////////////////////////////////////////////////////
 
-  std::set<Uint>::const_iterator it;
+void Reader::find_ghost_nodes(const NodeChunk& owned, const ElementChunk& elements, NodeChunk& ghosts)
+{
+  // Nodes used by the elements of this part, that were not read with its own nodes
+  std::vector<Uint> used(elements.nodes);
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
 
-  Uint coord_idx=0;
-  Uint gmsh_node_number;
+  std::vector<Uint> owned_numbers(owned.numbers);
+  std::sort(owned_numbers.begin(), owned_numbers.end());
+
+  std::vector<Uint> missing;
+  std::set_difference(used.begin(), used.end(), owned_numbers.begin(), owned_numbers.end(), std::back_inserter(missing));
 
-  for (Uint node_idx=0; node_idx<m_total_nb_nodes; ++node_idx)
+  if (m_distributed)
   {
-//    if (m_total_nb_nodes > 100000)
-//    {
-//      if(node_idx%(m_total_nb_nodes/20)==0)
-//        CFinfo << 100*node_idx/m_total_nb_nodes << "% " << CFflush;
-//      if(node_idx==m_total_nb_nodes-1)
-//        CFinfo << CFendl;
-//    }
-    getline(m_file,line);
-//    CFinfo << line << CFendl;
-    if (m_hash->subhash(NODES).owns(node_idx))
+    request_ghost_nodes(owned, missing, ghosts);
+  }
+  else if (!missing.empty())
+  {
+    // Without other processors to ask, the nodes of the other parts are read from the file
+    const Uint part = options().value<Uint>("part");
+    const Uint nb_parts = options().value<Uint>("nb_parts");
+    for (Uint other_part=0; other_part<nb_parts; ++other_part)
     {
-      std::stringstream ss(line);
-      ss >> gmsh_node_number;
-      m_node_idx_gmsh_to_cf[gmsh_node_number]=coord_idx;
+      if (other_part == part)
+        continue;
+      NodeChunk other_nodes;
+      read_nodes(other_part, other_nodes);
+      for (Uint n=0; n<other_nodes.numbers.size(); ++n)
+      {
+        if (std::binary_search(missing.begin(), missing.end(), other_nodes.numbers[n]))
+        {
+          ghosts.numbers.push_back(other_nodes.numbers[n]);
+          ghosts.coordinates.insert(ghosts.coordinates.end(), other_nodes.coordinates.begin()+3*n, other_nodes.coordinates.begin()+3*n+3);
+          ghosts.parts.push_back(other_part);
+        }
+      }
+    }
+    if (ghosts.numbers.size() < missing.size())
+      throw ParsingFailed(FromHere(),"Elements use "+to_str(static_cast<Uint>(missing.size()-ghosts.numbers.size()))+" nodes that are not defined in the file");
+  }
+}
 
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << gmsh_node_number << " --> " << coord_idx << std::endl;
+//////////////////////////////////////////////////////////////////////////////
 
-      for (Uint dim=0; dim<m_mesh_dimension; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-      if(m_mesh_dimension < DIM_3D) getline(ss,line); //Gmsh always stores 3 coordinates, even for 2D meshes
+void Reader::request_ghost_nodes(const NodeChunk& owned, const std::vector<Uint>& missing, NodeChunk& ghosts)
+{
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_procs = comm.size();
+
+  // 1) Register the owned nodes in a directory distributed over all processors:
+  //    the owner of node n is known by processor n % nb_procs
+  std::vector< std::vector<Uint> > send(nb_procs);
+  std::vector< std::vector<Uint> > recv(nb_procs);
+  boost_foreach(const Uint number, owned.numbers)
+    send[number % nb_procs].push_back(number);
+  comm.all_to_all(send, recv);
+
+  std::vector< std::pair<Uint,Uint> > directory;
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    boost_foreach(const Uint number, recv[proc])
+      directory.push_back(std::make_pair(number, proc));
+  }
+  std::sort(directory.begin(), directory.end());
 
-      nodes.rank()[coord_idx] = part;
-      nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
+  // 2) Ask the directory which processors own the missing nodes
+  std::vector< std::vector<Uint> > requested(nb_procs);
+  boost_foreach(const Uint number, missing)
+    requested[number % nb_procs].push_back(number);
+  comm.all_to_all(requested, recv);
 
-      coord_idx++;
-    }
-    else
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    send[proc].clear();
+    boost_foreach(const Uint number, recv[proc])
     {
-      it = m_ghost_nodes.find(node_idx);
-      if (it != m_ghost_nodes.end())
-      {
-        std::stringstream ss(line);
-        ss >> gmsh_node_number;
-        m_node_idx_gmsh_to_cf[gmsh_node_number]=coord_idx;
-
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << gmsh_node_number << " --> " << coord_idx << std::endl;
+      std::vector< std::pair<Uint,Uint> >::const_iterator entry =
+          std::lower_bound(directory.begin(), directory.end(), std::make_pair(number, 0u));
+      if (entry == directory.end() || entry->first != number)
+        throw ParsingFailed(FromHere(),"Node "+to_str(number)+" is used by an element, but is not defined in the file");
+      send[proc].push_back(entry->second);
+    }
+  }
+  std::vector< std::vector<Uint> > owners(nb_procs);
+  comm.all_to_all(send, owners);
 
-        for (Uint dim=0; dim<m_mesh_dimension; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-        if(m_mesh_dimension < DIM_3D) getline(ss, line);
+  // 3) Ask the owners for the coordinates of the missing nodes
+  for (Uint proc=0; proc<nb_procs; ++proc)
+    send[proc].clear();
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    for (Uint i=0; i<requested[proc].size(); ++i)
+      send[owners[proc][i]].push_back(requested[proc][i]);
+  }
+  comm.all_to_all(send, recv);
 
-        nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(node_idx);
-        nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
+  std::vector< std::pair<Uint,Uint> > owned_index(owned.numbers.size());
+  for (Uint n=0; n<owned.numbers.size(); ++n)
+    owned_index[n] = std::make_pair(owned.numbers[n], n);
+  std::sort(owned_index.begin(), owned_index.end());
 
-        coord_idx++;
-      }
+  std::vector< std::vector<Real> > send_coordinates(nb_procs);
+  std::vector< std::vector<Real> > recv_coordinates(nb_procs);
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    boost_foreach(const Uint number, recv[proc])
+    {
+      const Uint n = std::lower_bound(owned_index.begin(), owned_index.end(), std::make_pair(number, 0u))->second;
+      send_coordinates[proc].insert(send_coordinates[proc].end(), owned.coordinates.begin()+3*n, owned.coordinates.begin()+3*n+3);
     }
+  }
+  comm.all_to_all(send_coordinates, recv_coordinates);
 
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    ghosts.numbers.insert(ghosts.numbers.end(), send[proc].begin(), send[proc].end());
+    ghosts.coordinates.insert(ghosts.coordinates.end(), recv_coordinates[proc].begin(), recv_coordinates[proc].end());
+    ghosts.parts.insert(ghosts.parts.end(), send[proc].size(), proc);
+  }
+}
 
-  } //loop over nodes
+//////////////////////////////////////////////////////////////////////////////
 
+void Reader::read_coordinates(const NodeChunk& owned, const NodeChunk& ghosts)
+{
+  Dictionary& nodes = m_mesh->geometry_fields();
+  nodes.resize(owned.numbers.size()+ghosts.numbers.size());
 
+  m_node_idx_gmsh_to_cf.clear();
 
-  /*
-  CFinfo << "Printing all nodal coordinates:" << CFendl;
-  for(Uint i = 0; i < m_total_nb_nodes; ++i)
+  // Owned nodes first, then the ghost nodes
+  const NodeChunk* chunks[2] = { &owned, &ghosts };
+  Uint coord_idx=0;
+  for (Uint c=0; c<2; ++c)
   {
-      CFinfo << "\t";
-      for(Uint dim = 0; dim < m_mesh_dimension; ++dim)
-        {
-            CFinfo << nodes.coordinates()[i][dim] << " ";
-        }
-      CFinfo << CFendl;
-  }
-  */
+    const NodeChunk& chunk = *chunks[c];
+    for (Uint n=0; n<chunk.numbers.size(); ++n)
+    {
+      const Uint gmsh_node_number = chunk.numbers[n];
+      m_node_idx_gmsh_to_cf.insert(m_node_idx_gmsh_to_cf.end(), std::make_pair(gmsh_node_number, coord_idx));
 
-  getline(m_file,line);
+      for (Uint dim=0; dim<m_mesh_dimension; ++dim)
+        nodes.coordinates()[coord_idx][dim] = chunk.coordinates[3*n+dim];
+
+      nodes.rank()[coord_idx] = chunk.parts[n];
+      nodes.glb_idx()[coord_idx] = gmsh_node_number-1;
+
+      ++coord_idx;
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::read_connectivity()
+void Reader::read_connectivity(const ElementChunk& elements)
 {
 
   Dictionary& nodes = m_mesh->geometry_fields();
@@ -516,23 +1088,14 @@ void Reader::read_connectivity()
 
  std::map<Uint, Entities*>::iterator elem_table_iter;
 
-// std::vector<std::map<std::string,Handle< Elements > > > elements(m_nb_regions);
-// std::vector<std::map<std::string,Handle< Connectivity::Buffer > > > buffer(m_nb_regions);
-
-
  m_elem_idx_gmsh_to_cf.clear();
  //Loop over all regions and allocate a connectivity table of proper size for each element type that
- //is present in each region. Counting of elements was done during the first pass in the function
- //get_file_positions
+ //is present in each region. Counting of elements was done in the function find_element_types
  for(Uint ir = 0; ir < m_nb_regions; ++ir)
  {
    // create new region
    Handle< Region > region = m_region_list[ir].region;
 
-//   elements[ir] = create_cells_in_region(*region,m_mesh->geometry_fields(),m_supported_types);
-//   buffer[ir] = create_connectivity_buffermap(elements[ir]);
-
-
    // Take the gmsh element types present in this region and generate new names of elements which correspond
    // to coolfuid naming:
    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
@@ -562,92 +1125,51 @@ void Reader::read_connectivity()
    }
  }
 
-   std::string etype_CF;
-   std::set<Uint>::const_iterator it;
    std::vector<Uint> cf_element;
-   Uint element_number, gmsh_element_type, nb_element_nodes;
-   Uint gmsh_node_number, nb_tags, phys_tag, other_tag;
-   Uint cf_node_number;
    Uint cf_idx;
 
-   m_file.seekg(m_elements_position,std::ios::beg);
-   // skip next line
-   std::string line;
-   //Re-read the line that contains the keyword '$Elements':
-   getline(m_file,line);
-   //Parse the following line (containing the actual number of elements)
-   getline(m_file,line);
-
    for(Uint ir = 0; ir < m_nb_regions; ++ir)
      for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
       (m_nb_gmsh_elem_in_region[ir])[etype] = 0;
 
-  for (Uint i=0; i<m_total_nb_elements; ++i)
+  Uint first_node = 0;
+  for (Uint e=0; e<elements.numbers.size(); ++e)
   {
-//    if (m_total_nb_elements > 100000)
-//    {
-//      if(i%(m_total_nb_elements/20)==0)
-//        CFinfo << 100*i/m_total_nb_elements << "% " << CFflush;
-//      if(i==m_total_nb_elements-1)
-//        CFinfo << CFendl;
-//    }
-
-    // element description
-    m_file >> element_number >> gmsh_element_type;
-
-    nb_element_nodes = Shared::m_nodes_in_gmsh_elem[gmsh_element_type];
+    const Uint element_number = elements.numbers[e];
+    const Uint gmsh_element_type = elements.types[e];
+    const Uint region_idx = elements.regions[e];
+    const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[gmsh_element_type];
 
-    // get element nodes
-    if (m_hash->subhash(ELEMS).owns(i))
+    cf_element.resize(nb_element_nodes);
+    for (Uint j=0; j<nb_element_nodes; ++j)
     {
-      m_file >> nb_tags;
-      m_file >> phys_tag;
-      for(Uint itag = 0; itag < (nb_tags-1); ++itag)
-          m_file >> other_tag;
-
-//      CFinfo << "Reading element " << element_number << " of type " << gmsh_element_type;
-//      CFinfo << " in region " << phys_tag << " with " << nb_element_nodes << " nodes " << CFendl;
-
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << element_number << "   -->   ";
-
-      cf_element.resize(nb_element_nodes);
-      for (Uint j=0; j<nb_element_nodes; ++j)
-      {
-        cf_idx = Shared::m_nodes_gmsh_to_cf[gmsh_element_type][j];
-        m_file >> gmsh_node_number;
-        cf_node_number = m_node_idx_gmsh_to_cf[gmsh_node_number];
-        cf_element[cf_idx] = cf_node_number;
-//        if (PE::Comm::instance().rank()==IO_rank)
-//          std::cout << "  " << gmsh_node_number << "("<<m_node_idx_gmsh_to_cf[gmsh_node_number]<<")";
-      }
-//      if (PE::Comm::instance().rank()==IO_rank)
-//        std::cout << std::endl;
-
-      elem_table_iter = conn_table_idx[phys_tag-1].find(gmsh_element_type);
-      const Uint row_idx = (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type];
-
-      Handle< Elements > elements_region = Handle<Elements>(elem_table_iter->second->handle<Component>());
-      Connectivity::Row element_nodes = elements_region->geometry_space().connectivity()[row_idx];
-
-      m_elem_idx_gmsh_to_cf[element_number] = std::make_pair( elements_region , row_idx);
+      cf_idx = Shared::m_nodes_gmsh_to_cf[gmsh_element_type][j];
+      const Uint gmsh_node_number = elements.nodes[first_node+j];
+      std::map<Uint,Uint>::const_iterator node = m_node_idx_gmsh_to_cf.find(gmsh_node_number);
+      if (node == m_node_idx_gmsh_to_cf.end())
+        throw ParsingFailed(FromHere(),"Node "+to_str(gmsh_node_number)+" of element "+to_str(element_number)+" is not defined in the file");
+      cf_element[cf_idx] = node->second;
+    }
+    first_node += nb_element_nodes;
 
-      for(Uint node = 0; node < nb_element_nodes; ++node)
-      {
-         element_nodes[node] = cf_element[node];
-      }
+    elem_table_iter = conn_table_idx[region_idx].find(gmsh_element_type);
+    const Uint row_idx = (m_nb_gmsh_elem_in_region[region_idx])[gmsh_element_type];
 
-      elements_region->rank()[row_idx] = part;
-      elements_region->glb_idx()[row_idx] = element_number-1;
+    Handle< Elements > elements_region = Handle<Elements>(elem_table_iter->second->handle<Component>());
+    Connectivity::Row element_nodes = elements_region->geometry_space().connectivity()[row_idx];
 
-      (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type]++;
+    m_elem_idx_gmsh_to_cf[element_number] = std::make_pair( elements_region , row_idx);
 
+    for(Uint node = 0; node < nb_element_nodes; ++node)
+    {
+       element_nodes[node] = cf_element[node];
     }
 
-    // finish the line
-    getline(m_file,line);
+    elements_region->rank()[row_idx] = part;
+    elements_region->glb_idx()[row_idx] = element_number-1;
+
+    (m_nb_gmsh_elem_in_region[region_idx])[gmsh_element_type]++;
   }
-  getline(m_file,line);  // ENDOFSECTION
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -673,7 +1195,7 @@ void Reader::read_element_node_data()
 
   std::map<std::string,Reader::Field> gmsh_fields;
 
-  boost_foreach(Uint element_node_data_position, m_element_node_data_positions)
+  boost_foreach(std::streamoff element_node_data_position, m_element_node_data_positions)
   {
     m_file.seekg(element_node_data_position,std::ios::beg);
     read_variable_header(gmsh_fields);
@@ -709,9 +1231,8 @@ void Reader::read_element_node_data()
         CFdebug << "Reading " << field.name() << "/" << field.var_name(var) <<"["<<static_cast<Uint>(field.var_length(var))<<"]" << CFendl;
         Uint var_begin = field.var_offset(var);
         Uint var_end = var_begin + static_cast<Uint>(field.var_length(var));
-        m_file.seekg(gmsh_field.file_data_positions[var]);
+        detail::RecordReader reader(m_file, gmsh_field.file_data_positions[var], m_file_end, m_binary);
 
-        std::string line;
         Uint gmsh_elem_idx;
         Uint gmsh_nb_elem_nodes;
         Uint cf_idx;
@@ -722,7 +1243,10 @@ void Reader::read_element_node_data()
         std::map<Uint, std::pair<Handle< Elements >,Uint> >::iterator it;
         for (Uint e=0; e<gmsh_field.nb_entries; ++e)
         {
-          m_file >> gmsh_elem_idx >> gmsh_nb_elem_nodes;
+          if (!reader.next_record())
+            throw ParsingFailed(FromHere(),"Field "+field_name+" has fewer entries than announced");
+          gmsh_elem_idx = reader.next_uint();
+          gmsh_nb_elem_nodes = reader.next_uint();
 
           it = m_elem_idx_gmsh_to_cf.find(gmsh_elem_idx);
           if (it != m_elem_idx_gmsh_to_cf.end())
@@ -736,7 +1260,7 @@ void Reader::read_element_node_data()
             {
 
               for (d=0; d<data.size(); ++d)
-                m_file >> data[d];
+                data[d] = reader.next_real();
 
               mesh::Field::Row field_data = field[space.connectivity()[cf_idx][n]] ;
 
@@ -750,7 +1274,12 @@ void Reader::read_element_node_data()
                 field_data[v] = data[d++];
             }
           }
-          getline(m_file,line); // finish line
+          else if (m_binary)
+          {
+            // binary records have no line ending to skip to
+            for (n=0; n<gmsh_nb_elem_nodes*data.size(); ++n)
+              reader.next_real();
+          }
         }
       }
     }
@@ -781,7 +1310,7 @@ void Reader::read_element_data()
 
   std::map<std::string,Reader::Field> fields;
 
-  boost_foreach(Uint element_data_position, m_element_data_positions)
+  boost_foreach(std::streamoff element_data_position, m_element_data_positions)
   {
     m_file.seekg(element_data_position,std::ios::beg);
     read_variable_header(fields);
@@ -806,8 +1335,7 @@ void Reader::read_element_data()
         CFdebug << "Reading " << field.name() << "/" << field.var_name(i) <<"["<<static_cast<Uint>(field.var_length(i))<<"]" << CFendl;
         Uint var_begin = field.var_offset(i);
         Uint var_end = var_begin + static_cast<Uint>(field.var_length(i));
-        m_file.seekg(gmsh_field.file_data_positions[i]);
-
+        detail::RecordReader reader(m_file, gmsh_field.file_data_positions[i], m_file_end, m_binary);
 
         Uint gmsh_elem_idx;
         Uint cf_idx;
@@ -817,9 +1345,11 @@ void Reader::read_element_data()
 
         for (Uint e=0; e<gmsh_field.nb_entries; ++e)
         {
-          m_file >> gmsh_elem_idx;
+          if (!reader.next_record())
+            throw ParsingFailed(FromHere(),"Field "+name+" has fewer entries than announced");
+          gmsh_elem_idx = reader.next_uint();
           for (d=0; d<data.size(); ++d)
-            m_file >> data[d];
+            data[d] = reader.next_real();
 
           std::map<Uint, std::pair<Handle< Elements >,Uint> >::iterator it = m_elem_idx_gmsh_to_cf.find(gmsh_elem_idx);
           if (it != m_elem_idx_gmsh_to_cf.end())
@@ -862,7 +1392,7 @@ void Reader::read_node_data()
 
   std::map<std::string,Field> fields;
 
-  boost_foreach(Uint node_data_position, m_node_data_positions)
+  boost_foreach(std::streamoff node_data_position, m_node_data_positions)
   {
     m_file.seekg(node_data_position,std::ios::beg);
     read_variable_header(fields);
@@ -878,7 +1408,7 @@ void Reader::read_node_data()
       CFdebug << "Reading " << field.name() << "/" << field.var_name(i) <<"["<<static_cast<Uint>(field.var_length(i))<<"]" << CFendl;
       Uint var_begin = field.var_offset(i);
       Uint var_end = var_begin + static_cast<Uint>(field.var_length(i));
-      m_file.seekg(gmsh_field.file_data_positions[i]);
+      detail::RecordReader reader(m_file, gmsh_field.file_data_positions[i], m_file_end, m_binary);
 
       Uint gmsh_node_idx;
       Uint cf_idx;
@@ -887,9 +1417,11 @@ void Reader::read_node_data()
 
       for (Uint e=0; e<gmsh_field.nb_entries; ++e)
       {
-        m_file >> gmsh_node_idx;
+        if (!reader.next_record())
+          throw ParsingFailed(FromHere(),"Field "+name+" has fewer entries than announced");
+        gmsh_node_idx = reader.next_uint();
         for (d=0; d<data.size(); ++d)
-          m_file >> data[d];
+          data[d] = reader.next_real();
 
         std::map<Uint, Uint>::iterator it = m_node_idx_gmsh_to_cf.find(gmsh_node_idx);
         if (it != m_node_idx_gmsh_to_cf.end())
@@ -928,7 +1460,8 @@ void Reader::read_variable_header(std::map<std::string,Field>& fields)
   Uint var_type(0);
   Uint nb_entries(0);
 
-  //Re-read the line that contains the keyword '$Elements':
+  //Re-read the line that contains the keyword of the section:
+  m_file.clear();
   getline(m_file,line);
 
   // string tags
@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <set>
+#include <iosfwd>
 #include <boost/tuple/tuple.hpp>
 
 #include "mesh/MeshReader.hpp"
@@ -24,16 +25,26 @@ namespace mesh {
 
 class Elements;
 class Region;
-class MergedParallelDistribution;
 class Dictionary;
 
 class Mesh;
 
 namespace gmsh {
 
+namespace detail { class RecordReader; }
+
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines gmsh mesh format reader
+///
+/// Both the ascii and the binary variant of the MSH 2 format are read.
+/// Every part reads only its own chunk of the $Nodes and $Elements sections:
+/// in ascii files the sections are split in byte ranges that start at a line,
+/// in binary files in ranges of records. A first scan locates the sections;
+/// for ascii files every processor scans a slice of the file for section markers.
+/// Nodes used by the elements of a part but read by another part are requested
+/// from that part through a distributed directory of node numbers.
+/// If the parts are not read by as many processors, these nodes are read from the file.
 /// @author Willem Deconinck
 /// @author Martin Vymazal
 class gmsh_API Reader : public MeshReader, public Shared
@@ -49,17 +60,90 @@ public: // functions
 
   virtual std::vector<std::string> get_extensions();
 
+private: // types
+
+  /// Nodes read from the file, with their gmsh number, 3 coordinates and part
+  struct NodeChunk
+  {
+    std::vector<Uint> numbers;
+    std::vector<Real> coordinates;
+    std::vector<Uint> parts;
+  };
+
+  /// Elements read from the file, with their gmsh number, gmsh type, region index
+  /// and the gmsh numbers of their nodes, in gmsh order
+  struct ElementChunk
+  {
+    std::vector<Uint> numbers;
+    std::vector<Uint> types;
+    std::vector<Uint> regions;
+    std::vector<Uint> nodes;
+  };
+
+  /// Block of elements in a binary file, sharing their type and number of tags
+  struct ElementBlock
+  {
+    Uint gmsh_type;
+    Uint nb_tags;
+    Uint first_element;
+    Uint nb_elements;
+    std::streamoff begin;
+  };
+
 private: // functions
 
+  /// Read the $MeshFormat section
+  /// @return the position after it
+  std::streamoff read_mesh_format();
+
   void get_file_positions();
 
+  /// Locate the sections of an ascii file from the positions of the lines starting with '$'
+  void scan_sections_ascii(const std::streamoff begin);
+
+  /// Locate the sections of a binary file, skipping the binary data by its size
+  void scan_sections_binary(const std::streamoff begin);
+
+  /// @return the positions of the lines starting with '$' in the given slice of [begin,end)
+  std::vector<std::streamoff> find_section_markers(const std::streamoff begin, const std::streamoff end,
+                                                   const Uint slice, const Uint nb_slices);
+
+  void read_physical_names();
+
   Handle<Region> create_region(std::string const& relative_path);
 
-  void find_used_nodes();
+  /// @return the first record of a part, when nb_records are split in nb_parts
+  Uint first_record_of_part(const Uint nb_records, const Uint part) const;
+
+  /// @return the start of the first line at or after position, in an ascii section ending at end
+  std::streamoff line_start(const std::streamoff position, const std::streamoff end);
+
+  /// @return the begin of the chunk of a part, in an ascii section [begin,end)
+  std::streamoff ascii_chunk_begin(const std::streamoff begin, const std::streamoff end, const Uint part);
+
+  /// Read the nodes of a part
+  void read_nodes(const Uint part, NodeChunk& nodes);
+
+  /// Read the elements of a part
+  /// @param [in] store_nodes  if false, only the type and region of the elements are stored
+  void read_elements(const Uint part, ElementChunk& elements, const bool store_nodes);
 
-  void read_coordinates();
+  /// Read one element, after its number, gmsh type and number of tags
+  void read_element_record(detail::RecordReader& reader, const Uint number, const Uint gmsh_type, const Uint nb_tags,
+                           ElementChunk& elements, const bool store_nodes);
 
-  void read_connectivity();
+  /// Find the element types of every region over all parts, and count the elements of this part
+  void find_element_types(const ElementChunk& elements);
+
+  /// Find the nodes used by the elements of this part, that were read by other parts
+  void find_ghost_nodes(const NodeChunk& owned, const ElementChunk& elements, NodeChunk& ghosts);
+
+  /// Get the ghost nodes from the processors that read them, using a directory of node numbers
+  void request_ghost_nodes(const NodeChunk& owned, const std::vector<Uint>& missing, NodeChunk& ghosts);
+
+  void read_coordinates(const NodeChunk& owned, const NodeChunk& ghosts);
+
+  void read_connectivity(const ElementChunk& elements);
 
   void read_element_node_data();
 
@@ -71,9 +155,6 @@ private: // data
 
   virtual void do_read_mesh_into(const common::URI& fp, Mesh& mesh);
 
-  enum HashType { NODES=0, ELEMS=1 };
-  Handle<MergedParallelDistribution> m_hash;
-
   // map< gmsh index , pair< elements, index in elements > >
   std::map<Uint, std::pair<Handle<Elements>,Uint> > m_elem_idx_gmsh_to_cf;
   std::map<Uint, Uint> m_node_idx_gmsh_to_cf;
@@ -100,19 +181,23 @@ private: // data
 
   std::vector<RegionData> m_region_list;
 
-  std::set<Uint> m_ghost_nodes;
-  //std::set<Uint> m_ghost_elems;
-  std::set<Uint> m_used_nodes;
-  
-  std::vector<std::set<Uint> > m_node_to_glb_elements;
+  /// True if the file is in binary format
+  bool m_binary;
+
+  /// True if every processor reads its own part, so that ghost nodes can be exchanged
+  bool m_distributed;
 
   //Markers for important places in the file to be read
-  Uint m_region_names_position;
-  Uint m_coordinates_position;
-  Uint m_elements_position;
-  std::vector<Uint> m_element_data_positions;
-  std::vector<Uint> m_node_data_positions;
-  std::vector<Uint> m_element_node_data_positions;
+  std::streamoff m_file_end;
+  std::streamoff m_region_names_position;
+  std::streamoff m_nodes_begin;
+  std::streamoff m_nodes_end;
+  std::streamoff m_elements_begin;
+  std::streamoff m_elements_end;
+  std::vector<ElementBlock> m_element_blocks;
+  std::vector<std::streamoff> m_element_data_positions;
+  std::vector<std::streamoff> m_node_data_positions;
+  std::vector<std::streamoff> m_element_node_data_positions;
 
 
   std::vector<std::vector<Uint> > m_nb_gmsh_elem_in_region;
@@ -127,7 +212,7 @@ private: // data
     Uint time_step;
     std::vector<Uint> var_types;
     Uint nb_entries;
-    std::vector<Uint> file_data_positions;
+    std::vector<std::streamoff> file_data_positions;
     std::string description() const
     {
       std::stringstream ss;
@@ -160,7 +245,6 @@ private: // data
 
   void read_variable_header(std::map<std::string,Field>& fields);
 
-  Uint IO_rank;
 }; // end Reader
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,452 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/CF.hpp"
+
+#include <cstring>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/MappedFile.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/native/Reader.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ContinuousDictionary.hpp"
+#include "mesh/DiscontinuousDictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Tags.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+using namespace common;
+
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Number of rows and columns of an array in the file, and the position of its values
+struct ArrayView
+{
+  Uint nb_rows;
+  Uint nb_cols;
+  const char* values;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Input file, mapped into memory, of the numbers, strings and arrays written by BinaryOutput
+class BinaryInput
+{
+public:
+
+  BinaryInput(const std::string& path, const Uint alignment) :
+    m_path(path),
+    m_alignment(alignment),
+    m_file(path),
+    m_begin(m_file.begin()),
+    m_end(m_file.end()),
+    m_pos(m_begin)
+  {
+  }
+
+  /// @return the position of the next nb_bytes bytes, and skip them
+  const char* read_bytes(const std::size_t nb_bytes)
+  {
+    if (static_cast<std::size_t>(m_end-m_pos) < nb_bytes)
+      throw FileFormatError(FromHere(), "File "+m_path+" is truncated");
+    const char* bytes = m_pos;
+    m_pos += nb_bytes;
+    return bytes;
+  }
+
+  Uint read_uint()
+  {
+    Uint value;
+    std::memcpy(&value, read_bytes(sizeof(Uint)), sizeof(Uint));
+    return value;
+  }
+
+  std::string read_string()
+  {
+    const Uint size = read_uint();
+    return std::string(read_bytes(size), size);
+  }
+
+  /// Read the number of rows and columns of an array, and skip its values
+  template <typename ValueT>
+  ArrayView read_array()
+  {
+    ArrayView array;
+    array.nb_rows = read_uint();
+    array.nb_cols = read_uint();
+    const std::size_t misalignment = (m_pos-m_begin) % m_alignment;
+    if (misalignment)
+      read_bytes(m_alignment-misalignment);
+    array.values = read_bytes(sizeof(ValueT)*array.nb_rows*array.nb_cols);
+    return array;
+  }
+
+  template <typename ValueT>
+  void read_list(List<ValueT>& list)
+  {
+    const ArrayView array = read_array<ValueT>();
+    if (array.nb_cols != 1)
+      throw FileFormatError(FromHere(), "File "+m_path+" has a table where "+list.uri().string()+" expects a list");
+    list.resize(array.nb_rows);
+    if (array.nb_rows)
+      std::memcpy(list.array().data(), array.values, sizeof(ValueT)*array.nb_rows);
+  }
+
+  template <typename ValueT>
+  void read_table(Table<ValueT>& table)
+  {
+    const ArrayView array = read_array<ValueT>();
+    table.set_row_size(array.nb_cols);
+    table.resize(array.nb_rows);
+    if (array.nb_rows != 0 && array.nb_cols != 0)
+      std::memcpy(table.array().data(), array.values, sizeof(ValueT)*array.nb_rows*array.nb_cols);
+  }
+
+private:
+
+  std::string m_path;
+  const Uint m_alignment;
+
+  MappedFile m_file;
+
+  const char* m_begin;
+  const char* m_end;
+  const char* m_pos;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < native::Reader, MeshReader, LibNative> aNativeReader_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+void add_tags(Component& component, const std::string& tags)
+{
+  std::vector<std::string> tag_list;
+  boost::algorithm::split(tag_list, tags, boost::algorithm::is_any_of(" "), boost::algorithm::token_compress_on);
+  boost_foreach(const std::string& tag, tag_list)
+  {
+    if (!tag.empty() && !component.has_tag(tag))
+      component.add_tag(tag);
+  }
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+Reader::Reader( const std::string& name )
+: MeshReader(name),
+  Shared()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Reader::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reader::do_read_mesh_into(const URI& path, Mesh& mesh)
+{
+  if (mesh.dimension() != 0 || count(find_components_recursively<Entities>(mesh.topology())) != 0)
+    throw SetupError(FromHere(), "Native mesh files can only be read into an empty mesh, while "+mesh.uri().string()+" is not empty");
+
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+  const URI file_path = file_of_rank(path, rank);
+
+  CFinfo << "reading native mesh file " << file_path.path() << CFendl;
+
+  detail::BinaryInput file(file_path.path(), alignment);
+
+  Header header;
+  std::memcpy(&header, file.read_bytes(sizeof(Header)), sizeof(Header));
+  check_header(header, file_path.path());
+  if (header.nb_procs != nb_procs || header.rank != rank)
+    throw SetupError(FromHere(), file_path.path()+" was written by processor "+to_str<Uint>(header.rank)+" of "+to_str<Uint>(header.nb_procs)
+                     +", and can not be read by processor "+to_str(rank)+" of "+to_str(nb_procs));
+
+  m_dictionaries.clear();
+  m_entities.clear();
+
+  for (Uint d=0; d<header.nb_dictionaries; ++d)
+    read_dictionary(file, mesh);
+
+  for (Uint c=0; c<header.nb_components; ++c)
+    read_component(file, mesh);
+
+  for (Uint c=0; c<header.nb_connectivities; ++c)
+    read_connectivity(file);
+
+  // The values are copied once all spaces of the dictionaries exist,
+  // while the file is still mapped
+  boost_foreach(const DictionaryData& data, m_dictionaries)
+    fill_dictionary(data, mesh, header.dimension);
+
+  mesh.update_structures();
+  mesh.update_statistics();
+
+  m_dictionaries.clear();
+  m_entities.clear();
+
+  mesh.raise_mesh_loaded();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_dictionary(detail::BinaryInput& file, Mesh& mesh)
+{
+  DictionaryData data;
+  const std::string name = file.read_string();
+  const bool continuous = file.read_uint();
+
+  if (name == mesh.geometry_fields().name())
+    data.dict = mesh.geometry_fields().handle<Dictionary>();
+  else if (continuous)
+    data.dict = mesh.create_component<ContinuousDictionary>(name)->handle<Dictionary>();
+  else
+    data.dict = mesh.create_component<DiscontinuousDictionary>(name)->handle<Dictionary>();
+
+  const detail::ArrayView glb_idx = file.read_array<Uint>();
+  const detail::ArrayView rank = file.read_array<Uint>();
+  data.size = glb_idx.nb_rows;
+  data.glb_idx = glb_idx.values;
+  data.rank = rank.values;
+
+  const Uint nb_fields = file.read_uint();
+  data.fields.resize(nb_fields);
+  boost_foreach(FieldData& field, data.fields)
+  {
+    field.name = file.read_string();
+    field.description = file.read_string();
+    field.tags = file.read_string();
+    const detail::ArrayView values = file.read_array<Real>();
+    if (values.nb_rows != data.size)
+      throw FileFormatError(FromHere(), "Field "+field.name+" has "+to_str(values.nb_rows)+" rows, while dictionary "+name+" has size "+to_str(data.size));
+    field.row_size = values.nb_cols;
+    field.values = values.values;
+  }
+
+  m_dictionaries.push_back(data);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_component(detail::BinaryInput& file, Mesh& mesh)
+{
+  const Uint kind = file.read_uint();
+  const std::string path = file.read_string();
+  const std::string tags = file.read_string();
+
+  // Parents are always read before their children
+  std::vector<std::string> names;
+  boost::algorithm::split(names, path, boost::algorithm::is_any_of("/"));
+  Handle<Component> parent = mesh.topology().handle();
+  for (Uint i=0; i+1<names.size(); ++i)
+    parent = parent->get_child_checked(names[i]);
+
+  if (kind == REGION)
+  {
+    Region& region = *parent->create_component<Region>(names.back());
+    add_tags(region, tags);
+    return;
+  }
+  if (kind != ENTITIES)
+    throw FileFormatError(FromHere(), "Unknown kind of component "+path);
+
+  const std::string builder_name = file.read_string();
+  const std::string element_type_name = file.read_string();
+  boost::shared_ptr<Entities> entities_ptr = build_component_abstract_type<Entities>(builder_name, names.back());
+  parent->add_component(entities_ptr);
+  Entities& entities = *entities_ptr;
+  add_tags(entities, tags);
+  m_entities.push_back(entities.handle<Entities>());
+
+  file.read_list(entities.glb_idx());
+  file.read_list(entities.rank());
+
+  const Uint nb_spaces = file.read_uint();
+  for (Uint s=0; s<nb_spaces; ++s)
+  {
+    const std::string dict_name = file.read_string();
+    const std::string shape_function_name = file.read_string();
+
+    Handle<Dictionary> dict;
+    boost_foreach(const DictionaryData& data, m_dictionaries)
+    {
+      if (data.dict->name() == dict_name)
+        dict = data.dict;
+    }
+    if (is_null(dict))
+      throw FileFormatError(FromHere(), "Entities "+path+" use unknown dictionary "+dict_name);
+
+    // The first space is the geometry space
+    if (s == 0)
+      entities.initialize(element_type_name, *dict);
+    Space& space = s == 0 ? entities.geometry_space() : entities.create_space(shape_function_name, *dict);
+    file.read_table(space.connectivity());
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Restore a table of Entity, stored as the index of its Entities in the file and its index
+void decode_entities(const detail::ArrayView& array,
+                     const std::vector< Handle<Entities> >& entities,
+                     const Uint null_entities,
+                     ElementConnectivity& table)
+{
+  std::vector<Uint> encoded(array.nb_rows*array.nb_cols);
+  if (!encoded.empty())
+    std::memcpy(&encoded[0], array.values, sizeof(Uint)*encoded.size());
+
+  table.set_row_size(array.nb_cols/2);
+  table.resize(array.nb_rows);
+  Uint pos = 0;
+  for (Uint row=0; row<table.size(); ++row)
+  {
+    for (Uint col=0; col<table.row_size(); ++col, pos+=2)
+    {
+      const Uint entities_idx = encoded[pos];
+      if (entities_idx != null_entities && entities_idx >= entities.size())
+        throw FileFormatError(FromHere(), "Connectivity "+table.uri().string()+" refers to unknown entities");
+      table[row][col].comp = entities_idx == null_entities ? 0 : entities[entities_idx].get();
+      table[row][col].idx = encoded[pos+1];
+    }
+  }
+}
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_connectivity(detail::BinaryInput& file)
+{
+  const Uint kind = file.read_uint();
+  const Uint entities_idx = file.read_uint();
+  const std::string name = file.read_string();
+  if (entities_idx >= m_entities.size())
+    throw FileFormatError(FromHere(), "Connectivity "+name+" belongs to unknown entities");
+  Entities& entities = *m_entities[entities_idx];
+
+  if (kind == FACE_TO_CELL)
+  {
+    Handle<FaceCellConnectivity> f2c = entities.create_component<FaceCellConnectivity>(name);
+    entities.connectivity_face2cell() = f2c;
+
+    const detail::ArrayView used = file.read_array<Uint>();
+    for (Uint u=0; u<used.nb_rows; ++u)
+    {
+      Uint used_idx;
+      std::memcpy(&used_idx, used.values+u*sizeof(Uint), sizeof(Uint));
+      if (used_idx >= m_entities.size())
+        throw FileFormatError(FromHere(), "Connectivity "+f2c->uri().string()+" uses unknown entities");
+      f2c->add_used(*m_entities[used_idx]);
+    }
+
+    decode_entities(file.read_array<Uint>(), m_entities, null_entities, f2c->connectivity());
+    file.read_table(f2c->face_number());
+
+    const detail::ArrayView is_bdry_face = file.read_array<char>();
+    f2c->is_bdry_face().resize(is_bdry_face.nb_rows);
+    for (Uint face=0; face<is_bdry_face.nb_rows; ++face)
+      f2c->is_bdry_face()[face] = is_bdry_face.values[face];
+  }
+  else if (kind == CELL_TO_FACE || kind == CELL_TO_CELL)
+  {
+    Handle<ElementConnectivity> connectivity = entities.create_component<ElementConnectivity>(name);
+    if (kind == CELL_TO_FACE)
+      entities.connectivity_cell2face() = connectivity;
+    else
+      entities.connectivity_cell2cell() = connectivity;
+    decode_entities(file.read_array<Uint>(), m_entities, null_entities, *connectivity);
+  }
+  else
+  {
+    throw FileFormatError(FromHere(), "Unknown kind of connectivity "+name);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Reader::fill_dictionary(const DictionaryData& data, Mesh& mesh, const Uint dimension)
+{
+  Dictionary& dict = *data.dict;
+
+  if (&dict == &mesh.geometry_fields())
+    mesh.initialize_nodes(data.size, dimension);
+  else
+    dict.resize(data.size);
+
+  if (data.size)
+  {
+    std::memcpy(dict.glb_idx().array().data(), data.glb_idx, sizeof(Uint)*data.size);
+    std::memcpy(dict.rank().array().data(), data.rank, sizeof(Uint)*data.size);
+  }
+
+  boost_foreach(const FieldData& field_data, data.fields)
+  {
+    Handle<Field> field(dict.get_child(field_data.name));
+    if (is_null(field))
+      field = dict.create_field(field_data.name, field_data.description).handle<Field>();
+    add_tags(*field, field_data.tags);
+    if (field->row_size() != field_data.row_size)
+      throw FileFormatError(FromHere(), "Field "+field->uri().string()+" has "+to_str(field->row_size())
+                            +" columns, while the file has "+to_str(field_data.row_size));
+    if (data.size != 0 && field_data.row_size != 0)
+      std::memcpy(field->array().data(), field_data.values, sizeof(Real)*data.size*field_data.row_size);
+  }
+
+  dict.update_structures();
+  dict.rebuild_map_glb_to_loc();
+  dict.rebuild_node_to_element_connectivity();
+  if (is_not_null(dict.get_child(mesh::Tags::coordinates())))
+    dict.coordinates();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
@@ -0,0 +1,102 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Reader_hpp
+#define cf3_mesh_native_Reader_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshReader.hpp"
+
+#include "mesh/native/LibNative.hpp"
+#include "mesh/native/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+namespace native {
+
+namespace detail { class BinaryInput; }
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Reader of the native binary checkpoint format written by native::Writer
+///
+/// Every processor maps the file it wrote into memory and copies the tables
+/// straight into the mesh. The mesh is restored as it was written: partitioned,
+/// with its overlap, global numbering, faces and all fields. The communication
+/// patterns are derived again from the restored global indices and ranks on first use.
+/// @note The mesh must be read on as many processors as it was written on.
+class native_API Reader : public MeshReader, public native::Shared
+{
+public: // functions
+
+  /// constructor
+  Reader( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Reader"; }
+
+  virtual std::string get_format() { return "native"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // types
+
+  /// Field of a dictionary, pointing to its values in the mapped file
+  struct FieldData
+  {
+    std::string name;
+    std::string description;
+    std::string tags;
+    Uint row_size;
+    const char* values;
+  };
+
+  /// Dictionary with its global indices, ranks and fields in the mapped file,
+  /// filled once all spaces of the dictionary are created
+  struct DictionaryData
+  {
+    Handle<Dictionary> dict;
+    Uint size;
+    const char* glb_idx;
+    const char* rank;
+    std::vector<FieldData> fields;
+  };
+
+private: // functions
+
+  virtual void do_read_mesh_into(const common::URI& path, Mesh& mesh);
+
+  void read_dictionary(detail::BinaryInput& file, Mesh& mesh);
+
+  void read_component(detail::BinaryInput& file, Mesh& mesh);
+
+  void read_connectivity(detail::BinaryInput& file);
+
+  void fill_dictionary(const DictionaryData& data, Mesh& mesh, const Uint dimension);
+
+private: // data
+
+  /// Dictionaries in the order they are read
+  std::vector<DictionaryData> m_dictionaries;
+
+  /// Entities in the order they are read
+  std::vector< Handle<Entities> > m_entities;
+
+}; // end Reader
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Reader_hpp
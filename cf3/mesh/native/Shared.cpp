@@ -0,0 +1,87 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "mesh/native/Shared.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const char format_magic[8] = "CF3MESH";
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+const Uint Shared::alignment;
+const Uint Shared::format_version;
+const Uint Shared::byte_order_mark;
+const Uint Shared::null_entities;
+
+////////////////////////////////////////////////////////////////////////////////
+
+Shared::Shared()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Shared::Header Shared::make_header(const Uint nb_procs, const Uint rank)
+{
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, format_magic, sizeof(header.magic));
+  header.version = format_version;
+  header.byte_order = byte_order_mark;
+  header.uint_size = sizeof(Uint);
+  header.real_size = sizeof(Real);
+  header.rank = rank;
+  header.nb_procs = nb_procs;
+  return header;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Shared::check_header(const Header& header, const std::string& file)
+{
+  if (std::memcmp(header.magic, format_magic, sizeof(header.magic)) != 0)
+    throw FileFormatError(FromHere(), file+" is not a native mesh file");
+  if (header.version != format_version)
+    throw FileFormatError(FromHere(), file+" has format version "+to_str<Uint>(header.version)
+                          +", while version "+to_str(format_version)+" is supported");
+  if (header.byte_order != byte_order_mark)
+    throw FileFormatError(FromHere(), file+" was written on a machine with another byte order");
+  if (header.uint_size != sizeof(Uint) || header.real_size != sizeof(Real))
+    throw FileFormatError(FromHere(), file+" was written with "+to_str<Uint>(8*header.uint_size)+"-bit integers and "
+                          +to_str<Uint>(8*header.real_size)+"-bit reals, which differ from this build");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+URI Shared::file_of_rank(const URI& path, const Uint rank)
+{
+  const URI dir = URI(path.path()).base_path();
+  return dir / (path.base_name() + "_P" + to_str(rank) + ".cf3mesh");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
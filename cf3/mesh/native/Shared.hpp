@@ -0,0 +1,112 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Shared_hpp
+#define cf3_mesh_native_Shared_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/cstdint.hpp>
+
+#include "common/URI.hpp"
+
+#include "mesh/native/LibNative.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Layout of the native binary checkpoint format, shared by Writer and Reader
+///
+/// Every processor writes its own part of the mesh to its own file, named
+/// <basename>_P<rank>.cf3mesh. A file contains, in this order:
+/// - the Header
+/// - every Dictionary: name, continuity, glb_idx, rank, and every Field
+///   with its name, variables description, tags and values
+/// - every Region and Entities of the topology, depth first: kind, path and tags.
+///   Entities also store their builder, element type, glb_idx, rank, and for every
+///   Space the dictionary name, shape function and connectivity table
+/// - the face-cell and cell-face connectivities built by BuildFaces,
+///   with every Entity stored as the index of its Entities in the file and its index
+///
+/// Numbers are stored in the native byte order and size, strings as their length
+/// followed by their characters. Arrays store their number of rows and columns,
+/// followed by the raw values, starting at a multiple of alignment bytes, so that
+/// they can be copied straight from a memory mapped file.
+class native_API Shared
+{
+public:
+
+  /// constructor
+  Shared();
+
+  /// Gets the Class name
+  static std::string type_name() { return "Shared"; }
+
+protected: // types
+
+  /// Fixed size header at the start of every file
+  struct Header
+  {
+    char            magic[8];        ///< "CF3MESH", null-terminated
+    boost::uint32_t version;         ///< format_version
+    boost::uint32_t byte_order;      ///< byte_order_mark, as written on the writing machine
+    boost::uint32_t uint_size;       ///< sizeof(Uint)
+    boost::uint32_t real_size;       ///< sizeof(Real)
+    boost::uint32_t rank;            ///< rank of the processor that wrote the file
+    boost::uint32_t nb_procs;        ///< number of processors that wrote files
+    boost::uint32_t dimension;       ///< coordinate dimension of the mesh
+    boost::uint32_t nb_dictionaries; ///< number of dictionaries in the file
+    boost::uint32_t nb_components;   ///< number of regions and entities in the file
+    boost::uint32_t nb_connectivities; ///< number of face-cell and cell-face connectivities
+  };
+
+  /// Kind of a topology record
+  enum ComponentKind { REGION=0, ENTITIES=1 };
+
+  /// Kind of a connectivity record
+  enum ConnectivityKind { FACE_TO_CELL=0, CELL_TO_FACE=1, CELL_TO_CELL=2 };
+
+protected: // functions
+
+  /// @return the header describing this build and processor
+  static Header make_header(const Uint nb_procs, const Uint rank);
+
+  /// @throw FileFormatError if the header was not written by a compatible build
+  static void check_header(const Header& header, const std::string& file);
+
+  /// @return the path of the file of one processor
+  static common::URI file_of_rank(const common::URI& path, const Uint rank);
+
+protected: // data
+
+  /// Arrays start at a multiple of this number of bytes
+  static const Uint alignment = 8;
+
+  /// Version of the format, increased with every incompatible change
+  static const Uint format_version = 1;
+
+  /// Written as a 4-byte integer, to detect files from machines with another byte order
+  static const Uint byte_order_mark = 0x01020304;
+
+  /// Stored instead of an Entities index for an Entity without component
+  static const Uint null_entities = 0xffffffff;
+
+}; // end Shared
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Shared_hpp
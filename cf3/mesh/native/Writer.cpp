@@ -0,0 +1,346 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <fstream>
+
+#include <boost/algorithm/string/join.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/native/Writer.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace native {
+
+using namespace common;
+
+namespace detail {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Output file of numbers, strings and aligned raw arrays
+class BinaryOutput
+{
+public:
+
+  BinaryOutput(const std::string& path, const Uint alignment) :
+    m_file(path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc),
+    m_position(0),
+    m_alignment(alignment)
+  {
+    if (!m_file)
+      throw FileSystemError(FromHere(), "Could not open file "+path+" for writing");
+  }
+
+  void write_bytes(const void* data, const std::size_t nb_bytes)
+  {
+    m_file.write(static_cast<const char*>(data), nb_bytes);
+    m_position += nb_bytes;
+  }
+
+  void write_uint(const Uint value)
+  {
+    write_bytes(&value, sizeof(Uint));
+  }
+
+  void write_string(const std::string& str)
+  {
+    write_uint(str.size());
+    write_bytes(str.data(), str.size());
+  }
+
+  /// Write the number of rows and columns, followed by the aligned values
+  template <typename ValueT>
+  void write_array(const ValueT* data, const Uint nb_rows, const Uint nb_cols)
+  {
+    write_uint(nb_rows);
+    write_uint(nb_cols);
+    const std::size_t misalignment = m_position % m_alignment;
+    if (misalignment)
+    {
+      const std::vector<char> padding(m_alignment-misalignment, 0);
+      write_bytes(&padding[0], padding.size());
+    }
+    if (nb_rows != 0 && nb_cols != 0)
+      write_bytes(data, sizeof(ValueT)*nb_rows*nb_cols);
+  }
+
+  template <typename ValueT>
+  void write_list(const List<ValueT>& list)
+  {
+    write_array(list.array().data(), list.size(), 1u);
+  }
+
+  template <typename ValueT>
+  void write_table(const Table<ValueT>& table)
+  {
+    write_array(table.array().data(), table.size(), table.row_size());
+  }
+
+  /// Overwrite bytes at the start of the file, without moving the end
+  void overwrite_start(const void* data, const std::size_t nb_bytes)
+  {
+    m_file.seekp(0);
+    m_file.write(static_cast<const char*>(data), nb_bytes);
+    m_file.seekp(0, std::ios_base::end);
+  }
+
+  void close()
+  {
+    m_file.close();
+    if (m_file.fail())
+      throw FileSystemError(FromHere(), "Could not write native mesh file");
+  }
+
+private:
+
+  std::ofstream m_file;
+  std::size_t m_position;
+  const Uint m_alignment;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < native::Writer, MeshWriter, LibNative> aNativeWriter_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer( const std::string& name )
+: MeshWriter(name),
+  Shared(),
+  m_nb_components(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Writer::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write()
+{
+  const Mesh& mesh = *m_mesh;
+  const Uint rank = PE::Comm::instance().rank();
+  const URI file_path = file_of_rank(m_file_path, rank);
+
+  CFinfo << "writing native mesh file " << file_path.path() << CFendl;
+
+  Header header = make_header(PE::Comm::instance().size(), rank);
+  header.dimension = mesh.dimension();
+
+  detail::BinaryOutput file(file_path.path(), alignment);
+  file.write_bytes(&header, sizeof(Header));
+
+  // Geometry first, as the other dictionaries are defined on the entities that use it
+  std::vector<const Dictionary*> dictionaries(1, &mesh.geometry_fields());
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+  {
+    if (dict.get() != &mesh.geometry_fields())
+      dictionaries.push_back(dict.get());
+  }
+  header.nb_dictionaries = dictionaries.size();
+  boost_foreach(const Dictionary* dict, dictionaries)
+    write_dictionary(file, *dict);
+
+  m_entities.clear();
+  m_entities_idx.clear();
+  m_nb_components = 0;
+  write_region(file, mesh.topology(), std::string());
+  header.nb_components = m_nb_components;
+
+  header.nb_connectivities = write_connectivities(file);
+
+  file.overwrite_start(&header, sizeof(Header));
+  file.close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_dictionary(detail::BinaryOutput& file, const Dictionary& dict)
+{
+  file.write_string(dict.name());
+  file.write_uint(dict.continuous());
+  file.write_list(dict.glb_idx());
+  file.write_list(dict.rank());
+
+  file.write_uint(dict.fields().size());
+  boost_foreach(const Handle<Field>& field, dict.fields())
+  {
+    file.write_string(field->name());
+    file.write_string(field->descriptor().description());
+    file.write_string(boost::algorithm::join(field->get_tags(), " "));
+    file.write_table(*field);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_region(detail::BinaryOutput& file, const Region& region, const std::string& path)
+{
+  // The topology itself always exists, and is not written
+  if (!path.empty())
+  {
+    file.write_uint(REGION);
+    file.write_string(path);
+    file.write_string(boost::algorithm::join(region.get_tags(), " "));
+    ++m_nb_components;
+  }
+
+  boost_foreach(const Component& child, find_components(region))
+  {
+    const std::string child_path = path.empty() ? child.name() : path+"/"+child.name();
+    if (Handle<Region const> child_region = child.handle<Region>())
+      write_region(file, *child_region, child_path);
+    else if (Handle<Entities const> child_entities = child.handle<Entities>())
+      write_entities(file, *child_entities, child_path);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_entities(detail::BinaryOutput& file, const Entities& entities, const std::string& path)
+{
+  m_entities_idx[&entities] = m_entities.size();
+  m_entities.push_back(&entities);
+  ++m_nb_components;
+
+  file.write_uint(ENTITIES);
+  file.write_string(path);
+  file.write_string(boost::algorithm::join(entities.get_tags(), " "));
+  file.write_string(entities.derived_type_name());
+  file.write_string(entities.element_type().derived_type_name());
+  file.write_list(entities.glb_idx());
+  file.write_list(entities.rank());
+
+  // The geometry space is created with the entities, and written first
+  std::vector< Handle<Space> > spaces(1, entities.geometry_space().handle<Space>());
+  boost_foreach(const Handle<Space>& space, entities.spaces())
+  {
+    if (space != spaces.front())
+      spaces.push_back(space);
+  }
+  file.write_uint(spaces.size());
+  boost_foreach(const Handle<Space>& space, spaces)
+  {
+    file.write_string(space->dict().name());
+    file.write_string(space->shape_function().derived_type_name());
+    file.write_table(space->connectivity());
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Table of Entity, with every Entity as the index of its Entities in the file and its index
+std::vector<Uint> encode_entities(const ElementConnectivity& table, const std::map<const Entities*,Uint>& entities_idx, const Uint null_entities)
+{
+  std::vector<Uint> encoded;
+  encoded.reserve(2*table.size()*table.row_size());
+  for (Uint row=0; row<table.size(); ++row)
+  {
+    for (Uint col=0; col<table.row_size(); ++col)
+    {
+      const Entity& entity = table[row][col];
+      std::map<const Entities*,Uint>::const_iterator found = entities_idx.find(entity.comp);
+      encoded.push_back(found == entities_idx.end() ? null_entities : found->second);
+      encoded.push_back(entity.idx);
+    }
+  }
+  return encoded;
+}
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+Uint Writer::write_connectivities(detail::BinaryOutput& file)
+{
+  Uint nb_connectivities = 0;
+  for (Uint idx=0; idx<m_entities.size(); ++idx)
+  {
+    const Entities& entities = *m_entities[idx];
+
+    if (Handle<FaceCellConnectivity const> f2c = entities.connectivity_face2cell())
+    {
+      file.write_uint(FACE_TO_CELL);
+      file.write_uint(idx);
+      file.write_string(f2c->name());
+
+      std::vector<Uint> used;
+      boost_foreach(const Handle<Component>& used_comp, const_cast<FaceCellConnectivity&>(*f2c).used())
+      {
+        std::map<const Entities*,Uint>::const_iterator found = m_entities_idx.find(dynamic_cast<const Entities*>(used_comp.get()));
+        if (found != m_entities_idx.end())
+          used.push_back(found->second);
+      }
+      file.write_array(used.empty() ? 0 : &used[0], used.size(), 1u);
+
+      const std::vector<Uint> cells = encode_entities(f2c->connectivity(), m_entities_idx, null_entities);
+      file.write_array(cells.empty() ? 0 : &cells[0], f2c->connectivity().size(), 2*f2c->connectivity().row_size());
+      file.write_table(f2c->face_number());
+
+      std::vector<char> is_bdry_face(f2c->is_bdry_face().size());
+      for (Uint face=0; face<is_bdry_face.size(); ++face)
+        is_bdry_face[face] = f2c->is_bdry_face()[face];
+      file.write_array(is_bdry_face.empty() ? 0 : &is_bdry_face[0], is_bdry_face.size(), 1u);
+      ++nb_connectivities;
+    }
+
+    const Handle<ElementConnectivity const> element_connectivities[] = { entities.connectivity_cell2face(), entities.connectivity_cell2cell() };
+    const ConnectivityKind kinds[] = { CELL_TO_FACE, CELL_TO_CELL };
+    for (Uint k=0; k<2; ++k)
+    {
+      const Handle<ElementConnectivity const>& connectivity = element_connectivities[k];
+      if (is_null(connectivity))
+        continue;
+      file.write_uint(kinds[k]);
+      file.write_uint(idx);
+      file.write_string(connectivity->name());
+      const std::vector<Uint> elements = encode_entities(*connectivity, m_entities_idx, null_entities);
+      file.write_array(elements.empty() ? 0 : &elements[0], connectivity->size(), 2*connectivity->row_size());
+      ++nb_connectivities;
+    }
+  }
+  return nb_connectivities;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
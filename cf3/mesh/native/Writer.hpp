@@ -0,0 +1,87 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_native_Writer_hpp
+#define cf3_mesh_native_Writer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/native/LibNative.hpp"
+#include "mesh/native/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+  class Region;
+namespace native {
+
+namespace detail { class BinaryOutput; }
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Writer of the native binary checkpoint format
+///
+/// Every processor writes its part of the mesh, as it is in memory, to its own file:
+/// all dictionaries with all their fields, the complete topology with global numbering
+/// and ranks, and the face connectivities. Reading it back with native::Reader on the
+/// same number of processors restores the partitioned mesh without any partitioning,
+/// face building or global numbering.
+/// @note The "fields" and "regions" options are ignored, as a checkpoint always
+///       contains the complete mesh and all fields.
+class native_API Writer : public MeshWriter, public native::Shared
+{
+public: // functions
+
+  /// constructor
+  Writer( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Writer"; }
+
+  virtual std::string get_format() { return "native"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void write();
+
+  void write_dictionary(detail::BinaryOutput& file, const Dictionary& dict);
+
+  void write_region(detail::BinaryOutput& file, const Region& region, const std::string& path);
+
+  void write_entities(detail::BinaryOutput& file, const Entities& entities, const std::string& path);
+
+  /// @return the number of connectivities written
+  Uint write_connectivities(detail::BinaryOutput& file);
+
+private: // data
+
+  /// Index of every written Entities in the file
+  std::map<const Entities*,Uint> m_entities_idx;
+
+  /// Entities in the order they are written
+  std::vector<const Entities*> m_entities;
+
+  Uint m_nb_components;
+
+}; // end Writer
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // native
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_native_Writer_hpp
@@ -4,6 +4,7 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
 #include <set>
 
 #include "common/Log.hpp"
@@ -18,6 +19,8 @@
 #include "common/DynTable.hpp"
 #include "common/List.hpp"
 #include "common/PropertyList.hpp"
+#include "common/MappedFile.hpp"
+#include "common/TextScanner.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -46,6 +49,11 @@ cf3::common::ComponentBuilder < neu::Reader, MeshReader, LibNeu > aneuReader_Bui
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Number of nodes on each line of an element record, continued on the next lines
+static const Uint nb_nodes_per_line = 7;
+
+//////////////////////////////////////////////////////////////////////////////
+
 Reader::Reader( const std::string& name )
 : MeshReader(name),
   Shared()
@@ -90,12 +98,12 @@ std::vector<std::string> Reader::get_extensions()
 void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 {
 
-  // if the file is present open it
+  // if the file is present map it into memory
   boost::filesystem::path fp (file.path());
   if( boost::filesystem::exists(fp) )
   {
     CFinfo << "Opening file " <<  fp.string() << CFendl;
-    m_file.open(fp,std::ios_base::in); // exists so open it
+    m_file.reset(new MappedFile(fp.string())); // exists so map it
   }
   else // doesnt exist so throw exception
   {
@@ -128,7 +136,7 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   //else
   //  m_region = m_mesh->create_region(m_headerData.mesh_name,!option("Serial Handle<Region>(Merge").value<bool>()).handle<Component>());
 
-  find_ghost_nodes();
+  read_elements();
   read_coordinates();
   read_connectivity();
   if (options().value<bool>("read_boundaries"))
@@ -154,8 +162,8 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   }
 
 
-  // close the file
-  m_file.close();
+  // unmap the file
+  m_file.reset();
 
   cf3_assert(m_mesh->geometry_fields().coordinates().row_size() == m_headerData.NDFCD);
   cf3_assert(m_mesh->properties().value<Uint>(common::Tags::dimension()) == m_headerData.NDFCD);
@@ -169,6 +177,22 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
 
 //////////////////////////////////////////////////////////////////////////////
 
+TextScanner Reader::scanner_at(const std::size_t offset) const
+{
+  return TextScanner(m_file->begin()+offset, m_file->end());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint Reader::coord_idx(const Uint neu_node) const
+{
+  const std::vector<Uint>::const_iterator it = std::lower_bound(m_coord_nodes.begin(),m_coord_nodes.end(),neu_node);
+  cf3_assert(it != m_coord_nodes.end() && *it == neu_node);
+  return it - m_coord_nodes.begin();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Reader::get_file_positions()
 {
   std::string nodal_coordinates("NODAL COORDINATES");
@@ -179,12 +203,19 @@ void Reader::get_file_positions()
   m_element_group_positions.resize(0);
   m_boundary_condition_positions.resize(0);
 
-  int p;
-  std::string line;
-  while (!m_file.eof())
+  TextScanner scanner(m_file->begin(), m_file->end());
+  while (!scanner.at_end())
   {
-    p = m_file.tellg();
-    getline(m_file,line);
+    const char* line_begin = scanner.position();
+    scanner.skip_line();
+
+    // Only section headers and names start with a letter, the numeric records are skipped
+    const char first = *line_begin;
+    if (!((first >= 'A' && first <= 'Z') || (first >= 'a' && first <= 'z')))
+      continue;
+
+    const std::size_t p = line_begin - m_file->begin();
+    const std::string line(line_begin, scanner.position());
     if (line.find(nodal_coordinates)!=std::string::npos)
       m_nodal_coordinates_position=p;
     else if (line.find(elements_cells)!=std::string::npos)
@@ -194,89 +225,83 @@ void Reader::get_file_positions()
     else if (line.find(boundary_condition)!=std::string::npos)
       m_boundary_condition_positions.push_back(p);
   }
-  m_file.clear();
-
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void Reader::read_headerData()
 {
-  m_file.seekg(0,std::ios::beg);
-
-  Uint NUMNP, NELEM, NGRPS, NBSETS, NDFCD, NDFVL;
-  std::string line;
+  TextScanner scanner = scanner_at(0);
 
   // skip 2 lines
-  for (Uint i=0; i<2; ++i)
-    getline(m_file,line);
+  scanner.skip_lines(2);
 
-  m_file >> m_headerData.mesh_name;   getline(m_file,line);
+  m_headerData.mesh_name = scanner.next_token();
+  scanner.skip_line();
 
   // skip 3 lines
-  for (Uint i=0; i<3; ++i)
-    getline(m_file,line);
+  scanner.skip_lines(3);
 
   // read number of points, elements, groups, sets, dimensions, velocitycomponents
-  getline(m_file,line);
-  std::stringstream ss(line);
-  ss >> NUMNP >> NELEM >> NGRPS >> NBSETS >> NDFCD >> NDFVL;
-
-  m_headerData.NUMNP  = NUMNP;
-  m_headerData.NELEM  = NELEM;
-  m_headerData.NGRPS  = NGRPS;
-  m_headerData.NBSETS = NBSETS;
-  m_headerData.NDFCD  = NDFCD;
-  m_headerData.NDFVL  = NDFVL;
-
-  getline(m_file,line);
+  m_headerData.NUMNP  = scanner.next_uint();
+  m_headerData.NELEM  = scanner.next_uint();
+  m_headerData.NGRPS  = scanner.next_uint();
+  m_headerData.NBSETS = scanner.next_uint();
+  m_headerData.NDFCD  = scanner.next_uint();
+  m_headerData.NDFVL  = scanner.next_uint();
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::find_ghost_nodes()
+void Reader::read_elements()
 {
   m_ghost_nodes.clear();
+  m_elements.number.clear();
+  m_elements.type.clear();
+  m_elements.nodes_begin.assign(1,0);
+  m_elements.nodes.clear();
 
-  // Only find ghost nodes if the domain is split up
-  if (options().value<Uint>("nb_parts") > 1)
-  {
-    m_file.seekg(m_elements_cells_position,std::ios::beg);
-    // skip next line
-    std::string line;
-    getline(m_file,line);
+  const ParallelDistribution& elems_hash = m_hash->subhash(ELEMS);
+  const ParallelDistribution& nodes_hash = m_hash->subhash(NODES);
+  const bool find_ghosts = options().value<Uint>("nb_parts") > 1;
 
+  TextScanner scanner = scanner_at(m_elements_cells_position);
+  // skip the section header
+  scanner.skip_line();
 
-    // read every line and store the connectivity in the correct region through the buffer
-    Uint elementNumber, elementType, nbElementNodes;
-    for (Uint i=0; i<m_headerData.NELEM; ++i)
+  for (Uint i=0; i<m_headerData.NELEM; ++i)
+  {
+    if (m_headerData.NELEM > 100000)
     {
-      if (m_headerData.NELEM > 100000)
-      {
-        if(i%(m_headerData.NELEM/20)==0)
-          CFinfo << 100*i/m_headerData.NELEM << "% " << CFendl;
-      }
+      if(i%(m_headerData.NELEM/20)==0)
+        CFinfo << 100*i/m_headerData.NELEM << "% " << CFendl;
+    }
 
-      if (m_hash->subhash(ELEMS).owns(i))
-      {
-        // element description
-        m_file >> elementNumber >> elementType >> nbElementNodes;
+    // element description
+    const Uint elementNumber  = scanner.next_uint();
+    const Uint elementType    = scanner.next_uint();
+    const Uint nbElementNodes = scanner.next_uint();
 
-        // check if element nodes are ghost
-        std::vector<Uint> neu_element_nodes(nbElementNodes);
-        for (Uint j=0; j<nbElementNodes; ++j)
-        {
-          m_file >> neu_element_nodes[j];
-          if (!m_hash->subhash(NODES).owns(neu_element_nodes[j]-1))
-          {
-            m_ghost_nodes.insert(neu_element_nodes[j]);
-          }
-        }
+    if (elems_hash.owns(i))
+    {
+      m_elements.number.push_back(elementNumber);
+      m_elements.type.push_back(elementType);
+      for (Uint j=0; j<nbElementNodes; ++j)
+      {
+        const Uint neu_node = scanner.next_uint();
+        m_elements.nodes.push_back(neu_node);
+        if (find_ghosts && !nodes_hash.owns(neu_node-1))
+          m_ghost_nodes.insert(neu_node);
       }
+      m_elements.nodes_begin.push_back(m_elements.nodes.size());
       // finish the line
-      getline(m_file,line);
+      scanner.skip_line();
+    }
+    else
+    {
+      // records of other parts are not parsed, only their lines are counted
+      scanner.skip_lines((nbElementNodes+nb_nodes_per_line-1)/nb_nodes_per_line);
     }
-    getline(m_file,line);  // ENDOFSECTION
   }
 }
 
@@ -284,23 +309,23 @@ void Reader::find_ghost_nodes()
 
 void Reader::read_coordinates()
 {
-  m_file.seekg(m_nodal_coordinates_position,std::ios::beg);
-
   // Create the nodes
 
   Dictionary& nodes = m_mesh->geometry_fields();
+  const ParallelDistribution& nodes_hash = m_hash->subhash(NODES);
 
-  nodes.resize(m_hash->subhash(NODES).nb_objects_in_part(PE::Comm::instance().rank()) + m_ghost_nodes.size());
-  std::string line;
-  // skip one line
-  getline(m_file,line);
+  const Uint nb_nodes = nodes_hash.nb_objects_in_part(PE::Comm::instance().rank()) + m_ghost_nodes.size();
+  nodes.resize(nb_nodes);
+  m_coord_nodes.resize(nb_nodes);
 
-  // declare and allocate one coordinate row
-  std::vector<Real> rowVector(m_headerData.NDFCD);
+  TextScanner scanner = scanner_at(m_nodal_coordinates_position);
+  // skip the section header
+  scanner.skip_line();
 
-  std::set<Uint>::const_iterator not_found = m_ghost_nodes.end();
+  std::set<Uint>::const_iterator next_ghost = m_ghost_nodes.begin();
 
   Uint coord_idx=0;
+  Uint nb_skipped_lines=0;
   for (Uint node_idx=1; node_idx<=m_headerData.NUMNP; ++node_idx)
   {
     if (m_headerData.NUMNP > 100000)
@@ -308,37 +333,36 @@ void Reader::read_coordinates()
       if(node_idx%(m_headerData.NUMNP/20)==0)
         CFinfo << 100*node_idx/m_headerData.NUMNP << "% " << CFendl;
     }
-    getline(m_file,line);
-    if (m_hash->subhash(NODES).owns(node_idx-1))
+
+    bool read_node = nodes_hash.owns(node_idx-1);
+    if (next_ghost != m_ghost_nodes.end() && *next_ghost == node_idx)
     {
-      nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(node_idx-1);
-      nodes.glb_idx()[coord_idx] = node_idx;
-      m_node_to_coord_idx[node_idx]=coord_idx;
-      std::stringstream ss(line);
-      Uint nodeNumber;
-      ss >> nodeNumber;
-      for (Uint dim=0; dim<m_headerData.NDFCD; ++dim)
-        ss >> nodes.coordinates()[coord_idx][dim];
-      coord_idx++;
+      read_node = true;
+      ++next_ghost;
     }
-    else
+
+    if (!read_node)
     {
-      if (m_ghost_nodes.find(node_idx) != not_found)
-      {
-        // add global node index
-        nodes.rank()[coord_idx] = m_hash->subhash(NODES).part_of_obj(node_idx-1);
-        nodes.glb_idx()[coord_idx] = node_idx;
-        m_node_to_coord_idx[node_idx]=coord_idx;
-        std::stringstream ss(line);
-        Uint nodeNumber;
-        ss >> nodeNumber;
-        for (Uint dim=0; dim<m_headerData.NDFCD; ++dim)
-          ss >> nodes.coordinates()[coord_idx][dim];
-        coord_idx++;
-      }
+      ++nb_skipped_lines;
+      continue;
     }
+
+    // lines of nodes that are neither owned nor ghost are only counted
+    scanner.skip_lines(nb_skipped_lines);
+    nb_skipped_lines = 0;
+
+    // add global node index
+    nodes.rank()[coord_idx] = nodes_hash.part_of_obj(node_idx-1);
+    nodes.glb_idx()[coord_idx] = node_idx;
+    m_coord_nodes[coord_idx] = node_idx;
+    scanner.skip_token(); // node number
+    Field::Row coords = nodes.coordinates()[coord_idx];
+    for (Uint dim=0; dim<m_headerData.NDFCD; ++dim)
+      coords[dim] = scanner.next_real();
+    scanner.skip_line();
+    coord_idx++;
   }
-  getline(m_file,line);
+  cf3_assert(coord_idx == nb_nodes);
 }
 
 
@@ -350,66 +374,42 @@ void Reader::read_connectivity()
   m_tmp = Handle<Region>(m_region->create_region("main").handle<Component>());
 
   m_global_to_tmp.clear();
-  m_file.seekg(m_elements_cells_position,std::ios::beg);
 
   std::map<std::string,Handle< Elements > > elements = create_cells_in_region(*m_tmp,nodes,m_supported_types);
-  std::map<std::string,boost::shared_ptr< Connectivity::Buffer > > buffer = create_connectivity_buffermap(elements);
-
-  // skip next line
-  std::string line;
-  getline(m_file,line);
 
-  // read every line and store the connectivity in the correct region through the buffer
-  std::string etype_CF;
-  std::vector<Uint> cf_element;
-  Uint neu_node_number;
-  Uint cf_node_number;
-  Uint cf_idx;
-  Uint table_idx;
-
-  for (Uint i=0; i<m_headerData.NELEM; ++i)
+  // count the elements of each type, to allocate the connectivity tables at once
+  const Uint nb_records = m_elements.number.size();
+  std::vector<std::string> etype_CF(nb_records);
+  std::map<std::string,Uint> nb_elems;
+  for (Uint r=0; r<nb_records; ++r)
   {
-    if (m_headerData.NELEM > 100000)
-    {
-      if(i%(m_headerData.NELEM/20)==0)
-        CFinfo << 100*i/m_headerData.NELEM << "% " << CFendl;
-    }
-
-    // element description
-    Uint elementNumber, elementType, nbElementNodes;
-    m_file >> elementNumber >> elementType >> nbElementNodes;
+    etype_CF[r] = element_type(m_elements.type[r],m_elements.nodes_begin[r+1]-m_elements.nodes_begin[r]);
+    ++nb_elems[etype_CF[r]];
+  }
+  for (std::map<std::string,Uint>::iterator it=nb_elems.begin(); it!=nb_elems.end(); ++it)
+  {
+    elements[it->first]->resize(it->second);
+    it->second = 0; // from now on the number of filled rows
+  }
 
-    // get element nodes
-    if (m_hash->subhash(ELEMS).owns(i))
-    {
-      cf_element.resize(nbElementNodes);
-      for (Uint j=0; j<nbElementNodes; ++j)
-      {
-        cf_idx = m_nodes_neu_to_cf[elementType][j];
-        m_file >> neu_node_number;
-        cf3_assert(m_node_to_coord_idx.count(neu_node_number));
-        cf_node_number = m_node_to_coord_idx[neu_node_number];
-        cf3_assert(cf_node_number < nodes.size());
-        cf_element[cf_idx] = cf_node_number;
-      }
-      etype_CF = element_type(elementType,nbElementNodes);
-      table_idx = buffer[etype_CF]->add_row(cf_element);
-      m_global_to_tmp[elementNumber] = std::make_pair(elements[etype_CF],table_idx);
-    }
-    else
+  // store the connectivity of every owned element in its table
+  for (Uint r=0; r<nb_records; ++r)
+  {
+    const Uint elementType = m_elements.type[r];
+    Elements& etype_elements = *elements[etype_CF[r]];
+    const Uint table_idx = nb_elems[etype_CF[r]]++;
+    Connectivity::Row cf_element = etype_elements.geometry_space().connectivity()[table_idx];
+    for (Uint j=0; j<m_elements.nodes_begin[r+1]-m_elements.nodes_begin[r]; ++j)
     {
-      for (Uint j=0; j<nbElementNodes; ++j)
-      {
-        m_file >> neu_node_number;
-      }
+      const Uint cf_node_number = coord_idx(m_elements.nodes[m_elements.nodes_begin[r]+j]);
+      cf3_assert(cf_node_number < nodes.size());
+      cf_element[m_nodes_neu_to_cf[elementType][j]] = cf_node_number;
     }
-
-    // finish the line
-    getline(m_file,line);
+    m_global_to_tmp[m_elements.number[r]] = std::make_pair(elements[etype_CF[r]],table_idx);
   }
-  getline(m_file,line);  // ENDOFSECTION
 
-  m_node_to_coord_idx.clear();
+  m_elements = ElementRecords();
+  m_coord_nodes.clear();
 
 }
 
@@ -421,28 +421,21 @@ void Reader::read_groups()
   cf3_assert(m_element_group_positions.size() == m_headerData.NGRPS)
 
   std::vector<GroupData> groups(m_headerData.NGRPS);
-  std::string line;
-  int dummy;
-
-  std::set<Uint>::const_iterator it;
 
   for (Uint g=0; g<m_headerData.NGRPS; ++g)
   {
-    m_file.seekg(m_element_group_positions[g],std::ios::beg);
-
-    std::string ELMMAT;
-    Uint NGP, NELGP, MTYP, NFLAGS, I;
-    getline(m_file,line);  // ELEMENT GROUP...
-    m_file >> line >> NGP >> line >> NELGP >> line >> MTYP >> line >> NFLAGS >> ELMMAT;
-    groups[g].NGP    = NGP;
-    groups[g].NELGP  = NELGP;
-    groups[g].MTYP   = MTYP;
-    groups[g].NFLAGS = NFLAGS;
-    groups[g].ELMMAT = ELMMAT;
+    TextScanner scanner = scanner_at(m_element_group_positions[g]);
+    scanner.skip_line();  // ELEMENT GROUP...
+
+    scanner.skip_token();  groups[g].NGP    = scanner.next_uint();
+    scanner.skip_token();  groups[g].NELGP  = scanner.next_uint();
+    scanner.skip_token();  groups[g].MTYP   = scanner.next_uint();
+    scanner.skip_token();  groups[g].NFLAGS = scanner.next_uint();
+    groups[g].ELMMAT = scanner.next_token();
     //groups[g].print();
 
-    for (Uint i=0; i<NFLAGS; ++i)
-      m_file >> dummy;
+    for (Uint i=0; i<groups[g].NFLAGS; ++i)
+      scanner.skip_token();
 
 
     // 2 cases:
@@ -458,28 +451,12 @@ void Reader::read_groups()
     // 2) there are multiple groups --> New regions have to be created
     //    and the elements from the tmp region have to be distributed among
     //    these new regions.
-
-    // Read first to see howmany elements to allocate
-    int p = m_file.tellg();
-    Uint nb_elems_in_group = 0;
-    for (Uint i=0; i<NELGP; ++i)
+    for (Uint i=0; i<groups[g].NELGP; ++i)
     {
-      m_file >> I;
-      if (m_hash->subhash(ELEMS).owns(I-1))
-        nb_elems_in_group++;
-    }
-    // now allocate and read again
-    groups[g].ELEM.reserve(nb_elems_in_group);
-    m_file.seekg(p,std::ios::beg);
-    for (Uint i=0; i<NELGP; ++i)
-    {
-      m_file >> I;
+      const Uint I = scanner.next_uint();
       if (m_hash->subhash(ELEMS).owns(I-1))
         groups[g].ELEM.push_back(I);     // set element index
     }
-
-    getline(m_file,line);  // finish the line (read new line)
-    getline(m_file,line);  // ENDOFSECTION
   }
 
   // Create Region for each group
@@ -491,7 +468,16 @@ void Reader::read_groups()
     //CFinfo << "region " << region.uri().string() << " created" << CFendl;
     // Create regions for each element type in each group-region
     std::map<std::string,Handle< Elements > > elements = create_cells_in_region(region,nodes,m_supported_types);
-    std::map<std::string,boost::shared_ptr< Connectivity::Buffer > > buffer = create_connectivity_buffermap(elements);
+
+    // Allocate the connectivity tables of the group at once
+    std::map<std::string,Uint> nb_elems;
+    boost_foreach(Uint global_element, group.ELEM)
+      ++nb_elems[m_global_to_tmp[global_element].first->element_type().derived_type_name()];
+    for (std::map<std::string,Uint>::iterator it=nb_elems.begin(); it!=nb_elems.end(); ++it)
+    {
+      elements[it->first]->resize(it->second);
+      it->second = 0; // from now on the number of filled rows
+    }
 
     // Copy elements from tmp_region in the correct region
     boost_foreach(Uint global_element, group.ELEM)
@@ -500,9 +486,9 @@ void Reader::read_groups()
       Uint local_element = m_global_to_tmp[global_element].second;
       std::string etype = tmp_elems->element_type().derived_type_name();
 
-      Uint idx = buffer[etype]->add_row(tmp_elems->geometry_space().connectivity().array()[local_element]);
-      std::string new_elems_name = tmp_elems->name();
-      m_global_to_tmp[global_element] = std::make_pair(Handle<Elements>(region.get_child(new_elems_name)),idx);
+      Uint idx = nb_elems[etype]++;
+      elements[etype]->geometry_space().connectivity().set_row(idx,tmp_elems->geometry_space().connectivity()[local_element]);
+      m_global_to_tmp[global_element] = std::make_pair(elements[etype],idx);
     }
   }
 
@@ -517,19 +503,18 @@ void Reader::read_boundaries()
 {
   cf3_assert_desc(to_str(m_boundary_condition_positions.size())+"=="+to_str(m_headerData.NBSETS),m_boundary_condition_positions.size() == m_headerData.NBSETS);
 
-  std::string line;
   for (Uint t=0; t<m_headerData.NBSETS; ++t) {
 
-    m_file.seekg(m_boundary_condition_positions[t],std::ios::beg);
-
-    std::string NAME;
-    int ITYPE, NENTRY, NVALUES, IBCODE1, IBCODE2, IBCODE3, IBCODE4, IBCODE5;
+    TextScanner scanner = scanner_at(m_boundary_condition_positions[t]);
 
     // read header
-    getline(m_file,line);  // BOUNDARY CONDITIONS...
-    getline(m_file,line);  // header
-    std::stringstream ss(line);
-    ss >> NAME >> ITYPE >> NENTRY >> NVALUES >> IBCODE1 >> IBCODE2 >> IBCODE3 >> IBCODE4 >> IBCODE5;
+    scanner.skip_line();  // BOUNDARY CONDITIONS...
+    const std::string NAME = scanner.next_token();
+    const Uint ITYPE   = scanner.next_uint();
+    const Uint NENTRY  = scanner.next_uint();
+    scanner.skip_token(); // NVALUES
+    const Uint IBCODE1 = scanner.next_uint();
+    scanner.skip_line();  // optional boundary condition codes
     if (ITYPE!=1) {
       throw common::NotSupported(FromHere(),"error: supports only boundary condition data 1 (element/cell): page C-11 of user's guide");
     }
@@ -545,10 +530,12 @@ void Reader::read_boundaries()
     std::map<std::string,boost::shared_ptr< Connectivity::Buffer > > buffer = create_connectivity_buffermap (elements);
 
     // read boundary elements connectivity
-    for (int i=0; i<NENTRY; ++i)
+    for (Uint i=0; i<NENTRY; ++i)
     {
-      int ELEM, ETYPE, FACE;
-      m_file >> ELEM >> ETYPE >> FACE;
+      const Uint ELEM  = scanner.next_uint();
+      const Uint ETYPE = scanner.next_uint();
+      const Uint FACE  = scanner.next_uint();
+      scanner.skip_line();  // values of the record
 
       Uint global_element = ELEM;
 
@@ -579,9 +566,7 @@ void Reader::read_boundaries()
         cf3_assert_desc(to_str(row.size())+"!="+to_str(buffer[face_type]->get_appointed().shape()[1]),row.size() == buffer[face_type]->get_appointed().shape()[1]);
         buffer[face_type]->add_row(row);
       }
-      getline(m_file,line);  // finish the line (read new line)
     }
-    getline(m_file,line);  // ENDOFSECTION
 
   }
 }
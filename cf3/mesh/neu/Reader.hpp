@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/scoped_ptr.hpp>
+
 #include "mesh/MeshReader.hpp"
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
@@ -19,6 +21,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace cf3 {
+namespace common { class MappedFile; class TextScanner; }
 namespace mesh {
   class Elements;
   class Region;
@@ -52,7 +55,7 @@ private: // functions
 
   void read_headerData();
 
-  void find_ghost_nodes();
+  void read_elements();
 
   void read_coordinates();
 
@@ -66,6 +69,12 @@ private: // functions
 
   std::string element_type(const Uint neu_type, const Uint nb_nodes);
 
+  /// @return a scanner of the file, starting at the given offset
+  common::TextScanner scanner_at(const std::size_t offset) const;
+
+  /// @return the row in the coordinates table of a node, given its number in the file
+  Uint coord_idx(const Uint neu_node) const;
+
 private: // data
 
   virtual void do_read_mesh_into(const common::URI& fp, Mesh& mesh);
@@ -76,18 +85,30 @@ private: // data
   // map< global index , pair< temporary table, index in temporary table > >
   std::map<Uint,Region_TableIndex_pair> m_global_to_tmp;
 
-  boost::filesystem::fstream m_file;
+  boost::scoped_ptr<common::MappedFile> m_file;
   Handle<Mesh> m_mesh;
   Handle<Region> m_region;
   Handle< Region > m_tmp;
 
   std::set<Uint> m_ghost_nodes;
-  std::map<Uint,Uint> m_node_to_coord_idx;
 
-  Uint m_nodal_coordinates_position;
-  Uint m_elements_cells_position;
-  std::vector<Uint> m_element_group_positions;
-  std::vector<Uint> m_boundary_condition_positions;
+  /// Sorted numbers of the nodes stored in the coordinates table
+  std::vector<Uint> m_coord_nodes;
+
+  /// Offsets in the file of the section headers
+  std::size_t m_nodal_coordinates_position;
+  std::size_t m_elements_cells_position;
+  std::vector<std::size_t> m_element_group_positions;
+  std::vector<std::size_t> m_boundary_condition_positions;
+
+  /// Element records owned by this part, in file order
+  struct ElementRecords
+  {
+    std::vector<Uint> number;       // element number in the file
+    std::vector<Uint> type;         // neu element type
+    std::vector<Uint> nodes_begin;  // offset of the nodes of each record, plus the total
+    std::vector<Uint> nodes;        // neu node numbers of all records
+  } m_elements;
 
   struct HeaderData
   {
@@ -93,7 +93,7 @@ void Writer::write()
 void Writer::write_headerData(std::fstream& file, const Mesh& mesh)
 {
   // get the day of today
-  boost::gregorian::date date = boost::gregorian::from_simple_string(mesh.metadata().properties().value_str("date"));
+  boost::gregorian::date date = boost::gregorian::from_simple_string(metadata().properties().value_str("date"));
 
   Uint group_counter(0);
   Uint element_counter(0);
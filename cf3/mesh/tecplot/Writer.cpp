@@ -4,8 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
 #include <iostream>
 #include <set>
+
+#include <boost/assign/list_of.hpp>
+#include <boost/cstdint.hpp>
+
 #include "common/BoostFilesystem.hpp"
 #include "common/Foreach.hpp"
 #include "common/Log.hpp"
@@ -50,6 +55,24 @@ Writer::Writer( const std::string& name )
 
   options().add("cell_centred",true)
     .description("True if discontinuous fields are to be plotted as cell-centred fields");
+
+  std::vector<boost::any> formats;
+  formats.push_back(std::string("auto"));
+  formats.push_back(std::string("ascii"));
+  formats.push_back(std::string("binary"));
+  options().add("format",std::string("auto"))
+    .description("File format: ascii, binary, or auto to write binary for .plt files and ascii for .dat files")
+    .pretty_name("Format")
+    .restricted_list() = formats;
+
+  // Node order of each shape in the binary zone types, with coalesced nodes where tecplot has no matching type
+  m_nodes_cf_to_binary[GeoShape::LINE]  = boost::assign::list_of(0)(1);
+  m_nodes_cf_to_binary[GeoShape::TRIAG] = boost::assign::list_of(0)(1)(2);
+  m_nodes_cf_to_binary[GeoShape::QUAD]  = boost::assign::list_of(0)(1)(2)(3);
+  m_nodes_cf_to_binary[GeoShape::TETRA] = boost::assign::list_of(0)(1)(2)(3);
+  m_nodes_cf_to_binary[GeoShape::PYRAM] = boost::assign::list_of(0)(1)(2)(3)(4)(4)(4)(4);
+  m_nodes_cf_to_binary[GeoShape::PRISM] = boost::assign::list_of(0)(1)(2)(2)(3)(4)(5)(5);
+  m_nodes_cf_to_binary[GeoShape::HEXA]  = boost::assign::list_of(0)(1)(2)(3)(4)(5)(6)(7);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -58,11 +81,22 @@ std::vector<std::string> Writer::get_extensions()
 {
   std::vector<std::string> extensions;
   extensions.push_back(".plt");
+  extensions.push_back(".dat");
   return extensions;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
+bool Writer::is_binary() const
+{
+  const std::string format = options().value<std::string>("format");
+  if (format == "auto")
+    return m_file_path.extension() != ".dat";
+  return format == "binary";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void Writer::write()
 {
   // if the file is present open it
@@ -73,7 +107,8 @@ void Writer::write()
     path = boost::filesystem::basename(path) + "_P" + to_str(PE::Comm::instance().rank()) + boost::filesystem::extension(path);
   }
 //  CFLog(VERBOSE, "Opening file " <<  path.string() << "\n");
-  file.open(path,std::ios_base::out);
+  const bool binary = is_binary();
+  file.open(path, binary ? std::ios_base::out | std::ios_base::binary : std::ios_base::out);
   if (!file) // didn't open so throw exception
   {
      throw boost::filesystem::filesystem_error( path.string() + " failed to open",
@@ -81,7 +116,10 @@ void Writer::write()
   }
 
 
-  write_file(file);
+  if (binary)
+    write_binary_file(file);
+  else
+    write_file(file);
 
   file.close();
 
@@ -189,9 +227,9 @@ void Writer::write_file(std::fstream& file)
     // one zone per element type per cpu
     // therefore the title is dependent on those parameters
     file << "ZONE "
-         << "  T=\"ITER"<<m_mesh->metadata().properties().value<Uint>("iter") << ":" << zone_name << "\""
+         << "  T=\"ITER"<<metadata().properties().value<Uint>("iter") << ":" << zone_name << "\""
          << ", STRANDID="<<zone_idx
-         << ", SOLUTIONTIME="<<m_mesh->metadata().properties().value<Real>("time")
+         << ", SOLUTIONTIME="<<metadata().properties().value<Real>("time")
          << ", N=" << used_nodes.size()
          << ", E=" << nb_elems
          << ", DATAPACKING=BLOCK"
@@ -242,173 +280,24 @@ void Writer::write_file(std::fstream& file)
 
         for (Uint i=0; i<static_cast<Uint>(var_type); ++i)
         {
-          if (field.continuous())
+          std::vector<Real> values;
+          if (zone_values(field,var_idx,elements,used_nodes,zone_node_idx,values))
           {
-            // Continuous field with different space than geometry
-            if ( &field.dict() == &m_mesh->geometry_fields() )
-            {
-              boost_foreach(Uint n, used_nodes.array())
-              {
-                file << field[n][var_idx] << " ";
-                CF3_BREAK_LINE(file,n);
-              }
-              file << "\n";
-            }
-            // Continuous field with different space than geometry
-            else
+            for (Uint n=0; n<values.size(); ++n)
             {
-              if (field.dict().defined_for_entities(elements.handle<Entities>()) )
-              {
-                const Space& field_space = field.space(elements);
-                RealVector field_data (field_space.shape_function().nb_nodes());
-
-                std::vector<Real> nodal_data(used_nodes.size(),0.);
-
-                RealMatrix interpolation(elements.geometry_space().shape_function().nb_nodes(),field_space.shape_function().nb_nodes());
-                const RealMatrix& geometry_local_coords = elements.geometry_space().shape_function().local_coordinates();
-                const ShapeFunction& sf = field_space.shape_function();
-                for (Uint g=0; g<interpolation.rows(); ++g)
-                {
-                  interpolation.row(g) = sf.value(geometry_local_coords.row(g));
-                }
-
-                // Compute interpolated data in the vector nodal_data
-                for (Uint e=0; e<elements.size(); ++e)
-                {
-                  // Skip this element if it is a ghost cell and overlap is disabled
-                  if (m_enable_overlap || !elements.is_ghost(e))
-                  {
-                    // get the node indices of this element
-                    Connectivity::ConstRow field_index = field_space.connectivity()[e];
-
-                    /// set field data
-                    for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
-                    {
-                      field_data[iState] = field[field_index[iState]][var_idx];
-                    }
-
-                    /// evaluate field shape function in P0 space
-                    RealVector geometry_field_data = interpolation*field_data;
-
-                    Connectivity::ConstRow geom_nodes = elements.geometry_space().connectivity()[e];
-                    cf3_assert(geometry_field_data.size()==geom_nodes.size());
-                    /// Average nodal values
-                    for (Uint g=0; g<geom_nodes.size(); ++g)
-                    {
-                      const Uint geom_node = geom_nodes[g];
-                      const Uint node_idx = zone_node_idx[geom_node]-1;
-                      cf3_assert(node_idx < nodal_data.size());
-                      nodal_data[node_idx] = geometry_field_data[g];
-                    }
-                  }
-                }
-                for (Uint n=0; n<nodal_data.size(); ++n)
-                {
-                  file << nodal_data[n] << " ";
-                  CF3_BREAK_LINE(file,n)
-                }
-                file << "\n";
-              }
+              file << values[n] << " ";
+              CF3_BREAK_LINE(file,n)
             }
+            file << "\n";
           }
-          // Discontinuous fields
-          else
+          else if (field.discontinuous())
           {
-            if (field.dict().defined_for_entities(elements.handle<Entities>()))
-            {
-              const Space& field_space = field.space(elements);
-              RealVector field_data (field_space.shape_function().nb_nodes());
-
-              if (options().value<bool>("cell_centred"))
-              {
-                boost::shared_ptr< ShapeFunction > P0_cell_centred = boost::dynamic_pointer_cast<ShapeFunction>(build_component("cf3.mesh.LagrangeP1."+to_str(elements.element_type().shape_name()),"tmp_shape_func"));
-
-                for (Uint e=0; e<elements.size(); ++e)
-                {
-                  if (m_enable_overlap || !elements.is_ghost(e))
-                  {
-                    Connectivity::ConstRow field_index = field_space.connectivity()[e];
-                    /// set field data
-                    for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
-                    {
-                      field_data[iState] = field[field_index[iState]][var_idx];
-                    }
-
-                    /// get cell-centred local coordinates
-                    RealVector local_coords = P0_cell_centred->local_coordinates().row(0);
-
-                    /// evaluate field shape function in P0 space
-                    Real cell_centred_data = field_space.shape_function().value(local_coords)*field_data;
-
-                    /// Write cell centred value
-                    file << cell_centred_data << " ";
-                    CF3_BREAK_LINE(file,e);
-                  }
-                }
-                file << "\n";
-              }
-              else
-              {
-                std::vector<Real> nodal_data(used_nodes.size(),0.);
-                std::vector<Uint> nodal_data_count(used_nodes.size(),0u);
-
-                RealMatrix interpolation(elements.geometry_space().shape_function().nb_nodes(),field_space.shape_function().nb_nodes());
-                const RealMatrix& geometry_local_coords = elements.geometry_space().shape_function().local_coordinates();
-                const ShapeFunction& sf = field_space.shape_function();
-                for (Uint g=0; g<interpolation.rows(); ++g)
-                {
-                  interpolation.row(g) = sf.value(geometry_local_coords.row(g));
-                }
-
-                for (Uint e=0; e<elements.size(); ++e)
-                {
-                  Connectivity::ConstRow field_index = field_space.connectivity()[e];
-
-                  /// set field data
-                  for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
-                  {
-                    field_data[iState] = field[field_index[iState]][var_idx];
-                  }
-
-                  /// evaluate field shape function in P0 space
-                  RealVector geometry_field_data = interpolation*field_data;
-
-                  Connectivity::ConstRow geom_nodes = elements.geometry_space().connectivity()[e];
-                  cf3_assert(geometry_field_data.size()==geom_nodes.size());
-                  /// Average nodal values
-                  for (Uint g=0; g<geom_nodes.size(); ++g)
-                  {
-                    const Uint geom_node = geom_nodes[g];
-                    if (zone_node_idx.find(geom_node) != zone_node_idx.end())
-                    {
-                      const Uint node_idx = zone_node_idx[geom_node]-1;
-                      cf3_assert(node_idx < nodal_data.size());
-                      const Real accumulated_weight = nodal_data_count[node_idx]/(nodal_data_count[node_idx]+1.0);
-                      const Real add_weight = 1.0/(nodal_data_count[node_idx]+1.0);
-                      nodal_data[node_idx] = accumulated_weight*nodal_data[node_idx] + add_weight*geometry_field_data[g];
-                      ++nodal_data_count[node_idx];
-                    }
-                  }
-                }
-
-                for (Uint n=0; n<nodal_data.size(); ++n)
-                {
-                  file << nodal_data[n] << " ";
-                    CF3_BREAK_LINE(file,n)
-                }
-                file << "\n";
-
-              }
-            }
+            // field not defined for this zone, so write zeros
+            if (options().value<bool>("cell_centred"))
+              file << nb_elems << "*" << 0.;
             else
-            {
-              // field not defined for this zone, so write zeros
-              if (options().value<bool>("cell_centred"))
-                file << nb_elems << "*" << 0.;
-              else
-                file << used_nodes.size() << "*" << 0.;
-              file << "\n";
-            }
+              file << used_nodes.size() << "*" << 0.;
+            file << "\n";
           }
           var_idx++;
         }
@@ -435,6 +324,402 @@ void Writer::write_file(std::fstream& file)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+
+bool Writer::zone_values(const Field& field, const Uint var_idx, const Entities& elements,
+                         const common::List<Uint>& used_nodes, std::map<Uint,Uint>& zone_node_idx,
+                         std::vector<Real>& values)
+{
+  values.clear();
+  if (field.continuous())
+  {
+    // Continuous field in the geometry space
+    if ( &field.dict() == &m_mesh->geometry_fields() )
+    {
+      values.reserve(used_nodes.size());
+      boost_foreach(Uint n, used_nodes.array())
+        values.push_back(field[n][var_idx]);
+      return true;
+    }
+
+    // Continuous field with different space than geometry
+    if (!field.dict().defined_for_entities(elements.handle<Entities>()) )
+      return false;
+
+    const Space& field_space = field.space(elements);
+    RealVector field_data (field_space.shape_function().nb_nodes());
+
+    values.assign(used_nodes.size(),0.);
+
+    RealMatrix interpolation(elements.geometry_space().shape_function().nb_nodes(),field_space.shape_function().nb_nodes());
+    const RealMatrix& geometry_local_coords = elements.geometry_space().shape_function().local_coordinates();
+    const ShapeFunction& sf = field_space.shape_function();
+    for (Uint g=0; g<interpolation.rows(); ++g)
+    {
+      interpolation.row(g) = sf.value(geometry_local_coords.row(g));
+    }
+
+    // Compute interpolated data in the vector values
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      // Skip this element if it is a ghost cell and overlap is disabled
+      if (m_enable_overlap || !elements.is_ghost(e))
+      {
+        // get the node indices of this element
+        Connectivity::ConstRow field_index = field_space.connectivity()[e];
+
+        /// set field data
+        for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
+        {
+          field_data[iState] = field[field_index[iState]][var_idx];
+        }
+
+        /// evaluate field shape function in P0 space
+        RealVector geometry_field_data = interpolation*field_data;
+
+        Connectivity::ConstRow geom_nodes = elements.geometry_space().connectivity()[e];
+        cf3_assert(geometry_field_data.size()==geom_nodes.size());
+        /// Average nodal values
+        for (Uint g=0; g<geom_nodes.size(); ++g)
+        {
+          const Uint geom_node = geom_nodes[g];
+          const Uint node_idx = zone_node_idx[geom_node]-1;
+          cf3_assert(node_idx < values.size());
+          values[node_idx] = geometry_field_data[g];
+        }
+      }
+    }
+    return true;
+  }
+
+  // Discontinuous fields
+  if (!field.dict().defined_for_entities(elements.handle<Entities>()))
+    return false;
+
+  const Space& field_space = field.space(elements);
+  RealVector field_data (field_space.shape_function().nb_nodes());
+
+  if (options().value<bool>("cell_centred"))
+  {
+    boost::shared_ptr< ShapeFunction > P0_cell_centred = boost::dynamic_pointer_cast<ShapeFunction>(build_component("cf3.mesh.LagrangeP1."+to_str(elements.element_type().shape_name()),"tmp_shape_func"));
+
+    /// get cell-centred local coordinates
+    const RealVector local_coords = P0_cell_centred->local_coordinates().row(0);
+
+    values.reserve(elements.size());
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if (m_enable_overlap || !elements.is_ghost(e))
+      {
+        Connectivity::ConstRow field_index = field_space.connectivity()[e];
+        /// set field data
+        for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
+        {
+          field_data[iState] = field[field_index[iState]][var_idx];
+        }
+
+        /// evaluate field shape function in P0 space
+        values.push_back(field_space.shape_function().value(local_coords)*field_data);
+      }
+    }
+    return true;
+  }
+
+  values.assign(used_nodes.size(),0.);
+  std::vector<Uint> nodal_data_count(used_nodes.size(),0u);
+
+  RealMatrix interpolation(elements.geometry_space().shape_function().nb_nodes(),field_space.shape_function().nb_nodes());
+  const RealMatrix& geometry_local_coords = elements.geometry_space().shape_function().local_coordinates();
+  const ShapeFunction& sf = field_space.shape_function();
+  for (Uint g=0; g<interpolation.rows(); ++g)
+  {
+    interpolation.row(g) = sf.value(geometry_local_coords.row(g));
+  }
+
+  for (Uint e=0; e<elements.size(); ++e)
+  {
+    Connectivity::ConstRow field_index = field_space.connectivity()[e];
+
+    /// set field data
+    for (Uint iState=0; iState<field_space.shape_function().nb_nodes(); ++iState)
+    {
+      field_data[iState] = field[field_index[iState]][var_idx];
+    }
+
+    /// evaluate field shape function in P0 space
+    RealVector geometry_field_data = interpolation*field_data;
+
+    Connectivity::ConstRow geom_nodes = elements.geometry_space().connectivity()[e];
+    cf3_assert(geometry_field_data.size()==geom_nodes.size());
+    /// Average nodal values
+    for (Uint g=0; g<geom_nodes.size(); ++g)
+    {
+      const Uint geom_node = geom_nodes[g];
+      if (zone_node_idx.find(geom_node) != zone_node_idx.end())
+      {
+        const Uint node_idx = zone_node_idx[geom_node]-1;
+        cf3_assert(node_idx < values.size());
+        const Real accumulated_weight = nodal_data_count[node_idx]/(nodal_data_count[node_idx]+1.0);
+        const Real add_weight = 1.0/(nodal_data_count[node_idx]+1.0);
+        values[node_idx] = accumulated_weight*values[node_idx] + add_weight*geometry_field_data[g];
+        ++nodal_data_count[node_idx];
+      }
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/// Writes the binary records of the tecplot binary format (version 112)
+class BinaryOutput
+{
+public:
+
+  BinaryOutput(std::fstream& file) : m_file(file) {}
+
+  void write_int32(const boost::int32_t value)
+  {
+    m_file.write(reinterpret_cast<const char*>(&value), sizeof(boost::int32_t));
+  }
+
+  void write_float32(const float value)
+  {
+    m_file.write(reinterpret_cast<const char*>(&value), sizeof(float));
+  }
+
+  void write_float64(const double value)
+  {
+    m_file.write(reinterpret_cast<const char*>(&value), sizeof(double));
+  }
+
+  /// Strings are written as one int32 per character, and null-terminated
+  void write_string(const std::string& str)
+  {
+    std::vector<boost::int32_t> chars(str.begin(),str.end());
+    chars.push_back(0);
+    m_file.write(reinterpret_cast<const char*>(&chars[0]), chars.size()*sizeof(boost::int32_t));
+  }
+
+  void write_block(const std::vector<double>& values)
+  {
+    if (values.size())
+      m_file.write(reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(double));
+  }
+
+  void write_block(const std::vector<boost::int32_t>& values)
+  {
+    if (values.size())
+      m_file.write(reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(boost::int32_t));
+  }
+
+private:
+
+  std::fstream& m_file;
+};
+
+/// Marks the start of a zone, in the header and the data section
+const float zone_marker = 299.;
+
+/// Marks the end of the header section
+const float end_of_header_marker = 357.;
+
+} // detail
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_binary_file(std::fstream& file)
+{
+  detail::BinaryOutput out(file);
+
+  const Uint dimension = m_mesh->geometry_fields().coordinates().row_size();
+  const bool cell_centred = options().value<bool>("cell_centred");
+
+  // Variable names, and whether they are cell-centred
+  std::vector<std::string> var_names;
+  std::vector<boost::int32_t> var_location;
+  for (Uint i = 0; i < dimension ; ++i)
+  {
+    var_names.push_back("x"+to_str(i));
+    var_location.push_back(0);
+  }
+  boost_foreach(Handle<Field const> field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+    for (Uint iVar=0; iVar<field.nb_vars(); ++iVar)
+    {
+      const Uint var_length = field.var_length(iVar);
+      for (Uint i=0; i<var_length; ++i)
+      {
+        var_names.push_back(var_length > 1 ? field.var_name(iVar)+"["+to_str(i)+"]" : field.var_name(iVar));
+        var_location.push_back(field.discontinuous() && cell_centred);
+      }
+    }
+  }
+  const bool has_cell_centred_vars = std::count(var_location.begin(),var_location.end(),1);
+
+  // Zones, one per element type per cpu, as in the ASCII format
+  std::vector<Zone> zones;
+  Uint zone_idx=0;
+  boost_foreach (const Handle<Entities const>& elements_h, m_filtered_entities )
+  {
+    Entities const& elements = *elements_h;
+    const ElementType& etype = elements.element_type();
+    if (etype.shape() == GeoShape::POINT)
+      continue;
+
+    ++zone_idx;
+    Uint nb_elems = elements.size();
+    if(m_enable_overlap == false)
+    {
+      for (Uint e=0; e<elements.size(); ++e)
+      {
+        if (elements.is_ghost(e))
+          --nb_elems;
+      }
+    }
+
+    // tecplot doesn't handle zones with 0 elements
+    if (nb_elems == 0)
+      continue;
+
+    if (etype.order() != 1)
+    {
+      throw NotImplemented(FromHere(), "Tecplot can only output P1 elements. A new P1 space should be created, and used as geometry space");
+    }
+
+    Zone zone;
+    zone.elements = elements_h;
+    zone.name = elements.parent()->uri().path();
+    boost::algorithm::replace_first(zone.name,m_mesh->topology().uri().path()+"/","");
+    zone.strand_id = zone_idx;
+    zone.nb_elems = nb_elems;
+    zone.used_nodes = mesh::build_used_nodes_list(elements,m_mesh->geometry_fields(),m_enable_overlap);
+    zones.push_back(zone);
+  }
+
+  // Header section
+  file.write("#!TDV112",8);
+  out.write_int32(1);  // byte order
+  out.write_int32(0);  // full file, with grid and solution
+  out.write_string("COOLFluiD Mesh Data");
+  out.write_int32(var_names.size());
+  boost_foreach(const std::string& var_name, var_names)
+    out.write_string(var_name);
+
+  const Uint iter = metadata().properties().value<Uint>("iter");
+  const Real time = metadata().properties().value<Real>("time");
+  boost_foreach(const Zone& zone, zones)
+  {
+    out.write_float32(detail::zone_marker);
+    out.write_string("ITER"+to_str(iter)+":"+zone.name);
+    out.write_int32(-1);             // no parent zone
+    out.write_int32(zone.strand_id);
+    out.write_float64(time);
+    out.write_int32(-1);             // default zone color
+    out.write_int32(binary_zone_type(zone.elements->element_type()));
+    out.write_int32(has_cell_centred_vars);
+    if (has_cell_centred_vars)
+      out.write_block(var_location);
+    out.write_int32(0);              // no raw local face neighbors
+    out.write_int32(0);              // no user-defined face neighbor connections
+    out.write_int32(zone.used_nodes->size());
+    out.write_int32(zone.nb_elems);
+    out.write_int32(0); out.write_int32(0); out.write_int32(0); // cell dimensions, unused
+    out.write_int32(0);              // no auxiliary data
+  }
+  out.write_float32(detail::end_of_header_marker);
+
+  // Data section, in block data packing
+  boost_foreach(const Zone& zone, zones)
+  {
+    const Entities& elements = *zone.elements;
+    const common::List<Uint>& used_nodes = *zone.used_nodes;
+    std::map<Uint,Uint> zone_node_idx;
+    for (Uint n=0; n<used_nodes.size(); ++n)
+      zone_node_idx[ used_nodes[n] ] = n+1;
+
+    // All values of the zone are gathered first, as the data is preceded by the range of every variable
+    std::vector< std::vector<Real> > zone_data;
+    zone_data.reserve(var_names.size());
+    const common::Table<Real>& coordinates = m_mesh->geometry_fields().coordinates();
+    for (Uint d = 0; d < dimension; ++d)
+    {
+      zone_data.push_back(std::vector<Real>());
+      zone_data.back().reserve(used_nodes.size());
+      boost_foreach(Uint n, used_nodes.array())
+        zone_data.back().push_back(coordinates[n][d]);
+    }
+    boost_foreach(Handle<Field const> field_ptr, m_fields)
+    {
+      const Field& field = *field_ptr;
+      Uint var_idx(0);
+      for (Uint iVar=0; iVar<field.nb_vars(); ++iVar)
+      {
+        for (Uint i=0; i<field.var_length(iVar); ++i)
+        {
+          zone_data.push_back(std::vector<Real>());
+          if (!zone_values(field,var_idx,elements,used_nodes,zone_node_idx,zone_data.back()))
+          {
+            // field not defined for this zone, so write zeros
+            zone_data.back().assign(var_location[zone_data.size()-1] ? zone.nb_elems : used_nodes.size(), 0.);
+          }
+          var_idx++;
+        }
+      }
+    }
+
+    out.write_float32(detail::zone_marker);
+    for (Uint var=0; var<zone_data.size(); ++var)
+      out.write_int32(2); // double precision
+    out.write_int32(0);   // no passive variables
+    out.write_int32(0);   // no variable sharing
+    out.write_int32(-1);  // no connectivity sharing
+    boost_foreach(const std::vector<Real>& values, zone_data)
+    {
+      out.write_float64(values.empty() ? 0. : *std::min_element(values.begin(),values.end()));
+      out.write_float64(values.empty() ? 0. : *std::max_element(values.begin(),values.end()));
+    }
+    boost_foreach(const std::vector<Real>& values, zone_data)
+      out.write_block(values);
+
+    // Connectivity as zero-based int32 node indices, with coalesced nodes for the shapes tecplot doesn't know
+    const std::vector<Uint>& nodes_to_tp = m_nodes_cf_to_binary[elements.element_type().shape()];
+    std::vector<boost::int32_t> connectivity;
+    connectivity.reserve(zone.nb_elems*nodes_to_tp.size());
+    const Connectivity& geometry_connectivity = elements.geometry_space().connectivity();
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if (m_enable_overlap || !elements.is_ghost(e))
+      {
+        Connectivity::ConstRow element_nodes = geometry_connectivity[e];
+        boost_foreach(const Uint n, nodes_to_tp)
+          connectivity.push_back(zone_node_idx[element_nodes[n]]-1);
+      }
+    }
+    out.write_block(connectivity);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+Uint Writer::binary_zone_type(const ElementType& etype) const
+{
+  if ( etype.shape() == GeoShape::LINE)     return 1; // FELINESEG
+  if ( etype.shape() == GeoShape::TRIAG)    return 2; // FETRIANGLE
+  if ( etype.shape() == GeoShape::QUAD)     return 3; // FEQUADRILATERAL
+  if ( etype.shape() == GeoShape::TETRA)    return 4; // FETETRAHEDRON
+  if ( etype.shape() == GeoShape::PYRAM)    return 5; // FEBRICK with coalesced nodes
+  if ( etype.shape() == GeoShape::PRISM)    return 5; // FEBRICK with coalesced nodes
+  if ( etype.shape() == GeoShape::HEXA)     return 5; // FEBRICK
+  throw NotImplemented(FromHere(), "Element type " + etype.derived_type_name() + " has no tecplot zone type");
+  return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 std::string Writer::zone_type(const ElementType& etype) const
 {
   if ( etype.shape() == GeoShape::LINE)     return "FELINESEG";
@@ -9,6 +9,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
+#include "common/List.hpp"
+
 #include "mesh/MeshWriter.hpp"
 #include "mesh/GeoShape.hpp"
 
@@ -24,6 +28,10 @@ namespace tecplot {
 //////////////////////////////////////////////////////////////////////////////
 
 /// This class defines tecplot mesh format writer
+///
+/// Files are written in the binary tecplot format (#!TDV112), with block data packing
+/// and int32 connectivity, or in the ASCII format. The "format" option selects either,
+/// and by default the binary format is used for .plt files and ASCII for .dat files.
 /// @author Willem Deconinck
 class tecplot_API Writer : public MeshWriter
 {
@@ -46,14 +54,40 @@ public: // functions
 
   virtual std::vector<std::string> get_extensions();
 
+private: // types
+
+  /// Zone of the binary file, of which all headers are written before the data
+  struct Zone
+  {
+    Handle<Entities const> elements;
+    std::string name;
+    Uint strand_id;
+    Uint nb_elems;
+    boost::shared_ptr< common::List<Uint> > used_nodes;
+  };
+
 private: // functions
 
+  bool is_binary() const;
+
   void write_file(std::fstream& file);
 
+  void write_binary_file(std::fstream& file);
+
+  /// Values of one component of a field in a zone, at the zone nodes or cell centres
+  /// @return false if the field is not defined in the zone
+  bool zone_values(const Field& field, const Uint var_idx, const Entities& elements,
+                   const common::List<Uint>& used_nodes, std::map<Uint,Uint>& zone_node_idx,
+                   std::vector<Real>& values);
+
   std::string zone_type(const ElementType& etype) const;
 
+  Uint binary_zone_type(const ElementType& etype) const;
+
 private: // data
 
+  /// Nodes of every shape, in the order of the binary zone type
+  std::map<GeoShape::Type, std::vector<Uint> > m_nodes_cf_to_binary;
 
 }; // end Writer
 
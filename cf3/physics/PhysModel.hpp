@@ -7,6 +7,8 @@
 #ifndef cf3_physics_PhysModel_hpp
 #define cf3_physics_PhysModel_hpp
 
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include "common/Component.hpp"
 
 #include "physics/LibPhysics.hpp"
@@ -22,6 +24,10 @@ namespace physics {
   /// @note this class and its derived classes should not ave any virtual functions
   struct Properties : public boost::noncopyable {};
 
+  /// block of physical properties, used by the batched Variables interface
+  /// @note fill with properties created by PhysModel::create_properties()
+  typedef boost::ptr_vector<Properties> PropertiesBlock;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Component providing information about the physics
@@ -32,5 +32,64 @@ Variables::~Variables()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Variables::compute_properties_batch(const ConstRowBlock& coords,
+                                         const ConstRowBlock& sols,
+                                         PropertiesBlock& props)
+{
+  const Uint nb_states = sols.rows();
+  cf3_assert(coords.rows() == nb_states);
+  cf3_assert(props.size() >= nb_states);
+
+  RealVector coord(coords.cols());
+  RealVector sol(sols.cols());
+  RealMatrix grad_sol(sols.cols(), coords.cols());
+  grad_sol.setZero();
+
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    coord = coords.row(i).transpose();
+    sol = sols.row(i).transpose();
+    compute_properties(coord, sol, grad_sol, props[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Variables::compute_fluxes_batch(const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds)
+{
+  const Uint nb_states = sols.rows();
+  const Uint dim = directions.cols();
+  const Uint neqs = sols.cols();
+  cf3_assert(directions.rows() == nb_states);
+
+  RealVector coord(dim);
+  RealVector direction(dim);
+  RealVector sol(neqs);
+  RealVector flux_vec(neqs);
+  RealVector evalues(neqs);
+  RealMatrix grad_sol(neqs, dim);
+  coord.setZero();
+  grad_sol.setZero();
+
+  fluxes.resize(nb_states, neqs);
+  wave_speeds.resize(nb_states, neqs);
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    sol = sols.row(i).transpose();
+    direction = directions.row(i).transpose();
+    compute_properties(coord, sol, grad_sol, p);
+    flux(p, direction, flux_vec);
+    flux_jacobian_eigen_values(p, direction, evalues);
+    fluxes.row(i) = flux_vec.transpose();
+    wave_speeds.row(i) = evalues.transpose();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // physics
 } // cf3
@@ -31,6 +31,10 @@ namespace physics {
     virtual Real operator() ( const Real& r ) const { return r; };
   };
 
+  /// read-only view on a contiguous block of rows, such as states, coordinates or directions,
+  /// stored one per row. Maps onto a RealMatrix or a range of rows of a mesh::Field without copying.
+  typedef Eigen::Map<const RealMatrix> ConstRowBlock;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Interface to a set of variables
@@ -107,6 +111,36 @@ public: // functions
 
   //@} END INTERFACE
 
+  /// @name BATCHED INTERFACE
+  /// Works on a block of states stored one per row. The default implementation
+  /// loops over the single state interface, derived classes provide faster versions.
+  //@{
+
+  /// compute physical properties for a block of states
+  /// @param coords coordinates of each state, one per row
+  /// @param sols   states, one per row
+  /// @param props  at least sols.rows() properties created by the physical model
+  /// @note the gradients cached in the properties are set to zero
+  virtual void compute_properties_batch (const ConstRowBlock& coords,
+                                         const ConstRowBlock& sols,
+                                         PropertiesBlock& props);
+
+  /// compute the physical fluxes projected on a direction and the eigen values
+  /// of the flux jacobians for a block of states
+  /// @param sols        states, one per row
+  /// @param directions  direction to project on for each state, one per row
+  /// @param p           properties created by the physical model, supplying the
+  ///                    model constants and used as work space
+  /// @param fluxes      resized to hold the flux of each state, one per row
+  /// @param wave_speeds resized to hold the eigen values of each state, one per row
+  virtual void compute_fluxes_batch (const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds);
+
+  //@} END BATCHED INTERFACE
+
 }; // Variables
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,6 +264,64 @@ public:
 
   virtual math::VariablesDescriptor& description() { return *m_description; }
 
+  /// compute physical properties for a block of states, without virtual calls per state
+  virtual void compute_properties_batch (const ConstRowBlock& coords,
+                                         const ConstRowBlock& sols,
+                                         PropertiesBlock& props)
+  {
+    const Uint nb_states = sols.rows();
+    cf3_assert(coords.rows() == nb_states);
+    cf3_assert(props.size() >= nb_states);
+
+    typename PHYS::MODEL::GeoV coord;
+    typename PHYS::MODEL::SolV sol;
+    typename PHYS::MODEL::SolM grad_sol;
+    grad_sol.setZero();
+
+    for(Uint i = 0; i != nb_states; ++i)
+    {
+      coord = coords.row(i).transpose();
+      sol = sols.row(i).transpose();
+      PHYS::compute_properties( coord, sol, grad_sol, static_cast<typename PHYS::MODEL::Properties&>( props[i] ) );
+    }
+  }
+
+  /// compute the physical fluxes and eigen values for a block of states, without virtual calls per state
+  virtual void compute_fluxes_batch (const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds)
+  {
+    const Uint nb_states = sols.rows();
+    cf3_assert(directions.rows() == nb_states);
+
+    typename PHYS::MODEL::Properties& cp =
+        static_cast<typename PHYS::MODEL::Properties&>( p );
+
+    typename PHYS::MODEL::GeoV coord;
+    typename PHYS::MODEL::GeoV direction;
+    typename PHYS::MODEL::SolV sol;
+    typename PHYS::MODEL::SolV flux;
+    typename PHYS::MODEL::SolV evalues;
+    typename PHYS::MODEL::SolM grad_sol;
+    coord.setZero();
+    grad_sol.setZero();
+
+    fluxes.resize(nb_states, PHYS::MODEL::_neqs);
+    wave_speeds.resize(nb_states, PHYS::MODEL::_neqs);
+    for(Uint i = 0; i != nb_states; ++i)
+    {
+      sol = sols.row(i).transpose();
+      direction = directions.row(i).transpose();
+      PHYS::compute_properties( coord, sol, grad_sol, cp );
+      PHYS::flux( cp, direction, flux );
+      PHYS::flux_jacobian_eigen_values( cp, direction, evalues );
+      fluxes.row(i) = flux.transpose();
+      wave_speeds.row(i) = evalues.transpose();
+    }
+  }
+
 private:
   boost::shared_ptr<math::VariablesDescriptor> m_description;
 
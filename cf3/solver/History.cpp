@@ -6,6 +6,11 @@
 
 #include <iomanip>
 
+#include <boost/cstdint.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
 #include "common/BoostFilesystem.hpp"
 #include "common/PropertyList.hpp"
 #include "common/OptionList.hpp"
@@ -25,6 +30,221 @@ common::ComponentBuilder < History , Component, LibSolver > History_Builder;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+class History::LogWriter
+{
+public:
+
+  LogWriter() : m_nb_pending(0), m_flush_entries(1u), m_flush_interval(0.), m_binary(false), m_stop(false) {}
+
+  ~LogWriter()
+  {
+    close();
+  }
+
+  bool is_open() const { return m_file.is_open(); }
+
+  /// Set how entries are buffered and the file format, which takes effect on the next open()
+  void configure(const Uint flush_entries, const Real flush_interval, const bool binary)
+  {
+    stop_thread();
+    m_flush_entries = std::max(flush_entries,1u);
+    m_flush_interval = flush_interval;
+    m_binary = binary;
+  }
+
+  /// (Re)create the file with all rows of the table, dropping the buffered entries that the table contains
+  void open(const URI& file_uri, const std::vector<std::string>& columns, const Table<Real>& table)
+  {
+    boost::mutex::scoped_lock file_lock(m_file_mutex);
+    {
+      boost::mutex::scoped_lock lock(m_pending_mutex);
+      m_pending.clear();
+      m_nb_pending = 0;
+    }
+
+    if (m_file.is_open())
+      m_file.close();
+    if (m_binary)
+    {
+      boost::filesystem::path path (file_uri.path());
+      m_file.open(path,std::ios_base::out | std::ios_base::binary);
+      if (!m_file)
+        throw boost::filesystem::filesystem_error( path.string() + " failed to open", boost::system::error_code() );
+    }
+    else
+    {
+      History::open_file(m_file,file_uri);
+    }
+    m_nb_columns = columns.size();
+    write_header(columns);
+    if (table.size())
+      write_rows(&table.array()[0][0],table.size());
+    m_file.flush();
+
+    if (m_flush_interval > 0. && !m_thread)
+    {
+      m_stop = false;
+      m_thread.reset(new boost::thread(&LogWriter::run, this));
+    }
+  }
+
+  /// Buffer an entry, and write the buffered entries if there are enough
+  void append(const std::vector<Real>& entry)
+  {
+    cf3_assert(entry.size() == m_nb_columns);
+    bool full = false;
+    {
+      boost::mutex::scoped_lock lock(m_pending_mutex);
+      m_pending.insert(m_pending.end(),entry.begin(),entry.end());
+      full = ++m_nb_pending >= m_flush_entries;
+    }
+    if (full)
+    {
+      if (m_thread)
+        m_condition.notify_one();
+      else
+        write_pending();
+    }
+  }
+
+  /// Write all buffered entries to the file
+  void write_pending()
+  {
+    boost::mutex::scoped_lock file_lock(m_file_mutex);
+    std::vector<Real> rows;
+    Uint nb_rows;
+    {
+      boost::mutex::scoped_lock lock(m_pending_mutex);
+      rows.swap(m_pending);
+      nb_rows = m_nb_pending;
+      m_nb_pending = 0;
+    }
+    if (nb_rows == 0 || !m_file.is_open())
+      return;
+    write_rows(&rows[0],nb_rows);
+    m_file.flush();
+  }
+
+  /// Write all buffered entries and close the file
+  void close()
+  {
+    stop_thread();
+    write_pending();
+    boost::mutex::scoped_lock file_lock(m_file_mutex);
+    if (m_file.is_open())
+      m_file.close();
+  }
+
+private:
+
+  /// Background thread, writing the buffered entries when notified or after the flush interval
+  void run()
+  {
+    const boost::posix_time::milliseconds interval(static_cast<long>(1000.*m_flush_interval));
+    while (true)
+    {
+      {
+        boost::mutex::scoped_lock lock(m_pending_mutex);
+        if (!m_stop && m_nb_pending < m_flush_entries)
+          m_condition.timed_wait(lock,interval);
+        if (m_stop)
+          return;
+      }
+      write_pending();
+    }
+  }
+
+  void stop_thread()
+  {
+    if (!m_thread)
+      return;
+    {
+      boost::mutex::scoped_lock lock(m_pending_mutex);
+      m_stop = true;
+    }
+    m_condition.notify_one();
+    m_thread->join();
+    m_thread.reset();
+  }
+
+  void write_header(const std::vector<std::string>& columns)
+  {
+    if (m_binary)
+    {
+      m_file.write("CF3HIST1",8);
+      write_uint32(columns.size());
+      boost_foreach(const std::string& column, columns)
+      {
+        write_uint32(column.size());
+        m_file.write(column.data(),column.size());
+      }
+    }
+    else
+    {
+      // format: # var1 var2 vector[0] vector[1]
+      m_file << "#";
+      boost_foreach(const std::string& column, columns)
+        m_file << "\t" << std::setw(16) << column;
+      m_file << "\n";
+    }
+  }
+
+  /// Write rows stored one after the other
+  void write_rows(const Real* rows, const Uint nb_rows)
+  {
+    if (m_binary)
+    {
+      // One block, column after column
+      write_uint32(nb_rows);
+      std::vector<double> column(nb_rows);
+      for (Uint c=0; c<m_nb_columns; ++c)
+      {
+        for (Uint r=0; r<nb_rows; ++r)
+          column[r] = rows[r*m_nb_columns+c];
+        m_file.write(reinterpret_cast<const char*>(&column[0]),nb_rows*sizeof(double));
+      }
+    }
+    else
+    {
+      for (Uint r=0; r<nb_rows; ++r)
+      {
+        for (Uint c=0; c<m_nb_columns; ++c)
+          m_file << "\t" << std::scientific << std::setw(16) << rows[r*m_nb_columns+c];
+        m_file << "\n";
+      }
+    }
+  }
+
+  void write_uint32(const Uint value)
+  {
+    const boost::uint32_t value32 = value;
+    m_file.write(reinterpret_cast<const char*>(&value32),sizeof(value32));
+  }
+
+private:
+
+  boost::filesystem::fstream m_file;
+  Uint m_nb_columns;
+
+  /// Entries not written yet, one after the other
+  std::vector<Real> m_pending;
+  Uint m_nb_pending;
+
+  Uint m_flush_entries;
+  Real m_flush_interval;
+  bool m_binary;
+
+  /// Protects m_pending, m_nb_pending and m_stop
+  boost::mutex m_pending_mutex;
+  /// Protects m_file
+  boost::mutex m_file_mutex;
+  boost::condition_variable m_condition;
+  boost::scoped_ptr<boost::thread> m_thread;
+  bool m_stop;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 History::History ( const std::string& name ) :
   Component(name)
 {
@@ -42,7 +262,27 @@ History::History ( const std::string& name ) :
 
   // Extension TSV for "Tab Separated Values"
   options().add("file",URI("history.tsv"))
-      .description("Log file for history");
+      .description("Log file for history")
+      .attach_trigger( boost::bind( &History::configure_log_writer, this ) );
+
+  std::vector<boost::any> formats;
+  formats.push_back(std::string("tsv"));
+  formats.push_back(std::string("binary"));
+  options().add("format",std::string("tsv"))
+      .description("Format of the log file: tab separated values (tsv), or columns of doubles (binary)")
+      .attach_trigger( boost::bind( &History::configure_log_writer, this ) )
+      .restricted_list() = formats;
+
+  options().add("flush_entries",1u)
+      .description("Number of entries that are buffered before they are written to the log file")
+      .attach_trigger( boost::bind( &History::configure_log_writer, this ) );
+
+  options().add("flush_interval",0.)
+      .description("Maximum time in seconds between writes of the buffered entries, by a background thread. "
+                   "Zero writes the entries in the calling thread, every flush_entries entries")
+      .attach_trigger( boost::bind( &History::configure_log_writer, this ) );
+
+  m_log_writer.reset(new LogWriter);
 
   regist_signal ( "write" )
       .description( "Write history" )
@@ -55,10 +295,18 @@ History::History ( const std::string& name ) :
 
 History::~History()
 {
-  if (m_file)
-  {
-    m_file.close();
-  }
+  m_log_writer->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void History::configure_log_writer()
+{
+  // The file is recreated with the new settings at the next entry
+  m_log_writer->close();
+  m_log_writer->configure(options().value<Uint>("flush_entries"),
+                          options().value<Real>("flush_interval"),
+                          options().value<std::string>("format") == "binary");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,20 +375,14 @@ void History::save_entry()
   {
     if (PE::Comm::instance().rank() == 0)
     {
-      if (resized)
-        m_file.close();
-
-      if (!m_file)
+      if (resized || !m_log_writer->is_open())
       {
-        flush();
-        open_file(m_file,options().value<URI>("file"));
-        write_file(m_file);
-        m_file.flush();
+        m_buffer->flush();
+        m_log_writer->open(options().value<URI>("file"),column_names(),*m_table);
       }
       else
       {
-        m_file << this_entry << "\n";
-        m_file.flush();
+        m_log_writer->append(this_entry.data());
       }
     }
   }
@@ -151,6 +393,7 @@ void History::save_entry()
 void History::flush()
 {
   m_buffer->flush();
+  m_log_writer->write_pending();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -210,25 +453,35 @@ void History::open_file(boost::filesystem::fstream& file, const common::URI& fil
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::string History::file_header() const
+std::vector<std::string> History::column_names() const
 {
-  std::stringstream ss;
-
-  ss << "#";
+  std::vector<std::string> columns;
+  columns.reserve(m_variables->size());
   for (Uint var_idx=0; var_idx<m_variables->nb_vars(); ++var_idx)
   {
     const Uint var_length = m_variables->var_length(var_idx);
     if (var_length == 1)
     {
-      ss << "\t" << std::setw(16) << m_variables->user_variable_name(var_idx);
+      columns.push_back(m_variables->user_variable_name(var_idx));
     }
     else
     {
       for (Uint i=0; i<var_length; ++i)
-        ss << "\t" << std::setw(16) << m_variables->user_variable_name(var_idx)<<"["<<i<<"]";
+        columns.push_back(m_variables->user_variable_name(var_idx)+"["+to_str(i)+"]");
     }
-
   }
+  return columns;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string History::file_header() const
+{
+  std::stringstream ss;
+
+  ss << "#";
+  boost_foreach(const std::string& column, column_names())
+    ss << "\t" << std::setw(16) << column;
   ss << "\n";
   return ss.str();
 }
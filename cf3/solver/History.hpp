@@ -7,6 +7,8 @@
 #ifndef cf3_solver_History_hpp
 #define cf3_solver_History_hpp
 
+#include <boost/scoped_ptr.hpp>
+
 #include "common/BoostFilesystem.hpp"
 
 #include "common/Table.hpp"
@@ -33,7 +35,19 @@ class HistoryEntry;
 /// History is stored internally using a common::Table<Real> .
 /// An optional (default=ON) logging facility is provided to log the history to
 /// file at every new entry.
-/// The file format is Tab Separated Values (extension tsv)
+/// The file format is Tab Separated Values (extension tsv), or binary.
+///
+/// Entries can be buffered before they are written to the file, with the options
+/// "flush_entries" and "flush_interval". With a flush interval, the entries are
+/// written from a background thread, so that a slow file system does not stall
+/// the iterations. flush() and table() write all buffered entries.
+///
+/// The binary format stores columns of doubles, for long histories:
+/// - the characters "CF3HIST1"
+/// - the number of columns as a 32 bit unsigned integer
+/// - for every column, the length of its name as a 32 bit unsigned integer, and the name
+/// - any number of blocks, each with the number of rows as a 32 bit unsigned integer,
+///   followed by the values of the rows in the block, column after column
 ///
 /// Any number of variables can be added after logging started. This will cause
 /// The history file to be rewritten, including the new variables, putting zero's
@@ -114,17 +128,28 @@ public:
   Handle<math::VariablesDescriptor const> variables() const;
 
 
-  /// @brief Flush the buffer in the table
+  /// @brief Flush the buffer in the table, and write buffered entries to the log file
   void flush();
 
   /// @brief make a Entry object that can be written to any output stream
   HistoryEntry entry() const;
 
+private: // types
+
+  /// Writes the log file, possibly from a background thread
+  class LogWriter;
+
 private: // functions
 
   /// @brief open a file with given URI
   static void open_file(boost::filesystem::fstream& file, const common::URI& file_uri);
 
+  /// @brief names of all columns of the table
+  std::vector<std::string> column_names() const;
+
+  /// @brief Configure the log writer from the options
+  void configure_log_writer();
+
   /// @brief resize table and rebuild buffer if needed
   bool resize_if_necessary();
 
@@ -136,8 +161,8 @@ private: // data
   /// Flag to check if the history has to be logged
   bool m_logging;
 
-  /// Log file handle
-  boost::filesystem::fstream m_file;
+  /// Writer of the log file
+  boost::scoped_ptr<LogWriter> m_log_writer;
 
   /// Handle to the table
   Handle< common::Table<Real> > m_table;
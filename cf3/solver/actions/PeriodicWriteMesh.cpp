@@ -4,16 +4,25 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #include "common/Builder.hpp"
 #include "common/OptionT.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Foreach.hpp"
 #include "common/FindComponents.hpp"
+#include "common/Group.hpp"
+
+#include "math/VariablesDescriptor.hpp"
 
 #include "mesh/WriteMesh.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/MeshMetadata.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
 
 #include "PeriodicWriteMesh.hpp"
 
@@ -32,7 +41,8 @@ common::ComponentBuilder < PeriodicWriteMesh, common::Action, LibActions > Perio
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Action(name),
-  m_writer( *create_static_component<WriteMesh>("MeshWriter") )
+  m_writer( *create_static_component<WriteMesh>("MeshWriter") ),
+  m_last_buffer(1)
 {
   mark_basic();
 
@@ -48,8 +58,30 @@ PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Actio
   options().add( "filepath", URI() )
       .pretty_name("File Path")
       .description("Path where to save the mesh");
+
+  options().add( "fields", std::vector<URI>() )
+      .pretty_name("Fields")
+      .description("Fields to write. If empty, all fields of the mesh are written");
+
+  options().add( "asynchronous", false )
+      .pretty_name("Asynchronous")
+      .description("Copy the fields into a snapshot and write it in a background thread, "
+                   "while the solver continues");
+
+  m_buffers[0] = create_static_component<Group>("snapshot_0");
+  m_buffers[1] = create_static_component<Group>("snapshot_1");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PeriodicWriteMesh::~PeriodicWriteMesh()
+{
+  if (m_thread)
+    m_thread->join();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
 
 void PeriodicWriteMesh::execute()
 {
@@ -66,19 +98,129 @@ void PeriodicWriteMesh::execute()
   {
     URI filepath = options().value<URI>("filepath");
 
-    /// @note writes all fields to the mesh
+    const std::vector<URI> fields = fields_to_write();
 
-    std::vector<URI> state_fields;
+    if ( options().value<bool>("asynchronous") == false )
+    {
+      wait();
+      m_writer.write_mesh( mesh(), filepath, fields );
+      return;
+    }
+
+    // The other buffer may still be read by the write in progress,
+    // so the snapshot can be taken before waiting for it
+    const Uint buffer = 1 - m_last_buffer;
+    const std::vector<URI> snapshot_fields = take_snapshot( *m_buffers[buffer], fields );
+
+    wait();
+
+    // Finding the writer rebuilds the writers of m_writer, and the file name and stamps
+    // come from the mesh metadata, which the solver keeps updating. Both are resolved here,
+    // so that the background thread only reads the snapshot and writes the file.
+    Handle<MeshWriter> writer = m_writer.find_writer( filepath );
+    writer->options().set( "fields", snapshot_fields );
+    writer->options().set( "mesh", mesh().handle<Mesh>() );
+    writer->options().set( "file", m_writer.expand_filepath( filepath, mesh().metadata() ) );
+    writer->options().set( "metadata", Handle<MeshMetadata const>( m_buffers[buffer]->get_child("metadata") ) );
+
+    m_last_buffer = buffer;
+    m_thread.reset( new boost::thread( boost::bind( &PeriodicWriteMesh::write_snapshot, this, writer ) ) );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PeriodicWriteMesh::wait()
+{
+  if ( !m_thread )
+    return;
+
+  m_thread->join();
+  m_thread.reset();
+
+  if ( !m_error.empty() )
+  {
+    const std::string error = m_error;
+    m_error.clear();
+    throw FileSystemError( FromHere(), "Asynchronous write of mesh in " + uri().string() + " failed:\n" + error );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<URI> PeriodicWriteMesh::fields_to_write()
+{
+  std::vector<URI> fields = options().value< std::vector<URI> >("fields");
+
+  /// @note writes all fields of the mesh if none are given
+  if ( fields.empty() )
+  {
     boost_foreach(const Field& field, find_components_recursively<Field>( mesh() ) )
     {
-      state_fields.push_back(field.uri());
+      fields.push_back(field.uri());
     }
+  }
+
+  return fields;
+}
 
-    m_writer.write_mesh( mesh(), filepath, state_fields );
+////////////////////////////////////////////////////////////////////////////////
 
+std::vector<URI> PeriodicWriteMesh::take_snapshot( Group& buffer, const std::vector<URI>& fields )
+{
+  std::vector<URI> snapshot_fields;
+  snapshot_fields.reserve(fields.size());
 
+  boost_foreach(const URI& field_uri, fields)
+  {
+    Handle<Field const> field( mesh().access_component_checked(field_uri) );
+    if ( is_null(field) )
+      throw ValueNotFound( FromHere(), "Invalid type of field URI [" + field_uri.string() + "]" );
+
+    // Snapshots are grouped per dictionary, so that they keep the name of the original field
+    Dictionary& dict = field->dict();
+    Handle<Group> dict_buffer( buffer.get_child(dict.name()) );
+    if ( is_null(dict_buffer) )
+      dict_buffer = buffer.create_component<Group>(dict.name());
+
+    Handle<Field> snapshot( dict_buffer->get_child(field->name()) );
+    if ( is_null(snapshot) )
+      snapshot = dict_buffer->create_component<Field>(field->name());
+
+    snapshot->set_dict(dict);
+    snapshot->set_descriptor(field->descriptor());
+    snapshot->resize(field->size());
+    snapshot->array() = field->array();
+
+    snapshot_fields.push_back(snapshot->uri());
   }
 
+  // Iteration and time written in the file, which may change before the write has finished
+  Handle<MeshMetadata> metadata( buffer.get_child("metadata") );
+  if ( is_null(metadata) )
+    metadata = buffer.create_component<MeshMetadata>("metadata");
+  boost_foreach( const PropertyList::PropertyStorage_t::value_type& property, mesh().metadata().properties() )
+    metadata->properties()[property.first] = property.second;
+
+  return snapshot_fields;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void PeriodicWriteMesh::write_snapshot( const Handle<MeshWriter>& writer )
+{
+  try
+  {
+    writer->execute();
+  }
+  catch ( std::exception& e )
+  {
+    m_error = e.what();
+  }
+  catch ( ... )
+  {
+    m_error = "unknown error";
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
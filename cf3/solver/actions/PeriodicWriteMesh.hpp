@@ -7,16 +7,30 @@
 #ifndef cf3_solver_actions_PeriodicWriteMesh_hpp
 #define cf3_solver_actions_PeriodicWriteMesh_hpp
 
+#include <boost/scoped_ptr.hpp>
+
 #include "solver/actions/LibActions.hpp"
 #include "solver/Action.hpp"
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+namespace boost { class thread; }
+
 namespace cf3 {
-namespace mesh   { class Field; class Mesh; class WriteMesh; }
+namespace common { class Group; }
+namespace mesh   { class Field; class Mesh; class MeshWriter; class WriteMesh; }
 namespace solver {
 namespace actions {
 
+/// Writes the mesh every "saverate" iterations.
+/// When the option "asynchronous" is enabled, the written fields and the mesh metadata
+/// are first copied into a snapshot buffer. The writer and the file name are resolved
+/// right away, and only the writing of the file runs in a background thread while
+/// the solver continues. Two snapshot buffers are used in turn, so the copy for the
+/// next write can be made while the previous one is still being written. A new write
+/// only blocks when the previous one has not finished yet.
+/// @note In asynchronous mode, the mesh connectivity and coordinates must not be
+///       modified while a write is in progress, since they are not copied.
 class solver_actions_API PeriodicWriteMesh : public solver::Action {
 
 public: // functions
@@ -25,7 +39,7 @@ public: // functions
   PeriodicWriteMesh ( const std::string& name );
 
   /// Virtual destructor
-  virtual ~PeriodicWriteMesh() {}
+  virtual ~PeriodicWriteMesh();
 
   /// Get the class name
   static std::string type_name () { return "PeriodicWriteMesh"; }
@@ -33,12 +47,40 @@ public: // functions
   /// execute the action
   virtual void execute ();
 
+  /// Block until the write running in the background, if any, has finished
+  /// @throws common::FileSystemError if the background write failed
+  void wait();
+
+private: // functions
+
+  /// Fields to write, taken from the option "fields", or all fields of the mesh
+  std::vector<common::URI> fields_to_write();
+
+  /// Copy the given fields and the mesh metadata into a snapshot buffer
+  /// @return the URIs of the snapshot fields
+  std::vector<common::URI> take_snapshot(common::Group& buffer, const std::vector<common::URI>& fields);
+
+  /// Body of the background thread, executing the configured writer
+  void write_snapshot(const Handle<mesh::MeshWriter>& writer);
+
 private: // data
 
   Handle<Component> m_iterator;  ///< component that holds the iteration
 
   mesh::WriteMesh& m_writer; ///< mesh writer
 
+  /// Snapshot buffers, used in turn by asynchronous writes
+  Handle<common::Group> m_buffers[2];
+
+  /// Index of the buffer used by the last asynchronous write
+  Uint m_last_buffer;
+
+  /// Thread running the last asynchronous write
+  boost::scoped_ptr<boost::thread> m_thread;
+
+  /// Error message of the last asynchronous write, empty if it succeeded
+  std::string m_error;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
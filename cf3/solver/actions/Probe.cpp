@@ -6,8 +6,10 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include "common/Core.hpp"
+#include "common/EventHandler.hpp"
 #include "common/Builder.hpp"
 #include "common/PropertyList.hpp"
 #include "common/OptionList.hpp"
@@ -29,6 +31,7 @@
 #include "mesh/Dictionary.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/PointInterpolator.hpp"
+#include "mesh/Tags.hpp"
 
 namespace cf3 {
 namespace solver {
@@ -42,7 +45,11 @@ common::ComponentBuilder < Probe, common::Action, solver::actions::LibActions >
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-Probe::Probe( const std::string& name  ) : common::Action(name)
+Probe::Probe( const std::string& name  ) :
+  common::Action(name),
+  m_located(false),
+  m_found(false),
+  m_found_on_proc(-1)
 {
   mark_basic(); // by default probes are visible
 
@@ -52,7 +59,8 @@ Probe::Probe( const std::string& name  ) : common::Action(name)
   properties()["description"] = description;
   
   options().add("coordinate",std::vector<Real>())
-    .description("Coordinate to interpolate fields to");
+    .description("Coordinate to interpolate fields to")
+    .attach_trigger( boost::bind( &Probe::invalidate, this ) );
     
   options().add("dict",m_dict)
       .description("Dictionary that will be probed")
@@ -68,6 +76,9 @@ Probe::Probe( const std::string& name  ) : common::Action(name)
 
   m_point_interpolator = create_component<PointInterpolator>("point_interpolator");
   m_variables = create_component<math::VariablesDescriptor>("variables");
+
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_loaded(), this, &Probe::on_mesh_modified_event);
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &Probe::on_mesh_modified_event);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,46 +86,41 @@ Probe::Probe( const std::string& name  ) : common::Action(name)
 void Probe::configure_point_interpolator()
 {
   m_point_interpolator->options().set("dict",m_dict);
+  invalidate();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Probe::execute()
+void Probe::locate()
 {
-  if ( is_null(m_dict) )
-    throw SetupError(FromHere(), "Option \"dict\" was not configured in "+uri().string());
-
   // Take the coordinate from the options
   std::vector<Real> opt_coord = options().value< std::vector<Real> >("coordinate");
   RealVector coord(opt_coord.size());
   math::copy(opt_coord,coord);
 
   // Find interpolation data for this coordinate
-  SpaceElem m_element;
-  std::vector<SpaceElem> m_stencil;
-  std::vector<Uint> m_points;
-  std::vector<Real> m_weights;
-
-  int found = m_point_interpolator->compute_storage(coord,m_element,m_stencil,m_points,m_weights);
+  SpaceElem element;
+  std::vector<SpaceElem> stencil;
 
-//  std::cout << PE::Comm::instance().rank() << ":  found = " << found << std::endl;
+  m_found = m_point_interpolator->compute_storage(coord,element,stencil,m_points,m_weights);
 
-  int found_on_proc = found ? PE::Comm::instance().rank() : -1;
+  m_found_on_proc = m_found ? PE::Comm::instance().rank() : -1;
 
   if (PE::Comm::instance().is_active())
-    PE::Comm::instance().all_reduce(PE::max(), &found_on_proc, 1, &found_on_proc);
-
-//  std::cout << PE::Comm::instance().rank() << ":  found_on_proc = " << found_on_proc << std::endl;
+    PE::Comm::instance().all_reduce(PE::max(), &m_found_on_proc, 1, &m_found_on_proc);
 
-  if (found_on_proc<0)
+  if (m_found_on_proc<0)
     throw SetupError(FromHere(),"Cannot probe: coordinate ("+to_str(opt_coord)+") lies outside the domain");
 
+  // Only the processor with the highest rank interpolates, when the coordinate is in the overlap
+  m_found = ( m_found_on_proc == static_cast<int>(PE::Comm::instance().rank()) );
+
   PE::Buffer elem_comp_buffer;
-  if (found)
+  if (m_found)
   {
-    elem_comp_buffer << m_element.comp->uri().path() << m_element.glb_idx();
+    elem_comp_buffer << element.comp->uri().path() << element.glb_idx();
   }
-  elem_comp_buffer.broadcast(found_on_proc);
+  elem_comp_buffer.broadcast(m_found_on_proc);
   std::string elem_comp;
   Uint glb_idx;
   elem_comp_buffer >> elem_comp >> glb_idx;
@@ -122,8 +128,31 @@ void Probe::execute()
   properties()["space"]=elem_comp;
   properties()["glb_elem_idx"]=glb_idx;
 
-//  std::cout << PE::Comm::instance().rank() << ":  elem_comp = " << elem_comp << std::endl;
-//  std::cout << PE::Comm::instance().rank() << ":  glb_idx = " << glb_idx << std::endl;
+  m_located = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Probe::on_mesh_modified_event(SignalArgs& args)
+{
+  if ( is_null(m_dict) )
+    return;
+
+  SignalOptions options(args);
+  const std::string mesh_path = options.value<URI>("mesh_uri").path();
+  if ( boost::algorithm::starts_with(m_dict->uri().path(), mesh_path+"/") )
+    invalidate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Probe::execute()
+{
+  if ( is_null(m_dict) )
+    throw SetupError(FromHere(), "Option \"dict\" was not configured in "+uri().string());
+
+  if ( !m_located )
+    locate();
 
   boost_foreach (const Handle<Field>& field, m_dict->fields())
   {
@@ -131,7 +160,7 @@ void Probe::execute()
     // Interpolate each field to the given point
     std::vector<Real> interpolated(field->row_size());
 
-    if (found)
+    if (m_found)
     {
       for(Uint v=0; v<interpolated.size(); ++v)
       {
@@ -143,7 +172,7 @@ void Probe::execute()
       }
     }
 
-    PE::Comm::instance().broadcast(interpolated,interpolated,found_on_proc);
+    PE::Comm::instance().broadcast(interpolated,interpolated,m_found_on_proc);
 
     // Set interpolated variables as properties
     for (Uint var_idx=0; var_idx<field->nb_vars(); ++var_idx)
@@ -28,6 +28,8 @@ class ProbePostProcessor;
 /// Interpolated values are stored as properties within the probe component.
 /// Actions can be added as child to the probe, and will be executed, after
 /// the probe is executed.
+/// The coordinate is located once, and the interpolation weights are reused
+/// until the coordinate, the dictionary or its mesh changes.
 /// @author Willem Deconinck
 class solver_actions_API Probe : public common::Action {
 friend class ProbePostProcessor;
@@ -74,12 +76,26 @@ private: // functions
   /// @brief Configure the point interpolator
   void configure_point_interpolator();
 
+  /// @brief Find the processor and interpolation weights for the coordinate
+  void locate();
+
+  /// @brief Locate the coordinate again on the next execution
+  void invalidate() { m_located = false; }
+
+  void on_mesh_modified_event(common::SignalArgs& args);
+
 private: // data
 
   Handle<mesh::Dictionary>            m_dict;                ///< Dictionary to interpolate
   Handle<mesh::PointInterpolator>     m_point_interpolator;  ///< Interpolator for one point
   Handle< math::VariablesDescriptor > m_variables;           ///< Variable description
 
+  bool              m_located;        ///< If the data below is valid for the current coordinate
+  bool              m_found;          ///< If this processor interpolates the coordinate
+  int               m_found_on_proc;  ///< Processor that interpolates the coordinate
+  std::vector<Uint> m_points;         ///< Dictionary points to interpolate from
+  std::vector<Real> m_weights;        ///< Interpolation weights of m_points
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,221 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "common/Core.hpp"
+#include "common/EventHandler.hpp"
+#include "common/Builder.hpp"
+#include "common/PropertyList.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "common/XML/SignalOptions.hpp"
+
+#include "solver/actions/ProbeSet.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/PointInterpolator.hpp"
+#include "mesh/Tags.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+using namespace common;
+using namespace common::XML;
+using namespace mesh;
+
+common::ComponentBuilder < ProbeSet, common::Action, solver::actions::LibActions > ProbeSet_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ProbeSet::ProbeSet( const std::string& name  ) :
+  common::Action(name),
+  m_located(false)
+{
+  mark_basic();
+
+  properties()["brief"] = std::string("Set of probes to interpolate field values to many coordinates");
+  std::string description =
+      "Configure the coordinates and dictionary, and the probe set will interpolate all fields\n"
+      "to all coordinates, collecting the values in the table \"values\" on the root processor";
+  properties()["description"] = description;
+
+  options().add("coordinates",std::vector<Real>())
+      .description("Coordinates to interpolate fields to, one coordinate after the other")
+      .pretty_name("Coordinates")
+      .mark_basic()
+      .attach_trigger( boost::bind( &ProbeSet::invalidate, this ) );
+
+  options().add("dict",m_dict)
+      .description("Dictionary that will be probed")
+      .pretty_name("Dictionary")
+      .mark_basic()
+      .link_to(&m_dict)
+      .attach_trigger( boost::bind( &ProbeSet::configure_point_interpolator, this ) );
+
+  m_point_interpolator = create_static_component<PointInterpolator>("point_interpolator");
+  m_values = create_static_component< Table<Real> >("values");
+
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_loaded(), this, &ProbeSet::on_mesh_modified_event);
+  Core::instance().event_handler().connect_to_event(mesh::Tags::event_mesh_changed(), this, &ProbeSet::on_mesh_modified_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ProbeSet::~ProbeSet() {}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ProbeSet::configure_point_interpolator()
+{
+  m_point_interpolator->options().set("dict",m_dict);
+  invalidate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ProbeSet::on_mesh_modified_event(SignalArgs& args)
+{
+  if ( is_null(m_dict) )
+    return;
+
+  SignalOptions options(args);
+  const std::string mesh_path = options.value<URI>("mesh_uri").path();
+  if ( boost::algorithm::starts_with(m_dict->uri().path(), mesh_path+"/") )
+    invalidate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint ProbeSet::nb_probes() const
+{
+  if ( is_null(m_dict) )
+    return 0;
+  return options().value< std::vector<Real> >("coordinates").size() / m_dict->coordinates().row_size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ProbeSet::locate()
+{
+  const std::vector<Real> coordinates = options().value< std::vector<Real> >("coordinates");
+  const Uint dim = m_dict->coordinates().row_size();
+  if (coordinates.size() % dim != 0)
+    throw BadValue(FromHere(), "Option \"coordinates\" of "+uri().string()+" must contain "+to_str(dim)+" values per coordinate");
+  const Uint nb_probes = coordinates.size() / dim;
+
+  // Locate all coordinates at once
+  std::vector<Uint> offsets;
+  std::vector<Uint> points;
+  std::vector<Real> weights;
+  m_point_interpolator->compute_storage(coordinates,dim,offsets,points,weights);
+
+  // The processor with the highest rank interpolates a coordinate found in the overlap
+  const int rank = PE::Comm::instance().rank();
+  std::vector<int> found_on_proc(nb_probes);
+  for (Uint p=0; p<nb_probes; ++p)
+    found_on_proc[p] = offsets[p+1] > offsets[p] ? rank : -1;
+  if (PE::Comm::instance().is_active() && nb_probes)
+    PE::Comm::instance().all_reduce(PE::max(), &found_on_proc[0], nb_probes, &found_on_proc[0]);
+
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1u;
+  m_interpolation.clear();
+  m_nb_owned.assign(nb_procs,0);
+  for (Uint p=0; p<nb_probes; ++p)
+  {
+    if (found_on_proc[p]<0)
+    {
+      std::vector<Real> coord(coordinates.begin()+p*dim,coordinates.begin()+(p+1)*dim);
+      throw SetupError(FromHere(),"Cannot probe: coordinate ("+to_str(coord)+") lies outside the domain");
+    }
+    ++m_nb_owned[found_on_proc[p]];
+    if (found_on_proc[p] == rank)
+      m_interpolation.add_row(&points[offsets[p]],&weights[offsets[p]],offsets[p+1]-offsets[p]);
+  }
+
+  // Every processor sends its probes in increasing order, so the root
+  // receives them sorted by processor first
+  m_gathered_order.clear();
+  m_gathered_order.reserve(nb_probes);
+  for (Uint proc=0; proc<nb_procs; ++proc)
+    for (Uint p=0; p<nb_probes; ++p)
+      if (found_on_proc[p] == static_cast<int>(proc))
+        m_gathered_order.push_back(p);
+
+  m_located = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ProbeSet::execute()
+{
+  if ( is_null(m_dict) )
+    throw SetupError(FromHere(), "Option \"dict\" was not configured in "+uri().string());
+
+  if ( !m_located )
+    locate();
+
+  // Interpolate all fields to the owned probes, field after field for every probe
+  Uint nb_values = 0;
+  boost_foreach (const Handle<Field>& field, m_dict->fields())
+    nb_values += field->row_size();
+
+  const Uint nb_owned = m_interpolation.nb_rows();
+  std::vector<Real> send(std::max(nb_owned*nb_values,1u));
+  std::vector<Real> interpolated;
+  Uint field_offset = 0;
+  boost_foreach (const Handle<Field>& field, m_dict->fields())
+  {
+    std::vector<Uint> vars(field->row_size());
+    for (Uint v=0; v<vars.size(); ++v)
+      vars[v] = v;
+    m_interpolation.multiply(*field,vars,interpolated);
+    for (Uint p=0; p<nb_owned; ++p)
+      for (Uint v=0; v<vars.size(); ++v)
+        send[p*nb_values+field_offset+v] = interpolated[p*vars.size()+v];
+    field_offset += vars.size();
+  }
+
+  // Collect all probes on the root processor
+  const Uint nb_probes = m_gathered_order.size();
+  std::vector<Real> received(std::max(nb_probes*nb_values,1u));
+  if (PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    PE::Comm::instance().gather(&send[0],nb_owned,&received[0],&m_nb_owned[0],0,nb_values);
+  else
+    received.swap(send);
+
+  if (PE::Comm::instance().rank() == 0)
+  {
+    m_values->set_row_size(nb_values);
+    m_values->resize(nb_probes);
+    for (Uint r=0; r<nb_probes; ++r)
+    {
+      Table<Real>::Row row = m_values->array()[m_gathered_order[r]];
+      for (Uint v=0; v<nb_values; ++v)
+        row[v] = received[r*nb_values+v];
+    }
+  }
+
+  // Do all post-processing actions
+  boost_foreach (common::Action& action, find_components<common::Action>(*this))
+  {
+    action.execute();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
@@ -0,0 +1,89 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ProbeSet_hpp
+#define cf3_solver_actions_ProbeSet_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Action.hpp"
+#include "common/Table_fwd.hpp"
+
+#include "mesh/InterpolationMatrix.hpp"
+
+#include "solver/actions/LibActions.hpp"
+
+namespace cf3 {
+namespace mesh { class Dictionary; class PointInterpolator; }
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Set of probes, interpolating field values to many coordinates at once
+///
+/// All coordinates are located together the first time the set is executed,
+/// and again only when the coordinates, the dictionary or its mesh change.
+/// Every execution interpolates all fields of the dictionary on the processors
+/// owning the probes, and collects the values on the root processor in one
+/// gather. Row p of the table "values" then holds the values of all fields at
+/// coordinate p, field after field in the order of the dictionary.
+/// Actions added as child are executed after the probes are sampled.
+class solver_actions_API ProbeSet : public common::Action {
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  ProbeSet ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ProbeSet();
+
+  /// Get the class name
+  static std::string type_name () { return "ProbeSet"; }
+
+  virtual void execute();
+
+  /// @brief Number of probes
+  Uint nb_probes() const;
+
+  /// @brief Probed values, only filled on the root processor
+  const common::Table<Real>& values() const { return *m_values; }
+
+private: // functions
+
+  /// @brief Configure the point interpolator
+  void configure_point_interpolator();
+
+  /// @brief Find the owning processors and interpolation weights of all coordinates
+  void locate();
+
+  /// @brief Locate the coordinates again on the next execution
+  void invalidate() { m_located = false; }
+
+  void on_mesh_modified_event(common::SignalArgs& args);
+
+private: // data
+
+  Handle<mesh::Dictionary>        m_dict;                ///< Dictionary to interpolate
+  Handle<mesh::PointInterpolator> m_point_interpolator;  ///< Interpolator for the coordinates
+  Handle< common::Table<Real> >   m_values;              ///< Probed values, one row per coordinate
+
+  bool                    m_located;         ///< If the data below is valid for the current coordinates
+  mesh::InterpolationMatrix m_interpolation; ///< Interpolation of the probes owned by this processor
+  std::vector<int>        m_nb_owned;        ///< Number of probes owned by each processor
+  std::vector<Uint>       m_gathered_order;  ///< Probe of every gathered row, in the order of the processors
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_solver_actions_ProbeSet_hpp
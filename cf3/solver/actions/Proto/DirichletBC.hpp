@@ -30,10 +30,11 @@ struct DirichletBCTag
 /// Used to create placeholders for a Dirichlet condition
 typedef LSSWrapper<DirichletBCTag> DirichletBC;
 
-/// Helper function for assignment
+/// Helper function for assignment. The conditions are queued in the LSS and applied in bulk,
+/// once the node loop is done and the system is accessed again
 inline void assign_dirichlet(math::LSS::System& lss, const Real new_value, const Real old_value, const Uint node_idx, const Uint offset)
 {
-  lss.dirichlet(node_idx, offset, new_value - old_value);
+  lss.queue_dirichlet(node_idx, offset, new_value - old_value);
 }
 
 /// Overload for vector types
@@ -41,7 +42,7 @@ template<typename NewT, typename OldT>
 inline void assign_dirichlet(math::LSS::System& lss, const NewT& new_value, const OldT& old_value, const Uint node_idx, const Uint offset)
 {
   for(Uint i = 0; i != OldT::RowsAtCompileTime; ++i)
-    lss.dirichlet(node_idx, offset+i, new_value[i] - old_value[i]);
+    lss.queue_dirichlet(node_idx, offset+i, new_value[i] - old_value[i]);
 }
 
 /// Sets whole-variable dirichlet BC, allowing the use of a complete vector as value
@@ -18,6 +18,8 @@ option( CF3_ENABLE_SANDBOX            "Enable build of sandbox projects"
 
 option( CF3_ENABLE_VECTORIZATION      "Enable floating point vectorization"            ON  )
 
+option( CF3_ENABLE_OPENMP             "Enable OpenMP threading (if available)"         OFF )
+
 option( CF3_ENABLE_GPU                "Enable GPU computing    (if available)"         OFF )
 
 option( CF3_ENABLE_CUDA               "Enable CUDA for GPGPU   (if available)"         ON  )
@@ -27,6 +29,8 @@ option( CF3_ENABLE_TCMALLOC           "Google tcmalloc (can be faster, but buggy
 
 option( CF3_ENABLE_STDDEBUG           "Enable debug of STL code"                       OFF )
 
+option( CF3_ENABLE_HASHED_GLB_TO_LOC  "Use a hash map for the global to local index map of dictionaries" ON )
+
 set( CF3_EXTRA_DEFINES "" CACHE STRING "Extra defines or undefines to pass (examples: -DNDEBUG or -UNDEBUG)" )
 
 # precision for real numbers
@@ -87,11 +87,26 @@ find_package(Parmetis)        # parallel domain decomposition
 find_package(Zoltan)          # parallel and serial domain decomposition using parmetis or pt-scotch
 find_package(Curl)            # curl downloads files on the fly
 find_package(CGNS)            # CGNS library
+find_package(LZ4)             # fast file compression
 find_package(SuperLU)         # SuperLU sparse sirect solver
 find_package(Trilinos)        # Trilinos sparse matrix library
 find_package(Gnuplot QUIET)   # Find gnuplot executable
 coolfluid_set_package(PACKAGE Gnuplot DESCRIPTION "Gnuplot executable")
 
+# openmp support, shared memory threading inside the mpi processes
+set( CF3_HAVE_OPENMP OFF CACHE INTERNAL "OpenMP threading available" )
+if( CF3_ENABLE_OPENMP )
+  find_package(OpenMP QUIET)
+  if( OPENMP_FOUND )
+    set( CF3_HAVE_OPENMP ON CACHE INTERNAL "OpenMP threading available" )
+    set( CMAKE_C_FLAGS   "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}" )
+    set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}" )
+  endif()
+  coolfluid_log_file( "OPENMP_FOUND: [${OPENMP_FOUND}]" )
+  coolfluid_log_file( "  OpenMP_CXX_FLAGS: [${OpenMP_CXX_FLAGS}]" )
+  coolfluid_set_feature( OpenMP ${OPENMP_FOUND} "shared memory threading" )
+endif()
+
 # opencl support
 if( CF3_ENABLE_OPENCL AND CF3_ENABLE_GPU )
   find_package(OpenCL)
@@ -0,0 +1,34 @@
+# this module looks for the LZ4 compression library
+# it will define the following values
+#
+# Needs environmental variables
+#   LZ4_HOME
+# Sets
+#   LZ4_INCLUDE_DIRS
+#   LZ4_LIBRARIES
+#   CF3_HAVE_LZ4
+#
+
+option( CF3_SKIP_LZ4 "Skip search for LZ4 library" OFF )
+
+    coolfluid_set_trial_include_path("") # clear include search path
+    coolfluid_set_trial_library_path("") # clear library search path
+
+    coolfluid_add_trial_include_path( ${LZ4_HOME}/include )
+    coolfluid_add_trial_include_path( $ENV{LZ4_HOME}/include )
+
+    find_path( LZ4_INCLUDE_DIRS lz4.h PATHS ${TRIAL_INCLUDE_PATHS}  NO_DEFAULT_PATH )
+    find_path( LZ4_INCLUDE_DIRS lz4.h )
+
+    coolfluid_add_trial_library_path(${LZ4_HOME}/lib )
+    coolfluid_add_trial_library_path($ENV{LZ4_HOME}/lib)
+
+    find_library(LZ4_LIBRARIES lz4  PATHS  ${TRIAL_LIBRARY_PATHS}  NO_DEFAULT_PATH)
+    find_library(LZ4_LIBRARIES lz4 )
+
+coolfluid_set_package( PACKAGE LZ4
+                       DESCRIPTION "fast file compression"
+                       URL "http://lz4.github.io/lz4"
+                       PURPOSE "For LZ4 compressed VTK XML output"
+                       TYPE OPTIONAL
+                       VARS LZ4_INCLUDE_DIRS LZ4_LIBRARIES )
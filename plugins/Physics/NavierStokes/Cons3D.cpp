@@ -28,6 +28,70 @@ Cons3D::~Cons3D() {}
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+void Cons3D::compute_fluxes_batch(const ConstRowBlock& sols,
+                                  const ConstRowBlock& directions,
+                                  physics::Properties& physp,
+                                  RealMatrix& fluxes,
+                                  RealMatrix& wave_speeds)
+{
+  const MODEL::Properties& p = static_cast<const MODEL::Properties&>( physp );
+  const Uint nb_states = sols.rows();
+  cf3_assert(sols.cols() == MODEL::_neqs);
+  cf3_assert(directions.rows() == nb_states && directions.cols() == MODEL::_ndim);
+
+  const Real gamma = p.gamma;
+  const Real gamma_minus_1 = p.gamma_minus_1;
+
+  fluxes.resize(nb_states, MODEL::_neqs);
+  wave_speeds.resize(nb_states, MODEL::_neqs);
+
+  // The pressure check is deferred until after the loop, so the loop body has no branches
+  Uint nb_invalid = 0;
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    const Real rho  = sols(i,Rho );
+    const Real rhou = sols(i,RhoU);
+    const Real rhov = sols(i,RhoV);
+    const Real rhow = sols(i,RhoW);
+    const Real rhoE = sols(i,RhoE);
+
+    const Real inv_rho = 1. / rho;
+    const Real u = rhou * inv_rho;
+    const Real v = rhov * inv_rho;
+    const Real w = rhow * inv_rho;
+    const Real P = gamma_minus_1 * ( rhoE - 0.5 * rho * (u*u + v*v + w*w) );
+    nb_invalid += P <= 0.;
+
+    const Real RT = P * inv_rho;
+    const Real H = rhoE * inv_rho + RT;
+    const Real a = sqrt( gamma * RT );
+
+    const Real nx = directions(i,XX);
+    const Real ny = directions(i,YY);
+    const Real nz = directions(i,ZZ);
+    const Real rhoum = rhou * nx + rhov * ny + rhow * nz;
+    const Real um = u * nx + v * ny + w * nz;
+
+    fluxes(i,0) = rhoum;
+    fluxes(i,1) = rhoum * u + P*nx;
+    fluxes(i,2) = rhoum * v + P*ny;
+    fluxes(i,3) = rhoum * w + P*nz;
+    fluxes(i,4) = rhoum * H;
+
+    wave_speeds(i,0) = um;
+    wave_speeds(i,1) = um;
+    wave_speeds(i,2) = um;
+    wave_speeds(i,3) = um + a;
+    wave_speeds(i,4) = um - a;
+  }
+
+  if(nb_invalid != 0)
+    throw common::FailedToConverge( FromHere(), "Pressure is negative in " + common::to_str(nb_invalid)
+                                    + " of " + common::to_str(nb_states) + " states" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
 } // NavierStokes
 } // physics
 } // cf3
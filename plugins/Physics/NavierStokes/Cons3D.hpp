@@ -49,6 +49,14 @@ public: // functions
   /// Get the class name
   static std::string type_name () { return "Cons3D"; }
 
+  /// compute the fluxes and eigen values for a block of states in a single pass,
+  /// without filling a full set of properties for each state
+  virtual void compute_fluxes_batch (const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds);
+
   /// compute physical properties
   template < typename CV, typename SV, typename GM >
   static void compute_properties ( const CV& coord,
@@ -104,7 +104,7 @@ public: // functions
   virtual std::auto_ptr<physics::Properties> create_properties()
   {
     std::auto_ptr<physics::Properties> props( new NavierStokes3D::Properties() );
-    set_constants( static_cast<NavierStokes3D::Properties&>( *props ) );
+    set_gas_constants( static_cast<NavierStokes3D::Properties&>( *props ) );
     return props;
   }
 
@@ -116,15 +116,15 @@ public: // functions
 
   //@} END INTERFACE
 
-private:
-
-  void set_constants(NavierStokes3D::Properties& props)
+  void set_gas_constants(NavierStokes3D::Properties& props)
   {
     props.gamma = m_gamma;
     props.gamma_minus_1 = m_gamma - 1.;
     props.R = m_R;
   }
 
+private:
+
   Real m_gamma;
   Real m_R;
 
@@ -45,6 +45,14 @@ public: // functions
   /// Get the class name
   static std::string type_name () { return "Prim2D"; }
 
+  /// compute the fluxes and eigen values for a block of states in a single pass,
+  /// without filling a full set of properties for each state
+  virtual void compute_fluxes_batch (const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds);
+
   /// compute physical properties
   template < typename CV, typename SV, typename GM >
   static void compute_properties ( const CV& coord,
@@ -116,7 +124,15 @@ public: // functions
   static void flux( const MODEL::Properties& p,
                     FM& flux)
   {
-    throw common::NotImplemented(FromHere(), "flux not implemented for Prim2D");
+    flux(0,XX) = p.rhou;              // rho.u
+    flux(1,XX) = p.rhou * p.u + p.P;  // rho.u^2 + P
+    flux(2,XX) = p.rhou * p.v;        // rho.u.v
+    flux(3,XX) = p.rhou * p.H;        // rho.u.H
+
+    flux(0,YY) = p.rhov;              // rho.v
+    flux(1,YY) = p.rhov * p.u;        // rho.v.u
+    flux(2,YY) = p.rhov * p.v + p.P;  // rho.v^2 + P
+    flux(3,YY) = p.rhov * p.H;        // rho.v.H
   }
 
   /// compute the physical flux
@@ -125,9 +141,14 @@ public: // functions
                     const GV& direction,
                     FM& flux)
   {
-    throw common::NotImplemented(FromHere(), "flux not implemented for Prim2D");
-  }
+    const Real rhoum = p.rhou * direction[XX]
+                     + p.rhov * direction[YY];
 
+    flux[0] = rhoum;
+    flux[1] = rhoum * p.u + p.P*direction[XX];
+    flux[2] = rhoum * p.v + p.P*direction[YY];
+    flux[3] = rhoum * p.H;
+  }
 
   /// compute the eigen values of the flux jacobians
   template < typename GV, typename EV >
@@ -135,7 +156,13 @@ public: // functions
                                          const GV& direction,
                                          EV& Dv)
   {
-    throw common::NotImplemented(FromHere(), "flux_jacobian_eigen_values not implemented for Prim2D");
+    const Real um = p.u * direction[XX]
+                  + p.v * direction[YY];
+
+    Dv[0] = um;
+    Dv[1] = um;
+    Dv[2] = um + p.a;
+    Dv[3] = um - p.a;
   }
 
   /// compute the eigen values of the flux jacobians
@@ -146,7 +173,15 @@ public: // functions
                                          OP& op )
 
   {
-    throw common::NotImplemented(FromHere(), "flux_jacobian_eigen_values not implemented for Prim2D");
+    const Real um = p.u * direction[XX]
+                  + p.v * direction[YY];
+
+    const Real op_um = op(um);
+
+    Dv[0] = op_um;
+    Dv[1] = op_um;
+    Dv[2] = op_um + p.a;
+    Dv[3] = op_um - p.a;
   }
 
   /// decompose the eigen structure of the flux jacobians projected on the gradients
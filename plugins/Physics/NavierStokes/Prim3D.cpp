@@ -28,6 +28,64 @@ Prim3D::~Prim3D() {}
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+void Prim3D::compute_fluxes_batch(const ConstRowBlock& sols,
+                                  const ConstRowBlock& directions,
+                                  physics::Properties& physp,
+                                  RealMatrix& fluxes,
+                                  RealMatrix& wave_speeds)
+{
+  const MODEL::Properties& p = static_cast<const MODEL::Properties&>( physp );
+  const Uint nb_states = sols.rows();
+  cf3_assert(sols.cols() == MODEL::_neqs);
+  cf3_assert(directions.rows() == nb_states && directions.cols() == MODEL::_ndim);
+
+  const Real gamma = p.gamma;
+  const Real gamma_minus_1 = p.gamma_minus_1;
+
+  fluxes.resize(nb_states, MODEL::_neqs);
+  wave_speeds.resize(nb_states, MODEL::_neqs);
+
+  // The pressure check is deferred until after the loop, so the loop body has no branches
+  Uint nb_invalid = 0;
+  for(Uint i = 0; i != nb_states; ++i)
+  {
+    const Real rho = sols(i,Rho);
+    const Real u   = sols(i,U);
+    const Real v   = sols(i,V);
+    const Real w   = sols(i,W);
+    const Real P   = sols(i,Prim3D::P);
+    nb_invalid += P <= 0.;
+
+    const Real RT = P / rho;
+    const Real H = RT*gamma/gamma_minus_1 + 0.5*(u*u + v*v + w*w);
+    const Real a = sqrt( gamma * RT );
+
+    const Real nx = directions(i,XX);
+    const Real ny = directions(i,YY);
+    const Real nz = directions(i,ZZ);
+    const Real rhoum = rho*u * nx + rho*v * ny + rho*w * nz;
+    const Real um = u * nx + v * ny + w * nz;
+
+    fluxes(i,0) = rhoum;
+    fluxes(i,1) = rhoum * u + P*nx;
+    fluxes(i,2) = rhoum * v + P*ny;
+    fluxes(i,3) = rhoum * w + P*nz;
+    fluxes(i,4) = rhoum * H;
+
+    wave_speeds(i,0) = um;
+    wave_speeds(i,1) = um;
+    wave_speeds(i,2) = um;
+    wave_speeds(i,3) = um + a;
+    wave_speeds(i,4) = um - a;
+  }
+
+  if(nb_invalid != 0)
+    throw common::FailedToConverge( FromHere(), "Pressure is negative in " + common::to_str(nb_invalid)
+                                    + " of " + common::to_str(nb_states) + " states" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
 } // NavierStokes
 } // physics
 } // cf3
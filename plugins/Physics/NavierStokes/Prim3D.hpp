@@ -45,6 +45,14 @@ public: // functions
   /// Get the class name
   static std::string type_name () { return "Prim3D"; }
 
+  /// compute the fluxes and eigen values for a block of states in a single pass,
+  /// without filling a full set of properties for each state
+  virtual void compute_fluxes_batch (const ConstRowBlock& sols,
+                                     const ConstRowBlock& directions,
+                                     physics::Properties& p,
+                                     RealMatrix& fluxes,
+                                     RealMatrix& wave_speeds);
+
   /// compute physical properties
   template < typename CV, typename SV, typename GM >
   static void compute_properties ( const CV& coord,
@@ -122,7 +130,23 @@ public: // functions
   static void flux( const MODEL::Properties& p,
                     FM& flux)
   {
-    throw common::NotImplemented(FromHere(), "flux not implemented for Prim3D");
+    flux(0,XX) = p.rhou;                       // rho.u
+    flux(1,XX) = p.rhou * p.u + p.P;           // rho.u^2 + P
+    flux(2,XX) = p.rhou * p.rhov * p.inv_rho;  // rho.u.v
+    flux(3,XX) = p.rhou * p.rhow * p.inv_rho;  // rho.u.w
+    flux(4,XX) = p.rhou * p.H;                 // rho.u.H
+
+    flux(0,YY) = p.rhov;                       // rho.v
+    flux(1,YY) = p.rhov * p.rhou * p.inv_rho;  // rho.v.u
+    flux(2,YY) = p.rhov * p.v + p.P;           // rho.v^2 + P
+    flux(3,YY) = p.rhov * p.rhow * p.inv_rho;  // rho.v.w
+    flux(4,YY) = p.rhov * p.H;                 // rho.v.H
+
+    flux(0,ZZ) = p.rhow;                       // rho.w
+    flux(1,ZZ) = p.rhow * p.rhou * p.inv_rho;  // rho.w.u
+    flux(2,ZZ) = p.rhow * p.rhov * p.inv_rho;  // rho.w.v
+    flux(3,ZZ) = p.rhow * p.w + p.P;           // rho.w^2 + P
+    flux(4,ZZ) = p.rhow * p.H;                 // rho.w.H
   }
 
   /// compute the physical flux
@@ -131,17 +155,32 @@ public: // functions
                     const GV& direction,
                     FM& flux)
   {
-    throw common::NotImplemented(FromHere(), "flux not implemented for Prim3D");
+    const Real rhoum = p.rhou * direction[XX]
+                     + p.rhov * direction[YY]
+                     + p.rhow * direction[ZZ];
+
+    flux[0] = rhoum;
+    flux[1] = rhoum * p.u + p.P*direction[XX];
+    flux[2] = rhoum * p.v + p.P*direction[YY];
+    flux[3] = rhoum * p.w + p.P*direction[ZZ];
+    flux[4] = rhoum * p.H;
   }
 
-
   /// compute the eigen values of the flux jacobians
   template < typename GV, typename EV >
   static void flux_jacobian_eigen_values(const MODEL::Properties& p,
                                          const GV& direction,
                                          EV& Dv)
   {
-    throw common::NotImplemented(FromHere(), "flux_jacobian_eigen_values not implemented for Prim3D");
+    const Real um = p.u * direction[XX]
+                  + p.v * direction[YY]
+                  + p.w * direction[ZZ];
+
+    Dv[0] = um;
+    Dv[1] = um;
+    Dv[2] = um;
+    Dv[3] = um + p.a;
+    Dv[4] = um - p.a;
   }
 
   /// compute the eigen values of the flux jacobians
@@ -152,7 +191,17 @@ public: // functions
                                          OP& op )
 
   {
-    throw common::NotImplemented(FromHere(), "flux_jacobian_eigen_values not implemented for Prim3D");
+    const Real um = p.u * direction[XX]
+                  + p.v * direction[YY]
+                  + p.w * direction[ZZ];
+
+    const Real op_um = op(um);
+
+    Dv[0] = op_um;
+    Dv[1] = op_um;
+    Dv[2] = op_um;
+    Dv[3] = op_um + p.a;
+    Dv[4] = op_um - p.a;
   }
 
   /// decompose the eigen structure of the flux jacobians projected on the gradients
@@ -0,0 +1,155 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the batched interface of cf3::physics::NavierStokes variables"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+
+#include "NavierStokes/Cons1D.hpp"
+#include "NavierStokes/Cons2D.hpp"
+#include "NavierStokes/Cons3D.hpp"
+#include "NavierStokes/Prim2D.hpp"
+#include "NavierStokes/Prim3D.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::physics;
+using namespace cf3::physics::NavierStokes;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct BatchedVariablesFixture
+{
+  /// Create nb_states states with varying density, velocity and pressure, in conservative or primitive form
+  void create_states(const Uint nb_states, const Uint dim, const bool conservative, RealMatrix& sols, RealMatrix& coords, RealMatrix& directions)
+  {
+    const Real gamma = 1.4;
+    sols.resize(nb_states, dim+2);
+    coords.resize(nb_states, dim);
+    directions.resize(nb_states, dim);
+    for(Uint i = 0; i != nb_states; ++i)
+    {
+      const Real rho = 1. + 0.1*i;
+      const Real P = 101300. - 100.*i;
+      Real vel2 = 0.;
+      sols(i, 0) = rho;
+      for(Uint d = 0; d != dim; ++d)
+      {
+        const Real u = 50. - 3.*i + 10.*d;
+        vel2 += u*u;
+        sols(i, 1+d) = conservative ? rho*u : u;
+        coords(i, d) = 0.5*i + d;
+        directions(i, d) = 1. + d*0.2*i;
+      }
+      sols(i, dim+1) = conservative ? P/(gamma-1.) + 0.5*rho*vel2 : P;
+      directions.row(i).normalize();
+    }
+  }
+
+  /// Compare the batched interface of the given variables with the single state interface
+  void check_batched(const std::string& model_builder, const std::string& vars_name, const bool conservative)
+  {
+    Component& root = Core::instance().root();
+    Handle<PhysModel> model( root.create_component(vars_name + "_model", model_builder) );
+    Handle<Variables> vars( model->create_variables(vars_name, "solution") );
+
+    const Uint dim = model->ndim();
+    const Uint neqs = model->neqs();
+    const Uint nb_states = 20;
+    RealMatrix sols, coords, directions;
+    create_states(nb_states, dim, conservative, sols, coords, directions);
+
+    const ConstRowBlock sols_block(sols.data(), sols.rows(), sols.cols());
+    const ConstRowBlock coords_block(coords.data(), coords.rows(), coords.cols());
+    const ConstRowBlock directions_block(directions.data(), directions.rows(), directions.cols());
+
+    // Batched fluxes and wave speeds
+    std::auto_ptr<Properties> work_props = model->create_properties();
+    RealMatrix fluxes, wave_speeds;
+    vars->compute_fluxes_batch(sols_block, directions_block, *work_props, fluxes, wave_speeds);
+    BOOST_CHECK_EQUAL(fluxes.rows(), nb_states);
+    BOOST_CHECK_EQUAL(wave_speeds.rows(), nb_states);
+
+    // Batched properties
+    PropertiesBlock props;
+    for(Uint i = 0; i != nb_states; ++i)
+      props.push_back(model->create_properties().release());
+    vars->compute_properties_batch(coords_block, sols_block, props);
+
+    // Reference using the single state interface
+    std::auto_ptr<Properties> p = model->create_properties();
+    RealVector coord(dim), direction(dim), sol(neqs), flux(neqs), evalues(neqs), batched_flux(neqs), vars_from_props(neqs);
+    RealMatrix grad_sol(neqs, dim);
+    grad_sol.setZero();
+    for(Uint i = 0; i != nb_states; ++i)
+    {
+      coord = coords.row(i).transpose();
+      sol = sols.row(i).transpose();
+      direction = directions.row(i).transpose();
+      vars->compute_properties(coord, sol, grad_sol, *p);
+      vars->flux(*p, direction, flux);
+      vars->flux_jacobian_eigen_values(*p, direction, evalues);
+
+      vars->flux(props[i], direction, batched_flux);
+      vars->compute_variables(props[i], vars_from_props);
+
+      for(Uint eq = 0; eq != neqs; ++eq)
+      {
+        BOOST_CHECK_CLOSE(fluxes(i, eq), flux[eq], 1e-10);
+        BOOST_CHECK_CLOSE(wave_speeds(i, eq), evalues[eq], 1e-10);
+        BOOST_CHECK_CLOSE(batched_flux[eq], flux[eq], 1e-10);
+        BOOST_CHECK_CLOSE(vars_from_props[eq], sol[eq], 1e-10);
+      }
+    }
+
+    // A state with negative pressure must be rejected
+    sols(nb_states/2, 0) = 1.;
+    for(Uint d = 0; d != dim; ++d)
+      sols(nb_states/2, 1+d) = conservative ? 1000. : 1.;
+    sols(nb_states/2, dim+1) = conservative ? 1. : -1.;
+    BOOST_CHECK_THROW(vars->compute_fluxes_batch(sols_block, directions_block, *work_props, fluxes, wave_speeds), FailedToConverge);
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE( NavierStokes_Batched_Suite, BatchedVariablesFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Cons1D_batched )
+{
+  check_batched("cf3.physics.NavierStokes.NavierStokes1D", "Cons1D", true);
+}
+
+BOOST_AUTO_TEST_CASE( Cons2D_batched )
+{
+  check_batched("cf3.physics.NavierStokes.NavierStokes2D", "Cons2D", true);
+}
+
+BOOST_AUTO_TEST_CASE( Prim2D_batched )
+{
+  check_batched("cf3.physics.NavierStokes.NavierStokes2D", "Prim2D", false);
+}
+
+BOOST_AUTO_TEST_CASE( Cons3D_batched )
+{
+  check_batched("cf3.physics.NavierStokes.NavierStokes3D", "Cons3D", true);
+}
+
+BOOST_AUTO_TEST_CASE( Prim3D_batched )
+{
+  check_batched("cf3.physics.NavierStokes.NavierStokes3D", "Prim3D", false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
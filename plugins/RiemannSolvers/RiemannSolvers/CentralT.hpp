@@ -0,0 +1,109 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RiemannSolvers_CentralT_hpp
+#define cf3_RiemannSolvers_CentralT_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/bind.hpp>
+
+#include "common/OptionList.hpp"
+
+#include "RiemannSolvers/RiemannSolvers/RiemannSolverT.hpp"
+
+namespace cf3 {
+namespace RiemannSolvers {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Central flux with the solution variables PHYS known at compile time.
+/// Computes the same flux as Central, but without the virtual Variables calls and dynamic storage.
+template < typename PHYS >
+class CentralT : public RiemannSolverT< PHYS::MODEL::_ndim, PHYS::MODEL::_neqs >
+{
+public: // typedefs
+
+  typedef RiemannSolverT< PHYS::MODEL::_ndim, PHYS::MODEL::_neqs > BaseT;
+  typedef typename BaseT::GeoV GeoV;
+  typedef typename BaseT::SolV SolV;
+  typedef typename PHYS::MODEL MODEL;
+
+public: // functions
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /// Contructor
+  /// @param name of the component
+  CentralT ( const std::string& name ) : BaseT(name)
+  {
+    dummy_coords.setZero();
+    dummy_grads.setZero();
+    this->options().option("physical_model").attach_trigger( boost::bind( &CentralT::trigger_physical_model, this) );
+  }
+
+  /// Virtual destructor
+  virtual ~CentralT() {}
+
+  /// type name
+  static std::string type_name() { return "Central" + PHYS::type_name(); }
+
+  using BaseT::compute_interface_fluxes;
+
+  virtual void compute_interface_fluxes(const Uint nb_faces, const SolV left[], const SolV right[], const GeoV normals[],
+                                        SolV fluxes[], SolV wave_speeds[])
+  {
+    for(Uint f = 0; f != nb_faces; ++f)
+    {
+      // Compute left and right properties
+      PHYS::compute_properties(dummy_coords, left[f], dummy_grads, p_left);
+      PHYS::compute_properties(dummy_coords, right[f], dummy_grads, p_right);
+
+      // Wave speeds from the averaged state
+      sol_avg.noalias() = 0.5*(left[f]+right[f]);
+      PHYS::compute_properties(dummy_coords, sol_avg, dummy_grads, p_avg);
+      PHYS::flux_jacobian_eigen_values(p_avg, normals[f], wave_speeds[f]);
+
+      // Compute left and right fluxes
+      PHYS::flux(p_left , normals[f], flux_left);
+      PHYS::flux(p_right, normals[f], flux_right);
+
+      fluxes[f].noalias() = 0.5*(flux_left + flux_right);
+    }
+  }
+
+private:
+
+  void trigger_physical_model()
+  {
+    Handle<MODEL> model(this->m_physical_model);
+    if(is_null(model))
+      throw common::SetupError(FromHere(), "Physical model for " + this->uri().string() + " must be of type " + MODEL::type_name());
+    model->set_gas_constants(p_left);
+    model->set_gas_constants(p_right);
+    model->set_gas_constants(p_avg);
+  }
+
+  typename MODEL::Properties p_left;
+  typename MODEL::Properties p_right;
+  typename MODEL::Properties p_avg;
+
+  typename MODEL::GeoV dummy_coords;
+  typename MODEL::SolM dummy_grads;
+
+  SolV sol_avg;
+  SolV flux_left;
+  SolV flux_right;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RiemannSolvers
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RiemannSolvers_CentralT_hpp
@@ -43,5 +43,30 @@ RiemannSolver::~RiemannSolver()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void RiemannSolver::compute_interface_fluxes(const RealMatrix& left, const RealMatrix& right, const RealMatrix& coords, const RealMatrix& normals,
+                                             RealMatrix& fluxes)
+{
+  const Uint nb_faces = left.rows();
+  cf3_assert(right.rows() == nb_faces);
+  cf3_assert(normals.rows() == nb_faces);
+  fluxes.resize(nb_faces, left.cols());
+
+  RealVector left_state(left.cols()), right_state(right.cols()), normal(normals.cols()), flux(left.cols());
+  // Coordinates are optional, leave them at zero if they are not given for every face
+  RealVector coord = RealVector::Zero(normals.cols());
+  for(Uint f = 0; f != nb_faces; ++f)
+  {
+    left_state = left.row(f).transpose();
+    right_state = right.row(f).transpose();
+    if(coords.rows() == nb_faces)
+      coord = coords.row(f).transpose();
+    normal = normals.row(f).transpose();
+    compute_interface_flux(left_state, right_state, coord, normal, flux);
+    fluxes.row(f) = flux.transpose();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // RiemannSolvers
 } // cf3
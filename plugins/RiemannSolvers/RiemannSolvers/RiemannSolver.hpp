@@ -47,6 +47,12 @@ public: // functions
   virtual void compute_interface_flux(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
                                       RealVector& flux) = 0;
 
+  /// Compute interface fluxes for a batch of faces, with one face per row of each matrix.
+  /// The default implementation calls compute_interface_flux for each face, solvers with a
+  /// fixed-size implementation override it to process the whole batch in one call.
+  virtual void compute_interface_fluxes(const RealMatrix& left, const RealMatrix& right, const RealMatrix& coords, const RealMatrix& normals,
+                                        RealMatrix& fluxes);
+
 protected:
 
   physics::Variables& solution_vars() const { return *m_solution_vars; }
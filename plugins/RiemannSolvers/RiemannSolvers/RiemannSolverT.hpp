@@ -0,0 +1,117 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RiemannSolvers_RiemannSolverT_hpp
+#define cf3_RiemannSolvers_RiemannSolverT_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "RiemannSolvers/RiemannSolvers/RiemannSolver.hpp"
+
+namespace cf3 {
+namespace RiemannSolvers {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Riemann solver with the number of dimensions and equations fixed at compile time.
+/// Derived classes implement the batched compute_interface_fluxes, which works on
+/// fixed-size Eigen vectors, so the work for one face is unrolled and vectorized over
+/// the equations. Faces are still processed one after the other: the batch only
+/// saves the virtual dispatch and the dynamic storage per face.
+/// The dynamic RiemannSolver interface is implemented on top of it.
+template < Uint NDIM, Uint NEQS >
+class RiemannSolverT : public RiemannSolver
+{
+public: // typedefs
+
+  enum { ndim = NDIM }; ///< number of dimensions
+  enum { neqs = NEQS }; ///< number of equations
+
+  typedef Eigen::Matrix<Real, NDIM, 1> GeoV;  ///< type of the normal vector
+  typedef Eigen::Matrix<Real, NEQS, 1> SolV;  ///< type of a state, flux or wave speed vector
+  typedef Eigen::Matrix<Real, NEQS, NEQS> JacM;  ///< type of a flux jacobian or eigenvector matrix
+
+  /// Number of faces that are copied into fixed-size storage at once by the dynamic batch interface
+  enum { batch_size = 32 };
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  RiemannSolverT ( const std::string& name ) : RiemannSolver(name) {}
+
+  /// Virtual destructor
+  virtual ~RiemannSolverT() {}
+
+  /// Get the class name
+  static std::string type_name () { return "RiemannSolverT"; }
+
+  /// Compute the interface fluxes and wave speeds for nb_faces faces at once
+  virtual void compute_interface_fluxes(const Uint nb_faces, const SolV left[], const SolV right[], const GeoV normals[],
+                                        SolV fluxes[], SolV wave_speeds[]) = 0;
+
+  using RiemannSolver::compute_interface_fluxes;
+
+  /// Compute interface flux and wavespeeds, as a batch of one face
+  virtual void compute_interface_flux_and_wavespeeds(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
+                                                     RealVector& flux, RealVector& wave_speeds)
+  {
+    const SolV left_state(left);
+    const SolV right_state(right);
+    const GeoV unit_normal(normal);
+    SolV face_flux, face_wave_speeds;
+    compute_interface_fluxes(1u, &left_state, &right_state, &unit_normal, &face_flux, &face_wave_speeds);
+    flux = face_flux;
+    wave_speeds = face_wave_speeds;
+  }
+
+  /// Compute interface flux, as a batch of one face
+  virtual void compute_interface_flux(const RealVector& left, const RealVector& right, const RealVector& coords, const RealVector& normal,
+                                      RealVector& flux)
+  {
+    RealVector wave_speeds(NEQS);
+    compute_interface_flux_and_wavespeeds(left, right, coords, normal, flux, wave_speeds);
+  }
+
+  /// Compute interface fluxes for a batch of faces stored one per row, copying
+  /// them into fixed-size storage in chunks of batch_size faces
+  virtual void compute_interface_fluxes(const RealMatrix& left, const RealMatrix& right, const RealMatrix& coords, const RealMatrix& normals,
+                                        RealMatrix& fluxes)
+  {
+    const Uint nb_faces = left.rows();
+    cf3_assert(left.cols() == NEQS && right.cols() == NEQS && normals.cols() == NDIM);
+    cf3_assert(right.rows() == nb_faces && normals.rows() == nb_faces);
+    fluxes.resize(nb_faces, NEQS);
+
+    SolV left_states[batch_size], right_states[batch_size], face_fluxes[batch_size], face_wave_speeds[batch_size];
+    GeoV face_normals[batch_size];
+    for(Uint begin = 0; begin < nb_faces; begin += batch_size)
+    {
+      const Uint nb_batch = std::min(static_cast<Uint>(batch_size), nb_faces - begin);
+      for(Uint f = 0; f != nb_batch; ++f)
+      {
+        left_states[f] = left.row(begin+f).transpose();
+        right_states[f] = right.row(begin+f).transpose();
+        face_normals[f] = normals.row(begin+f).transpose();
+      }
+      compute_interface_fluxes(nb_batch, left_states, right_states, face_normals, face_fluxes, face_wave_speeds);
+      for(Uint f = 0; f != nb_batch; ++f)
+        fluxes.row(begin+f) = face_fluxes[f].transpose();
+    }
+  }
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RiemannSolvers
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RiemannSolvers_RiemannSolverT_hpp
@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RiemannSolvers_RoeT_hpp
+#define cf3_RiemannSolvers_RoeT_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/bind.hpp>
+
+#include "common/OptionList.hpp"
+
+#include "RiemannSolvers/RiemannSolvers/RiemannSolverT.hpp"
+
+namespace cf3 {
+namespace RiemannSolvers {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Roe scheme with the solution variables PHYS and Roe variables ROE known at compile time.
+/// Computes the same flux as Roe, but without the virtual Variables calls and dynamic storage.
+template < typename PHYS, typename ROE >
+class RoeT : public RiemannSolverT< PHYS::MODEL::_ndim, PHYS::MODEL::_neqs >
+{
+public: // typedefs
+
+  typedef RiemannSolverT< PHYS::MODEL::_ndim, PHYS::MODEL::_neqs > BaseT;
+  typedef typename BaseT::GeoV GeoV;
+  typedef typename BaseT::SolV SolV;
+  typedef typename BaseT::JacM JacM;
+  typedef typename PHYS::MODEL MODEL;
+
+public: // functions
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /// Contructor
+  /// @param name of the component
+  RoeT ( const std::string& name ) : BaseT(name)
+  {
+    dummy_coords.setZero();
+    dummy_grads.setZero();
+    this->options().option("physical_model").attach_trigger( boost::bind( &RoeT::trigger_physical_model, this) );
+  }
+
+  /// Virtual destructor
+  virtual ~RoeT() {}
+
+  /// type name
+  static std::string type_name() { return "Roe" + PHYS::type_name(); }
+
+  using BaseT::compute_interface_fluxes;
+
+  virtual void compute_interface_fluxes(const Uint nb_faces, const SolV left[], const SolV right[], const GeoV normals[],
+                                        SolV fluxes[], SolV wave_speeds[])
+  {
+    for(Uint f = 0; f != nb_faces; ++f)
+    {
+      // Compute left and right properties
+      PHYS::compute_properties(dummy_coords, left[f], dummy_grads, p_left);
+      PHYS::compute_properties(dummy_coords, right[f], dummy_grads, p_right);
+
+      // Compute the Roe averaged properties
+      // Roe-average = standard average of the Roe-parameter vectors
+      ROE::compute_variables(p_left,  roe_left );
+      ROE::compute_variables(p_right, roe_right);
+      roe_avg.noalias() = 0.5*(roe_left+roe_right);                // Roe-average is result
+      ROE::compute_properties(dummy_coords, roe_avg, dummy_grads, p_avg);
+
+      // Compute absolute jacobian using Roe averaged properties
+      PHYS::flux_jacobian_eigen_structure(p_avg, normals[f], right_eigenvectors, left_eigenvectors, eigenvalues);
+      abs_jacobian.noalias() = right_eigenvectors * eigenvalues.cwiseAbs().asDiagonal() * left_eigenvectors;
+
+      // Compute left and right fluxes
+      PHYS::flux(p_left , normals[f], flux_left);
+      PHYS::flux(p_right, normals[f], flux_right);
+
+      // flux = central flux - upwind flux
+      fluxes[f].noalias() = 0.5*(flux_left + flux_right);
+      fluxes[f].noalias() -= 0.5*abs_jacobian*(right[f]-left[f]);
+      wave_speeds[f] = eigenvalues;
+    }
+  }
+
+private:
+
+  void trigger_physical_model()
+  {
+    Handle<MODEL> model(this->m_physical_model);
+    if(is_null(model))
+      throw common::SetupError(FromHere(), "Physical model for " + this->uri().string() + " must be of type " + MODEL::type_name());
+    model->set_gas_constants(p_left);
+    model->set_gas_constants(p_right);
+    model->set_gas_constants(p_avg);
+  }
+
+  typename MODEL::Properties p_left;
+  typename MODEL::Properties p_right;
+  typename MODEL::Properties p_avg;
+
+  typename MODEL::GeoV dummy_coords;
+  typename MODEL::SolM dummy_grads;
+
+  SolV roe_left;
+  SolV roe_right;
+  SolV roe_avg;
+  SolV flux_left;
+  SolV flux_right;
+  SolV eigenvalues;
+  JacM right_eigenvectors;
+  JacM left_eigenvectors;
+  JacM abs_jacobian;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RiemannSolvers
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RiemannSolvers_RoeT_hpp
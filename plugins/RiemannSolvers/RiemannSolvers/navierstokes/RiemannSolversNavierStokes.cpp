@@ -0,0 +1,35 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+
+#include "RiemannSolvers/navierstokes/RiemannSolversNavierStokes.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace RiemannSolvers {
+namespace navierstokes {
+
+//////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < RoeCons1D, RiemannSolver, LibNavierStokes > RoeCons1D_Builder;
+common::ComponentBuilder < RoeCons2D, RiemannSolver, LibNavierStokes > RoeCons2D_Builder;
+common::ComponentBuilder < RoeCons3D, RiemannSolver, LibNavierStokes > RoeCons3D_Builder;
+
+common::ComponentBuilder < CentralCons1D, RiemannSolver, LibNavierStokes > CentralCons1D_Builder;
+common::ComponentBuilder < CentralCons2D, RiemannSolver, LibNavierStokes > CentralCons2D_Builder;
+common::ComponentBuilder < CentralCons3D, RiemannSolver, LibNavierStokes > CentralCons3D_Builder;
+
+common::ComponentBuilder < LaxFriedrichCons1D, RiemannSolver, LibNavierStokes > LaxFriedrichCons1D_Builder;
+common::ComponentBuilder < LaxFriedrichCons2D, RiemannSolver, LibNavierStokes > LaxFriedrichCons2D_Builder;
+common::ComponentBuilder < LaxFriedrichCons3D, RiemannSolver, LibNavierStokes > LaxFriedrichCons3D_Builder;
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // navierstokes
+} // RiemannSolvers
+} // cf3
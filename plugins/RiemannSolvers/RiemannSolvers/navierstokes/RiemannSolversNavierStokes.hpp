@@ -0,0 +1,54 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RiemannSolvers_navierstokes_RiemannSolversNavierStokes_hpp
+#define cf3_RiemannSolvers_navierstokes_RiemannSolversNavierStokes_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Physics/NavierStokes/Cons1D.hpp"
+#include "Physics/NavierStokes/Cons2D.hpp"
+#include "Physics/NavierStokes/Cons3D.hpp"
+#include "Physics/NavierStokes/Roe1D.hpp"
+#include "Physics/NavierStokes/Roe2D.hpp"
+#include "Physics/NavierStokes/Roe3D.hpp"
+
+#include "RiemannSolvers/RiemannSolvers/RoeT.hpp"
+#include "RiemannSolvers/RiemannSolvers/CentralT.hpp"
+#include "RiemannSolvers/RiemannSolvers/LaxFriedrichT.hpp"
+
+#include "RiemannSolvers/RiemannSolvers/navierstokes/LibNavierStokes.hpp"
+
+namespace cf3 {
+namespace RiemannSolvers {
+namespace navierstokes {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @name Fixed-size Riemann solvers for the conservative Navier-Stokes variables
+//@{
+typedef RoeT< physics::NavierStokes::Cons1D, physics::NavierStokes::Roe1D > RoeCons1D;
+typedef RoeT< physics::NavierStokes::Cons2D, physics::NavierStokes::Roe2D > RoeCons2D;
+typedef RoeT< physics::NavierStokes::Cons3D, physics::NavierStokes::Roe3D > RoeCons3D;
+
+typedef CentralT< physics::NavierStokes::Cons1D > CentralCons1D;
+typedef CentralT< physics::NavierStokes::Cons2D > CentralCons2D;
+typedef CentralT< physics::NavierStokes::Cons3D > CentralCons3D;
+
+typedef LaxFriedrichT< physics::NavierStokes::Cons1D > LaxFriedrichCons1D;
+typedef LaxFriedrichT< physics::NavierStokes::Cons2D > LaxFriedrichCons2D;
+typedef LaxFriedrichT< physics::NavierStokes::Cons3D > LaxFriedrichCons3D;
+//@}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // navierstokes
+} // RiemannSolvers
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RiemannSolvers_navierstokes_RiemannSolversNavierStokes_hpp
@@ -0,0 +1,224 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the fixed-size, batched cf3::RiemannSolvers"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+
+#include "physics/PhysModel.hpp"
+#include "physics/Variables.hpp"
+
+#include "RiemannSolvers/RiemannSolver.hpp"
+#include "RiemannSolvers/navierstokes/RiemannSolversNavierStokes.hpp"
+
+#include "math/Defs.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::RiemannSolvers;
+using namespace cf3::physics;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct BatchedRiemannFixture
+{
+  /// Fill left and right states with a Sod-like pressure jump and some velocity, one face per row
+  void create_states(const Uint nb_faces, const Uint dim, RealMatrix& left, RealMatrix& right, RealMatrix& normals)
+  {
+    const Real g = 1.4;
+    const Uint neqs = dim + 2;
+    left.resize(nb_faces, neqs);
+    right.resize(nb_faces, neqs);
+    normals.resize(nb_faces, dim);
+    for(Uint f = 0; f != nb_faces; ++f)
+    {
+      const Real r_L = 4.696 + 0.01*f;   const Real r_R = 1.408;
+      const Real p_L = 404400;           const Real p_R = 101100 + 10.*f;
+      Real vel2_L = 0., vel2_R = 0.;
+      left(f, 0) = r_L;
+      right(f, 0) = r_R;
+      for(Uint d = 0; d != dim; ++d)
+      {
+        const Real u_L = 10. + d + 0.5*f;
+        const Real u_R = -5. + d;
+        left(f, 1+d) = r_L*u_L;
+        right(f, 1+d) = r_R*u_R;
+        vel2_L += u_L*u_L;
+        vel2_R += u_R*u_R;
+        normals(f, d) = 1. + d*0.3*f;
+      }
+      left(f, neqs-1) = p_L/(g-1.) + 0.5*r_L*vel2_L;
+      right(f, neqs-1) = p_R/(g-1.) + 0.5*r_R*vel2_R;
+      normals.row(f).normalize();
+    }
+  }
+
+  /// Compare the batched fluxes of a fixed-size solver with the dynamic version
+  void check_batched(Component& model, const std::string& physics_builder, const std::string& sol_vars_name, const std::string& dynamic_builder, const std::string& batched_builder, const std::string& roe_vars_name = "")
+  {
+    Handle<PhysModel> physics( model.create_component("navierstokes", physics_builder) );
+    Handle<Variables> sol_vars( physics->create_variables(sol_vars_name, "solution") );
+
+    Handle<RiemannSolver> dynamic( model.create_component("dynamic", dynamic_builder) );
+    dynamic->options().set("physical_model",physics);
+    dynamic->options().set("solution_vars",sol_vars);
+    if(!roe_vars_name.empty())
+    {
+      Handle<Variables> roe_vars( physics->create_variables(roe_vars_name,"roe") );
+      dynamic->options().set("roe_vars",roe_vars);
+    }
+
+    Handle<RiemannSolver> batched( model.create_component("batched", batched_builder) );
+    batched->options().set("physical_model",physics);
+
+    const Uint dim = physics->ndim();
+    const Uint nb_faces = 50;
+    RealMatrix left, right, normals;
+    create_states(nb_faces, dim, left, right, normals);
+
+    RealMatrix batched_fluxes;
+    batched->compute_interface_fluxes(left, right, RealMatrix(), normals, batched_fluxes);
+    BOOST_CHECK_EQUAL(batched_fluxes.rows(), nb_faces);
+
+    RealVector coords(dim); coords.setZero();
+    RealVector flux(physics->neqs());
+    RealVector wave_speeds(physics->neqs()), batched_wave_speeds(physics->neqs());
+    RealVector l(physics->neqs()), r(physics->neqs()), n(dim);
+    const Real tol (0.000001);
+    for(Uint f = 0; f != nb_faces; ++f)
+    {
+      l = left.row(f).transpose();
+      r = right.row(f).transpose();
+      n = normals.row(f).transpose();
+      dynamic->compute_interface_flux_and_wavespeeds(l, r, coords, n, flux, wave_speeds);
+      for(Uint i = 0; i != physics->neqs(); ++i)
+        BOOST_CHECK_CLOSE(batched_fluxes(f, i), flux[i], tol);
+
+      batched->compute_interface_flux_and_wavespeeds(l, r, coords, n, flux, batched_wave_speeds);
+      for(Uint i = 0; i != physics->neqs(); ++i)
+      {
+        BOOST_CHECK_CLOSE(batched_fluxes(f, i), flux[i], tol);
+        BOOST_CHECK_SMALL(batched_wave_speeds[i] - wave_speeds[i], 1e-8);
+      }
+    }
+  }
+
+  /// Compare the batched Lax-Friedrichs fluxes with the fluxes projected on the normal,
+  /// computed face by face through the dynamic Variables interface
+  void check_lax_friedrich(Component& model, const std::string& physics_builder, const std::string& sol_vars_name, const std::string& batched_builder)
+  {
+    Handle<PhysModel> physics( model.create_component("navierstokes", physics_builder) );
+    Handle<Variables> sol_vars( physics->create_variables(sol_vars_name, "solution") );
+
+    Handle<RiemannSolver> batched( model.create_component("batched", batched_builder) );
+    batched->options().set("physical_model",physics);
+
+    const Uint dim = physics->ndim();
+    const Uint neqs = physics->neqs();
+    const Uint nb_faces = 50;
+    RealMatrix left, right, normals;
+    create_states(nb_faces, dim, left, right, normals);
+
+    RealMatrix batched_fluxes;
+    batched->compute_interface_fluxes(left, right, RealMatrix(), normals, batched_fluxes);
+    BOOST_CHECK_EQUAL(batched_fluxes.rows(), nb_faces);
+
+    std::auto_ptr<Properties> p_left = physics->create_properties();
+    std::auto_ptr<Properties> p_right = physics->create_properties();
+    RealVector coords(dim); coords.setZero();
+    RealMatrix grads(dim, neqs); grads.setZero();
+    RealVector l(neqs), r(neqs), n(dim);
+    RealVector flux_left(neqs), flux_right(neqs), eigenvalues_left(neqs), eigenvalues_right(neqs);
+    RealVector reference(neqs), flux(neqs);
+    const Real tol (0.000001);
+    for(Uint f = 0; f != nb_faces; ++f)
+    {
+      l = left.row(f).transpose();
+      r = right.row(f).transpose();
+      n = normals.row(f).transpose();
+      sol_vars->compute_properties(coords, l, grads, *p_left);
+      sol_vars->compute_properties(coords, r, grads, *p_right);
+      sol_vars->flux(*p_left, n, flux_left);
+      sol_vars->flux(*p_right, n, flux_right);
+      sol_vars->flux_jacobian_eigen_values(*p_left, n, eigenvalues_left);
+      sol_vars->flux_jacobian_eigen_values(*p_right, n, eigenvalues_right);
+      reference = 0.5*(flux_left + flux_right);
+      reference.array() -= 0.5*(eigenvalues_left.cwiseAbs() + eigenvalues_right.cwiseAbs()).array() * (r-l).array();
+
+      batched->compute_interface_flux(l, r, coords, n, flux);
+      for(Uint i = 0; i != neqs; ++i)
+      {
+        BOOST_CHECK_CLOSE(batched_fluxes(f, i), reference[i], tol);
+        BOOST_CHECK_CLOSE(flux[i], reference[i], tol);
+      }
+    }
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE( RiemannSolversBatched_Suite, BatchedRiemannFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( NavierStokes1D_Roe )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model1DRoe");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes1D", "Cons1D", "cf3.RiemannSolvers.Roe", "cf3.RiemannSolvers.navierstokes.RoeCons1D", "Roe1D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_Roe )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model2DRoe");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes2D", "Cons2D", "cf3.RiemannSolvers.Roe", "cf3.RiemannSolvers.navierstokes.RoeCons2D", "Roe2D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes3D_Roe )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model3DRoe");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes3D", "Cons3D", "cf3.RiemannSolvers.Roe", "cf3.RiemannSolvers.navierstokes.RoeCons3D", "Roe3D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_Central )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model2DCentral");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes2D", "Cons2D", "cf3.RiemannSolvers.Central", "cf3.RiemannSolvers.navierstokes.CentralCons2D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes3D_Central )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model3DCentral");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes3D", "Cons3D", "cf3.RiemannSolvers.Central", "cf3.RiemannSolvers.navierstokes.CentralCons3D");
+}
+
+// The dynamic LaxFriedrich does not project the fluxes on the normal, so it can only be compared in 1D
+BOOST_AUTO_TEST_CASE( NavierStokes1D_LaxFriedrich )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model1DLaxFriedrich");
+  check_batched(model, "cf3.physics.NavierStokes.NavierStokes1D", "Cons1D", "cf3.RiemannSolvers.LaxFriedrich", "cf3.RiemannSolvers.navierstokes.LaxFriedrichCons1D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes2D_LaxFriedrich )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model2DLaxFriedrich");
+  check_lax_friedrich(model, "cf3.physics.NavierStokes.NavierStokes2D", "Cons2D", "cf3.RiemannSolvers.navierstokes.LaxFriedrichCons2D");
+}
+
+BOOST_AUTO_TEST_CASE( NavierStokes3D_LaxFriedrich )
+{
+  Component& model = *Core::instance().root().create_component<Component>("model3DLaxFriedrich");
+  check_lax_friedrich(model, "cf3.physics.NavierStokes.NavierStokes3D", "Cons3D", "cf3.RiemannSolvers.navierstokes.LaxFriedrichCons3D");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
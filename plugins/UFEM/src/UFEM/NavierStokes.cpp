@@ -29,6 +29,7 @@
 #include "solver/Time.hpp"
 #include "solver/Tags.hpp"
 
+#include "NavierStokesBatchedAssembly.hpp"
 #include "NavierStokesSpecializations.hpp"
 #include "SUPG.hpp"
 #include "Tags.hpp"
@@ -63,6 +64,11 @@ NavierStokes::NavierStokes(const std::string& name) :
     .description("Activate the use of specialized high performance code")
     .attach_trigger(boost::bind(&NavierStokes::trigger_use_specializations, this));
 
+  options().add("use_batched_assembly", false)
+    .pretty_name("Use Batched Assembly")
+    .description("When using specializations, assemble P1 triangles and tetrahedra several elements at a time, using SIMD-friendly kernels")
+    .attach_trigger(boost::bind(&NavierStokes::trigger_use_specializations, this));
+
   set_solution_tag("navier_stokes_solution");
 
   // This ensures that the linear system matrix is reset to zero each timestep
@@ -105,8 +111,15 @@ void NavierStokes::trigger_use_specializations()
   
   // Add the assembly, depending on the use of specialized code or not
   const bool use_specializations = options().value<bool>("use_specializations");
-  set_triag_assembly(use_specializations);
-  set_tetra_assembly(use_specializations);
+  if(use_specializations && options().value<bool>("use_batched_assembly"))
+  {
+    m_assembly->create_component<NavierStokesBatchedAssembly>("AssemblyBatched");
+  }
+  else
+  {
+    set_triag_assembly(use_specializations);
+    set_tetra_assembly(use_specializations);
+  }
   set_quad_assembly();
   set_hexa_assembly();
 
@@ -114,6 +127,9 @@ void NavierStokes::trigger_use_specializations()
     configure_option_recursively(solver::Tags::physical_model(), m_physical_model);
   
   configure_option_recursively(solver::Tags::regions(), options().option(solver::Tags::regions()).value());
+  // The batched assembly is a standalone action, so it needs its own links to the LSS and time
+  m_assembly->configure_option_recursively(solver::Tags::time(), options().option(solver::Tags::time()).value());
+  m_assembly->configure_option_recursively("lss", options().option("lss").value());
 }
 
 void NavierStokes::on_initial_conditions_set(InitialConditions& initial_conditions)
@@ -0,0 +1,288 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_UFEM_NavierStokesBatched_hpp
+#define cf3_UFEM_NavierStokesBatched_hpp
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/CF.hpp"
+
+#include "mesh/LagrangeP1/Triag2D.hpp"
+#include "mesh/LagrangeP1/Tetra3D.hpp"
+
+namespace cf3 {
+
+namespace UFEM {
+
+/// Number of elements that are processed together by the batched kernels. Each lane of a batch
+/// occupies one entry of the innermost array dimension, so this should match the number of doubles
+/// in a SIMD register (4 for AVX, 8 for AVX-512)
+#ifdef __AVX512F__
+static const Uint supg_batch_size = 8;
+#else
+static const Uint supg_batch_size = 4;
+#endif
+
+/// Element geometry needed by the batched SUPG kernel: the scaled face normals, volume and characteristic length
+template<typename ElementT>
+struct SUPGBatchGeometry;
+
+/// Geometry for P1 triangles
+template<>
+struct SUPGBatchGeometry<mesh::LagrangeP1::Triag2D>
+{
+  template<Uint B>
+  static void compute(const Real (&nodes)[3][2][B], Real (&normals)[3][2][B], Real (&volume)[B], Real (&he)[B])
+  {
+    for(Uint l = 0; l != B; ++l)
+    {
+      normals[0][XX][l] = nodes[1][YY][l] - nodes[2][YY][l];
+      normals[0][YY][l] = nodes[2][XX][l] - nodes[1][XX][l];
+      normals[1][XX][l] = nodes[2][YY][l] - nodes[0][YY][l];
+      normals[1][YY][l] = nodes[0][XX][l] - nodes[2][XX][l];
+      normals[2][XX][l] = nodes[0][YY][l] - nodes[1][YY][l];
+      normals[2][YY][l] = nodes[1][XX][l] - nodes[0][XX][l];
+
+      volume[l] = 0.5 * ( (nodes[1][XX][l] - nodes[0][XX][l]) * (nodes[2][YY][l] - nodes[0][YY][l])
+                        - (nodes[2][XX][l] - nodes[0][XX][l]) * (nodes[1][YY][l] - nodes[0][YY][l]) );
+      he[l] = sqrt(4./3.141592654*volume[l]);
+    }
+  }
+};
+
+/// Geometry for P1 tetrahedra
+template<>
+struct SUPGBatchGeometry<mesh::LagrangeP1::Tetra3D>
+{
+  template<Uint B>
+  static void compute(const Real (&nodes)[4][3][B], Real (&normals)[4][3][B], Real (&volume)[B], Real (&he)[B])
+  {
+    // Normal to the face opposite node i, as the half cross product of two edges of that face
+    static const Uint face_nodes[4][3] = { {1, 3, 2}, {0, 2, 3}, {0, 3, 1}, {0, 1, 2} };
+    for(Uint i = 0; i != 4; ++i)
+    {
+      const Uint o = face_nodes[i][0];
+      const Uint a = face_nodes[i][1];
+      const Uint b = face_nodes[i][2];
+      for(Uint l = 0; l != B; ++l)
+      {
+        const Real ax = nodes[a][XX][l] - nodes[o][XX][l];
+        const Real ay = nodes[a][YY][l] - nodes[o][YY][l];
+        const Real az = nodes[a][ZZ][l] - nodes[o][ZZ][l];
+        const Real bx = nodes[b][XX][l] - nodes[o][XX][l];
+        const Real by = nodes[b][YY][l] - nodes[o][YY][l];
+        const Real bz = nodes[b][ZZ][l] - nodes[o][ZZ][l];
+        normals[i][XX][l] = (ay*bz - by*az) / 2.0;
+        normals[i][YY][l] = (az*bx - bz*ax) / 2.0;
+        normals[i][ZZ][l] = (ax*by - bx*ay) / 2.0;
+      }
+    }
+
+    for(Uint l = 0; l != B; ++l)
+    {
+      const Real ax = nodes[1][XX][l] - nodes[0][XX][l];
+      const Real ay = nodes[1][YY][l] - nodes[0][YY][l];
+      const Real az = nodes[1][ZZ][l] - nodes[0][ZZ][l];
+      const Real bx = nodes[2][XX][l] - nodes[0][XX][l];
+      const Real by = nodes[2][YY][l] - nodes[0][YY][l];
+      const Real bz = nodes[2][ZZ][l] - nodes[0][ZZ][l];
+      const Real cx = nodes[3][XX][l] - nodes[0][XX][l];
+      const Real cy = nodes[3][YY][l] - nodes[0][YY][l];
+      const Real cz = nodes[3][ZZ][l] - nodes[0][ZZ][l];
+      volume[l] = (ax*(by*cz - bz*cy) - ay*(bx*cz - bz*cx) + az*(bx*cy - by*cx)) / 6.;
+      he[l] = ::pow(3./4./3.141592654*volume[l],1./3.);
+    }
+  }
+};
+
+/// Computes the SUPG/PSPG/bulk-viscosity element matrices for the Navier-Stokes equations on a batch of BatchSize P1 elements at once.
+/// The formulation is the same as in SUPGSpecialized, but all data is stored as structure-of-arrays with the element index
+/// innermost, so each loop over the lanes maps onto SIMD instructions.
+/// The resulting matrices are in node-major order (u1 v1 p1 u2 v2 p2 ...), ready to be copied into a BlockAccumulator.
+template<typename ElementT, Uint BatchSize = supg_batch_size>
+struct SUPGBatch
+{
+  static const Uint dim = ElementT::dimension;
+  static const Uint nb_nodes = ElementT::nb_nodes;
+  static const Uint nb_dofs = dim + 1;
+  static const Uint mat_size = nb_nodes * nb_dofs;
+
+  /// Offset of the first velocity component and the pressure within the unknowns of each node
+  SUPGBatch(const Uint u_offset, const Uint p_offset) : m_u_offset(u_offset), m_p_offset(p_offset)
+  {
+  }
+
+  /// Input: node coordinates
+  Real nodes[nb_nodes][dim][BatchSize];
+  /// Input: linearized advection velocity at the nodes
+  Real u_adv[nb_nodes][dim][BatchSize];
+  /// Input: effective viscosity at the nodes
+  Real nu_eff[nb_nodes][BatchSize];
+
+  /// Output: the system matrix
+  Real A[mat_size][mat_size][BatchSize];
+  /// Output: the time (mass) matrix
+  Real T[mat_size][mat_size][BatchSize];
+
+  /// Fill the unused lanes by copying the last valid one, so they don't produce NaNs
+  void pad(const Uint nb_valid)
+  {
+    cf3_assert(nb_valid > 0 && nb_valid <= BatchSize);
+    for(Uint l = nb_valid; l != BatchSize; ++l)
+    {
+      for(Uint n = 0; n != nb_nodes; ++n)
+      {
+        for(Uint d = 0; d != dim; ++d)
+        {
+          nodes[n][d][l] = nodes[n][d][nb_valid-1];
+          u_adv[n][d][l] = u_adv[n][d][nb_valid-1];
+        }
+        nu_eff[n][l] = nu_eff[n][nb_valid-1];
+      }
+    }
+  }
+
+  /// Compute A and T for all lanes
+  void compute(const Real u_ref, const Real rho)
+  {
+    static const Real fc = 0.5;
+    // Integration constants for P1 shape functions
+    static const Real c_conv = 1. / static_cast<Real>(dim*(dim+1));
+    static const Real c_mass = 1. / static_cast<Real>((dim+1)*(dim+2));
+    static const Real one_third = 1./3.;
+    const Real inv_rho = 1. / rho;
+
+    Real normals[nb_nodes][dim][BatchSize];
+    Real volume[BatchSize];
+    Real he[BatchSize];
+    SUPGBatchGeometry<ElementT>::compute(nodes, normals, volume, he);
+
+    // Averaged advection velocity and viscosity
+    Real u_avg[dim][BatchSize];
+    Real nu[BatchSize];
+    for(Uint l = 0; l != BatchSize; ++l)
+    {
+      nu[l] = 0.;
+      for(Uint d = 0; d != dim; ++d)
+        u_avg[d][l] = 0.;
+    }
+    for(Uint n = 0; n != nb_nodes; ++n)
+    {
+      for(Uint l = 0; l != BatchSize; ++l)
+      {
+        nu[l] += nu_eff[n][l];
+        for(Uint d = 0; d != dim; ++d)
+          u_avg[d][l] += u_adv[n][d][l];
+      }
+    }
+
+    // Stabilization coefficients, with the branches of the scalar version turned into selects
+    Real tau_ps[BatchSize], tau_su[BatchSize], tau_bulk[BatchSize], c_lap[BatchSize];
+    Real u_n[nb_nodes][BatchSize];
+    for(Uint l = 0; l != BatchSize; ++l)
+    {
+      nu[l] = fabs(nu[l] / static_cast<Real>(nb_nodes));
+      Real umag = 0.;
+      for(Uint d = 0; d != dim; ++d)
+      {
+        u_avg[d][l] /= static_cast<Real>(nb_nodes);
+        umag += u_avg[d][l]*u_avg[d][l];
+      }
+      umag = sqrt(umag);
+
+      c_lap[l] = 1. / (static_cast<Real>(dim*dim) * volume[l]);
+
+      const Real ree = u_ref*he[l]/(2.*nu[l]);
+      const Real xi = ree < 3. ? 0.3333333333333333*ree : 1.;
+      tau_ps[l] = he[l]*xi/(2.*u_ref);
+      tau_bulk[l] = he[l]*u_ref/xi;
+
+      Real abs_sum = 0.;
+      for(Uint n = 0; n != nb_nodes; ++n)
+      {
+        Real un = 0.;
+        for(Uint d = 0; d != dim; ++d)
+          un += u_avg[d][l]*normals[n][d][l];
+        u_n[n][l] = un;
+        abs_sum += fabs(un);
+      }
+
+      const bool has_velocity = umag > 1e-10;
+      const Real safe_umag = has_velocity ? umag : 1.;
+      const Real h = has_velocity ? 2. * volume[l] * safe_umag / abs_sum : 1.;
+      const Real ree_su = safe_umag*h/(2.*nu[l]);
+      const Real xi_su = ree_su < 3. ? 0.3333333333333333*ree_su : 1.;
+      tau_su[l] = has_velocity ? h*xi_su/(2.*safe_umag) : 0.;
+    }
+
+    std::fill(&A[0][0][0], &A[0][0][0] + mat_size*mat_size*BatchSize, 0.);
+    std::fill(&T[0][0][0], &T[0][0][0] + mat_size*mat_size*BatchSize, 0.);
+
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      const Uint Pi = i*nb_dofs + m_p_offset;
+      const Uint Ui = i*nb_dofs + m_u_offset;
+      for(Uint j = 0; j != nb_nodes; ++j)
+      {
+        const Uint Pj = j*nb_dofs + m_p_offset;
+        const Uint Uj = j*nb_dofs + m_u_offset;
+        const Real mass_factor = i == j ? 2.*c_mass : c_mass;
+
+        for(Uint l = 0; l != BatchSize; ++l)
+        {
+          const Real u_ni = u_n[i][l];
+          const Real uknj = u_n[j][l];
+          Real ninj = 0.;
+          for(Uint d = 0; d != dim; ++d)
+            ninj += normals[i][d][l]*normals[j][d][l];
+
+          // Convection (Standard + SUPG) and the diagonal diffusion part
+          const Real diag = c_conv*uknj + tau_su[l]*c_lap[l]*uknj*u_ni + nu[l]*c_lap[l]*ninj;
+          // Convection Skewsymm (Standard + SUPG)
+          const Real skew = fc*c_conv + fc*tau_su[l]*c_lap[l]*u_ni;
+          // Bulk viscosity and second viscosity effect
+          const Real bulk = (tau_bulk[l] + one_third*nu[l])*c_lap[l];
+          // Convection (PSPG) and Convection Skewsymm (PSPG)
+          const Real pspg_conv = tau_ps[l]*c_lap[l]*uknj;
+          const Real pspg_skew = fc*tau_ps[l]*c_lap[l]*u_ni;
+          // Pressure (Standard + SUPG)
+          const Real pressure = c_conv*inv_rho + tau_su[l]*c_lap[l]*u_ni*inv_rho;
+          // Time (Standard + SUPG)
+          const Real mass = mass_factor*volume[l] + tau_su[l]*c_conv*u_ni;
+
+          for(Uint a = 0; a != dim; ++a)
+          {
+            A[Ui+a][Uj+a][l] += diag;
+            for(Uint b = 0; b != dim; ++b)
+              A[Ui+a][Uj+b][l] += skew*u_avg[a][l]*normals[j][b][l] + bulk*normals[i][a][l]*normals[j][b][l];
+            A[Ui+a][Pj][l] += pressure*normals[j][a][l];
+            // Continuity (Standard) and PSPG convection terms
+            A[Pi][Uj+a][l] += pspg_conv*normals[i][a][l] + (pspg_skew + c_conv)*normals[j][a][l];
+
+            T[Ui+a][Uj+a][l] += mass;
+            // Time (PSPG)
+            T[Pi][Uj+a][l] += tau_ps[l]*c_conv*normals[i][a][l];
+          }
+
+          // Pressure (PSPG)
+          A[Pi][Pj][l] += tau_ps[l]*c_lap[l]*inv_rho*ninj;
+        }
+      }
+    }
+  }
+
+private:
+  const Uint m_u_offset;
+  const Uint m_p_offset;
+};
+
+} // UFEM
+} // cf3
+
+
+#endif // cf3_UFEM_NavierStokesBatched_hpp
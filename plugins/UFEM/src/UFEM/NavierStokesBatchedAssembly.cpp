@@ -0,0 +1,183 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/scoped_ptr.hpp>
+
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/LSS/System.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Space.hpp"
+
+#include "physics/PhysModel.hpp"
+
+#include "solver/Tags.hpp"
+#include "solver/Time.hpp"
+
+#include "NavierStokesBatched.hpp"
+#include "NavierStokesBatchedAssembly.hpp"
+
+namespace cf3 {
+namespace UFEM {
+
+using namespace common;
+
+ComponentBuilder < NavierStokesBatchedAssembly, common::Action, LibUFEM > NavierStokesBatchedAssembly_builder;
+
+NavierStokesBatchedAssembly::NavierStokesBatchedAssembly(const std::string& name) :
+  solver::Action(name)
+{
+  options().add("lss", m_lss)
+    .pretty_name("LSS")
+    .description("The linear system to assemble into")
+    .link_to(&m_lss);
+
+  options().add(solver::Tags::time(), m_time)
+    .pretty_name("Time")
+    .description("Component that keeps track of time for this simulation")
+    .link_to(&m_time);
+}
+
+NavierStokesBatchedAssembly::~NavierStokesBatchedAssembly()
+{
+}
+
+void NavierStokesBatchedAssembly::execute()
+{
+  if(is_null(m_lss))
+    throw SetupError(FromHere(), "LSS not set for " + uri().string());
+  if(is_null(m_time))
+    throw SetupError(FromHere(), "Time not set for " + uri().string());
+
+  const Real u_ref = physical_model().options().value<Real>("reference_velocity");
+  const Real rho = physical_model().options().value<Real>("density");
+
+  BOOST_FOREACH(const Handle<mesh::Region>& region, m_loop_regions)
+  {
+    BOOST_FOREACH(const mesh::Elements& elements, find_components_recursively_with_filter<mesh::Elements>(*region, mesh::IsElementType<mesh::LagrangeP1::Triag2D>()))
+    {
+      assemble<mesh::LagrangeP1::Triag2D>(elements, u_ref, rho);
+    }
+    BOOST_FOREACH(const mesh::Elements& elements, find_components_recursively_with_filter<mesh::Elements>(*region, mesh::IsElementType<mesh::LagrangeP1::Tetra3D>()))
+    {
+      assemble<mesh::LagrangeP1::Tetra3D>(elements, u_ref, rho);
+    }
+  }
+}
+
+template<typename ElementT>
+void NavierStokesBatchedAssembly::assemble(const mesh::Elements& elements, const Real u_ref, const Real rho)
+{
+  typedef SUPGBatch<ElementT> BatchT;
+  static const Uint nb_nodes = BatchT::nb_nodes;
+  static const Uint dim = BatchT::dim;
+  static const Uint mat_size = BatchT::mat_size;
+  static const Uint batch_size = supg_batch_size;
+
+  const mesh::Mesh& mesh = find_parent_component<mesh::Mesh>(elements);
+  const mesh::Field& solution = find_component_recursively_with_tag<mesh::Field>(mesh, "navier_stokes_solution");
+  const mesh::Field& u_adv = find_component_recursively_with_tag<mesh::Field>(mesh, "linearized_velocity");
+  const mesh::Field& nu_eff = find_component_recursively_with_tag<mesh::Field>(mesh, "navier_stokes_viscosity");
+  const mesh::Field& coordinates = elements.geometry_fields().coordinates();
+
+  if(solution.descriptor().size() != BatchT::nb_dofs)
+    throw SetupError(FromHere(), "Batched Navier-Stokes assembly expects " + common::to_str(BatchT::nb_dofs) + " unknowns per node, but the solution has " + common::to_str(solution.descriptor().size()));
+
+  const Uint u_var_offset = solution.descriptor().offset("Velocity");
+  const Uint p_var_offset = solution.descriptor().offset("Pressure");
+  const Uint u_adv_offset = u_adv.descriptor().offset("AdvectionVelocity");
+  const Uint nu_eff_offset = nu_eff.descriptor().offset("EffectiveViscosity");
+
+  const mesh::Connectivity& geo_conn = elements.geometry_space().connectivity();
+  const mesh::Connectivity& sol_conn = solution.dict().space(elements).connectivity();
+  const mesh::Connectivity& u_adv_conn = u_adv.dict().space(elements).connectivity();
+  const mesh::Connectivity& nu_eff_conn = nu_eff.dict().space(elements).connectivity();
+
+  const Handle< List<Uint> > used_node_map(m_lss->get_child("used_node_map"));
+  math::LSS::Matrix& matrix = *m_lss->matrix();
+  math::LSS::Vector& rhs = *m_lss->rhs();
+  const Real invdt = m_time->invdt();
+
+  math::LSS::BlockAccumulator block_accumulator;
+  block_accumulator.resize(nb_nodes, BatchT::nb_dofs);
+  block_accumulator.reset();
+
+  // The batch data is large, so keep it on the heap
+  boost::scoped_ptr<BatchT> batch_ptr(new BatchT(u_var_offset, p_var_offset));
+  BatchT& batch = *batch_ptr;
+
+  const Uint nb_elems = elements.size();
+  for(Uint batch_begin = 0; batch_begin < nb_elems; batch_begin += batch_size)
+  {
+    const Uint nb_valid = std::min(batch_size, nb_elems - batch_begin);
+
+    // Gather the element data into the structure-of-arrays layout
+    for(Uint l = 0; l != nb_valid; ++l)
+    {
+      const Uint elem_idx = batch_begin + l;
+      for(Uint n = 0; n != nb_nodes; ++n)
+      {
+        const mesh::Field::ConstRow coords_row = coordinates[geo_conn[elem_idx][n]];
+        const mesh::Field::ConstRow u_adv_row = u_adv[u_adv_conn[elem_idx][n]];
+        for(Uint d = 0; d != dim; ++d)
+        {
+          batch.nodes[n][d][l] = coords_row[d];
+          batch.u_adv[n][d][l] = u_adv_row[u_adv_offset + d];
+        }
+        batch.nu_eff[n][l] = nu_eff[nu_eff_conn[elem_idx][n]][nu_eff_offset];
+      }
+    }
+    batch.pad(nb_valid);
+
+    batch.compute(u_ref, rho);
+
+    // Scatter the results into the linear system
+    for(Uint l = 0; l != nb_valid; ++l)
+    {
+      const Uint elem_idx = batch_begin + l;
+      for(Uint n = 0; n != nb_nodes; ++n)
+      {
+        const Uint node_idx = sol_conn[elem_idx][n];
+        block_accumulator.indices[n] = is_null(used_node_map) ? node_idx : (*used_node_map)[node_idx];
+        for(Uint v = 0; v != BatchT::nb_dofs; ++v)
+          block_accumulator.sol[n*BatchT::nb_dofs + v] = solution[node_idx][v];
+      }
+
+      for(Uint row = 0; row != mat_size; ++row)
+      {
+        Real rhs_val = 0.;
+        for(Uint col = 0; col != mat_size; ++col)
+        {
+          const Real a = batch.A[row][col][l];
+          block_accumulator.mat(row, col) = invdt*batch.T[row][col][l] + a;
+          rhs_val -= a*block_accumulator.sol[col];
+        }
+        block_accumulator.rhs[row] = rhs_val;
+      }
+
+      matrix.add_values(block_accumulator);
+      rhs.add_rhs_values(block_accumulator);
+    }
+  }
+}
+
+} // UFEM
+} // cf3
@@ -0,0 +1,51 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_UFEM_NavierStokesBatchedAssembly_hpp
+#define cf3_UFEM_NavierStokesBatchedAssembly_hpp
+
+#include "solver/Action.hpp"
+
+#include "LibUFEM.hpp"
+
+namespace cf3 {
+  namespace math { namespace LSS { class System; } }
+  namespace mesh { class Elements; }
+  namespace solver { class Time; }
+namespace UFEM {
+
+/// Assembles the Navier-Stokes system for P1 triangles and tetrahedra, processing several elements at once
+/// using the SIMD-friendly kernels from NavierStokesBatched.hpp. Other element types are skipped, so this is
+/// meant to be used next to the generic Proto assembly for the remaining element types.
+class UFEM_API NavierStokesBatchedAssembly : public solver::Action
+{
+public:
+
+  /// Contructor
+  /// @param name of the component
+  NavierStokesBatchedAssembly ( const std::string& name );
+
+  virtual ~NavierStokesBatchedAssembly();
+
+  /// Get the class name
+  static std::string type_name () { return "NavierStokesBatchedAssembly"; }
+
+  virtual void execute();
+
+private:
+  /// Assemble all elements of the given type
+  template<typename ElementT>
+  void assemble(const mesh::Elements& elements, const Real u_ref, const Real rho);
+
+  Handle<math::LSS::System> m_lss;
+  Handle<solver::Time> m_time;
+};
+
+} // UFEM
+} // cf3
+
+
+#endif // cf3_UFEM_NavierStokesBatchedAssembly_hpp
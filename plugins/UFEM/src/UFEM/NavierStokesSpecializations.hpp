@@ -252,9 +252,9 @@ struct SUPGSpecialized
         A(Vi,Uj) += val*vk*normals(j, XX);
         A(Vi,Vj) += val*vk*normals(j, YY);
         A(Vi,Wj) += val*vk*normals(j, ZZ);
-        A(Wi,Uj) += val*vk*normals(j, XX);
-        A(Wi,Vj) += val*vk*normals(j, YY);
-        A(Wi,Wj) += val*vk*normals(j, ZZ);
+        A(Wi,Uj) += val*wk*normals(j, XX);
+        A(Wi,Vj) += val*wk*normals(j, YY);
+        A(Wi,Wj) += val*wk*normals(j, ZZ);
 
         // Convection Skewsymm (PSPG)
         val = fc*tau_ps/(9.*volume);
@@ -264,9 +264,9 @@ struct SUPGSpecialized
         A(Pi,Uj) += val*normals(i, YY)*vk*normals(j, XX);
         A(Pi,Vj) += val*normals(i, YY)*vk*normals(j, YY);
         A(Pi,Wj) += val*normals(i, YY)*vk*normals(j, ZZ);
-        A(Pi,Uj) += val*normals(i, ZZ)*vk*normals(j, XX);
-        A(Pi,Vj) += val*normals(i, ZZ)*vk*normals(j, YY);
-        A(Pi,Wj) += val*normals(i, ZZ)*vk*normals(j, ZZ);
+        A(Pi,Uj) += val*normals(i, ZZ)*wk*normals(j, XX);
+        A(Pi,Vj) += val*normals(i, ZZ)*wk*normals(j, YY);
+        A(Pi,Wj) += val*normals(i, ZZ)*wk*normals(j, ZZ);
 
 
         //difusion (Standard)
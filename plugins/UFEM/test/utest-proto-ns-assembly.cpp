@@ -20,6 +20,8 @@
 #include "common/Group.hpp"
 
 #include "mesh/Domain.hpp"
+#include "mesh/MeshTriangulator.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
 #include "mesh/LagrangeP1/Triag2D.hpp"
 #include "mesh/LagrangeP1/Tetra3D.hpp"
 
@@ -50,7 +52,7 @@ typedef std::vector<Uint> SizesT;
 struct NavierStokesAssemblyFixture
 {
   template<Uint Dim, typename ExprT>
-  void run_model(const boost::shared_ptr<Mesh>& mesh, const ExprT& initial_condition_expression, const Real eps = 1e-12)
+  void run_model(const boost::shared_ptr<Mesh>& mesh, const ExprT& initial_condition_expression, const Real eps = 1e-12, const Real zero = 0.)
   {
     boost::shared_ptr<common::Group> root = allocate_component<Group>("Root");
     Handle<ModelUnsteady> model = root->create_component<ModelUnsteady>("NavierStokes");
@@ -100,7 +102,19 @@ struct NavierStokesAssemblyFixture
       for(Uint j = 0; j != matsize; ++j)
 	 lss.matrix()->get_value(i, j, generic_result(i,j));
       
-    check_close(generic_result, spec_result, eps);
+    check_close(generic_result, spec_result, eps, zero);
+
+    lss_action->options().set("use_specializations", true);
+    lss_action->options().set("use_batched_assembly", true);
+    time.options().set("end_time", 3.);
+    model->simulate();
+
+    RealMatrix batched_result(matsize, matsize);
+    for(Uint i = 0; i != matsize; ++i)
+      for(Uint j = 0; j != matsize; ++j)
+	 lss.matrix()->get_value(i, j, batched_result(i,j));
+
+    check_close(generic_result, batched_result, eps, zero);
   }
 
   boost::shared_ptr<Mesh> create_triangle(const RealVector2& a, const RealVector2& b, const RealVector2& c)
@@ -139,11 +153,36 @@ struct NavierStokesAssemblyFixture
     return mesh_ptr;
   }
 
-  void check_close(const RealMatrix& a, const RealMatrix& b, const Real eps)
+  /// Split the cells of a unit square or cube mesh into triangles or tetrahedra, giving a mesh of many elements
+  boost::shared_ptr<Mesh> create_simplex_mesh(const SizesT& nb_cells)
+  {
+    Handle<SimpleMeshGenerator> generator = Core::instance().root().create_component<SimpleMeshGenerator>("generator");
+    generator->options().set("mesh", Core::instance().root().uri()/"simplex_mesh");
+    generator->options().set("nb_cells", nb_cells);
+    generator->options().set("lengths", std::vector<Real>(nb_cells.size(), 1.));
+    generator->options().set("bdry", false);
+    Mesh& mesh = generator->generate();
+    Core::instance().root().remove_component(*generator);
+
+    allocate_component<MeshTriangulator>("triangulator")->transform(mesh);
+
+    return boost::dynamic_pointer_cast<Mesh>(Core::instance().root().remove_component(mesh));
+  }
+
+  /// Compare matrices entry by entry. Entries that are below zero in both matrices are
+  /// compared in absolute value, since the roundoff of a sum over several elements leaves them at random.
+  void check_close(const RealMatrix& a, const RealMatrix& b, const Real eps, const Real zero = 0.)
   {
     for(Uint i = 0; i != a.rows(); ++i)
+    {
       for(Uint j = 0; j != a.cols(); ++j)
-        BOOST_CHECK_CLOSE(a(i,j), b(i,j), eps);
+      {
+        if(std::abs(a(i,j)) < zero && std::abs(b(i,j)) < zero)
+          BOOST_CHECK_SMALL(a(i,j) - b(i,j), zero);
+        else
+          BOOST_CHECK_CLOSE(a(i,j), b(i,j), eps);
+      }
+    }
   }
 };
 
@@ -201,4 +240,36 @@ BOOST_AUTO_TEST_CASE( GenericTetraVortex )
   run_model<3>(create_tetra(RealVector3(100.2, 100.1, 99.9), RealVector3(100.75, 99.9, 100.05), RealVector3(100.33, 100.83, 100.23), RealVector3(100.1, 99.9, 100.67)), u = n_op*coordinates / (coordinates[0]*coordinates[0] + coordinates[1]*coordinates[1]), 0.2);
 }
 
+BOOST_AUTO_TEST_CASE( TetraNonUniformW )
+{
+  // Only w varies, and v is zero, so the v and w skew-symmetric terms cannot be confused
+  FieldVariable<0, VectorField> u("Velocity", "navier_stokes_solution");
+  RealVector u_base(3); u_base << 1., 0., 0.9;
+  RealVector w_gradient(3); w_gradient << 0., 0., 0.001;
+  run_model<3>(create_tetra(RealVector3(100.2, 100.1, 99.9), RealVector3(100.75, 99.9, 100.05), RealVector3(100.33, 100.83, 100.23), RealVector3(100.1, 99.9, 100.67)), u = u_base + w_gradient*coordinates[2], 0.2);
+}
+
+// The meshes below have more elements than a batch, and a number of elements that is not a multiple of the batch size,
+// so full batches, a partial last batch and the scatter of every lane are compared with the generic assembly
+
+BOOST_AUTO_TEST_CASE( TriangleMeshUniform )
+{
+  FieldVariable<0, VectorField> u("Velocity", "navier_stokes_solution");
+  RealVector u_init(2); u_init << 1., 0.5;
+  const SizesT nb_cells = boost::assign::list_of(3)(3);
+  boost::shared_ptr<Mesh> mesh = create_simplex_mesh(nb_cells);
+  BOOST_CHECK_EQUAL(mesh->topology().recursive_elements_count(true), 18u);
+  run_model<2>(mesh, u = u_init, 1e-10, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE( TetraMeshUniform )
+{
+  FieldVariable<0, VectorField> u("Velocity", "navier_stokes_solution");
+  RealVector u_init(3); u_init << 1., 0.5, 2.;
+  const SizesT nb_cells = boost::assign::list_of(3)(1)(1);
+  boost::shared_ptr<Mesh> mesh = create_simplex_mesh(nb_cells);
+  BOOST_CHECK_EQUAL(mesh->topology().recursive_elements_count(true), 15u);
+  run_model<3>(mesh, u = u_init, 1e-10, 1e-12);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -132,31 +132,41 @@ void CreateSDFields::execute()
 
       const RealMatrix& local_coords = space.shape_function().local_coordinates();
 
-      RealMatrix geometry_coords;
-      elements->geometry_space().allocate_coordinates(geometry_coords);
+      const ElementType& element_type = elements->element_type();
+      const Space& geometry_space = elements->geometry_space();
+      const Uint dimensionality = element_type.dimensionality();
+      const Uint dimension = element_type.dimension();
 
-      RealVector dKsi (elements->element_type().dimensionality()); dKsi.setConstant(2.);
-      RealVector dX (elements->element_type().dimension());
-      RealMatrix jacobian(elements->element_type().dimensionality(),elements->element_type().dimension());
+      RealVector dKsi (dimensionality); dKsi.setConstant(2.);
+      RealVector mapped_coord (dimensionality);
+      RealVector jacobian_determinants;
+      RealMatrix jacobians;
 
       const Connectivity& field_connectivity = space.connectivity();
 
-      for (Uint elem=0; elem<elements->size(); ++elem)
+      // Compute the jacobians of all elements at once, for each solution point
+      for (Uint node=0; node<local_coords.rows();++node)
       {
-        elements->geometry_space().put_coordinates(geometry_coords,elem);
+        mapped_coord = local_coords.row(node).transpose();
+        element_type.compute_jacobian_determinants_at(mapped_coord,geometry_space.connectivity(),geometry_space.dict().coordinates(),jacobian_determinants);
+        element_type.compute_jacobians_at(mapped_coord,geometry_space.connectivity(),geometry_space.dict().coordinates(),jacobians);
 
-        for (Uint node=0; node<local_coords.rows();++node)
+        for (Uint elem=0; elem<elements->size(); ++elem)
         {
           const Uint p = field_connectivity[elem][node];
-          jacob_det[p][0]=elements->element_type().jacobian_determinant(local_coords.row(node),geometry_coords);
+          jacob_det[p][0]=jacobian_determinants[elem];
           if (jacob_det[p][0] < 0)
             throw BadValue(FromHere(), "jacobian determinant is negative ("+to_str(jacob_det[p][0])+") in cell "+elements->uri().string()+"["+to_str(elem)+"] (glbidx="+to_str(+elements->glb_idx()[elem])+"). This is caused by a faulty node ordering in the mesh.");
-          elements->element_type().compute_jacobian(local_coords.row(node),geometry_coords,jacobian);
-          dX.noalias() = jacobian.transpose()*dKsi;
-          for (Uint d=0; d<dX.size(); ++d)
-            delta[p][d]=dX[d];
-        }
 
+          // dX = jacobian^T * dKsi, with the jacobian stored row by row
+          for (Uint d=0; d<dimension; ++d)
+          {
+            Real dX = 0.;
+            for (Uint k=0; k<dimensionality; ++k)
+              dX += jacobians(elem,k*dimension+d)*dKsi[k];
+            delta[p][d]=dX;
+          }
+        }
       }
     }
   }
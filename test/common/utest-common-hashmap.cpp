@@ -0,0 +1,169 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the HashMap component"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/CF.hpp"
+#include "common/HashMap.hpp"
+#include "common/TypeInfo.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::common;
+
+/// Key of which all values have the same hash, so every key probes the same slots
+struct CollidingKey
+{
+  CollidingKey(const int v = 0) : value(v) {}
+  bool operator==(const CollidingKey& other) const { return value == other.value; }
+  int value;
+};
+
+std::size_t hash_value(const CollidingKey&) { return 7u; }
+
+struct HashMapFixture
+{
+  HashMapFixture()
+  {
+    TypeInfo::instance().regist<CollidingKey>("CollidingKey");
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( HashMapTests, HashMapFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( insert_find_erase )
+{
+  boost::shared_ptr< HashMap<int,Uint> > map_ptr = allocate_component< HashMap<int,Uint> >("map");
+  HashMap<int,Uint>& map = *map_ptr;
+
+  for (int i=0; i<100; ++i)
+    map.push_back(3*i,i);
+  BOOST_CHECK_EQUAL(map.size(), 100u);
+  BOOST_CHECK(map.exists(42));
+  BOOST_CHECK(!map.exists(43));
+  BOOST_CHECK_EQUAL(map[42], 14u);
+  BOOST_CHECK(map.find(43) == map.end());
+
+  BOOST_CHECK(map.insert(std::make_pair(43,1000u)).second);
+  BOOST_CHECK(!map.insert(std::make_pair(43,2000u)).second);
+  BOOST_CHECK_EQUAL(map[43], 1000u);
+  map[44] = 5u;
+  BOOST_CHECK_EQUAL(map.size(), 102u);
+
+  // Erase every other key, and check all remaining keys can still be found
+  for (int i=0; i<100; i+=2)
+    BOOST_CHECK(map.erase(3*i));
+  BOOST_CHECK(!map.erase(0));
+  BOOST_CHECK_EQUAL(map.size(), 52u);
+  for (int i=0; i<100; ++i)
+  {
+    BOOST_CHECK_EQUAL(map.exists(3*i), i%2 == 1);
+    if (i%2 == 1)
+      BOOST_CHECK_EQUAL(map[3*i], static_cast<Uint>(i));
+  }
+  BOOST_CHECK_EQUAL(map[43], 1000u);
+  BOOST_CHECK_EQUAL(map[44], 5u);
+
+  // Erasing by iterator moves the last pair into its place
+  map.erase(map.find(43));
+  BOOST_CHECK(!map.exists(43));
+  BOOST_CHECK_EQUAL(map.size(), 51u);
+  BOOST_CHECK_EQUAL(map[44], 5u);
+
+  map.clear();
+  BOOST_CHECK_EQUAL(map.size(), 0u);
+  BOOST_CHECK(!map.exists(3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( rehash )
+{
+  boost::shared_ptr< HashMap<Uint,Uint> > map_ptr = allocate_component< HashMap<Uint,Uint> >("map");
+  HashMap<Uint,Uint>& map = *map_ptr;
+
+  // Grows from the minimal table without reserve(), rehashing many times
+  const Uint nb_keys = 10000;
+  for (Uint i=0; i<nb_keys; ++i)
+    map.push_back(7*i+3, i);
+  BOOST_CHECK_EQUAL(map.size(), nb_keys);
+
+  // Pairs keep their insertion order
+  Uint idx = 0;
+  for (HashMap<Uint,Uint>::const_iterator it=map.begin(); it!=map.end(); ++it, ++idx)
+  {
+    BOOST_CHECK_EQUAL(it->first, 7*idx+3);
+    BOOST_CHECK_EQUAL(it->second, idx);
+  }
+
+  Uint nb_wrong = 0;
+  const HashMap<Uint,Uint>& const_map = map;
+  for (Uint i=0; i<nb_keys; ++i)
+  {
+    if (const_map[7*i+3] != i)
+      ++nb_wrong;
+    if (const_map.exists(7*i+4))
+      ++nb_wrong;
+  }
+  BOOST_CHECK_EQUAL(nb_wrong, 0u);
+
+  // reserve() rehashes a filled map without losing pairs
+  map.reserve(4*nb_keys);
+  BOOST_CHECK_EQUAL(map.size(), nb_keys);
+  for (Uint i=0; i<nb_keys; ++i)
+    if (const_map[7*i+3] != i)
+      ++nb_wrong;
+  BOOST_CHECK_EQUAL(nb_wrong, 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( collisions )
+{
+  boost::shared_ptr< HashMap<CollidingKey,Uint> > map_ptr = allocate_component< HashMap<CollidingKey,Uint> >("map");
+  HashMap<CollidingKey,Uint>& map = *map_ptr;
+
+  // All keys share one probe sequence, which wraps around the end of the table
+  const int nb_keys = 50;
+  for (int i=0; i<nb_keys; ++i)
+    map.push_back(CollidingKey(i), i);
+  for (int i=0; i<nb_keys; ++i)
+    BOOST_CHECK_EQUAL(map[CollidingKey(i)], static_cast<Uint>(i));
+  BOOST_CHECK(!map.exists(CollidingKey(nb_keys)));
+
+  // Erasing from the front, the middle and the end of the sequence
+  // shifts the following keys back so they can still be found
+  BOOST_CHECK(map.erase(CollidingKey(0)));
+  BOOST_CHECK(map.erase(CollidingKey(nb_keys/2)));
+  BOOST_CHECK(map.erase(CollidingKey(nb_keys-1)));
+  BOOST_CHECK_EQUAL(map.size(), static_cast<size_t>(nb_keys-3));
+  for (int i=0; i<nb_keys; ++i)
+  {
+    const bool erased = (i == 0 || i == nb_keys/2 || i == nb_keys-1);
+    BOOST_CHECK_EQUAL(map.exists(CollidingKey(i)), !erased);
+    if (!erased)
+      BOOST_CHECK_EQUAL(map[CollidingKey(i)], static_cast<Uint>(i));
+  }
+
+  // Erased keys can be inserted again
+  map.push_back(CollidingKey(0), 100u);
+  BOOST_CHECK_EQUAL(map[CollidingKey(0)], 100u);
+  BOOST_CHECK_EQUAL(map.size(), static_cast<size_t>(nb_keys-2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,82 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::common::TextScanner"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/TextScanner.hpp"
+
+using namespace std;
+using namespace cf3;
+using namespace cf3::common;
+
+BOOST_AUTO_TEST_SUITE( TextScanner_TestSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( numbers )
+{
+  const std::string text = " 12\t-3  +4 0.25 -1.5e-3 2E+2 \r\n 0.8571428571430554 name\n";
+  TextScanner scanner(text.data(), text.data()+text.size());
+
+  BOOST_CHECK_EQUAL(scanner.next_uint(), 12u);
+  BOOST_CHECK_EQUAL(scanner.next_int(), -3);
+  BOOST_CHECK_EQUAL(scanner.next_int(), 4);
+  BOOST_CHECK_EQUAL(scanner.next_real(), 0.25);
+  BOOST_CHECK_EQUAL(scanner.next_real(), -1.5e-3);
+  BOOST_CHECK_EQUAL(scanner.next_real(), 200.);
+  BOOST_CHECK_EQUAL(scanner.next_real(), 0.8571428571430554);
+  BOOST_CHECK_THROW(scanner.next_real(), ParsingFailed);
+  BOOST_CHECK_EQUAL(scanner.next_token(), "name");
+  BOOST_CHECK(scanner.at_end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( lines )
+{
+  const std::string text = "1 2 3\n4 5 6\n7";
+  TextScanner scanner(text.data(), text.data()+text.size());
+
+  BOOST_CHECK_EQUAL(TextScanner::count_lines(text.data(), text.data()+text.size()), 2u);
+  BOOST_CHECK_EQUAL(scanner.next_uint(), 1u);
+  scanner.skip_line();
+  scanner.skip_token();
+  BOOST_CHECK_EQUAL(scanner.next_uint(), 5u);
+  scanner.skip_line();
+  BOOST_CHECK_EQUAL(scanner.next_uint(), 7u);
+  BOOST_CHECK(scanner.at_end());
+  BOOST_CHECK_THROW(scanner.next_uint(), ParsingFailed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( reals_as_strtod )
+{
+  // Reals are converted exactly as strtod does, also with many significant digits
+  srand(1);
+  char buffer[64];
+  for (Uint i=0; i<10000; ++i)
+  {
+    const double value = (static_cast<double>(rand())/RAND_MAX-0.5) * (rand()%2 ? 1e-8 : 1e8);
+    sprintf(buffer, "%.*g", 1+rand()%17, value);
+    TextScanner scanner(buffer, buffer+strlen(buffer));
+    BOOST_CHECK_EQUAL(scanner.next_real(), strtod(buffer,0));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -387,6 +387,51 @@ BOOST_AUTO_TEST_CASE( test_matrix_only )
     CFinfo << "skipping symmetric dirichlet test" << CFendl;
   }
 
+  // bc-related: dirichlet-condition in bulk, ghost rows are skipped
+  mat->reset(-1.);
+  if (irank==0)
+  {
+    std::vector<Uint> blockrows, eqs;
+    blockrows += 3,3,1;
+    eqs += 1,0,1;
+    mat->set_rows(blockrows,eqs,1.,0.);
+    mat->debug_data(rows,cols,vals);
+    for (int i=0; i<(const int)vals.size(); i++)
+    {
+      if ((rows[i]==6)||(rows[i]==7))
+      {
+        if (cols[i]==rows[i]) { BOOST_CHECK_EQUAL(vals[i],1.); }
+        else { BOOST_CHECK_EQUAL(vals[i],0.); }
+      } else {
+        BOOST_CHECK_EQUAL(vals[i],-1.);
+      }
+    }
+  }
+
+  // bc-related: symmetricizing dirichlets in bulk gives the same as column by column
+  mat->reset(1.);
+  if (irank==0)
+  {
+    std::vector<Real> col10, col11;
+    mat->get_column_and_replace_to_zero(5,0,col10);
+    mat->get_column_and_replace_to_zero(5,1,col11);
+    mat->reset(1.);
+    std::vector<Uint> blockcols, eqs;
+    std::vector<Real> colvals;
+    blockcols += 5,5;
+    eqs += 0,1;
+    colvals += 3.,2.;
+    mat->get_columns_and_replace_to_zero(blockcols,eqs,colvals,vals);
+    BOOST_CHECK_EQUAL(vals.size(),col10.size());
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],3.*col10[i]+2.*col11[i]);
+    mat->debug_data(rows,cols,vals);
+    for (int i=0; i<(const int)vals.size(); i++)
+    {
+      if ((cols[i]==10)||(cols[i]==11)) { BOOST_CHECK_EQUAL(vals[i],0.); }
+      else { BOOST_CHECK_EQUAL(vals[i],1.); }
+    }
+  }
+
   // bc-related: periodicity
   mat->reset(-2.);
   if (irank==0)
@@ -687,6 +732,56 @@ BOOST_AUTO_TEST_CASE( test_complete_system )
     for (int i=14; i<16; i++) BOOST_CHECK_EQUAL(vals[i],4.);
   }
 
+  // dirichlet bc in bulk and queued, must match the one by one application
+  if (irank==0)
+  {
+    std::vector<Uint> ref_rows, ref_cols;
+    std::vector<Real> ref_mat, ref_sol, ref_rhs;
+    std::vector<Uint> blockrows, eqs;
+    std::vector<Real> values;
+    blockrows += 3,2;
+    eqs += 1,0;
+    values += 5.,6.;
+
+    sys->matrix()->reset(2.);
+    sys->solution()->reset(3.);
+    sys->rhs()->reset(4.);
+    sys->dirichlet(3,1,5.,true);
+    sys->dirichlet(2,0,6.,true);
+    sys->matrix()->debug_data(ref_rows,ref_cols,ref_mat);
+    sys->solution()->debug_data(ref_sol);
+    sys->rhs()->debug_data(ref_rhs);
+
+    sys->matrix()->reset(2.);
+    sys->solution()->reset(3.);
+    sys->rhs()->reset(4.);
+    sys->dirichlet(blockrows,eqs,values,true);
+    sys->matrix()->debug_data(rows,cols,vals);
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],ref_mat[i]);
+    sys->solution()->debug_data(vals);
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],ref_sol[i]);
+    sys->rhs()->debug_data(vals);
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],ref_rhs[i]);
+
+    sys->matrix()->reset(2.);
+    sys->solution()->reset(3.);
+    sys->rhs()->reset(4.);
+    sys->dirichlet(3,1,5.,false);
+    sys->dirichlet(2,0,6.,false);
+    sys->matrix()->debug_data(ref_rows,ref_cols,ref_mat);
+    sys->rhs()->debug_data(ref_rhs);
+
+    sys->matrix()->reset(2.);
+    sys->solution()->reset(3.);
+    sys->rhs()->reset(4.);
+    sys->queue_dirichlet(3,1,5.);
+    sys->queue_dirichlet(2,0,6.);
+    sys->matrix()->debug_data(rows,cols,vals);
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],ref_mat[i]);
+    sys->rhs()->debug_data(vals);
+    for (int i=0; i<(const int)vals.size(); i++) BOOST_CHECK_EQUAL(vals[i],ref_rhs[i]);
+  }
+
   // performant access - out of range access does not fail
   sys->reset();
   if (irank==1)
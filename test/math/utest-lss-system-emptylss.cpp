@@ -198,6 +198,11 @@ BOOST_AUTO_TEST_CASE( check_emptylss_implementations )
   BOOST_TEST_CHECKPOINT( "dirichlet" );
   sys->dirichlet(0,0,0.,true);
 
+  BOOST_TEST_CHECKPOINT( "bulk dirichlet" );
+  sys->dirichlet(std::vector<Uint>(2,0),std::vector<Uint>(2,0),std::vector<Real>(2,0.),true);
+  sys->queue_dirichlet(0,0,0.);
+  sys->apply_dirichlet();
+
   BOOST_TEST_CHECKPOINT( "periodicity" );
   sys->periodicity (0,0);
 
@@ -12,6 +12,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/List.hpp"
@@ -21,6 +23,7 @@
 #include "mesh/BlockMesh/BlockData.hpp"
 #include "mesh/Domain.hpp"
 #include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/MeshWriter.hpp"
 #include "mesh/Region.hpp"
@@ -174,6 +177,32 @@ BOOST_AUTO_TEST_CASE( WriteMesh )
   mesh().write_mesh("utest-blockmesh-3d-mpi_output.pvtu", fields);
 }
 
+BOOST_AUTO_TEST_CASE( GenerateMeshWithoutPartitioning )
+{
+  PE::Comm& comm = PE::Comm::instance();
+
+  BlockMesh::BlockArrays& blocks = *domain().create_component<BlockMesh::BlockArrays>("UnpartitionedBlockArrays");
+  Tools::MeshGeneration::create_channel_3d(blocks, 12., 0.5, 6., x_segs, y_segs/2, z_segs, 0.1);
+  blocks.options().set("overlap", 0u);
+
+  // The blocks are partitioned by create_mesh itself
+  Mesh& unpartitioned_mesh = *domain().create_component<Mesh>("unpartitioned_mesh");
+  blocks.create_mesh(unpartitioned_mesh);
+
+  Uint nb_cells = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(unpartitioned_mesh.topology()))
+  {
+    if(elements.element_type().dimensionality() == 3)
+      nb_cells += elements.size();
+  }
+
+  Uint total_nb_cells = nb_cells;
+  comm.all_reduce(PE::plus(), &nb_cells, 1, &total_nb_cells);
+  BOOST_CHECK_EQUAL(total_nb_cells, x_segs*(y_segs/2)*2*z_segs);
+  if(comm.size() > 1)
+    BOOST_CHECK(nb_cells < total_nb_cells);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,187 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Rebalance"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/Group.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/Rebalance.hpp"
+#include "mesh/actions/LoadBalance.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestRebalance_Fixture
+{
+  TestRebalance_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Number of elements in a region, including ghosts, as a solver action would loop over
+  Uint nb_elements(const Region& region)
+  {
+    Uint nb_elems = 0;
+    boost_foreach(const Entities& entities, find_components_recursively<Entities>(region))
+      nb_elems += entities.size();
+    return nb_elems;
+  }
+
+  /// Component with the timing properties and the "regions" option of a timed solver action
+  void add_timed_action(Component& parent, const std::string& name, const std::vector<URI>& regions, const Real time)
+  {
+    Handle<Component> action = parent.create_component<Group>(name);
+    action->options().add("regions", regions);
+    action->properties().add("timer_count", Uint(1));
+    action->properties().add("timer_mean", time);
+  }
+
+  /// Largest weighted load of the owned elements of a processor, relative to the average load
+  Real weighted_imbalance(const Mesh& mesh, const Real cell_cost, const Real face_cost)
+  {
+    Real load = 0.;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      const Real cost = entities->element_type().dimensionality() == mesh.dimensionality() ? cell_cost : face_cost;
+      for (Uint elem=0; elem<entities->size(); ++elem)
+        if (!entities->is_ghost(elem))
+          load += cost;
+    }
+    std::vector<Real> loads;
+    PE::Comm::instance().all_gather(load, loads);
+    Real max_load = 0.;
+    Real total_load = 0.;
+    boost_foreach(const Real proc_load, loads)
+    {
+      max_load = std::max(max_load, proc_load);
+      total_load += proc_load;
+    }
+    return max_load * loads.size() / total_load;
+  }
+
+  Uint nb_owned_elements(const Mesh& mesh)
+  {
+    Uint nb_owned = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      for (Uint elem=0; elem<entities->size(); ++elem)
+        if (!entities->is_ghost(elem))
+          ++nb_owned;
+    }
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_owned, 1, &nb_owned);
+    return nb_owned;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestRebalance_TestSuite, TestRebalance_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( rebalance_with_measured_costs )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,40.));
+  mesh_generator->options().set("nb_cells",std::vector<Uint>(2,40u));
+  Mesh& mesh = mesh_generator->generate();
+  allocate_component<LoadBalance>("load_balance")->transform(mesh);
+
+  Field& field = mesh.geometry_fields().create_field("field");
+  const Field& coords = mesh.geometry_fields().coordinates();
+  for (Uint node=0; node<field.size(); ++node)
+    field[node][0] = coords[node][XX] + 2.*coords[node][YY];
+
+  const Uint nb_elements_before = nb_owned_elements(mesh);
+
+  // Boundary faces are a hundred times as expensive as cells,
+  // and the first processor is slower than the others
+  const Real cell_cost = 1e-6;
+  const Real face_cost = 1e-4;
+  const Real slowdown = PE::Comm::instance().rank() == 0 ? 2. : 1.;
+  Handle<Component> timings = Core::instance().root().create_component<Group>("timings");
+
+  Region& interior = *Handle<Region>(mesh.topology().get_child("interior"));
+  add_timed_action(*timings, "cells", std::vector<URI>(1,interior.uri()), slowdown*cell_cost*nb_elements(interior));
+
+  std::vector<URI> boundaries;
+  Uint nb_faces = 0;
+  boost_foreach(const Region& region, find_components<Region>(mesh.topology()))
+  {
+    if (region.name() != "interior")
+    {
+      boundaries.push_back(region.uri());
+      nb_faces += nb_elements(region);
+    }
+  }
+  add_timed_action(*timings, "faces", boundaries, slowdown*face_cost*nb_faces);
+
+  boost::shared_ptr<Rebalance> rebalance = allocate_component<Rebalance>("rebalance");
+  rebalance->options().set("actions", std::vector<URI>(1,timings->uri()));
+  rebalance->options().set("imbalance_threshold", 1.1);
+  rebalance->transform(mesh);
+
+  CFinfo << "measured imbalance before rebalancing: " << rebalance->imbalance() << CFendl;
+  BOOST_CHECK_GT(rebalance->imbalance(), 1.1);
+
+  // All elements are kept, and are distributed by their cost
+  BOOST_CHECK_EQUAL(nb_owned_elements(mesh), nb_elements_before);
+  const Real imbalance_after = weighted_imbalance(mesh, cell_cost, face_cost);
+  CFinfo << "weighted imbalance after rebalancing: " << imbalance_after << CFendl;
+  BOOST_CHECK_LT(imbalance_after, 1.15);
+
+  // Field values moved along with the nodes
+  for (Uint node=0; node<field.size(); ++node)
+    BOOST_CHECK_CLOSE(field[node][0], coords[node][XX] + 2.*coords[node][YY], 1e-10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,169 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Renumber on a distributed mesh"
+
+#include <algorithm>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/CSRTable.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/NodeElementConnectivity.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestRenumberMPI_Fixture
+{
+  TestRenumberMPI_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Global indices and ranks of the nodes of every element, which must not change by renumbering
+  std::set< std::vector<Uint> > element_signatures(const Mesh& mesh)
+  {
+    const Dictionary& nodes = mesh.geometry_fields();
+    std::set< std::vector<Uint> > signatures;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      const Connectivity& connectivity = entities->geometry_space().connectivity();
+      for (Uint elem=0; elem<entities->size(); ++elem)
+      {
+        std::vector<Uint> signature(1, entities->glb_idx()[elem]);
+        signature.push_back(entities->rank()[elem]);
+        boost_foreach(const Uint node, connectivity[elem])
+        {
+          signature.push_back(nodes.glb_idx()[node]);
+          signature.push_back(nodes.rank()[node]);
+        }
+        signatures.insert(signature);
+      }
+    }
+    return signatures;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestRenumberMPI_TestSuite, TestRenumberMPI_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( renumber_distributed_mesh )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,10.));
+  mesh_generator->options().set("nb_cells",std::vector<Uint>(2,20u));
+  mesh_generator->options().set("overlap",1u);
+  Mesh& mesh = mesh_generator->generate();
+
+  Dictionary& nodes = mesh.geometry_fields();
+  const Field& coords = nodes.coordinates();
+  Field& field = nodes.create_field("field");
+  for (Uint node=0; node<field.size(); ++node)
+    field[node][0] = coords[node][XX] + 2.*coords[node][YY];
+  field.parallelize();
+
+  Handle<NodeElementConnectivity> node2elem = nodes.create_component<NodeElementConnectivity>("node2elem");
+  node2elem->setup(mesh.topology());
+
+  const std::set< std::vector<Uint> > signatures_before = element_signatures(mesh);
+  const Uint nb_nodes_before = nodes.size();
+
+  boost::shared_ptr<MeshTransformer> renumber = allocate_component<Renumber>("renumber");
+  renumber->options().set("ordering",std::string("rcm"));
+  renumber->transform(mesh);
+
+  // The same elements connect the same global nodes, only the local numbering changed
+  BOOST_CHECK_EQUAL(nodes.size(), nb_nodes_before);
+  BOOST_CHECK(element_signatures(mesh) == signatures_before);
+
+  // Fields moved along with the nodes
+  for (Uint node=0; node<field.size(); ++node)
+    BOOST_CHECK_CLOSE(field[node][0], coords[node][XX] + 2.*coords[node][YY], 1e-10);
+
+  // The rebuilt communication pattern sends the owned values to the renumbered ghosts
+  for (Uint node=0; node<field.size(); ++node)
+    if (nodes.is_ghost(node))
+      field[node][0] = -1.;
+  field.synchronize();
+  for (Uint node=0; node<field.size(); ++node)
+    BOOST_CHECK_CLOSE(field[node][0], coords[node][XX] + 2.*coords[node][YY], 1e-10);
+
+  // The global to local map follows the renumbered nodes
+  for (Uint node=0; node<nodes.size(); ++node)
+    BOOST_CHECK_EQUAL(nodes.glb_to_loc()[nodes.glb_idx()[node]], node);
+
+  // The node to element connectivity was rebuilt: every listed element contains the node
+  BOOST_CHECK_EQUAL(node2elem->connectivity().size(), nodes.size());
+  Uint nb_wrong = 0;
+  for (Uint node=0; node<nodes.size(); ++node)
+  {
+    boost_foreach(const Uint unified_idx, node2elem->connectivity()[node])
+    {
+      Handle<Component> component;
+      Uint elem;
+      boost::tie(component, elem) = node2elem->elements().location(unified_idx);
+      const Connectivity::ConstRow elem_nodes = Handle<Entities>(component)->geometry_space().connectivity()[elem];
+      if (std::find(elem_nodes.begin(), elem_nodes.end(), node) == elem_nodes.end())
+        ++nb_wrong;
+    }
+  }
+  BOOST_CHECK_EQUAL(nb_wrong, 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,227 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Renumber"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+#include "mesh/actions/BuildFaces.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestRenumber_Fixture
+{
+  TestRenumber_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  Mesh& generate(const std::string& name, const std::vector<Uint>& nb_cells)
+  {
+    Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>(name+"_generator");
+    mesh_generator->options().set("mesh",Core::instance().root().uri()/name);
+    mesh_generator->options().set("lengths",std::vector<Real>(nb_cells.size(),10.));
+    mesh_generator->options().set("nb_cells",nb_cells);
+    return mesh_generator->generate();
+  }
+
+  void renumber(Mesh& mesh, const std::string& ordering)
+  {
+    boost::shared_ptr<MeshTransformer> renumber = allocate_component<Renumber>("renumber");
+    renumber->options().set("ordering",ordering);
+    renumber->transform(mesh);
+  }
+
+  /// Largest difference between the node indices of one element
+  Uint bandwidth(const Mesh& mesh)
+  {
+    Uint max_bandwidth = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      boost_foreach(Connectivity::ConstRow nodes, entities->geometry_space().connectivity().array())
+      {
+        const Uint min_node = *std::min_element(nodes.begin(), nodes.end());
+        const Uint max_node = *std::max_element(nodes.begin(), nodes.end());
+        max_bandwidth = std::max(max_bandwidth, max_node-min_node);
+      }
+    }
+    return max_bandwidth;
+  }
+
+  typedef std::pair< Uint, std::vector<Uint> > ElementKey;
+
+  /// Coordinates of all nodes of every element, in connectivity order.
+  /// Elements are identified by their Entities and the sorted global indices of their nodes.
+  std::map< ElementKey, std::vector<Real> > element_coordinates(const Mesh& mesh)
+  {
+    std::map< ElementKey, std::vector<Real> > coordinates;
+    const Dictionary& geometry = mesh.geometry_fields();
+    const Field& coords = geometry.coordinates();
+    for (Uint entities_idx=0; entities_idx<mesh.elements().size(); ++entities_idx)
+    {
+      const Entities& entities = *mesh.elements()[entities_idx];
+      for (Uint elem=0; elem<entities.size(); ++elem)
+      {
+        ElementKey key(entities_idx, std::vector<Uint>());
+        std::vector<Real> elem_coords;
+        boost_foreach(const Uint node, entities.geometry_space().connectivity()[elem])
+        {
+          key.second.push_back(geometry.glb_idx()[node]);
+          for (Uint d=0; d<coords.row_size(); ++d)
+            elem_coords.push_back(coords[node][d]);
+        }
+        std::sort(key.second.begin(), key.second.end());
+        coordinates[key] = elem_coords;
+      }
+    }
+    return coordinates;
+  }
+
+  /// Nodes of a face seen from one of its cells, sorted
+  std::vector<Uint> face_nodes(const Entity& cell, const Uint face_nb)
+  {
+    std::vector<Uint> nodes;
+    Connectivity::ConstRow cell_nodes = cell.get_nodes();
+    boost_foreach(const Uint node_in_face, cell.element_type().faces().nodes_range(face_nb))
+      nodes.push_back(cell_nodes[node_in_face]);
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestRenumber_TestSuite, TestRenumber_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( rcm_reduces_bandwidth )
+{
+  Mesh& mesh = generate("rect", list_of(20)(20));
+
+  renumber(mesh, "hilbert");
+  const Uint hilbert_bandwidth = bandwidth(mesh);
+
+  renumber(mesh, "rcm");
+  const Uint rcm_bandwidth = bandwidth(mesh);
+
+  CFinfo << "bandwidth with hilbert ordering: " << hilbert_bandwidth << CFendl;
+  CFinfo << "bandwidth with rcm ordering:     " << rcm_bandwidth << CFendl;
+  BOOST_CHECK_LT(rcm_bandwidth, hilbert_bandwidth);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( renumber_keeps_mesh_consistent )
+{
+  Mesh& mesh = generate("box", list_of(6)(5)(4));
+
+  boost::shared_ptr<MeshTransformer> build_faces = allocate_component<BuildFaces>("build_faces");
+  build_faces->transform(mesh);
+
+  // Field depending on the coordinates, and element field with the element global indices
+  Field& geometry_field = mesh.geometry_fields().create_field("geometry_field");
+  const Field& coords = mesh.geometry_fields().coordinates();
+  for (Uint node=0; node<geometry_field.size(); ++node)
+    geometry_field[node][0] = coords[node][XX] + 2.*coords[node][YY] + 3.*coords[node][ZZ];
+
+  Dictionary& elems_P0 = mesh.create_discontinuous_space("elems_P0","cf3.mesh.LagrangeP0");
+  Field& elem_field = elems_P0.create_field("elem_field");
+  boost_foreach(const Handle<Entities>& entities, elems_P0.entities_range())
+  {
+    const Space& space = elems_P0.space(*entities);
+    for (Uint elem=0; elem<entities->size(); ++elem)
+      elem_field[space.connectivity()[elem][0]][0] = entities->glb_idx()[elem];
+  }
+
+  const std::map< ElementKey, std::vector<Real> > coordinates_before = element_coordinates(mesh);
+  const Uint nb_faces_before = find_components_recursively<FaceCellConnectivity>(mesh).size();
+
+  renumber(mesh, "hilbert");
+  renumber(mesh, "rcm");
+
+  BOOST_CHECK(mesh.check_sanity());
+  BOOST_CHECK_EQUAL(nb_faces_before, find_components_recursively<FaceCellConnectivity>(mesh).size());
+
+  // Elements still consist of the same nodes
+  BOOST_CHECK(coordinates_before == element_coordinates(mesh));
+
+  // Field rows moved along with the nodes and elements
+  for (Uint node=0; node<geometry_field.size(); ++node)
+    BOOST_CHECK_CLOSE(geometry_field[node][0], coords[node][XX] + 2.*coords[node][YY] + 3.*coords[node][ZZ], 1e-10);
+  boost_foreach(const Handle<Entities>& entities, elems_P0.entities_range())
+  {
+    const Space& space = elems_P0.space(*entities);
+    for (Uint elem=0; elem<entities->size(); ++elem)
+      BOOST_CHECK_EQUAL(elem_field[space.connectivity()[elem][0]][0], static_cast<Real>(entities->glb_idx()[elem]));
+  }
+
+  // Both cells of every face still see the same face
+  boost_foreach(const FaceCellConnectivity& f2c, find_components_recursively<FaceCellConnectivity>(mesh))
+  {
+    for (Uint face=0; face<f2c.size(); ++face)
+    {
+      const std::vector<Uint> nodes = face_nodes(f2c.connectivity()[face][0], f2c.face_number()[face][0]);
+      if (!f2c.is_bdry_face()[face])
+        BOOST_CHECK(nodes == face_nodes(f2c.connectivity()[face][1], f2c.face_number()[face][1]));
+
+      Handle<Entities const> faces(f2c.parent());
+      if (is_not_null(faces) && faces->size() == f2c.size())
+      {
+        Connectivity::ConstRow own_nodes = faces->geometry_space().connectivity()[face];
+        std::vector<Uint> sorted_own_nodes(own_nodes.begin(), own_nodes.end());
+        std::sort(sorted_own_nodes.begin(), sorted_own_nodes.end());
+        BOOST_CHECK(nodes == sorted_own_nodes);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,302 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::UniformRefinement"
+
+#include <cmath>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/UniformRefinement.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestUniformRefinement_Fixture
+{
+  TestUniformRefinement_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  Mesh& generate(const std::string& name, const Uint dim, const Uint nb_cells)
+  {
+    Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>(name+"_generator");
+    mesh_generator->options().set("mesh",Core::instance().root().uri()/name);
+    mesh_generator->options().set("lengths",std::vector<Real>(dim,1.));
+    mesh_generator->options().set("nb_cells",std::vector<Uint>(dim,nb_cells));
+    return mesh_generator->generate();
+  }
+
+  /// Read a mesh file and distribute it over the processors, with an overlap layer
+  Mesh& load(const std::string& name, const std::string& reader, const std::string& file)
+  {
+    Mesh& mesh = *Core::instance().root().create_component<Mesh>(name);
+    build_component_abstract_type<MeshReader>(reader,name+"_reader")->read_mesh_into(file,mesh);
+    build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.LoadBalance",name+"_load_balance")->transform(mesh);
+    return mesh;
+  }
+
+  /// Number of owned cells in a mesh, summed over all processors
+  Uint nb_owned_cells(const Mesh& mesh)
+  {
+    Uint nb_owned = 0;
+    boost_foreach(const Entities& cells, find_components_recursively_with_filter<Entities>(mesh,IsElementsVolume()))
+    {
+      for (Uint elem=0; elem<cells.size(); ++elem)
+        if (!cells.is_ghost(elem))
+          ++nb_owned;
+    }
+    Uint total = nb_owned;
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_owned, 1, &total);
+    return total;
+  }
+
+  /// Volume of the owned cells in a mesh, summed over all processors
+  /// @param [out] nb_inverted  number of cells of all processors without a positive volume
+  Real total_volume(const Mesh& mesh, Uint& nb_inverted)
+  {
+    Real volume = 0.;
+    Uint nb_local_inverted = 0;
+    boost_foreach(const Entities& cells, find_components_recursively_with_filter<Entities>(mesh,IsElementsVolume()))
+    {
+      for (Uint elem=0; elem<cells.size(); ++elem)
+      {
+        const Real cell_volume = cells.element_type().volume(cells.geometry_space().get_coordinates(elem));
+        if (cell_volume <= 0.)
+          ++nb_local_inverted;
+        if (!cells.is_ghost(elem))
+          volume += cell_volume;
+      }
+    }
+    Real total = volume;
+    PE::Comm::instance().all_reduce(PE::plus(), &volume, 1, &total);
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_local_inverted, 1, &nb_inverted);
+    return total;
+  }
+
+  /// Number of owned elements in a region, summed over all processors
+  Uint nb_owned_elements(const Region& region)
+  {
+    Uint nb_owned = 0;
+    boost_foreach(const Entities& entities, find_components_recursively<Entities>(region))
+    {
+      for (Uint elem=0; elem<entities.size(); ++elem)
+        if (!entities.is_ghost(elem))
+          ++nb_owned;
+    }
+    Uint total = nb_owned;
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_owned, 1, &total);
+    return total;
+  }
+
+  /// Global indices of the owned nodes of all processors
+  std::vector<Uint> owned_nodes(const Dictionary& nodes)
+  {
+    std::vector<Uint> owned;
+    for (Uint node=0; node<nodes.size(); ++node)
+      if (!nodes.is_ghost(node))
+        owned.push_back(nodes.glb_idx()[node]);
+    std::vector< std::vector<Uint> > all_owned;
+    PE::Comm::instance().all_gather(owned, all_owned);
+    std::vector<Uint> glb_owned;
+    boost_foreach(const std::vector<Uint>& proc_owned, all_owned)
+      glb_owned.insert(glb_owned.end(), proc_owned.begin(), proc_owned.end());
+    return glb_owned;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestUniformRefinement_TestSuite, TestUniformRefinement_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( refine_rectangle )
+{
+  Mesh& mesh = generate("rectangle", 2, 8);
+  Dictionary& nodes = mesh.geometry_fields();
+  const Field& coords = nodes.coordinates();
+  Field& field = nodes.create_field("field");
+  for (Uint node=0; node<field.size(); ++node)
+    field[node][0] = coords[node][XX] + 2.*coords[node][YY];
+
+  allocate_component<UniformRefinement>("refine")->transform(mesh);
+
+  // Every quad is split in 4 and every boundary line in 2, without changing the partitioning
+  BOOST_CHECK_EQUAL(nb_owned_elements(*Handle<Region>(mesh.topology().get_child("interior"))), 256u);
+  BOOST_CHECK_EQUAL(nb_owned_elements(*Handle<Region>(mesh.topology().get_child("bottom"))), 16u);
+
+  // Every node is owned by exactly one processor
+  const std::vector<Uint> glb_owned = owned_nodes(nodes);
+  BOOST_CHECK_EQUAL(glb_owned.size(), 289u);
+  BOOST_CHECK_EQUAL(std::set<Uint>(glb_owned.begin(), glb_owned.end()).size(), 289u);
+
+  // Linear fields are interpolated exactly
+  for (Uint node=0; node<field.size(); ++node)
+    BOOST_CHECK_CLOSE(field[node][0], coords[node][XX] + 2.*coords[node][YY], 1e-10);
+
+  // Ghost nodes are synchronized from the right owners
+  field.parallelize();
+  for (Uint node=0; node<field.size(); ++node)
+    if (nodes.is_ghost(node))
+      field[node][0] = -1.;
+  field.synchronize();
+  for (Uint node=0; node<field.size(); ++node)
+    BOOST_CHECK_CLOSE(field[node][0], coords[node][XX] + 2.*coords[node][YY], 1e-10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( refine_box_twice )
+{
+  Mesh& mesh = generate("box", 3, 2);
+
+  boost::shared_ptr<UniformRefinement> refine = allocate_component<UniformRefinement>("refine_twice");
+  refine->options().set("levels", 2u);
+  refine->transform(mesh);
+
+  BOOST_CHECK_EQUAL(nb_owned_elements(*Handle<Region>(mesh.topology().get_child("interior"))), 512u);
+  BOOST_CHECK_EQUAL(nb_owned_elements(*Handle<Region>(mesh.topology().get_child("top"))), 64u);
+
+  const std::vector<Uint> glb_owned = owned_nodes(mesh.geometry_fields());
+  BOOST_CHECK_EQUAL(glb_owned.size(), 729u);
+  BOOST_CHECK_EQUAL(std::set<Uint>(glb_owned.begin(), glb_owned.end()).size(), 729u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( project_boundary_nodes )
+{
+  Mesh& mesh = generate("curved", 2, 4);
+  Region& top = *Handle<Region>(mesh.topology().get_child("top"));
+
+  boost::shared_ptr<UniformRefinement> refine = allocate_component<UniformRefinement>("refine_curved");
+  refine->options().set("boundary_regions", std::vector<URI>(1, top.uri()));
+  std::vector<std::string> projection(2);
+  projection[XX] = "x";
+  projection[YY] = "1+x*(1-x)";
+  refine->options().set("projection", projection);
+  refine->transform(mesh);
+
+  // The new nodes on the top boundary lie on the curve, the old ones did not move
+  const Field& coords = mesh.geometry_fields().coordinates();
+  boost_foreach(const Entities& faces, find_components_recursively<Entities>(top))
+  {
+    const Connectivity& connectivity = faces.geometry_space().connectivity();
+    for (Uint face=0; face<connectivity.size(); ++face)
+    {
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+      {
+        const Real x = coords[connectivity[face][n]][XX];
+        const Real y = coords[connectivity[face][n]][YY];
+        const bool is_new_node = std::abs(x*4. - std::floor(x*4.+0.5)) > 1e-10;
+        BOOST_CHECK_CLOSE(y, is_new_node ? 1.+x*(1.-x) : 1., 1e-10);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( refine_triangles )
+{
+  Mesh& mesh = load("triangles", "cf3.mesh.gmsh.Reader", "../../../resources/rectangle-tg-p1.msh");
+
+  const Uint nb_cells = nb_owned_cells(mesh);
+  const Uint nb_nodes = owned_nodes(mesh.geometry_fields()).size();
+  Uint nb_inverted = 0;
+  const Real volume = total_volume(mesh, nb_inverted);
+  BOOST_CHECK_EQUAL(nb_inverted, 0u);
+
+  allocate_component<UniformRefinement>("refine_triangles")->transform(mesh);
+
+  // Every triangle is split in 4 children with a positive area, covering the parent
+  BOOST_CHECK_EQUAL(nb_owned_cells(mesh), 4*nb_cells);
+  BOOST_CHECK_CLOSE(total_volume(mesh, nb_inverted), volume, 1e-10);
+  BOOST_CHECK_EQUAL(nb_inverted, 0u);
+
+  // A node is added on every edge, and the rectangle has nb_nodes + nb_cells - 1 edges (Euler)
+  const std::vector<Uint> glb_owned = owned_nodes(mesh.geometry_fields());
+  BOOST_CHECK_EQUAL(glb_owned.size(), 2*nb_nodes + nb_cells - 1);
+  BOOST_CHECK_EQUAL(std::set<Uint>(glb_owned.begin(), glb_owned.end()).size(), glb_owned.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( refine_tetrahedra )
+{
+  // 8 hexahedra on 27 nodes, and apart from them 6 tetrahedra on 8 nodes with 19 edges
+  Mesh& mesh = load("hextet", "cf3.mesh.neu.Reader", "../../../resources/hextet.neu");
+
+  BOOST_CHECK_EQUAL(nb_owned_cells(mesh), 14u);
+  BOOST_CHECK_EQUAL(owned_nodes(mesh.geometry_fields()).size(), 35u);
+  Uint nb_inverted = 0;
+  const Real volume = total_volume(mesh, nb_inverted);
+  BOOST_CHECK_EQUAL(nb_inverted, 0u);
+
+  allocate_component<UniformRefinement>("refine_tetrahedra")->transform(mesh);
+
+  BOOST_CHECK_EQUAL(nb_owned_cells(mesh), 8u*14u);
+  BOOST_CHECK_CLOSE(total_volume(mesh, nb_inverted), volume, 1e-10);
+  BOOST_CHECK_EQUAL(nb_inverted, 0u);
+
+  // The hexahedra become a 4x4x4 block of 125 nodes, the tetrahedra get a node on each edge
+  const std::vector<Uint> glb_owned = owned_nodes(mesh.geometry_fields());
+  BOOST_CHECK_EQUAL(glb_owned.size(), 125u + 8u + 19u);
+  BOOST_CHECK_EQUAL(std::set<Uint>(glb_owned.begin(), glb_owned.end()).size(), glb_owned.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,164 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Memory and traversal benchmark of the DynTable and CSRTable node to element connectivity"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/DynTable.hpp"
+#include "common/CSRTable.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/NodeElementConnectivity.hpp"
+
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct ConnectivityBenchmarkFixture : Tools::Testing::TimedTestFixture
+{
+  ConnectivityBenchmarkFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Sum of all entries, so the traversals can not be optimized away
+  static Uint traverse(const DynTable<Uint>& table)
+  {
+    Uint sum = 0;
+    for (Uint i=0; i<table.size(); ++i)
+      boost_foreach(const Uint entry, table[i])
+        sum += entry;
+    return sum;
+  }
+
+  static Uint traverse(const CSRTable<Uint>& table)
+  {
+    Uint sum = 0;
+    for (Uint i=0; i<table.size(); ++i)
+      boost_foreach(const Uint entry, table[i])
+        sum += entry;
+    return sum;
+  }
+
+  static Handle<Mesh> mesh;
+  static Handle< DynTable<Uint> > dyn_table;
+  static Handle< CSRTable<Uint> > csr_table;
+  static const Uint nb_cells = 60;
+  static const Uint nb_traversals = 20;
+
+  int    m_argc;
+  char** m_argv;
+};
+
+Handle<Mesh> ConnectivityBenchmarkFixture::mesh;
+Handle< DynTable<Uint> > ConnectivityBenchmarkFixture::dyn_table;
+Handle< CSRTable<Uint> > ConnectivityBenchmarkFixture::csr_table;
+const Uint ConnectivityBenchmarkFixture::nb_cells;
+const Uint ConnectivityBenchmarkFixture::nb_traversals;
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityBenchmarkSuite, ConnectivityBenchmarkFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+BOOST_AUTO_TEST_CASE( generate_mesh )
+{
+  boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","box_generator");
+  meshgenerator->options().set("mesh",URI("//box"));
+  meshgenerator->options().set("nb_cells",std::vector<Uint>(3,nb_cells));
+  meshgenerator->options().set("lengths",std::vector<Real>(3,1.));
+  mesh = meshgenerator->generate().handle<Mesh>();
+}
+
+/// Node to element connectivity built as before, by growing each row
+BOOST_AUTO_TEST_CASE( build_dyntable )
+{
+  dyn_table = mesh->create_component< DynTable<Uint> >("dyn_table");
+  dyn_table->resize(mesh->geometry_fields().size());
+  Uint elem_idx = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(mesh->topology()))
+  {
+    boost_foreach(Connectivity::ConstRow elem_nodes, elements.geometry_space().connectivity().array())
+    {
+      boost_foreach(const Uint node_idx, elem_nodes)
+        dyn_table->array()[node_idx].push_back(elem_idx);
+      ++elem_idx;
+    }
+  }
+}
+
+/// Node to element connectivity built with the two-pass CSRTableBuilder
+BOOST_AUTO_TEST_CASE( build_csrtable )
+{
+  Handle<NodeElementConnectivity> node2elem = mesh->create_component<NodeElementConnectivity>("node2elem");
+  node2elem->setup(mesh->topology());
+  csr_table = node2elem->connectivity().handle< CSRTable<Uint> >();
+}
+
+BOOST_AUTO_TEST_CASE( memory )
+{
+  BOOST_CHECK_EQUAL(dyn_table->size(), csr_table->size());
+
+  Uint dyn_bytes = dyn_table->array().capacity()*sizeof(std::vector<Uint>);
+  boost_foreach(DynTable<Uint>::ConstRow row, dyn_table->array())
+    dyn_bytes += row.capacity()*sizeof(Uint);
+  const Uint csr_bytes = csr_table->offsets().capacity()*sizeof(Uint) + csr_table->values().capacity()*sizeof(Uint);
+
+  CFinfo << "node to element connectivity of " << dyn_table->size() << " nodes:" << CFendl;
+  CFinfo << "  DynTable: " << dyn_bytes << " bytes (excluding allocator overhead of " << dyn_table->size() << " separate allocations)" << CFendl;
+  CFinfo << "  CSRTable: " << csr_bytes << " bytes" << CFendl;
+  BOOST_CHECK_LT(csr_bytes, dyn_bytes);
+}
+
+BOOST_AUTO_TEST_CASE( traverse_dyntable )
+{
+  Uint sum = 0;
+  for (Uint i=0; i<nb_traversals; ++i)
+    sum += traverse(*dyn_table);
+  BOOST_CHECK_EQUAL(sum, nb_traversals*traverse(*csr_table));
+}
+
+BOOST_AUTO_TEST_CASE( traverse_csrtable )
+{
+  Uint sum = 0;
+  for (Uint i=0; i<nb_traversals; ++i)
+    sum += traverse(*csr_table);
+  BOOST_CHECK_EQUAL(sum, nb_traversals*traverse(*csr_table));
+}
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
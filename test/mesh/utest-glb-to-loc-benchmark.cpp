@@ -0,0 +1,139 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Build and lookup benchmark of the sorted Map and the HashMap used as global to local index map"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Map.hpp"
+#include "common/HashMap.hpp"
+
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct GlbToLocBenchmarkFixture : Tools::Testing::TimedTestFixture
+{
+  /// Deterministic pseudo-random numbers, so every run looks up the same keys
+  static boost::uint64_t random(boost::uint64_t& state)
+  {
+    state = state*6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 17;
+  }
+
+  /// Global indices as they occur on one rank of a partitioned mesh:
+  /// a shuffled, sparse subset of a larger global numbering
+  static void create_keys()
+  {
+    boost::uint64_t state = 1;
+    glb_idx.clear();
+    glb_idx.reserve(nb_keys);
+    for (boost::uint64_t glb=0; glb_idx.size()<nb_keys; ++glb)
+      if (random(state) % 4 == 0)
+        glb_idx.push_back(glb);
+    for (Uint i=glb_idx.size()-1; i>0; --i)
+      std::swap(glb_idx[i], glb_idx[random(state) % (i+1)]);
+
+    lookups.resize(nb_lookups);
+    for (Uint i=0; i<nb_lookups; ++i)
+      lookups[i] = glb_idx[random(state) % nb_keys];
+  }
+
+  /// Sum of all looked up local indices, so the lookups can not be optimized away
+  template <typename MapT>
+  static Uint lookup(const MapT& glb_to_loc)
+  {
+    Uint sum = 0;
+    for (Uint i=0; i<nb_lookups; ++i)
+      sum += glb_to_loc.find(lookups[i])->second;
+    return sum;
+  }
+
+  static std::vector<boost::uint64_t> glb_idx;
+  static std::vector<boost::uint64_t> lookups;
+  static Handle< Map<boost::uint64_t,Uint> > sorted_map;
+  static Handle< HashMap<boost::uint64_t,Uint> > hash_map;
+  static const Uint nb_keys = 2000000;
+  static const Uint nb_lookups = 20000000;
+};
+
+std::vector<boost::uint64_t> GlbToLocBenchmarkFixture::glb_idx;
+std::vector<boost::uint64_t> GlbToLocBenchmarkFixture::lookups;
+Handle< Map<boost::uint64_t,Uint> > GlbToLocBenchmarkFixture::sorted_map;
+Handle< HashMap<boost::uint64_t,Uint> > GlbToLocBenchmarkFixture::hash_map;
+const Uint GlbToLocBenchmarkFixture::nb_keys;
+const Uint GlbToLocBenchmarkFixture::nb_lookups;
+
+BOOST_FIXTURE_TEST_SUITE( GlbToLocBenchmarkSuite, GlbToLocBenchmarkFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( create_global_indices )
+{
+  create_keys();
+  sorted_map = Core::instance().root().create_component< Map<boost::uint64_t,Uint> >("sorted_map");
+  hash_map = Core::instance().root().create_component< HashMap<boost::uint64_t,Uint> >("hash_map");
+}
+
+/// Build as in Dictionary::rebuild_map_glb_to_loc()
+BOOST_AUTO_TEST_CASE( build_sorted_map )
+{
+  sorted_map->reserve(nb_keys);
+  for (Uint n=0; n<nb_keys; ++n)
+    sorted_map->push_back(glb_idx[n],n);
+  sorted_map->sort_keys();
+}
+
+BOOST_AUTO_TEST_CASE( build_hash_map )
+{
+  hash_map->reserve(nb_keys);
+  for (Uint n=0; n<nb_keys; ++n)
+    hash_map->push_back(glb_idx[n],n);
+  hash_map->sort_keys();
+}
+
+BOOST_AUTO_TEST_CASE( lookup_sorted_map )
+{
+  const Map<boost::uint64_t,Uint>& glb_to_loc = *sorted_map;
+  CFinfo << "checksum " << lookup(glb_to_loc) << CFendl;
+}
+
+BOOST_AUTO_TEST_CASE( lookup_hash_map )
+{
+  const HashMap<boost::uint64_t,Uint>& glb_to_loc = *hash_map;
+  CFinfo << "checksum " << lookup(glb_to_loc) << CFendl;
+}
+
+BOOST_AUTO_TEST_CASE( compare )
+{
+  const Map<boost::uint64_t,Uint>& sorted = *sorted_map;
+  const HashMap<boost::uint64_t,Uint>& hashed = *hash_map;
+  BOOST_CHECK_EQUAL(sorted.size(), hashed.size());
+  BOOST_CHECK_EQUAL(lookup(sorted), lookup(hashed));
+  Uint nb_wrong = 0;
+  for (Uint n=0; n<nb_keys; ++n)
+    if (hashed[glb_idx[n]] != n || sorted[glb_idx[n]] != n)
+      ++nb_wrong;
+  BOOST_CHECK_EQUAL(nb_wrong, 0u);
+  // global indices not on this rank
+  const boost::uint64_t max_glb = *std::max_element(glb_idx.begin(), glb_idx.end());
+  BOOST_CHECK(!hashed.exists(max_glb+1));
+  BOOST_CHECK_EQUAL(hashed.exists(max_glb/2), sorted.exists(max_glb/2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,187 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for parallel reading with cf3::mesh::CGNS::Reader"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/MeshReader.hpp"
+
+#include "mesh/CGNS/Shared.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::CGNS;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct CGNSParallelTests_Fixture
+{
+  /// common setup for each test case
+  CGNSParallelTests_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~CGNSParallelTests_Fixture()
+  {
+  }
+
+  /// common values accessed by all tests goes here
+  int    m_argc;
+  char** m_argv;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Value of the flow solution written in every node
+Real density(const Real x, const Real y) { return x + 10.*y; }
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( CGNSParallelTests_TestSuite, CGNSParallelTests_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_unstructured_grid )
+{
+  if (PE::Comm::instance().rank() == 0)
+  {
+    const int ni=9, nj=7;
+    std::vector<double> x(ni*nj), y(ni*nj), rho(ni*nj);
+    for (int j=0; j<nj; ++j)
+    {
+      for (int i=0; i<ni; ++i)
+      {
+        x[i+j*ni] = i;
+        y[i+j*ni] = j;
+        rho[i+j*ni] = density(i,j);
+      }
+    }
+
+    std::vector<int> quads;
+    for (int j=0; j<nj-1; ++j)
+    {
+      for (int i=0; i<ni-1; ++i)
+      {
+        const int first_node = 1+i+j*ni;
+        quads.push_back(first_node);
+        quads.push_back(first_node+1);
+        quads.push_back(first_node+1+ni);
+        quads.push_back(first_node+ni);
+      }
+    }
+    const int nb_quads = quads.size()/4;
+
+    std::vector<int> bars;
+    for (int i=0; i<ni-1; ++i)
+    {
+      bars.push_back(1+i);
+      bars.push_back(2+i);
+    }
+    const int nb_bars = bars.size()/2;
+
+    int index_file, index_base, index_zone, index_coord, index_section, index_bc, index_flow, index_field;
+    int isize[3] = { ni*nj, nb_quads, 0 };
+    CALL_CGNS(cg_open("grid_parallel.cgns",CG_MODE_WRITE,&index_file));
+    CALL_CGNS(cg_base_write(index_file,"Base",2,2,&index_base));
+    CALL_CGNS(cg_zone_write(index_file,index_base,"Zone",isize,Unstructured,&index_zone));
+    CALL_CGNS(cg_coord_write(index_file,index_base,index_zone,RealDouble,"CoordinateX",&x[0],&index_coord));
+    CALL_CGNS(cg_coord_write(index_file,index_base,index_zone,RealDouble,"CoordinateY",&y[0],&index_coord));
+    CALL_CGNS(cg_section_write(index_file,index_base,index_zone,"Elem",QUAD_4,1,nb_quads,0,&quads[0],&index_section));
+    CALL_CGNS(cg_section_write(index_file,index_base,index_zone,"BottomElem",BAR_2,nb_quads+1,nb_quads+nb_bars,0,&bars[0],&index_section));
+    int bottom_range[2] = { nb_quads+1, nb_quads+nb_bars };
+    CALL_CGNS(cg_boco_write(index_file,index_base,index_zone,"bottom",BCWall,ElementRange,2,bottom_range,&index_bc));
+    CALL_CGNS(cg_sol_write(index_file,index_base,index_zone,"FlowSolution",Vertex,&index_flow));
+    CALL_CGNS(cg_field_write(index_file,index_base,index_zone,index_flow,RealDouble,"Density",&rho[0],&index_field));
+    CALL_CGNS(cg_close(index_file));
+  }
+  PE::Comm::instance().barrier();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( read_distributed )
+{
+  PE::Comm& comm = PE::Comm::instance();
+
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.CGNS.Reader","meshreader");
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("grid_parallel");
+  meshreader->read_mesh_into("grid_parallel.cgns",mesh);
+
+  // Every cell is read by exactly one rank
+  Uint nb_cells = 0;
+  Dictionary& nodes = mesh.geometry_fields();
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+  {
+    if (elements.element_type().dimensionality() != 2)
+      continue;
+    nb_cells += elements.size();
+
+    // The nodes of the owned cells, including the ghost nodes, are available locally
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+    for (Uint e=0; e<connectivity.size(); ++e)
+    {
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+        BOOST_CHECK(connectivity[e][n] < nodes.size());
+    }
+  }
+  Uint total_nb_cells = nb_cells;
+  if (comm.is_active())
+    comm.all_reduce(PE::plus(), &nb_cells, 1, &total_nb_cells);
+  BOOST_CHECK_EQUAL(total_nb_cells, 48u);
+  if (comm.size() > 1)
+    BOOST_CHECK(nb_cells < total_nb_cells);
+
+  // Coordinates and flow solution of the ghost nodes come from their owners
+  Handle<Field> flow_solution(nodes.get_child("FlowSolution"));
+  BOOST_REQUIRE(is_not_null(flow_solution));
+  const Field& coords = nodes.coordinates();
+  for (Uint n=0; n<nodes.size(); ++n)
+    BOOST_CHECK_CLOSE((*flow_solution)[n][0], density(coords[n][XX],coords[n][YY]), 1e-10);
+
+  // The boundary spans the entire section, which is renamed on all ranks
+  BOOST_CHECK(is_not_null(mesh.topology().get_child("bottom")));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "common/DynTable.hpp"
+#include "common/CSRTable.hpp"
 #include "mesh/ElementType.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
@@ -700,6 +701,74 @@ BOOST_AUTO_TEST_CASE ( DynTable_test_hard )
 
 }
 
+BOOST_AUTO_TEST_CASE ( CSRTable_test )
+{
+//  0:  0
+//  1:  ~
+//  2:  1 4 5
+//  3:  0 3
+  DynTable<Uint>& dyn_table = *root.create_component< DynTable<Uint> >("dyn_table");
+  dyn_table.resize(4);
+  std::vector<Uint> row;
+  row = list_of(0);
+  dyn_table.set_row(0,row);
+  row = list_of(1)(4)(5);
+  dyn_table.set_row(2,row);
+  row = list_of(0)(3);
+  dyn_table.set_row(3,row);
+
+  // Two-pass construction, adding the rows in a shuffled order
+  CSRTable<Uint>& table = *root.create_component< CSRTable<Uint> >("csr_table");
+  CSRTableBuilder<Uint> builder(table,4);
+  builder.count(3,2);
+  builder.count(2,3);
+  builder.count(0);
+  builder.allocate();
+  BOOST_CHECK_EQUAL(table.nb_values(), 6u);
+  builder.add(2,1);
+  builder.add(3,0);
+  builder.add(2,4);
+  builder.add(0,0);
+  builder.add(3,3);
+  builder.add(2,5);
+  BOOST_CHECK_EQUAL(builder.nb_added(2), 3u);
+
+  // Construction by copying a DynTable
+  CSRTable<Uint>& copy = *root.create_component< CSRTable<Uint> >("csr_table_copy");
+  copy.assign(dyn_table.array());
+
+  BOOST_CHECK_EQUAL(table.size(), dyn_table.size());
+  BOOST_CHECK_EQUAL(copy.size(), dyn_table.size());
+  for (Uint i=0; i<dyn_table.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(table.row_size(i), dyn_table.row_size(i));
+    BOOST_CHECK_EQUAL(copy[i].size(), dyn_table[i].size());
+    Uint j=0;
+    boost_foreach(const Uint entry, table[i])
+    {
+      BOOST_CHECK_EQUAL(entry, dyn_table[i][j]);
+      BOOST_CHECK_EQUAL(copy[i][j], dyn_table[i][j]);
+      ++j;
+    }
+  }
+  BOOST_CHECK_EQUAL(table.offsets()[2], 1u);
+  BOOST_CHECK_EQUAL(table.offsets()[4], 6u);
+
+  // Values can be modified, row sizes can not
+  table[2][1] = 7;
+  BOOST_CHECK_EQUAL(table.values()[2], 7u);
+  row = list_of(2)(8);
+  table.set_row(3,row);
+  BOOST_CHECK_EQUAL(table[3][1], 8u);
+  BOOST_CHECK_THROW(table.set_row(1,row), BadValue);
+
+  table.resize(6);
+  BOOST_CHECK_EQUAL(table.row_size(5), 0u);
+  table.resize(2);
+  BOOST_CHECK_EQUAL(table.nb_values(), 1u);
+  CFinfo << table << CFendl;
+}
+
 
 BOOST_AUTO_TEST_CASE ( Mesh_test )
 {
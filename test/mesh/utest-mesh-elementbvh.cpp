@@ -0,0 +1,128 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::ElementBVH"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/OptionList.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/ElementBVH.hpp"
+#include "mesh/ElementFinder.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( ElementBVH_TestSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( stretched_mesh )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,1.));
+  mesh_generator->options().set("nb_cells",std::vector<Uint>(2,40u));
+  Mesh& mesh = mesh_generator->generate();
+
+  // Cluster the cells towards the wall y=0, with cell heights varying over 8 orders of magnitude
+  Field& coords = mesh.geometry_fields().coordinates();
+  for (Uint n=0; n<coords.size(); ++n)
+    coords[n][YY] = std::pow(10.,8.*(coords[n][YY]-1.));
+
+  ElementBVH& bvh = *mesh.create_component<ElementBVH>("element_bvh");
+  bvh.options().set("mesh",mesh.handle<Mesh>());
+  bvh.create_bvh();
+  BOOST_CHECK(bvh.is_created());
+
+  // Every element is found back at its centroid, including the thinnest ones
+  RealVector centroid(2);
+  Entity found;
+  Uint nb_elems = 0;
+  boost_foreach(Elements& elements, find_components_recursively_with_filter<Elements>(mesh,IsElementsVolume()))
+  {
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      elements.element_type().compute_centroid(elements.geometry_space().get_coordinates(e),centroid);
+      BOOST_CHECK(bvh.find_element(centroid,found));
+      BOOST_CHECK(found == Entity(elements,e));
+      BOOST_CHECK(bvh.find_closest_element(centroid,found));
+      BOOST_CHECK(found == Entity(elements,e));
+      ++nb_elems;
+    }
+  }
+  BOOST_CHECK_EQUAL(nb_elems, 1600u);
+
+  // Outside the mesh, only the closest element is found
+  RealVector outside(2);
+  outside << 2., 2e-8;
+  BOOST_CHECK(!bvh.find_element(outside,found));
+  BOOST_CHECK(bvh.find_closest_element(outside,found));
+  BOOST_CHECK(found.element_type().is_coord_in_element((RealVector(2) << 1.-1e-9, 2e-8).finished(),found.get_coordinates()));
+
+  // Through the element finder
+  boost::shared_ptr<ElementFinder> finder = build_component_abstract_type<ElementFinder>("cf3.mesh.ElementFinderBVH","finder");
+  finder->options().set("dict",mesh.geometry_fields().handle<Dictionary>());
+  SpaceElem space_elem;
+  RealVector point(2);
+  point << 0.51, 2e-8;
+  BOOST_CHECK(finder->find_element(point,space_elem));
+  BOOST_CHECK(space_elem.comp->support().element_type().is_coord_in_element(point,space_elem.get_coordinates()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( moved_mesh )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("moved_mesh_generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"moved_mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,1.));
+  mesh_generator->options().set("nb_cells",std::vector<Uint>(2,10u));
+  Mesh& mesh = mesh_generator->generate();
+
+  boost::shared_ptr<ElementFinder> finder = build_component_abstract_type<ElementFinder>("cf3.mesh.ElementFinderBVH","finder");
+  finder->options().set("dict",mesh.geometry_fields().handle<Dictionary>());
+  finder->options().set("find_closest",false);
+
+  RealVector point(2);
+  point << 1.5, 0.5;
+  SpaceElem space_elem;
+  BOOST_CHECK(!finder->find_element(point,space_elem));
+  ElementBVH& bvh = *Handle<ElementBVH>(mesh.get_child("element_bvh"));
+  BOOST_CHECK(bvh.is_created());
+
+  // Stretching the mesh and announcing it clears the hierarchy, which is built again on the next search
+  Field& coords = mesh.geometry_fields().coordinates();
+  for (Uint n=0; n<coords.size(); ++n)
+    coords[n][XX] *= 2.;
+  mesh.raise_mesh_changed();
+  BOOST_CHECK(!bvh.is_created());
+
+  BOOST_CHECK(finder->find_element(point,space_elem));
+  BOOST_CHECK(space_elem.comp->support().element_type().is_coord_in_element(point,space_elem.get_coordinates()));
+  BOOST_CHECK(bvh.is_created());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,161 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the batched computation functions of cf3::mesh::ElementType"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/MeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct ElementTypeBatchedFixture
+{
+  ElementTypeBatchedFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Generate a mesh with the simple mesh generator, slightly distorted so the elements differ
+  Mesh& generate_mesh(const std::string& name, const Uint dim)
+  {
+    boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator",name+"_generator");
+    meshgenerator->options().set("mesh",URI("//"+name));
+    meshgenerator->options().set("nb_cells",std::vector<Uint>(dim,5u));
+    meshgenerator->options().set("lengths",std::vector<Real>(dim,2.));
+    Mesh& mesh = meshgenerator->generate();
+
+    Field& coordinates = mesh.geometry_fields().coordinates();
+    for (Uint node=0; node<coordinates.size(); ++node)
+    {
+      const Real x = coordinates[node][XX];
+      for (Uint d=0; d<dim; ++d)
+        coordinates[node][d] += 0.01*x*x*(d+1);
+    }
+    return mesh;
+  }
+
+  /// Compare the batched functions with the per-element functions for all elements of the mesh
+  void check_mesh(Mesh& mesh)
+  {
+    const Field& coordinates = mesh.geometry_fields().coordinates();
+    boost_foreach(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+    {
+      const ElementType& etype = elements.element_type();
+      const Connectivity& connectivity = elements.geometry_space().connectivity();
+      const Uint nb_elems = elements.size();
+
+      RealMatrix nodes;
+      elements.geometry_space().allocate_coordinates(nodes);
+      RealVector mapped_coord(etype.dimensionality());
+      mapped_coord.setConstant(0.1);
+
+      if (etype.dimensionality() == etype.dimension())
+      {
+        RealVector volumes, determinants;
+        RealMatrix centroids, jacobians, plane_normals;
+        etype.compute_volumes(connectivity, coordinates, volumes);
+        etype.compute_centroids(connectivity, coordinates, centroids);
+        etype.compute_jacobians_at(mapped_coord, connectivity, coordinates, jacobians);
+        etype.compute_jacobian_determinants_at(mapped_coord, connectivity, coordinates, determinants);
+        etype.compute_plane_jacobian_normals_at(mapped_coord, KSI, connectivity, coordinates, plane_normals);
+        BOOST_CHECK_EQUAL(volumes.size(), nb_elems);
+        BOOST_CHECK_EQUAL(jacobians.cols(), etype.dimensionality()*etype.dimension());
+
+        RealVector centroid(etype.dimension()), plane_normal(etype.dimension());
+        RealMatrix jacobian(etype.dimensionality(), etype.dimension());
+        for (Uint elem=0; elem<nb_elems; ++elem)
+        {
+          elements.geometry_space().put_coordinates(nodes, elem);
+          BOOST_CHECK_CLOSE(volumes[elem], etype.volume(nodes), 1e-10);
+          BOOST_CHECK_CLOSE(determinants[elem], etype.jacobian_determinant(mapped_coord, nodes), 1e-10);
+          etype.compute_centroid(nodes, centroid);
+          etype.compute_jacobian(mapped_coord, nodes, jacobian);
+          etype.compute_plane_jacobian_normal(mapped_coord, nodes, KSI, plane_normal);
+          for (Uint i=0; i<etype.dimension(); ++i)
+          {
+            BOOST_CHECK_SMALL(centroids(elem,i) - centroid[i], 1e-12);
+            BOOST_CHECK_SMALL(plane_normals(elem,i) - plane_normal[i], 1e-12);
+            for (Uint k=0; k<etype.dimensionality(); ++k)
+              BOOST_CHECK_SMALL(jacobians(elem,k*etype.dimension()+i) - jacobian(k,i), 1e-12);
+          }
+        }
+      }
+      else if (etype.dimensionality() == etype.dimension()-1 && etype.dimensionality() > 0)
+      {
+        RealVector areas;
+        RealMatrix normals;
+        etype.compute_areas(connectivity, coordinates, areas);
+        etype.compute_normals(connectivity, coordinates, normals);
+        BOOST_CHECK_EQUAL(areas.size(), nb_elems);
+
+        RealVector normal(etype.dimension());
+        for (Uint elem=0; elem<nb_elems; ++elem)
+        {
+          elements.geometry_space().put_coordinates(nodes, elem);
+          BOOST_CHECK_CLOSE(areas[elem], etype.area(nodes), 1e-10);
+          etype.compute_normal(nodes, normal);
+          for (Uint i=0; i<etype.dimension(); ++i)
+            BOOST_CHECK_SMALL(normals(elem,i) - normal[i], 1e-12);
+        }
+      }
+    }
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+BOOST_FIXTURE_TEST_SUITE( ElementTypeBatchedSuite, ElementTypeBatchedFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+BOOST_AUTO_TEST_CASE( batched_2d )
+{
+  check_mesh(generate_mesh("rectangle", 2));
+}
+
+BOOST_AUTO_TEST_CASE( batched_3d )
+{
+  check_mesh(generate_mesh("box", 3));
+}
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
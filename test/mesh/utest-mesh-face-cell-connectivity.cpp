@@ -24,6 +24,9 @@
 #include "mesh/MeshReader.hpp"
 #include "mesh/SimpleMeshGenerator.hpp"
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Space.hpp"
 #include "mesh/ConnectivityData.hpp"
 
 using namespace boost;
@@ -114,6 +117,75 @@ BOOST_AUTO_TEST_CASE( face_elem_connectivity )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( face_numbering )
+{
+  Handle<FaceCellConnectivity> c = find_component_ptr_with_name<FaceCellConnectivity>(*m_mesh,"face_cell_connectivity");
+  const Uint nb_faces = c->size();
+
+  // 4x4 quads: 24 inner faces and 16 boundary faces
+  Uint nb_bdry_faces(0);
+  for (Uint f=0; f<nb_faces; ++f)
+    if (c->is_bdry_face()[f])
+      ++nb_bdry_faces;
+  BOOST_CHECK_EQUAL(nb_bdry_faces, 16u);
+
+  // Faces are numbered in order of first appearance: the first faces are those of the first element
+  BOOST_CHECK_EQUAL(c->connectivity()[0][0].idx, 0u);
+  BOOST_CHECK_EQUAL(c->face_number()[0][0], 0u);
+  BOOST_CHECK_EQUAL(c->connectivity()[3][0].idx, 0u);
+  BOOST_CHECK_EQUAL(c->face_number()[3][0], 3u);
+
+  // Both cells of an inner face have exactly the nodes of the face
+  for (Uint f=0; f<nb_faces; ++f)
+  {
+    if (c->is_bdry_face()[f])
+      continue;
+    std::vector<Uint> left_nodes = c->face_nodes(f);
+    const Entity right = c->connectivity()[f][1];
+    BOOST_CHECK(right.idx > c->connectivity()[f][0].idx);
+    std::vector<Uint> right_nodes;
+    Connectivity::ConstRow right_elem_nodes = right.get_nodes();
+    boost_foreach(const Uint node_in_face, right.element_type().faces().nodes_range(c->face_number()[f][1]))
+      right_nodes.push_back(right_elem_nodes[node_in_face]);
+    std::sort(left_nodes.begin(),left_nodes.end());
+    std::sort(right_nodes.begin(),right_nodes.end());
+    BOOST_CHECK(left_nodes == right_nodes);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( face_matcher )
+{
+  // faces 2 and 4 are permutations of faces 0 and 1
+  std::vector< std::vector<Uint> > faces(5);
+  faces[0] = list_of(1)(5)(3);
+  faces[1] = list_of(2)(3)(4)(7);
+  faces[2] = list_of(3)(1)(5);
+  faces[3] = list_of(1)(5);
+  faces[4] = list_of(7)(4)(3)(2);
+
+  FaceMatcher matcher;
+  std::vector<Uint> face_sizes;
+  boost_foreach(const std::vector<Uint>& face, faces)
+    face_sizes.push_back(face.size());
+  matcher.set_face_sizes(face_sizes);
+  for (Uint f=0; f<faces.size(); ++f)
+    matcher.set_face(f,faces[f]);
+
+  std::vector<Uint> first_match;
+  matcher.match(first_match);
+  std::vector<Uint> expected = list_of(0)(1)(0)(3)(1);
+  BOOST_CHECK(first_match == expected);
+
+  std::vector<Uint> nodes = list_of(5)(1);
+  BOOST_CHECK_EQUAL(matcher.find(nodes), 3u);
+  nodes = list_of(5)(1)(4);
+  BOOST_CHECK_EQUAL(matcher.find(nodes), FaceMatcher::invalid());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
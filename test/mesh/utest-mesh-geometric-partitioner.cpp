@@ -0,0 +1,178 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::GeometricPartitioner"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/GeometricPartitioner.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct GeometricPartitionerTests_Fixture
+{
+  GeometricPartitionerTests_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Distributed mesh, numbered as needed for partitioning
+  Mesh& generate(const std::string& name)
+  {
+    Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>(name+"_generator");
+    mesh_generator->options().set("mesh",Core::instance().root().uri()/name);
+    mesh_generator->options().set("lengths",std::vector<Real>(2,40.));
+    mesh_generator->options().set("nb_cells",std::vector<Uint>(2,40u));
+    Mesh& mesh = mesh_generator->generate();
+    build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalNumbering","glb_numbering")->transform(mesh);
+    build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalConnectivity","glb_connectivity")->transform(mesh);
+    return mesh;
+  }
+
+  /// Weight 3 for elements in the left quarter of the mesh, 1 elsewhere
+  std::vector< std::vector<Real> > element_weights(const Mesh& mesh)
+  {
+    std::vector< std::vector<Real> > weights(mesh.elements().size());
+    const Field& coordinates = mesh.geometry_fields().coordinates();
+    for (Uint entities_idx=0; entities_idx<mesh.elements().size(); ++entities_idx)
+    {
+      const Entities& entities = *mesh.elements()[entities_idx];
+      const Connectivity& connectivity = entities.geometry_space().connectivity();
+      weights[entities_idx].resize(entities.size());
+      for (Uint elem=0; elem<entities.size(); ++elem)
+      {
+        Real x = 0.;
+        boost_foreach(const Uint node, connectivity[elem])
+          x += coordinates[node][XX] / connectivity.row_size();
+        weights[entities_idx][elem] = x < 10. ? 3. : 1.;
+      }
+    }
+    return weights;
+  }
+
+  /// Largest weight of a part, relative to the average weight of a part
+  Real imbalance(const Mesh& mesh, const GeometricPartitioner& partitioner, const std::vector< std::vector<Real> >& weights)
+  {
+    const Uint nb_parts = PE::Comm::instance().size();
+    std::vector<Real> part_weights(nb_parts, 0.);
+    for (Uint entities_idx=0; entities_idx<mesh.elements().size(); ++entities_idx)
+    {
+      const Entities& entities = *mesh.elements()[entities_idx];
+      for (Uint elem=0; elem<entities.size(); ++elem)
+      {
+        if (entities.is_ghost(elem))
+          continue;
+        const Uint part = partitioner.part_of_element()[entities_idx][elem];
+        BOOST_CHECK_LT(part, nb_parts);
+        part_weights[part] += weights.empty() ? 1. : weights[entities_idx][elem];
+      }
+    }
+    PE::Comm::instance().all_reduce(PE::plus(), part_weights, part_weights);
+    Real total_weight = 0.;
+    boost_foreach(const Real part_weight, part_weights)
+      total_weight += part_weight;
+    return *std::max_element(part_weights.begin(), part_weights.end()) * nb_parts / total_weight;
+  }
+
+  Uint nb_owned_elements(const Mesh& mesh)
+  {
+    Uint nb_owned = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      for (Uint elem=0; elem<entities->size(); ++elem)
+        if (!entities->is_ghost(elem))
+          ++nb_owned;
+    }
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_owned, 1, &nb_owned);
+    return nb_owned;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( GeometricPartitionerTests_TestSuite, GeometricPartitionerTests_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( hilbert )
+{
+  Mesh& mesh = generate("hilbert_mesh");
+  const Uint nb_elements = nb_owned_elements(mesh);
+
+  boost::shared_ptr<GeometricPartitioner> partitioner = allocate_component<GeometricPartitioner>("partitioner");
+  partitioner->options().set("method",std::string("hilbert"));
+  partitioner->initialize(mesh);
+  partitioner->partition_graph();
+  BOOST_CHECK_LT(imbalance(mesh, *partitioner, std::vector< std::vector<Real> >()), 1.1);
+
+  partitioner->migrate();
+  BOOST_CHECK_EQUAL(nb_owned_elements(mesh), nb_elements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( rcb_with_weights )
+{
+  Mesh& mesh = generate("rcb_mesh");
+  const Uint nb_elements = nb_owned_elements(mesh);
+  const std::vector< std::vector<Real> > weights = element_weights(mesh);
+
+  boost::shared_ptr<GeometricPartitioner> partitioner = allocate_component<GeometricPartitioner>("partitioner");
+  partitioner->options().set("method",std::string("rcb"));
+  partitioner->set_element_weights(weights);
+  partitioner->initialize(mesh);
+  partitioner->partition_graph();
+  BOOST_CHECK_LT(imbalance(mesh, *partitioner, weights), 1.02);
+
+  partitioner->migrate();
+  BOOST_CHECK_EQUAL(nb_owned_elements(mesh), nb_elements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,10 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::gmsh::Reader"
 
+#include <fstream>
+#include <sstream>
+
+#include <boost/cstdint.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
@@ -26,6 +30,7 @@
 #include "mesh/Field.hpp"
 #include "mesh/Entities.hpp"
 #include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 #include "common/DynTable.hpp"
 #include "common/List.hpp"
 #include "common/Table.hpp"
@@ -54,6 +59,68 @@ struct gmshReaderMPITests_Fixture
   }
   /// possibly common functions used on the tests below
 
+  /// Convert an ascii gmsh file with only physical names, nodes and elements to binary format
+  void write_binary_copy(const std::string& ascii_file, const std::string& binary_file)
+  {
+    std::ifstream in(ascii_file.c_str());
+    std::ofstream out(binary_file.c_str(), std::ios_base::binary);
+    const boost::int32_t one = 1;
+    std::string line;
+    while (getline(in,line))
+    {
+      if (line == "$MeshFormat")
+      {
+        getline(in,line);
+        out << "$MeshFormat\n2.2 1 8\n";
+        out.write(reinterpret_cast<const char*>(&one), sizeof(one));
+        out << "\n";
+      }
+      else if (line == "$Nodes")
+      {
+        Uint nb_nodes;
+        in >> nb_nodes;
+        out << line << "\n" << nb_nodes << "\n";
+        for (Uint n=0; n<nb_nodes; ++n)
+        {
+          boost::int32_t number;
+          double coords[3];
+          in >> number >> coords[0] >> coords[1] >> coords[2];
+          out.write(reinterpret_cast<const char*>(&number), sizeof(number));
+          out.write(reinterpret_cast<const char*>(coords), sizeof(coords));
+        }
+        getline(in,line);
+        out << "\n";
+      }
+      else if (line == "$Elements")
+      {
+        Uint nb_elems;
+        in >> nb_elems;
+        out << line << "\n" << nb_elems << "\n";
+        // Every element in its own block, to have many block boundaries
+        for (Uint e=0; e<nb_elems; ++e)
+        {
+          boost::int32_t header[3];
+          boost::int32_t number;
+          in >> number >> header[0] >> header[2];
+          header[1] = 1;
+          std::vector<boost::int32_t> record(1,number);
+          getline(in,line);
+          std::stringstream ss(line);
+          boost::int32_t value;
+          while (ss >> value)
+            record.push_back(value);
+          out.write(reinterpret_cast<const char*>(header), sizeof(header));
+          out.write(reinterpret_cast<const char*>(&record[0]), record.size()*sizeof(boost::int32_t));
+        }
+        out << "\n";
+      }
+      else
+      {
+        out << line << "\n";
+      }
+    }
+  }
+
 
   /// common values accessed by all tests goes here
   int    m_argc;
@@ -311,6 +378,48 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh_mix_p1_out )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( read_binary )
+{
+  write_binary_copy("../../resources/rectangle-mix-p1.msh","rectangle-mix-p1-binary.msh");
+
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+  Mesh& ascii_mesh = *Core::instance().root().create_component<Mesh>("mesh_ascii");
+  meshreader->read_mesh_into("../../resources/rectangle-mix-p1.msh",ascii_mesh);
+  Mesh& binary_mesh = *Core::instance().root().create_component<Mesh>("mesh_binary");
+  meshreader->read_mesh_into("rectangle-mix-p1-binary.msh",binary_mesh);
+
+  // Both files describe the same mesh
+  const Dictionary& ascii_nodes = ascii_mesh.geometry_fields();
+  const Dictionary& binary_nodes = binary_mesh.geometry_fields();
+  BOOST_CHECK_EQUAL( ascii_nodes.size() , 177u );
+  BOOST_CHECK_EQUAL( binary_nodes.size() , ascii_nodes.size() );
+  for (Uint n=0; n<std::min(ascii_nodes.size(),binary_nodes.size()); ++n)
+  {
+    BOOST_CHECK_EQUAL( binary_nodes.glb_idx()[n] , ascii_nodes.glb_idx()[n] );
+    for (Uint d=0; d<ascii_mesh.dimension(); ++d)
+      BOOST_CHECK_EQUAL( binary_nodes.coordinates()[n][d] , ascii_nodes.coordinates()[n][d] );
+  }
+
+  BOOST_CHECK_EQUAL( find_component<Region>(ascii_mesh).recursive_elements_count(true) , 310u );
+  BOOST_CHECK_EQUAL( ascii_mesh.elements().size() , binary_mesh.elements().size() );
+  for (Uint i=0; i<std::min(ascii_mesh.elements().size(),binary_mesh.elements().size()); ++i)
+  {
+    const Entities& ascii_elements = *ascii_mesh.elements()[i];
+    const Entities& binary_elements = *binary_mesh.elements()[i];
+    BOOST_CHECK_EQUAL( binary_elements.parent()->name() , ascii_elements.parent()->name() );
+    BOOST_CHECK_EQUAL( binary_elements.element_type().derived_type_name() , ascii_elements.element_type().derived_type_name() );
+    BOOST_CHECK_EQUAL( binary_elements.size() , ascii_elements.size() );
+    for (Uint e=0; e<std::min(ascii_elements.size(),binary_elements.size()); ++e)
+    {
+      BOOST_CHECK_EQUAL( binary_elements.glb_idx()[e] , ascii_elements.glb_idx()[e] );
+      for (Uint n=0; n<ascii_elements.element_type().nb_nodes(); ++n)
+        BOOST_CHECK_EQUAL( binary_elements.geometry_space().connectivity()[e][n] , ascii_elements.geometry_space().connectivity()[e][n] );
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   Core::instance().terminate();
@@ -35,6 +35,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Connectivity.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/Octtree.hpp"
 
 #include "mesh/PointInterpolator.hpp"
 
@@ -301,6 +302,131 @@ BOOST_AUTO_TEST_CASE( test_new_interpolation )
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( batch_storage )
+{
+  Handle<Mesh> source_mesh(Core::instance().root().get_child("hextet_new"));
+  BOOST_REQUIRE(source_mesh);
+
+  boost::shared_ptr< PointInterpolator > point_interpolator = allocate_component<PointInterpolator>("batch_interpolator");
+  point_interpolator->options().set("dict",source_mesh->geometry_fields().handle<Dictionary>());
+
+  // Coordinates in a scattered order, the last one outside the mesh
+  const Uint dim = 3;
+  const Uint nb_coords = 200;
+  std::vector<Real> coordinates(nb_coords*dim);
+  for (Uint t=0; t<nb_coords; ++t)
+    for (Uint d=0; d<dim; ++d)
+      coordinates[t*dim+d] = 10.*( ((t*(7+3*d)) % nb_coords) + 0.5 ) / nb_coords;
+  coordinates[(nb_coords-1)*dim] = 20.;
+
+  std::vector<Uint> offsets;
+  std::vector<Uint> points;
+  std::vector<Real> weights;
+  point_interpolator->compute_storage(coordinates,dim,offsets,points,weights);
+  BOOST_REQUIRE_EQUAL(offsets.size(), nb_coords+1);
+  BOOST_CHECK_EQUAL(offsets.back(), points.size());
+  BOOST_CHECK_EQUAL(points.size(), weights.size());
+
+  // The batch must give the same points and weights as one coordinate at a time
+  RealVector coord(dim);
+  SpaceElem element;
+  std::vector<SpaceElem> stencil;
+  std::vector<Uint> t_points;
+  std::vector<Real> t_weights;
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    for (Uint d=0; d<dim; ++d)
+      coord[d] = coordinates[t*dim+d];
+    const bool found = point_interpolator->compute_storage(coord,element,stencil,t_points,t_weights);
+    BOOST_CHECK_EQUAL(found, t != nb_coords-1);
+    if (!found)
+    {
+      BOOST_CHECK_EQUAL(offsets[t+1], offsets[t]);
+      continue;
+    }
+    BOOST_REQUIRE_EQUAL(offsets[t+1]-offsets[t], t_points.size());
+    for (Uint s=0; s<t_points.size(); ++s)
+    {
+      BOOST_CHECK_EQUAL(points[offsets[t]+s], t_points[s]);
+      BOOST_CHECK_CLOSE(weights[offsets[t]+s], t_weights[s], 1e-10);
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( stored_interpolation_follows_mesh_changes )
+{
+  boost::shared_ptr<MeshGenerator> mesh_gen = allocate_component<SimpleMeshGenerator>("meshgen");
+  Handle<Mesh> source_mesh = Core::instance().root().create_component<Mesh>("stored_source");
+  mesh_gen->options().set("nb_cells",std::vector<Uint>(2,10));
+  mesh_gen->options().set("lengths",std::vector<Real>(2,10.));
+  mesh_gen->options().set("mesh",source_mesh->uri());
+  mesh_gen->execute();
+
+  Handle<Mesh> target_mesh = Core::instance().root().create_component<Mesh>("stored_target");
+  mesh_gen->options().set("nb_cells",std::vector<Uint>(2,4));
+  mesh_gen->options().set("offsets",std::vector<Real>(2,2.));
+  mesh_gen->options().set("lengths",std::vector<Real>(2,6.));
+  mesh_gen->options().set("mesh",target_mesh->uri());
+  mesh_gen->execute();
+
+  const Field& source_field = source_mesh->geometry_fields().coordinates();
+  Field& target_coords = target_mesh->geometry_fields().coordinates();
+  Field& target_field = target_mesh->geometry_fields().create_field("target","target[vector]");
+
+  boost::shared_ptr< Interpolator > interpolator = allocate_component<Interpolator>("stored_interpolator");
+  interpolator->options().set("store",true);
+  Handle<Component>(interpolator->get_child("point_interpolator"))->options().set("function",std::string("cf3.mesh.ShapeFunctionInterpolation"));
+
+  // Bilinear interpolation of the coordinates is exact
+  interpolator->interpolate(source_field,target_field);
+  for (Uint n=0; n<target_field.size(); ++n)
+    for (Uint d=0; d<2; ++d)
+      BOOST_CHECK_CLOSE(target_field[n][d], target_coords[n][d], 1e-8);
+
+  // Moving the target nodes must discard the stored interpolation
+  for (Uint n=0; n<target_coords.size(); ++n)
+    target_coords[n][XX] += 1.;
+  target_mesh->raise_mesh_changed();
+  interpolator->interpolate(source_field,target_field);
+  for (Uint n=0; n<target_field.size(); ++n)
+    for (Uint d=0; d<2; ++d)
+      BOOST_CHECK_CLOSE(target_field[n][d], target_coords[n][d], 1e-8);
+
+  // Moving the source nodes must also rebuild the octtree used to locate the target nodes.
+  // The cells are stretched up to a width of 1.9, so interpolating x^2 in the right cell
+  // is off by at most 1.9^2/4, while cells located in the old geometry extrapolate much further.
+  Field& source_coords = source_mesh->geometry_fields().coordinates();
+  for (Uint n=0; n<source_coords.size(); ++n)
+    source_coords[n][XX] = source_coords[n][XX]*source_coords[n][XX]/10.;
+  source_mesh->raise_mesh_changed();
+  BOOST_CHECK( ! Handle<Octtree>(source_mesh->get_child("octtree"))->is_created() );
+  Field& source_x2 = source_mesh->geometry_fields().create_field("x2");
+  for (Uint n=0; n<source_x2.size(); ++n)
+    source_x2[n][0] = source_coords[n][XX]*source_coords[n][XX];
+  Field& target_x2 = target_mesh->geometry_fields().create_field("x2");
+  interpolator->interpolate(source_x2,target_x2);
+  for (Uint n=0; n<target_x2.size(); ++n)
+    BOOST_CHECK_SMALL(target_x2[n][0] - target_coords[n][XX]*target_coords[n][XX], 1.9*1.9/4.);
+
+  // Interpolation between spaces of one mesh gives the same with and without storage
+  Dictionary& target_dict = source_mesh->create_continuous_space("P2","cf3.mesh.LagrangeP2");
+  Field& stored = target_dict.create_field("stored","stored[vector]");
+  Field& unstored = target_dict.create_field("unstored","unstored[vector]");
+  boost::shared_ptr< AInterpolator > space_interpolator = build_component_abstract_type<AInterpolator>("cf3.mesh.SpaceInterpolator","space_interpolator");
+  space_interpolator->interpolate(source_field,unstored);
+  space_interpolator->options().set("store",true);
+  space_interpolator->interpolate(source_field,stored);
+  space_interpolator->interpolate(source_field,stored);
+  for (Uint n=0; n<stored.size(); ++n)
+    for (Uint d=0; d<2; ++d)
+      BOOST_CHECK_EQUAL(stored[n][d], unstored[n][d]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_CASE( finalize_mpi )
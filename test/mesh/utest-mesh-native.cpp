@@ -0,0 +1,190 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::native::Writer and mesh::native::Reader"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/MeshTransformer.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct NativeMeshIO_Fixture
+{
+  NativeMeshIO_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Path of an Entity relative to its mesh, to compare entities of different meshes
+  std::string path(const Entity& entity, const Mesh& mesh)
+  {
+    if (is_null(entity.comp))
+      return "null";
+    return entity.comp->uri().path().substr(mesh.uri().path().size()) + "[" + to_str(entity.idx) + "]";
+  }
+
+  void check_equal(const ElementConnectivity& original, const ElementConnectivity& restored,
+                   const Mesh& original_mesh, const Mesh& restored_mesh)
+  {
+    BOOST_REQUIRE_EQUAL(original.size(), restored.size());
+    BOOST_REQUIRE_EQUAL(original.row_size(), restored.row_size());
+    for (Uint row=0; row<original.size(); ++row)
+      for (Uint col=0; col<original.row_size(); ++col)
+        BOOST_CHECK_EQUAL(path(original[row][col], original_mesh), path(restored[row][col], restored_mesh));
+  }
+
+  template <typename ArrayT>
+  void check_equal(const ArrayT& original, const ArrayT& restored)
+  {
+    BOOST_REQUIRE_EQUAL(original.num_elements(), restored.num_elements());
+    BOOST_CHECK(std::equal(original.data(), original.data()+original.num_elements(), restored.data()));
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( NativeMeshIO_TestSuite, NativeMeshIO_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_and_restore )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,10.));
+  mesh_generator->options().set("nb_cells",std::vector<Uint>(2,10u));
+  Mesh& mesh = mesh_generator->generate();
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.LoadBalance","load_balance")->transform(mesh);
+  build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.BuildFaces","build_faces")->transform(mesh);
+
+  const Field& coords = mesh.geometry_fields().coordinates();
+  Field& node_field = mesh.geometry_fields().create_field("node_field","u[scalar],v[vector]");
+  for (Uint node=0; node<node_field.size(); ++node)
+    for (Uint var=0; var<node_field.row_size(); ++var)
+      node_field[node][var] = coords[node][XX] + var*coords[node][YY];
+
+  Dictionary& cell_dict = mesh.create_discontinuous_space("cell_centred","cf3.mesh.LagrangeP0");
+  Field& cell_field = cell_dict.create_field("cell_field");
+  for (Uint cell=0; cell<cell_field.size(); ++cell)
+    cell_field[cell][0] = cell_dict.glb_idx()[cell];
+
+  boost::shared_ptr<MeshWriter> writer = build_component_abstract_type<MeshWriter>("cf3.mesh.native.Writer","writer");
+  writer->write_from_to(mesh, URI("checkpoint.cf3mesh"));
+
+  Mesh& restored = *Core::instance().root().create_component<Mesh>("restored");
+  boost::shared_ptr<MeshReader> reader = build_component_abstract_type<MeshReader>("cf3.mesh.native.Reader","reader");
+  reader->read_mesh_into(URI("checkpoint.cf3mesh"), restored);
+
+  // Dictionaries and fields
+  BOOST_CHECK_EQUAL(restored.dimension(), mesh.dimension());
+  BOOST_REQUIRE_EQUAL(restored.dictionaries().size(), mesh.dictionaries().size());
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+  {
+    Handle<Dictionary> restored_dict(restored.get_child(dict->name()));
+    BOOST_REQUIRE(is_not_null(restored_dict));
+    BOOST_CHECK_EQUAL(restored_dict->continuous(), dict->continuous());
+    check_equal(dict->glb_idx().array(), restored_dict->glb_idx().array());
+    check_equal(dict->rank().array(), restored_dict->rank().array());
+    BOOST_REQUIRE_EQUAL(restored_dict->fields().size(), dict->fields().size());
+    boost_foreach(const Handle<Field>& field, dict->fields())
+    {
+      const Field& restored_field = restored_dict->field(field->name());
+      BOOST_CHECK_EQUAL(restored_field.descriptor().description(), field->descriptor().description());
+      check_equal(field->array(), restored_field.array());
+    }
+  }
+
+  // Topology, with the faces
+  const Dictionary& restored_cell_dict = *Handle<Dictionary>(restored.get_child("cell_centred"));
+  BOOST_REQUIRE_EQUAL(restored.elements().size(), mesh.elements().size());
+  for (Uint idx=0; idx<mesh.elements().size(); ++idx)
+  {
+    const Entities& entities = *mesh.elements()[idx];
+    const Entities& restored_entities = *restored.elements()[idx];
+    BOOST_CHECK_EQUAL(restored_entities.uri().path().substr(restored.uri().path().size()),
+                      entities.uri().path().substr(mesh.uri().path().size()));
+    BOOST_CHECK_EQUAL(restored_entities.element_type().derived_type_name(), entities.element_type().derived_type_name());
+    check_equal(entities.glb_idx().array(), restored_entities.glb_idx().array());
+    check_equal(entities.rank().array(), restored_entities.rank().array());
+    BOOST_REQUIRE_EQUAL(restored_entities.spaces().size(), entities.spaces().size());
+    check_equal(entities.geometry_space().connectivity().array(), restored_entities.geometry_space().connectivity().array());
+    check_equal(entities.space(cell_dict).connectivity().array(), restored_entities.space(restored_cell_dict).connectivity().array());
+
+    BOOST_CHECK_EQUAL(is_null(restored_entities.connectivity_face2cell()), is_null(entities.connectivity_face2cell()));
+    if (is_not_null(entities.connectivity_face2cell()) && is_not_null(restored_entities.connectivity_face2cell()))
+    {
+      check_equal(entities.connectivity_face2cell()->connectivity(), restored_entities.connectivity_face2cell()->connectivity(), mesh, restored);
+      check_equal(entities.connectivity_face2cell()->face_number().array(), restored_entities.connectivity_face2cell()->face_number().array());
+      check_equal(entities.connectivity_face2cell()->is_bdry_face().array(), restored_entities.connectivity_face2cell()->is_bdry_face().array());
+    }
+    BOOST_CHECK_EQUAL(is_null(restored_entities.connectivity_cell2face()), is_null(entities.connectivity_cell2face()));
+    if (is_not_null(entities.connectivity_cell2face()) && is_not_null(restored_entities.connectivity_cell2face()))
+      check_equal(*entities.connectivity_cell2face(), *restored_entities.connectivity_cell2face(), mesh, restored);
+  }
+
+  // The communication pattern is derived from the restored global numbering
+  Field& restored_node_field = restored.geometry_fields().field("node_field");
+  for (Uint node=0; node<restored_node_field.size(); ++node)
+    if (restored.geometry_fields().is_ghost(node))
+      restored_node_field[node][0] = -1.;
+  restored_node_field.parallelize();
+  restored_node_field.synchronize();
+  for (Uint node=0; node<restored_node_field.size(); ++node)
+    BOOST_CHECK_EQUAL(restored_node_field[node][0], node_field[node][0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
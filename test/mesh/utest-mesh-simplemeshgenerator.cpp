@@ -12,6 +12,7 @@
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/Core.hpp"
+#include "common/PE/Comm.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -23,6 +24,12 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
 
 using namespace std;
 using namespace boost;
@@ -177,6 +184,97 @@ BOOST_AUTO_TEST_CASE( generate_3d_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Count the owned and total cells of the interior, and check that the mesh is consistent
+/// with the global numbering of the structured grid of unit spacing
+void check_distributed_rectangle(Mesh& mesh, const Uint nb_cells_1d, Uint& nb_owned_cells, Uint& nb_cells)
+{
+  Dictionary& nodes = mesh.geometry_fields();
+  const Field& coords = nodes.coordinates();
+  for (Uint n=0; n<nodes.size(); ++n)
+  {
+    const Uint glb_idx = nodes.glb_idx()[n];
+    BOOST_CHECK_EQUAL(coords[n][XX], static_cast<Real>(glb_idx % (nb_cells_1d+1)));
+    BOOST_CHECK_EQUAL(coords[n][YY], static_cast<Real>(glb_idx / (nb_cells_1d+1)));
+  }
+
+  nb_owned_cells = 0;
+  nb_cells = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(*mesh.topology().get_child("interior")))
+  {
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      if (!elements.is_ghost(e))
+        ++nb_owned_cells;
+      ++nb_cells;
+      for (Uint n=0; n<connectivity.row_size(); ++n)
+        BOOST_CHECK(connectivity[e][n] < nodes.size());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( generate_distributed_2d_mesh )
+{
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_cells_1d = 20;
+
+  boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","distributed_generator");
+  meshgenerator->options().set("mesh",URI("//distributed_rect"));
+  meshgenerator->options().set("nb_cells",std::vector<Uint>(2,nb_cells_1d));
+  meshgenerator->options().set("lengths",std::vector<Real>(2,static_cast<Real>(nb_cells_1d)));
+  Mesh& mesh = meshgenerator->generate();
+
+  Uint nb_owned_cells, nb_cells;
+  check_distributed_rectangle(mesh, nb_cells_1d, nb_owned_cells, nb_cells);
+  BOOST_CHECK_EQUAL(nb_owned_cells, nb_cells);
+
+  // Every node and cell is owned by exactly one part
+  Dictionary& nodes = mesh.geometry_fields();
+  Uint nb_owned_nodes = 0;
+  for (Uint n=0; n<nodes.size(); ++n)
+    if (!nodes.is_ghost(n))
+      ++nb_owned_nodes;
+
+  Uint total_nb_owned_cells = nb_owned_cells;
+  Uint total_nb_owned_nodes = nb_owned_nodes;
+  if (comm.is_active())
+  {
+    comm.all_reduce(PE::plus(), &nb_owned_cells, 1, &total_nb_owned_cells);
+    comm.all_reduce(PE::plus(), &nb_owned_nodes, 1, &total_nb_owned_nodes);
+  }
+  BOOST_CHECK_EQUAL(total_nb_owned_cells, nb_cells_1d*nb_cells_1d);
+  BOOST_CHECK_EQUAL(total_nb_owned_nodes, (nb_cells_1d+1)*(nb_cells_1d+1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( generate_distributed_2d_mesh_with_overlap )
+{
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint nb_cells_1d = 20;
+
+  boost::shared_ptr< MeshGenerator > meshgenerator = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","overlap_generator");
+  meshgenerator->options().set("mesh",URI("//overlap_rect"));
+  meshgenerator->options().set("nb_cells",std::vector<Uint>(2,nb_cells_1d));
+  meshgenerator->options().set("lengths",std::vector<Real>(2,static_cast<Real>(nb_cells_1d)));
+  meshgenerator->options().set("overlap",1u);
+  Mesh& mesh = meshgenerator->generate();
+
+  Uint nb_owned_cells, nb_cells;
+  check_distributed_rectangle(mesh, nb_cells_1d, nb_owned_cells, nb_cells);
+
+  // A layer of ghost cells was added along the partition boundaries
+  if (comm.size() > 1)
+    BOOST_CHECK(nb_cells > nb_owned_cells);
+
+  Uint total_nb_owned_cells = nb_owned_cells;
+  if (comm.is_active())
+    comm.all_reduce(PE::plus(), &nb_owned_cells, 1, &total_nb_owned_cells);
+  BOOST_CHECK_EQUAL(total_nb_owned_cells, nb_cells_1d*nb_cells_1d);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   PE::Comm::instance().finalize();
@@ -7,11 +7,17 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::tecplot::Writer"
 
+#include <fstream>
+#include <sstream>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/Core.hpp"
+#include "common/StringConversion.hpp"
 
 #include "math/VariablesDescriptor.hpp"
 
@@ -49,6 +55,134 @@ struct TecWriterTests_Fixture
   }
   /// possibly common functions used on the tests below
 
+  /// Values and one-based connectivity of every zone in a tecplot file
+  struct ZoneData
+  {
+    std::vector<Real> values;
+    std::vector<Uint> connectivity;
+  };
+
+  std::vector<ZoneData> read_ascii(const std::string& path)
+  {
+    std::vector<ZoneData> zones;
+    std::ifstream file(path.c_str());
+    std::string line;
+    bool in_connectivity = false;
+    while (std::getline(file,line))
+    {
+      if (boost::algorithm::starts_with(line,"ZONE"))
+      {
+        zones.push_back(ZoneData());
+        in_connectivity = false;
+        continue;
+      }
+      if (zones.empty())
+        continue;
+      if (boost::algorithm::starts_with(line,"###"))
+      {
+        in_connectivity = boost::algorithm::starts_with(line,"### connectivity");
+        continue;
+      }
+      std::stringstream tokens(line);
+      std::string token;
+      while (tokens >> token)
+      {
+        if (in_connectivity)
+          zones.back().connectivity.push_back(from_str<Uint>(token));
+        else if (token.find('*') != std::string::npos)
+          zones.back().values.resize(zones.back().values.size()+from_str<Uint>(token.substr(0,token.find('*'))), from_str<Real>(token.substr(token.find('*')+1)));
+        else
+          zones.back().values.push_back(from_str<Real>(token));
+      }
+    }
+    return zones;
+  }
+
+  template <typename T>
+  T read_binary(std::ifstream& file)
+  {
+    T value;
+    file.read(reinterpret_cast<char*>(&value),sizeof(T));
+    return value;
+  }
+
+  std::string read_binary_string(std::ifstream& file)
+  {
+    std::string str;
+    for (boost::int32_t c = read_binary<boost::int32_t>(file); c != 0; c = read_binary<boost::int32_t>(file))
+      str.push_back(c);
+    return str;
+  }
+
+  std::vector<ZoneData> read_binary_file(const std::string& path)
+  {
+    std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+    char magic[8];
+    file.read(magic,8);
+    BOOST_REQUIRE_EQUAL(std::string(magic,8), "#!TDV112");
+    BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 1);
+    BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+    BOOST_CHECK_EQUAL(read_binary_string(file), "COOLFluiD Mesh Data");
+    const Uint nb_vars = read_binary<boost::int32_t>(file);
+    for (Uint var=0; var<nb_vars; ++var)
+      read_binary_string(file);
+
+    // Zone headers
+    std::vector<Uint> nb_nodes, nb_elems, nb_nodes_per_elem;
+    std::vector< std::vector<boost::int32_t> > var_location;
+    const Uint nodes_per_zone_type[] = {0, 2, 3, 4, 4, 8};
+    while (read_binary<float>(file) == 299.)
+    {
+      read_binary_string(file);
+      read_binary<boost::int32_t>(file);
+      read_binary<boost::int32_t>(file);
+      read_binary<double>(file);
+      read_binary<boost::int32_t>(file);
+      const boost::int32_t zone_type = read_binary<boost::int32_t>(file);
+      BOOST_REQUIRE(zone_type > 0 && zone_type < 6);
+      nb_nodes_per_elem.push_back(nodes_per_zone_type[zone_type]);
+      var_location.push_back(std::vector<boost::int32_t>(nb_vars,0));
+      if (read_binary<boost::int32_t>(file))
+      {
+        for (Uint var=0; var<nb_vars; ++var)
+          var_location.back()[var] = read_binary<boost::int32_t>(file);
+      }
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+      nb_nodes.push_back(read_binary<boost::int32_t>(file));
+      nb_elems.push_back(read_binary<boost::int32_t>(file));
+      for (Uint i=0; i<3; ++i)
+        read_binary<boost::int32_t>(file);
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+    }
+
+    // Zone data
+    std::vector<ZoneData> zones(nb_nodes.size());
+    for (Uint z=0; z<zones.size(); ++z)
+    {
+      BOOST_REQUIRE_EQUAL(read_binary<float>(file), 299.);
+      for (Uint var=0; var<nb_vars; ++var)
+        BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 2);
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), 0);
+      BOOST_REQUIRE_EQUAL(read_binary<boost::int32_t>(file), -1);
+      std::vector<double> min_max(2*nb_vars);
+      file.read(reinterpret_cast<char*>(&min_max[0]), min_max.size()*sizeof(double));
+      for (Uint var=0; var<nb_vars; ++var)
+      {
+        const Uint begin = zones[z].values.size();
+        zones[z].values.resize(begin + (var_location[z][var] ? nb_elems[z] : nb_nodes[z]));
+        file.read(reinterpret_cast<char*>(&zones[z].values[begin]), (zones[z].values.size()-begin)*sizeof(double));
+        BOOST_CHECK_EQUAL(*std::min_element(zones[z].values.begin()+begin,zones[z].values.end()), min_max[2*var]);
+        BOOST_CHECK_EQUAL(*std::max_element(zones[z].values.begin()+begin,zones[z].values.end()), min_max[2*var+1]);
+      }
+      for (Uint i=0; i<nb_elems[z]*nb_nodes_per_elem[z]; ++i)
+        zones[z].connectivity.push_back(read_binary<boost::int32_t>(file)+1);
+    }
+    BOOST_CHECK(file.good());
+    return zones;
+  }
+
 
   /// common values accessed by all tests goes here
   int    m_argc;
@@ -131,6 +265,37 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh )
   BOOST_CHECK(true);
 }
 
+BOOST_AUTO_TEST_CASE( binary_matches_ascii )
+{
+  Mesh& mesh = *Handle<Mesh>(Core::instance().root().get_child("mesh"));
+
+  std::vector<URI> fields;
+  fields.push_back(mesh.geometry_fields().field("nodal").uri());
+  fields.push_back(Handle<Dictionary>(mesh.get_child("elems_P0"))->field("cell_centred").uri());
+  fields.push_back(Handle<Dictionary>(mesh.get_child("nodes_P2"))->field("nodesP2").uri());
+
+  boost::shared_ptr< MeshWriter > tec_writer = build_component_abstract_type<MeshWriter>("cf3.mesh.tecplot.Writer","meshwriter");
+  tec_writer->options().set("mesh",mesh.handle<Mesh const>());
+  tec_writer->options().set("fields",fields);
+  tec_writer->options().set("file",URI("quadtriag_ascii.dat"));
+  tec_writer->execute();
+  tec_writer->options().set("file",URI("quadtriag_binary.plt"));
+  tec_writer->execute();
+
+  const std::vector<ZoneData> ascii = read_ascii("quadtriag_ascii.dat");
+  const std::vector<ZoneData> binary = read_binary_file("quadtriag_binary.plt");
+  BOOST_REQUIRE_EQUAL(binary.size(), ascii.size());
+  BOOST_CHECK(binary.size() > 0);
+  for (Uint z=0; z<ascii.size(); ++z)
+  {
+    BOOST_REQUIRE_EQUAL(binary[z].values.size(), ascii[z].values.size());
+    for (Uint i=0; i<ascii[z].values.size(); ++i)
+      BOOST_CHECK_SMALL(binary[z].values[i] - ascii[z].values[i], 1e-10*std::max(1.,std::abs(ascii[z].values[i])));
+    BOOST_CHECK_EQUAL_COLLECTIONS(binary[z].connectivity.begin(), binary[z].connectivity.end(),
+                                  ascii[z].connectivity.begin(), ascii[z].connectivity.end());
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /*
 BOOST_AUTO_TEST_CASE( threeD_test )
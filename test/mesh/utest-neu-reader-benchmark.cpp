@@ -0,0 +1,145 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Reading benchmark of a large mesh with cf3::mesh::neu::Reader"
+
+#include <fstream>
+#include <iomanip>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/MeshReader.hpp"
+
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+struct NeuReaderBenchmarkFixture : Tools::Testing::TimedTestFixture
+{
+  /// Write a structured grid of nb_cells x nb_cells quadrilaterals in the neutral format,
+  /// laid out as the neu Writer does
+  static void write_grid(const std::string& path)
+  {
+    const Uint nb_nodes_1d = nb_cells+1;
+    std::ofstream file(path.c_str());
+    file << "        CONTROL INFO 2.3.16\n";
+    file << "** GAMBIT NEUTRAL FILE\n";
+    file << "benchmark\n";
+    file << "PROGRAM:                Gambit     VERSION:  2.3.16\n";
+    file << " Jan 2012\n";
+    file << std::setw(10) << "NUMNP" << std::setw(10) << "NELEM" << std::setw(10) << "NGRPS"
+         << std::setw(10) << "NBSETS" << std::setw(10) << "NDFCD" << std::setw(10) << "NDFVL" << "\n";
+    file << std::setw(10) << nb_nodes_1d*nb_nodes_1d << std::setw(10) << nb_cells*nb_cells << std::setw(10) << 1
+         << std::setw(10) << 1 << std::setw(10) << 2 << std::setw(10) << 2 << "\n";
+    file << "ENDOFSECTION\n";
+
+    file << "   NODAL COORDINATES 2.3.16\n";
+    for (Uint j=0; j<nb_nodes_1d; ++j)
+    {
+      for (Uint i=0; i<nb_nodes_1d; ++i)
+      {
+        file << std::setw(10) << 1+i+j*nb_nodes_1d
+             << std::setw(20) << std::scientific << static_cast<Real>(i)/nb_cells
+             << std::setw(20) << std::scientific << static_cast<Real>(j)/nb_cells << "\n";
+      }
+    }
+    file << "ENDOFSECTION\n";
+
+    file << "      ELEMENTS/CELLS 2.3.16\n";
+    for (Uint j=0; j<nb_cells; ++j)
+    {
+      for (Uint i=0; i<nb_cells; ++i)
+      {
+        const Uint first_node = 1+i+j*nb_nodes_1d;
+        file << std::setw(8) << 1+i+j*nb_cells << std::setw(3) << 2 << std::setw(3) << 4 << " "
+             << std::setw(8) << first_node << std::setw(8) << first_node+1
+             << std::setw(8) << first_node+1+nb_nodes_1d << std::setw(8) << first_node+nb_nodes_1d << "\n";
+      }
+    }
+    file << "ENDOFSECTION\n";
+
+    file << "       ELEMENT GROUP 2.3.16\n";
+    file << "GROUP:" << std::setw(11) << 1 << " ELEMENTS:" << std::setw(11) << nb_cells*nb_cells
+         << " MATERIAL:" << std::setw(11) << 2 << " NFLAGS:" << std::setw(11) << 1 << "\n";
+    file << std::setw(32) << "fluid" << "\n" << std::setw(8) << 0 << "\n";
+    for (Uint e=0; e<nb_cells*nb_cells; ++e)
+    {
+      if (e && e%10 == 0)
+        file << "\n";
+      file << std::setw(8) << e+1;
+    }
+    file << "\nENDOFSECTION\n";
+
+    // the first face of the quadrilaterals in the first row
+    file << " BOUNDARY CONDITIONS 2.3.16\n";
+    file << std::setw(32) << "bottom" << std::setw(8) << 1 << std::setw(8) << nb_cells
+         << std::setw(8) << 0 << std::setw(8) << 6 << "\n";
+    for (Uint i=0; i<nb_cells; ++i)
+      file << std::setw(10) << i+1 << std::setw(5) << 2 << std::setw(5) << 1 << "\n";
+    file << "ENDOFSECTION\n";
+  }
+
+  static Handle<Mesh> mesh;
+  static const Uint nb_cells = 600;
+};
+
+Handle<Mesh> NeuReaderBenchmarkFixture::mesh;
+const Uint NeuReaderBenchmarkFixture::nb_cells;
+
+BOOST_FIXTURE_TEST_SUITE( NeuReaderBenchmarkSuite, NeuReaderBenchmarkFixture )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( generate_file )
+{
+  write_grid("neu-reader-benchmark.neu");
+}
+
+BOOST_AUTO_TEST_CASE( read_file )
+{
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  mesh = Core::instance().root().create_component<Mesh>("mesh");
+  meshreader->read_mesh_into("neu-reader-benchmark.neu",*mesh);
+}
+
+BOOST_AUTO_TEST_CASE( check_mesh )
+{
+  BOOST_CHECK_EQUAL(mesh->geometry_fields().size(), (nb_cells+1)*(nb_cells+1));
+
+  Uint nb_cells_read = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(mesh->topology()))
+  {
+    if (elements.element_type().dimensionality() == 2)
+      nb_cells_read += elements.size();
+  }
+  BOOST_CHECK_EQUAL(nb_cells_read, nb_cells*nb_cells);
+
+  BOOST_REQUIRE(is_not_null(mesh->topology().get_child("fluid")));
+  Handle<Region> bottom(mesh->topology().get_child("bottom"));
+  BOOST_REQUIRE(is_not_null(bottom));
+  BOOST_CHECK_EQUAL(bottom->recursive_elements_count(true), nb_cells);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
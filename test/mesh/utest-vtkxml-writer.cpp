@@ -7,6 +7,11 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::tecplot::Writer"
 
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <boost/cstdint.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
@@ -15,6 +20,7 @@
 #include "common/OptionComponent.hpp"
 #include "common/OptionArray.hpp"
 #include "common/OptionURI.hpp"
+#include "common/StringConversion.hpp"
 #include "mesh/MeshWriter.hpp"
 
 #include "Tools/MeshGeneration/MeshGeneration.hpp"
@@ -52,6 +58,51 @@ BOOST_AUTO_TEST_CASE( WriteGrid )
   BOOST_CHECK(true);
 }
 
+BOOST_AUTO_TEST_CASE( WriteUncompressedSinglePrecision )
+{
+  Component& root = Core::instance().root();
+
+  Handle<Mesh> mesh(root.get_child("mesh"));
+
+  boost::shared_ptr< MeshWriter > vtk_writer = build_component_abstract_type<MeshWriter>("cf3.mesh.VTKXML.Writer","meshwriter");
+
+  std::vector<URI> fields; fields.push_back(mesh->geometry_fields().coordinates().uri());
+  vtk_writer->options().set("fields",fields);
+  vtk_writer->options().set("mesh",mesh);
+  vtk_writer->options().set("file",URI("grid_float.vtu"));
+  vtk_writer->options().set("compressor",std::string("none"));
+  vtk_writer->options().set("single_precision",true);
+  vtk_writer->execute();
+
+  // Read back the points, which are the first appended array
+  std::ifstream file("grid_float_P0.vtu", std::ios_base::in | std::ios_base::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string vtu = contents.str();
+  BOOST_CHECK(vtu.find("Float32") != std::string::npos);
+  BOOST_CHECK(vtu.find("compressor") == std::string::npos);
+  BOOST_CHECK(vtu.find("@") == std::string::npos);
+
+  const std::string appended_tag = "<AppendedData encoding=\"raw\">\n_";
+  const std::size_t data_begin = vtu.find(appended_tag) + appended_tag.size();
+  const std::size_t offset_begin = vtu.find("offset=\"") + 8;
+  const Uint points_offset = from_str<Uint>(vtu.substr(offset_begin, vtu.find('"', offset_begin) - offset_begin));
+  BOOST_CHECK_EQUAL(points_offset, 0u);
+
+  const Field& coords = mesh->geometry_fields().coordinates();
+  boost::uint32_t nb_bytes;
+  std::memcpy(&nb_bytes, &vtu[data_begin], 4);
+  BOOST_CHECK_EQUAL(nb_bytes, 3*coords.size()*sizeof(float));
+  for(Uint i = 0; i != coords.size(); ++i)
+  {
+    float point[3];
+    std::memcpy(point, &vtu[data_begin + 4 + 3*i*sizeof(float)], 3*sizeof(float));
+    BOOST_CHECK_EQUAL(point[0], static_cast<float>(coords[i][XX]));
+    BOOST_CHECK_EQUAL(point[1], static_cast<float>(coords[i][YY]));
+    BOOST_CHECK_EQUAL(point[2], 0.f);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
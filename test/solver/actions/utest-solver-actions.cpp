@@ -8,11 +8,14 @@
 #define BOOST_TEST_MODULE "Test module for cf3::actions"
 
 #include <iomanip>
+#include <fstream>
 
 #include <boost/test/unit_test.hpp>
 
 #include <boost/assign/list_of.hpp>
 
+#include "common/BoostFilesystem.hpp"
+
 #include "common/LibCommon.hpp"
 
 #include "common/Log.hpp"
@@ -21,6 +24,7 @@
 #include "common/Environment.hpp"
 #include "common/Group.hpp"
 #include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/MeshWriter.hpp"
@@ -32,6 +36,7 @@
 #include "mesh/Dictionary.hpp"
 #include "mesh/Connectivity.hpp"
 #include "mesh/Space.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
 
 #include "solver/actions/LibActions.hpp"
 #include "solver/actions/ForAllElements.hpp"
@@ -41,6 +46,9 @@
 #include "solver/actions/LoopOperation.hpp"
 #include "solver/actions/ComputeVolume.hpp"
 #include "solver/actions/ComputeArea.hpp"
+#include "solver/actions/Probe.hpp"
+#include "solver/actions/ProbeSet.hpp"
+#include "solver/actions/PeriodicWriteMesh.hpp"
 
 using namespace boost::assign;
 
@@ -264,6 +272,179 @@ BOOST_AUTO_TEST_CASE ( test_ForAllElementsT )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE ( test_ProbeSet )
+{
+  Component& root = Core::instance().root();
+  Handle<Mesh> mesh = root.create_component<Mesh>("probed_mesh");
+  Handle<SimpleMeshGenerator> generator = root.create_component<SimpleMeshGenerator>("probed_mesh_generator");
+  generator->options().set("mesh",mesh->uri());
+  generator->options().set("nb_cells",std::vector<Uint>(2,10u));
+  generator->options().set("lengths",std::vector<Real>(2,10.));
+  generator->execute();
+
+  const Field& coords = mesh->geometry_fields().coordinates();
+  Field& field = mesh->geometry_fields().create_field("probed","u[vector]");
+  for (Uint n=0; n<field.size(); ++n)
+  {
+    field[n][XX] = 2.*coords[n][XX] + coords[n][YY];
+    field[n][YY] = coords[n][YY] - 1.;
+  }
+
+  std::vector<Real> coordinates = list_of(0.5)(0.5)(5.2)(3.7)(9.9)(0.1);
+  Handle<ProbeSet> probe_set = root.create_component<ProbeSet>("probe_set");
+  probe_set->options().set("dict",mesh->geometry_fields().handle<Dictionary>());
+  probe_set->options().set("coordinates",coordinates);
+  probe_set->execute();
+  BOOST_CHECK_EQUAL(probe_set->nb_probes(), 3u);
+
+  // Every probe set sample must match a single probe at the same coordinate
+  Handle<Probe> probe = root.create_component<Probe>("probe");
+  probe->options().set("dict",mesh->geometry_fields().handle<Dictionary>());
+  const Uint u_column = coords.row_size();
+  const Table<Real>& values = probe_set->values();
+  BOOST_REQUIRE_EQUAL(values.size(), 3u);
+  BOOST_REQUIRE_EQUAL(values.row_size(), coords.row_size()+field.row_size());
+  for (Uint p=0; p<3; ++p)
+  {
+    probe->options().set("coordinate",std::vector<Real>(coordinates.begin()+2*p,coordinates.begin()+2*p+2));
+    probe->execute();
+    BOOST_CHECK_CLOSE(values[p][XX], coordinates[2*p+XX], 1e-8);
+    BOOST_CHECK_CLOSE(values[p][YY], coordinates[2*p+YY], 1e-8);
+    BOOST_CHECK_CLOSE(values[p][u_column+XX], probe->properties().value<Real>("u[0]"), 1e-8);
+    BOOST_CHECK_CLOSE(values[p][u_column+YY], probe->properties().value<Real>("u[1]"), 1e-8);
+  }
+
+  // New values are sampled with the stored interpolation
+  field = 1.;
+  probe_set->execute();
+  for (Uint p=0; p<3; ++p)
+    BOOST_CHECK_CLOSE(values[p][u_column+XX], 1., 1e-8);
+
+  // After moving the nodes, the probes are located again in the moved cells
+  Field& moved_coords = mesh->geometry_fields().coordinates();
+  for (Uint n=0; n<moved_coords.size(); ++n)
+  {
+    moved_coords[n][XX] = moved_coords[n][XX]*moved_coords[n][XX]/10.;
+    field[n][XX] = 2.*moved_coords[n][XX] + moved_coords[n][YY];
+  }
+  mesh->raise_mesh_changed();
+  probe_set->execute();
+  for (Uint p=0; p<3; ++p)
+  {
+    probe->options().set("coordinate",std::vector<Real>(coordinates.begin()+2*p,coordinates.begin()+2*p+2));
+    probe->execute();
+    BOOST_CHECK_CLOSE(values[p][XX], coordinates[2*p+XX], 1e-8);
+    BOOST_CHECK_CLOSE(values[p][YY], coordinates[2*p+YY], 1e-8);
+    BOOST_CHECK_CLOSE(values[p][u_column+XX], 2.*coordinates[2*p+XX] + coordinates[2*p+YY], 1e-8);
+    BOOST_CHECK_CLOSE(probe->properties().value<Real>("u[0]"), 2.*coordinates[2*p+XX] + coordinates[2*p+YY], 1e-8);
+  }
+
+  root.remove_component( *mesh );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE ( test_PeriodicWriteMesh_asynchronous )
+{
+  Component& root = Core::instance().root();
+  Handle<Mesh> mesh = root.create_component<Mesh>("written_mesh");
+  Handle<SimpleMeshGenerator> generator = root.create_component<SimpleMeshGenerator>("written_mesh_generator");
+  generator->options().set("mesh",mesh->uri());
+  generator->options().set("nb_cells",std::vector<Uint>(2,10u));
+  generator->options().set("lengths",std::vector<Real>(2,10.));
+  generator->execute();
+
+  Field& field = mesh->geometry_fields().create_field("written","u[scalar]");
+  field = 1.;
+
+  Handle<Group> iterator = root.create_component<Group>("write_iterator");
+  iterator->properties().add("iteration",0u);
+
+  Handle<PeriodicWriteMesh> sync_writer = root.create_component<PeriodicWriteMesh>("sync_writer");
+  sync_writer->options().set("mesh",mesh);
+  sync_writer->options().set("iterator",iterator->handle<Component>());
+  sync_writer->options().set("saverate",1u);
+  sync_writer->options().set("filepath",URI("periodic-sync.msh"));
+  sync_writer->execute();
+
+  Handle<PeriodicWriteMesh> async_writer = root.create_component<PeriodicWriteMesh>("async_writer");
+  async_writer->options().set("mesh",mesh);
+  async_writer->options().set("iterator",iterator->handle<Component>());
+  async_writer->options().set("saverate",1u);
+  async_writer->options().set("filepath",URI("periodic-async.msh"));
+  async_writer->options().set("asynchronous",true);
+  async_writer->execute();
+
+  // The solver may continue while the snapshot is being written
+  field = 2.;
+  async_writer->wait();
+
+  // Both files hold the field values at the time of execute()
+  std::ifstream sync_file("periodic-sync.msh");
+  std::ifstream async_file("periodic-async.msh");
+  const std::string sync_contents( (std::istreambuf_iterator<char>(sync_file)), std::istreambuf_iterator<char>() );
+  const std::string async_contents( (std::istreambuf_iterator<char>(async_file)), std::istreambuf_iterator<char>() );
+  BOOST_CHECK(!sync_contents.empty());
+  BOOST_CHECK(sync_contents == async_contents);
+
+  boost::filesystem::remove("periodic-sync.msh");
+  boost::filesystem::remove("periodic-async.msh");
+  root.remove_component( *mesh );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE ( test_PeriodicWriteMesh_asynchronous_stamps )
+{
+  Component& root = Core::instance().root();
+  Handle<Mesh> mesh = root.create_component<Mesh>("stamped_mesh");
+  Handle<SimpleMeshGenerator> generator = root.create_component<SimpleMeshGenerator>("stamped_mesh_generator");
+  generator->options().set("mesh",mesh->uri());
+  generator->options().set("nb_cells",std::vector<Uint>(2,10u));
+  generator->options().set("lengths",std::vector<Real>(2,10.));
+  generator->execute();
+  mesh->geometry_fields().create_field("stamped","u[scalar]");
+
+  Handle<Group> iterator = root.create_component<Group>("stamp_iterator");
+  iterator->properties().add("iteration",1u);
+
+  Handle<PeriodicWriteMesh> async_writer = root.create_component<PeriodicWriteMesh>("stamped_writer");
+  async_writer->options().set("mesh",mesh);
+  async_writer->options().set("iterator",iterator->handle<Component>());
+  async_writer->options().set("saverate",1u);
+  async_writer->options().set("filepath",URI("periodic-async-${iter}.dat"));
+  async_writer->options().set("asynchronous",true);
+
+  // The iteration advances while the previous write may still be running
+  mesh->metadata()["iter"] = 1u;
+  mesh->metadata()["time"] = 0.5;
+  async_writer->execute();
+  iterator->properties().property("iteration") = 2u;
+  mesh->metadata()["iter"] = 2u;
+  mesh->metadata()["time"] = 1.5;
+  async_writer->execute();
+  mesh->metadata()["iter"] = 3u;
+  mesh->metadata()["time"] = 2.5;
+  async_writer->wait();
+
+  // Each file is named and stamped with the iteration and time of its execute()
+  for (Uint iter=1; iter<=2; ++iter)
+  {
+    const std::string filename = "periodic-async-000"+to_str(iter)+".dat";
+    BOOST_CHECK(boost::filesystem::exists(filename));
+    std::ifstream file(filename.c_str());
+    const std::string contents( (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>() );
+    BOOST_CHECK(contents.find("T=\"ITER"+to_str(iter)+":") != std::string::npos);
+    BOOST_CHECK(contents.find("SOLUTIONTIME="+to_str(iter-0.5)+",") != std::string::npos);
+    boost::filesystem::remove(filename);
+  }
+  BOOST_CHECK(!boost::filesystem::exists("periodic-async-0003.dat"));
+
+  root.remove_component( *mesh );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,141 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::solver::History"
+
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/cstdint.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+
+#include "solver/History.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::solver;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct HistoryFixture
+{
+  /// Number of lines in a text file
+  Uint count_lines(const std::string& path)
+  {
+    std::ifstream file(path.c_str());
+    std::string line;
+    Uint nb_lines = 0;
+    while (std::getline(file,line))
+      ++nb_lines;
+    return nb_lines;
+  }
+
+  /// Read a binary history file into rows
+  std::vector< std::vector<Real> > read_binary(const std::string& path, std::vector<std::string>& columns)
+  {
+    std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+    char magic[8];
+    file.read(magic,8);
+    BOOST_REQUIRE_EQUAL(std::string(magic,8), std::string("CF3HIST1"));
+    boost::uint32_t nb_columns;
+    file.read(reinterpret_cast<char*>(&nb_columns),sizeof(nb_columns));
+    columns.resize(nb_columns);
+    for (Uint c=0; c<nb_columns; ++c)
+    {
+      boost::uint32_t length;
+      file.read(reinterpret_cast<char*>(&length),sizeof(length));
+      columns[c].resize(length);
+      file.read(&columns[c][0],length);
+    }
+    std::vector< std::vector<Real> > rows;
+    boost::uint32_t nb_rows;
+    while (file.read(reinterpret_cast<char*>(&nb_rows),sizeof(nb_rows)))
+    {
+      const Uint first = rows.size();
+      rows.resize(first+nb_rows,std::vector<Real>(nb_columns));
+      for (Uint c=0; c<nb_columns; ++c)
+        for (Uint r=0; r<nb_rows; ++r)
+          file.read(reinterpret_cast<char*>(&rows[first+r][c]),sizeof(double));
+    }
+    return rows;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( HistorySuite, HistoryFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( buffered_tsv )
+{
+  boost::shared_ptr<History> history = allocate_component<History>("history");
+  history->options().set("dimension",2u);
+  history->options().set("file",URI("history-buffered.tsv"));
+  history->options().set("flush_entries",10u);
+
+  for (Uint iter=0; iter<25; ++iter)
+  {
+    history->set("iter",static_cast<Real>(iter));
+    history->save_entry();
+  }
+  // The first entry creates the file, after which 20 entries were written in two batches
+  BOOST_CHECK_EQUAL(count_lines("history-buffered.tsv"), 1u+21u);
+
+  history->flush();
+  BOOST_CHECK_EQUAL(count_lines("history-buffered.tsv"), 1u+25u);
+  BOOST_CHECK_EQUAL(history->table()->size(), 25u);
+
+  history.reset();
+  boost::filesystem::remove("history-buffered.tsv");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( background_binary )
+{
+  boost::shared_ptr<History> history = allocate_component<History>("history");
+  history->options().set("dimension",2u);
+  history->options().set("file",URI("history-background.bin"));
+  history->options().set("format",std::string("binary"));
+  history->options().set("flush_entries",7u);
+  history->options().set("flush_interval",0.01);
+
+  for (Uint iter=0; iter<50; ++iter)
+  {
+    history->set("iter",static_cast<Real>(iter));
+    // A new variable rewrites the file
+    if (iter >= 20)
+      history->set("residual",std::vector<Real>(2,1./(iter+1)));
+    history->save_entry();
+  }
+  history->flush();
+
+  std::vector<std::string> columns;
+  std::vector< std::vector<Real> > rows = read_binary("history-background.bin",columns);
+  history.reset();
+  boost::filesystem::remove("history-background.bin");
+
+  BOOST_REQUIRE_EQUAL(columns.size(), 3u);
+  BOOST_CHECK_EQUAL(columns[0], "iter");
+  BOOST_CHECK_EQUAL(columns[1], "residual[0]");
+  BOOST_REQUIRE_EQUAL(rows.size(), 50u);
+  for (Uint iter=0; iter<50; ++iter)
+  {
+    BOOST_CHECK_EQUAL(rows[iter][0], static_cast<Real>(iter));
+    BOOST_CHECK_EQUAL(rows[iter][2], iter >= 20 ? 1./(iter+1) : 0.);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////